@@ -38,8 +38,10 @@ function getPwmFormData() {
 
 function enumSelectGenerate(id, val, arOptions) {
   // Generate a <select> item with every option in arOptions, and select the val element (0-based)
+  // undefined items are skipped but still take up an index
   const retVal = `<div class="mui-select"><select id="${id}">` +
         arOptions.map((item, idx) => {
+          if (item === undefined) return '';
           return `<option value="${idx}"${(idx == val) ? ' selected' : ''}>${item}</option>`;
         }).join('') + '</select></div>';
   return retVal;
@@ -59,7 +61,7 @@ function updatePwmSettings(arPwm) {
     const mode = (item >> 15) & 15; // 4 bits
     const narrow = (item >> 19) & 1;
     const modeSelect = enumSelectGenerate(`pwm_${index}_mode`, mode,
-        ['50Hz', '60Hz', '100Hz', '160Hz', '333Hz', '400Hz', 'On/Off']);
+        ['50Hz', '60Hz', '100Hz', '160Hz', '333Hz', '400Hz', 'On/Off', undefined, undefined, undefined, 'Sync']);
     const inputSelect = enumSelectGenerate(`pwm_${index}_ch`, ch,
         ['ch1', 'ch2', 'ch3', 'ch4',
           'ch5 (AUX1)', 'ch6 (AUX2)', 'ch7 (AUX3)', 'ch8 (AUX4)',
@@ -176,8 +178,18 @@ function getNetworks() {
 
 // =========================================================
 
-function uploadFile() {
-  const file = _('firmware_file').files[0];
+// The ESP32 decompresses gzip images as they arrive, so compress a plain .bin
+// in the browser when it can to cut the upload time over the soft-AP
+async function compressFirmware(file) {
+  if (!_('firmware_inflate') || typeof CompressionStream === 'undefined') return file;
+  const magic = new Uint8Array(await file.slice(0, 2).arrayBuffer());
+  if (magic[0] === 0x1f && magic[1] === 0x8b) return file;
+  const compressed = await new Response(file.stream().pipeThrough(new CompressionStream('gzip'))).blob();
+  return new File([compressed], file.name + '.gz');
+}
+
+async function uploadFile() {
+  const file = await compressFirmware(_('firmware_file').files[0]);
   const formdata = new FormData();
   formdata.append('upload', file, file.name);
   const ajax = new XMLHttpRequest();
@@ -18,5 +18,7 @@ void DynamicPower_Init();
 void DynamicPower_Update(uint32_t now);
 // Call DynamicPower_TelemetryUpdate from ISR with DYNPOWER_UPDATE_MISSED or ScaledSNR value
 void DynamicPower_TelemetryUpdate(int8_t snrScaled);
+// Call DynamicPower_UplinkLQShort from ISR with the 100ms uplink LQ from the RX
+void DynamicPower_UplinkLQShort(uint8_t lq);
 
 #endif
\ No newline at end of file
@@ -47,10 +47,15 @@ public:
 
 class HardwareSerial: public Stream {
 public:
+    HardwareSerial() : stream(nullptr) {}
+
+    // Tests can connect the port to a Stream of their own
+    void connect(Stream *s) { stream = s; }
+
     // Stream methods
-    int available() {return 0;}
-    int read() {return -1;}
-    int peek() {return 0;}
+    int available() {return stream ? stream->available() : 0;}
+    int read() {return stream ? stream->read() : -1;}
+    int peek() {return stream ? stream->peek() : 0;}
     void flush() {}
     void end() {}
     void begin(int baud) {}
@@ -58,8 +63,8 @@ public:
     int availableForWrite() {return 256;}
 
     // Print methods
-    size_t write(uint8_t c) {return 1;}
-    size_t write(uint8_t *s, int l) {return l;}
+    size_t write(uint8_t c) {return stream ? stream->write(c) : 1;}
+    size_t write(uint8_t *s, int l) {return stream ? stream->write(s, l) : l;}
 
     int print(const char *s) {return 0;}
     int print(uint8_t s) {return 0;}
@@ -68,6 +73,9 @@ public:
     int println(const char *s) {return 0;}
     int println(uint8_t s) {return 0;}
     int println(uint8_t s, int radix) {return 0;}
+
+private:
+    Stream *stream;
 };
 
 static HardwareSerial Serial;
@@ -76,7 +84,17 @@ static Stream *SerialLogger = &Serial;
 inline void interrupts() {}
 inline void noInterrupts() {}
 
+// Tests can run the clock on simulated time, it is real time until they set it
+struct NativeClock {
+    bool simulated;
+    uint32_t us;
+};
+inline NativeClock &nativeClock() { static NativeClock clock = { false, 0 }; return clock; }
+inline void nativeSetMicros(uint32_t us) { nativeClock().simulated = true; nativeClock().us = us; }
+
 inline unsigned long micros() {
+    if (nativeClock().simulated)
+        return nativeClock().us;
     struct timeval tv;
     gettimeofday(&tv,NULL);
     return tv.tv_sec*(uint64_t)1000000+tv.tv_usec;
@@ -86,7 +104,7 @@ inline void delay(int32_t time) {
     usleep(time);
 }
 
-inline unsigned long millis() { return 0; }
+inline unsigned long millis() { return nativeClock().simulated ? nativeClock().us / 1000 : 0; }
 inline void delayMicroseconds(int delay) { }
 inline char *itoa(int32_t value, char *str, int base) { sprintf(str, "%d", value); return str; }
 inline char *utoa(uint32_t value, char *str, int base) { sprintf(str, "%u", value); return str; }
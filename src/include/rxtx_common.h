@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include "targets.h"
 #include "common.h"
 #include "config.h"
@@ -38,7 +38,7 @@ static void cyclePower()
         {
             POWERMGNT::incPower();
         }
-        devicesTriggerEvent();
+        devicesTriggerEvent(EVENT_POWER_CHANGED);
     }
 };
 #endif
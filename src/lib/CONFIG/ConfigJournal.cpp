@@ -0,0 +1,176 @@
+#include "ConfigJournal.h"
+#include "crc.h"
+#include <string.h>
+
+#define JOURNAL_CRC_POLY    0x07
+#define JOURNAL_ERASED      0xFF
+// key + len + crc
+#define JOURNAL_RECORD_OVERHEAD 3
+
+static GENERIC_CRC8 journal_crc(JOURNAL_CRC_POLY);
+
+uint32_t ConfigJournal::alignUp(uint32_t len) const
+{
+    uint32_t align = m_flash->writeAlign();
+    return (len + align - 1) / align * align;
+}
+
+bool ConfigJournal::readHeader(uint8_t bank, journal_header_t *header)
+{
+    m_flash->read(bankBase(bank), header, sizeof(*header));
+    return header->magic == m_magic
+        && header->crc == journal_crc.calc((uint8_t *)header, sizeof(*header) - 1);
+}
+
+/**
+ * Index the records of bank
+ * Returns: the offset after the last valid record, or the bank size if the
+ * log ends in a torn record, as nothing can be appended after it
+ **/
+uint32_t ConfigJournal::scan(uint8_t bank)
+{
+    const uint32_t base = bankBase(bank);
+    const uint32_t size = m_flash->bankSize();
+    uint32_t pos = alignUp(sizeof(journal_header_t));
+
+    memset(m_index, 0, sizeof(m_index));
+    while (pos + JOURNAL_RECORD_OVERHEAD <= size)
+    {
+        uint8_t record[JOURNAL_RECORD_OVERHEAD + JOURNAL_MAX_RECORD_LEN];
+        m_flash->read(base + pos, record, 2);
+        uint8_t key = record[0];
+        uint8_t len = record[1];
+        if (key == JOURNAL_ERASED && len == JOURNAL_ERASED)
+            return pos;
+
+        uint32_t recordSize = alignUp(len + JOURNAL_RECORD_OVERHEAD);
+        if (key >= JOURNAL_MAX_KEYS || len > JOURNAL_MAX_RECORD_LEN || pos + recordSize > size)
+            break;
+        m_flash->read(base + pos + 2, &record[2], len + 1);
+        if (record[len + 2] != journal_crc.calc(record, len + 2))
+            break;
+
+        m_index[key] = pos;
+        pos += recordSize;
+    }
+
+    return size;
+}
+
+bool ConfigJournal::Begin(JournalFlash *flash, uint32_t magic)
+{
+    m_flash = flash;
+    m_magic = magic;
+    m_valid = false;
+    m_bank = 0;
+    m_seq = 0;
+    m_writePos = m_flash->bankSize();
+    memset(m_index, 0, sizeof(m_index));
+
+    for (uint8_t bank = 0; bank < m_flash->bankCount(); ++bank)
+    {
+        journal_header_t header;
+        if (!readHeader(bank, &header))
+            continue;
+        // Newest bank wins, the sequence number is allowed to wrap
+        if (!m_valid || (int16_t)(header.seq - m_seq) > 0)
+        {
+            m_valid = true;
+            m_bank = bank;
+            m_seq = header.seq;
+        }
+    }
+
+    if (m_valid)
+        m_writePos = scan(m_bank);
+    return m_valid;
+}
+
+bool ConfigJournal::Read(uint8_t key, void *data, uint8_t len)
+{
+    if (!m_valid || key >= JOURNAL_MAX_KEYS || m_index[key] == 0)
+        return false;
+
+    uint8_t recordHeader[2];
+    uint32_t addr = bankBase(m_bank) + m_index[key];
+    m_flash->read(addr, recordHeader, sizeof(recordHeader));
+    if (recordHeader[1] != len)
+        return false;
+    m_flash->read(addr + sizeof(recordHeader), data, len);
+    return true;
+}
+
+bool ConfigJournal::append(uint8_t key, const void *data, uint8_t len)
+{
+    uint8_t record[16];
+    uint32_t recordSize = alignUp(len + JOURNAL_RECORD_OVERHEAD);
+    if (len > JOURNAL_MAX_RECORD_LEN || recordSize > sizeof(record)
+        || m_writePos + recordSize > m_flash->bankSize())
+        return false;
+
+    memset(record, JOURNAL_ERASED, sizeof(record));
+    record[0] = key;
+    record[1] = len;
+    memcpy(&record[2], data, len);
+    record[len + 2] = journal_crc.calc(record, len + 2);
+
+    if (!m_flash->program(bankBase(m_bank) + m_writePos, record, recordSize))
+    {
+        // The location is now unknown, nothing more can go in this bank
+        m_writePos = m_flash->bankSize();
+        return false;
+    }
+
+    m_index[key] = m_writePos;
+    m_writePos += recordSize;
+    return true;
+}
+
+bool ConfigJournal::Update(uint8_t key, const void *data, uint8_t len)
+{
+    if (!m_valid || key >= JOURNAL_MAX_KEYS)
+        return false;
+
+    uint8_t current[JOURNAL_MAX_RECORD_LEN];
+    if (len <= sizeof(current) && Read(key, current, len) && memcmp(current, data, len) == 0)
+        return true;
+
+    return append(key, data, len);
+}
+
+bool ConfigJournal::Compact(journal_record_cb getRecord, void *ctx)
+{
+    uint8_t bank = (m_bank + 1) % m_flash->bankCount();
+    m_valid = false;
+    if (!m_flash->erase(bank))
+        return false;
+
+    m_bank = bank;
+    m_writePos = alignUp(sizeof(journal_header_t));
+    memset(m_index, 0, sizeof(m_index));
+    for (uint8_t key = 0; key < JOURNAL_MAX_KEYS; ++key)
+    {
+        uint8_t data[JOURNAL_MAX_RECORD_LEN];
+        uint8_t len = getRecord(ctx, key, data);
+        if (len && !append(key, data, len))
+            return false;
+    }
+
+    // The header goes last, the bank isn't used until everything is in it
+    journal_header_t header;
+    header.magic = m_magic;
+    header.seq = m_seq + 1;
+    header.unused = JOURNAL_ERASED;
+    header.crc = journal_crc.calc((uint8_t *)&header, sizeof(header) - 1);
+    if (!m_flash->program(bankBase(m_bank), &header, alignUp(sizeof(header))))
+        return false;
+
+    m_seq = header.seq;
+    m_valid = true;
+    return true;
+}
+
+uint32_t ConfigJournal::FreeSpace() const
+{
+    return m_valid ? m_flash->bankSize() - m_writePos : 0;
+}
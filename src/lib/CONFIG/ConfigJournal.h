@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdint.h>
+
+// Keys are 0..JOURNAL_MAX_KEYS-1, enough for 64 TX models plus the global items
+#define JOURNAL_MAX_KEYS        72
+#define JOURNAL_MAX_RECORD_LEN  8
+// Free space kept for a full Commit(), below this the next Commit() compacts first
+#define JOURNAL_COMMIT_RESERVE  64
+
+/**
+ * Raw access to the flash backing the journal, which is split into
+ * bankCount() erase units of bankSize() bytes. Addresses are offsets from the
+ * start of the first bank. program() can only clear bits, so a location can
+ * only be written once between erases, and must be called with addr and len
+ * aligned to writeAlign().
+ */
+class JournalFlash
+{
+public:
+    virtual uint32_t bankSize() const = 0;
+    virtual uint8_t bankCount() const = 0;
+    virtual uint8_t writeAlign() const = 0;
+    virtual void read(uint32_t addr, void *dst, uint32_t len) = 0;
+    virtual bool program(uint32_t addr, const void *src, uint32_t len) = 0;
+    virtual bool erase(uint8_t bank) = 0;
+};
+
+/**
+ * Serializes the current value of `key` into data (at most JOURNAL_MAX_RECORD_LEN bytes)
+ * Returns: the length of the record, 0 if the key is not used
+ **/
+typedef uint8_t (*journal_record_cb)(void *ctx, uint8_t key, uint8_t *data);
+
+/**
+ * Log-structured key/record store for the config.
+ *
+ * Each change is appended to the active bank as a small record of
+ * [key, len, data..., crc8] padded to the write alignment, so a config change
+ * programs a few bytes instead of erasing and rewriting the whole config, and
+ * the writes move through the bank instead of hitting the same cells. The
+ * latest valid record of each key wins. A record torn by power loss fails its
+ * CRC and is ignored along with anything after it.
+ *
+ * When the bank is full it is compacted: the next bank (or the same one if
+ * there is only one) is erased, the current value of every key is written,
+ * and the bank header with an incremented sequence number is written last.
+ * A bank is only used if its header is valid, so with two banks a compaction
+ * interrupted by power loss leaves the previous bank in use. With a single
+ * bank the erase makes the compaction itself the only unsafe window.
+ */
+class ConfigJournal
+{
+public:
+    /**
+     * Find the newest bank with a header matching magic and index its records
+     * Returns: true if a journal was found, false if Compact() must be used to create one
+     **/
+    bool Begin(JournalFlash *flash, uint32_t magic);
+    bool IsValid() const { return m_valid; }
+
+    /**
+     * Read the latest value of key into data
+     * Returns: true if a record of exactly len bytes was found
+     **/
+    bool Read(uint8_t key, void *data, uint8_t len);
+
+    /**
+     * Append a record for key if its value differs from the latest one
+     * Returns: false if it doesn't fit and the journal needs compacting
+     **/
+    bool Update(uint8_t key, const void *data, uint8_t len);
+
+    /**
+     * Rewrite the current value of every key, supplied by getRecord, to a freshly erased bank
+     **/
+    bool Compact(journal_record_cb getRecord, void *ctx);
+
+    uint32_t Size() const { return m_flash->bankSize(); }
+    uint32_t FreeSpace() const;
+    // True if the next Commit() will compact, which erases the flash and blocks for a while
+    bool NeedsCompaction() const { return !m_valid || FreeSpace() < JOURNAL_COMMIT_RESERVE; }
+
+private:
+    typedef struct {
+        uint32_t magic;
+        uint16_t seq;
+        uint8_t  unused;
+        uint8_t  crc;
+    } journal_header_t;
+
+    JournalFlash *m_flash;
+    uint32_t m_magic;
+    bool     m_valid;
+    uint8_t  m_bank;
+    uint16_t m_seq;
+    uint32_t m_writePos;    // offset in the active bank of the next record
+    uint16_t m_index[JOURNAL_MAX_KEYS]; // offset of the latest record of each key, 0 if none
+
+    uint32_t bankBase(uint8_t bank) const { return bank * m_flash->bankSize(); }
+    uint32_t alignUp(uint32_t len) const;
+    bool readHeader(uint8_t bank, journal_header_t *header);
+    uint32_t scan(uint8_t bank);
+    bool append(uint8_t key, const void *data, uint8_t len);
+};
@@ -0,0 +1,127 @@
+#include "config.h"
+
+#if defined(CONFIG_USE_JOURNAL)
+#include <string.h>
+
+#if defined(PLATFORM_ESP8266)
+extern "C" {
+#include "spi_flash.h"
+}
+extern "C" uint32_t _EEPROM_start;
+
+/**
+ * The 4KB sector reserved for the EEPROM emulation, as a single bank.
+ * The SPI flash can only be accessed in aligned 32-bit words.
+ */
+class PlatformJournalFlash : public JournalFlash
+{
+public:
+    uint32_t bankSize() const { return SPI_FLASH_SEC_SIZE; }
+    uint8_t bankCount() const { return 1; }
+    uint8_t writeAlign() const { return sizeof(uint32_t); }
+
+    void read(uint32_t addr, void *dst, uint32_t len)
+    {
+        uint8_t *out = (uint8_t *)dst;
+        while (len)
+        {
+            uint32_t word;
+            uint32_t offset = addr % sizeof(word);
+            uint32_t count = sizeof(word) - offset;
+            if (count > len)
+                count = len;
+            spi_flash_read(base() + addr - offset, &word, sizeof(word));
+            memcpy(out, (uint8_t *)&word + offset, count);
+            out += count;
+            addr += count;
+            len -= count;
+        }
+    }
+
+    bool program(uint32_t addr, const void *src, uint32_t len)
+    {
+        const uint8_t *in = (const uint8_t *)src;
+        for (uint32_t i = 0; i < len; i += sizeof(uint32_t))
+        {
+            uint32_t word;
+            memcpy(&word, &in[i], sizeof(word));
+            if (spi_flash_write(base() + addr + i, &word, sizeof(word)) != SPI_FLASH_RESULT_OK)
+                return false;
+        }
+        return true;
+    }
+
+    bool erase(uint8_t bank)
+    {
+        return spi_flash_erase_sector(base() / SPI_FLASH_SEC_SIZE) == SPI_FLASH_RESULT_OK;
+    }
+
+private:
+    uint32_t base() const { return (uint32_t)&_EEPROM_start - 0x40200000; }
+};
+#endif // PLATFORM_ESP8266
+
+#if defined(PLATFORM_STM32)
+// The same page the core's EEPROM emulation uses, the last page of the flash
+#if !defined(FLASH_END)
+    #if defined(FLASH_BANK2_END)
+        #define FLASH_END FLASH_BANK2_END
+    #elif defined(FLASH_BANK1_END)
+        #define FLASH_END FLASH_BANK1_END
+    #endif
+#endif
+#define JOURNAL_FLASH_BASE ((uint32_t)((FLASH_END + 1) - FLASH_PAGE_SIZE))
+
+/**
+ * The internal flash page reserved for the EEPROM emulation, as a single bank.
+ * Programming a halfword stalls the CPU for ~50us, erasing the page for ~20ms.
+ */
+class PlatformJournalFlash : public JournalFlash
+{
+public:
+    uint32_t bankSize() const { return FLASH_PAGE_SIZE; }
+    uint8_t bankCount() const { return 1; }
+    uint8_t writeAlign() const { return sizeof(uint16_t); }
+
+    void read(uint32_t addr, void *dst, uint32_t len)
+    {
+        memcpy(dst, (const void *)(JOURNAL_FLASH_BASE + addr), len);
+    }
+
+    bool program(uint32_t addr, const void *src, uint32_t len)
+    {
+        const uint8_t *in = (const uint8_t *)src;
+        bool success = true;
+        HAL_FLASH_Unlock();
+        __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_WRPERR | FLASH_FLAG_PGERR);
+        for (uint32_t i = 0; i < len && success; i += sizeof(uint16_t))
+        {
+            uint16_t halfword;
+            memcpy(&halfword, &in[i], sizeof(halfword));
+            success = HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, JOURNAL_FLASH_BASE + addr + i, halfword) == HAL_OK;
+        }
+        HAL_FLASH_Lock();
+        return success;
+    }
+
+    bool erase(uint8_t bank)
+    {
+        FLASH_EraseInitTypeDef eraseInit;
+        uint32_t pageError = 0;
+        eraseInit.TypeErase = FLASH_TYPEERASE_PAGES;
+        eraseInit.PageAddress = JOURNAL_FLASH_BASE;
+        eraseInit.NbPages = 1;
+
+        HAL_FLASH_Unlock();
+        __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_WRPERR | FLASH_FLAG_PGERR);
+        bool success = HAL_FLASHEx_Erase(&eraseInit, &pageError) == HAL_OK;
+        HAL_FLASH_Lock();
+        return success;
+    }
+};
+#endif // PLATFORM_STM32
+
+static PlatformJournalFlash platformJournalFlash;
+JournalFlash *configJournalFlash = &platformJournalFlash;
+
+#endif // CONFIG_USE_JOURNAL
@@ -12,6 +12,12 @@
 #define FAN_CHANGED         bit(4)
 #define MOTION_CHANGED      bit(5)
 
+// Journal keys, 0-63 are the models
+#define TX_KEY_VTX          64
+#define TX_KEY_MAIN         65
+#define TX_KEY_FAN          66
+#define TX_KEY_MOTION       67
+
 TxConfig::TxConfig()
 {
     SetModelId(0);
@@ -84,6 +90,104 @@ TxConfig::Load()
     m_model = &m_config.model_config[m_modelId];
     m_modified = 0;
 }
+#elif defined(CONFIG_USE_JOURNAL)
+void
+TxConfig::Load()
+{
+    m_modified = 0;
+    if (m_journal.Begin(configJournalFlash, TX_CONFIG_VERSION | TX_CONFIG_MAGIC))
+    {
+        DBGLN("Found version %u config journal", TX_CONFIG_VERSION);
+        m_config.version = TX_CONFIG_VERSION | TX_CONFIG_MAGIC;
+        JournalLoad();
+        // Compacting erases the journal, it's only done by Commit() when the
+        // changes no longer fit, never speculatively at boot
+        return;
+    }
+
+    // No journal yet, take the config from the EEPROM struct which was in this flash before
+    m_eeprom->Get(0, m_config);
+    if (m_config.version != (uint32_t)(TX_CONFIG_VERSION | TX_CONFIG_MAGIC))
+    {
+        if (!UpgradeEepromV5ToV6())
+        {
+            DBGLN("EEPROM version mismatch! Resetting to defaults...");
+            SetDefaults();
+        }
+    }
+    if (!m_journal.IsValid())
+        m_journal.Compact(&TxConfig::JournalRecord, this);
+}
+
+uint8_t
+TxConfig::JournalRecord(void *ctx, uint8_t key, uint8_t *data)
+{
+    tx_config_t const * const c = &((TxConfig *)ctx)->m_config;
+    if (key < 64)
+    {
+        memcpy(data, &c->model_config[key], sizeof(model_config_t));
+        return sizeof(model_config_t);
+    }
+
+    switch (key)
+    {
+    case TX_KEY_VTX:
+        data[0] = c->vtxBand;
+        data[1] = c->vtxChannel;
+        data[2] = c->vtxPower;
+        data[3] = c->vtxPitmode;
+        return 4;
+    case TX_KEY_MAIN:
+        data[0] = c->powerFanThreshold;
+        data[1] = c->dvrAux;
+        data[2] = c->dvrStartDelay;
+        data[3] = c->dvrStopDelay;
+        return 4;
+    case TX_KEY_FAN:
+        data[0] = c->fanMode;
+        return 1;
+    case TX_KEY_MOTION:
+        data[0] = c->motionMode;
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+void
+TxConfig::JournalLoad()
+{
+    for (unsigned i = 0; i < 64; ++i)
+        m_journal.Read(i, &m_config.model_config[i], sizeof(model_config_t));
+
+    uint8_t data[4];
+    if (m_journal.Read(TX_KEY_VTX, data, 4))
+    {
+        m_config.vtxBand = data[0];
+        m_config.vtxChannel = data[1];
+        m_config.vtxPower = data[2];
+        m_config.vtxPitmode = data[3];
+    }
+    if (m_journal.Read(TX_KEY_MAIN, data, 4))
+    {
+        m_config.powerFanThreshold = data[0];
+        m_config.dvrAux = data[1];
+        m_config.dvrStartDelay = data[2];
+        m_config.dvrStopDelay = data[3];
+    }
+    if (m_journal.Read(TX_KEY_FAN, data, 1))
+        m_config.fanMode = data[0];
+    if (m_journal.Read(TX_KEY_MOTION, data, 1))
+        m_config.motionMode = data[0];
+}
+
+bool
+TxConfig::JournalUpdate(uint8_t key)
+{
+    uint8_t data[JOURNAL_MAX_RECORD_LEN];
+    uint8_t len = JournalRecord(this, key, data);
+    return m_journal.Update(key, data, len);
+}
 #else
 void
 TxConfig::Load()
@@ -151,6 +255,21 @@ TxConfig::Commit()
         nvs_set_u8(handle, "dvrstopdelay", m_config.dvrStopDelay);
     }
     nvs_commit(handle);
+#elif defined(CONFIG_USE_JOURNAL)
+    // Append only the changed parts, unless they don't fit and everything is rewritten
+    bool appended = !m_journal.NeedsCompaction();
+    if (appended && (m_modified & MODEL_CHANGED))
+        appended = JournalUpdate(m_modelId);
+    if (appended && (m_modified & VTX_CHANGED))
+        appended = JournalUpdate(TX_KEY_VTX);
+    if (appended && (m_modified & FAN_CHANGED))
+        appended = JournalUpdate(TX_KEY_FAN);
+    if (appended && (m_modified & MOTION_CHANGED))
+        appended = JournalUpdate(TX_KEY_MOTION);
+    if (appended && (m_modified & MAIN_CHANGED))
+        appended = JournalUpdate(TX_KEY_MAIN);
+    if (!appended)
+        m_journal.Compact(&TxConfig::JournalRecord, this);
 #else
     // Write the struct to eeprom
     m_eeprom->Put(0, m_config);
@@ -479,9 +598,30 @@ TxConfig::SetModelId(uint8_t modelId)
 
 #if defined(TARGET_RX)
 
+#define RX_KEY_BIND         0
+#define RX_KEY_LOAN         1
+#define RX_KEY_POWERON      2
+#define RX_KEY_MODEL        3
+#define RX_KEY_POWER        4
+#define RX_KEY_ANTENNA      5
+#define RX_KEY_PWM          8 // 8-23 are the PWM channels
+
 void
 RxConfig::Load()
 {
+#if defined(CONFIG_USE_JOURNAL)
+    m_modified = false;
+    if (m_journal.Begin(configJournalFlash, RX_CONFIG_VERSION | RX_CONFIG_MAGIC))
+    {
+        DBGLN("Found version %u config journal", RX_CONFIG_VERSION);
+        m_config.version = RX_CONFIG_VERSION | RX_CONFIG_MAGIC;
+        JournalLoad();
+        // Compacting erases the journal, it's only done by Commit() when the
+        // changes no longer fit, never speculatively at boot
+        return;
+    }
+    // No journal yet, take the config from the EEPROM struct which was in this flash before
+#endif
     // Populate the struct from eeprom
     m_eeprom->Get(0, m_config);
 
@@ -494,8 +634,73 @@ RxConfig::Load()
     }
 
     m_modified = false;
+#if defined(CONFIG_USE_JOURNAL)
+    if (!m_journal.IsValid())
+        m_journal.Compact(&RxConfig::JournalRecord, this);
+#endif
+}
+
+#if defined(CONFIG_USE_JOURNAL)
+uint8_t
+RxConfig::JournalRecord(void *ctx, uint8_t key, uint8_t *data)
+{
+    rx_config_t const * const c = &((RxConfig *)ctx)->m_config;
+    if (key >= RX_KEY_PWM && key < RX_KEY_PWM + PWM_MAX_CHANNELS)
+    {
+        memcpy(data, &c->pwmChannels[key - RX_KEY_PWM].raw, sizeof(uint32_t));
+        return sizeof(uint32_t);
+    }
+
+    switch (key)
+    {
+    case RX_KEY_BIND:
+        data[0] = c->isBound;
+        memcpy(&data[1], c->uid, UID_LEN);
+        return 1 + UID_LEN;
+    case RX_KEY_LOAN:
+        data[0] = c->onLoan;
+        memcpy(&data[1], c->loanUID, UID_LEN);
+        return 1 + UID_LEN;
+    case RX_KEY_POWERON:
+        data[0] = c->powerOnCounter;
+        return 1;
+    case RX_KEY_MODEL:
+        data[0] = c->modelId;
+        return 1;
+    case RX_KEY_POWER:
+        data[0] = c->power;
+        return 1;
+    case RX_KEY_ANTENNA:
+        data[0] = c->antennaMode;
+        return 1;
+    default:
+        return 0;
+    }
 }
 
+void
+RxConfig::JournalLoad()
+{
+    uint8_t data[1 + UID_LEN];
+    if (m_journal.Read(RX_KEY_BIND, data, 1 + UID_LEN))
+    {
+        m_config.isBound = data[0];
+        memcpy(m_config.uid, &data[1], UID_LEN);
+    }
+    if (m_journal.Read(RX_KEY_LOAN, data, 1 + UID_LEN))
+    {
+        m_config.onLoan = data[0];
+        memcpy(m_config.loanUID, &data[1], UID_LEN);
+    }
+    m_journal.Read(RX_KEY_POWERON, &m_config.powerOnCounter, 1);
+    m_journal.Read(RX_KEY_MODEL, &m_config.modelId, 1);
+    m_journal.Read(RX_KEY_POWER, &m_config.power, 1);
+    m_journal.Read(RX_KEY_ANTENNA, &m_config.antennaMode, 1);
+    for (unsigned ch = 0; ch < PWM_MAX_CHANNELS; ++ch)
+        m_journal.Read(RX_KEY_PWM + ch, &m_config.pwmChannels[ch].raw, sizeof(uint32_t));
+}
+#endif
+
 void
 RxConfig::Commit()
 {
@@ -505,9 +710,22 @@ RxConfig::Commit()
         return;
     }
 
+#if defined(CONFIG_USE_JOURNAL)
+    // Append the items which differ from the journal, unless they don't fit and everything is rewritten
+    bool appended = !m_journal.NeedsCompaction();
+    for (uint8_t key = 0; appended && key < RX_KEY_PWM + PWM_MAX_CHANNELS; ++key)
+    {
+        uint8_t data[JOURNAL_MAX_RECORD_LEN];
+        uint8_t len = JournalRecord(this, key, data);
+        appended = !len || m_journal.Update(key, data, len);
+    }
+    if (!appended)
+        m_journal.Compact(&RxConfig::JournalRecord, this);
+#else
     // Write the struct to eeprom
     m_eeprom->Put(0, m_config);
     m_eeprom->Commit();
+#endif
 
     m_modified = false;
 }
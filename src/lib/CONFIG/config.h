@@ -9,6 +9,13 @@
 #include <nvs.h>
 #endif
 
+#if defined(PLATFORM_ESP8266) || (defined(PLATFORM_STM32) && !defined(TARGET_USE_EEPROM) && (defined(STM32F1xx) || defined(STM32F3xx)))
+// Changes are appended to a journal in the flash used for the EEPROM emulation
+#define CONFIG_USE_JOURNAL
+#include "ConfigJournal.h"
+extern JournalFlash *configJournalFlash;
+#endif
+
 // CONFIG_MAGIC is ORed with CONFIG_VERSION in the version field
 #define TX_CONFIG_MAGIC     (0b01 << 30)
 #define RX_CONFIG_MAGIC     (0b10 << 30)
@@ -59,6 +66,12 @@ public:
     uint8_t GetSwitchMode() const { return m_model->switchMode; }
     bool GetModelMatch() const { return m_model->modelMatch; }
     bool     IsModified() const { return m_modified; }
+#if defined(CONFIG_USE_JOURNAL)
+    // Only a compaction erases the flash, appending the changes is quick
+    bool IsCommitBlocking() const { return m_journal.NeedsCompaction(); }
+#else
+    bool IsCommitBlocking() const { return true; }
+#endif
     uint8_t  GetVtxBand() const { return m_config.vtxBand; }
     uint8_t  GetVtxChannel() const { return m_config.vtxChannel; }
     uint8_t  GetVtxPower() const { return m_config.vtxPower; }
@@ -105,6 +118,12 @@ private:
 #if defined(PLATFORM_ESP32)
     nvs_handle  handle;
 #endif
+#if defined(CONFIG_USE_JOURNAL)
+    ConfigJournal m_journal;
+    static uint8_t JournalRecord(void *ctx, uint8_t key, uint8_t *data);
+    bool JournalUpdate(uint8_t key);
+    void JournalLoad();
+#endif
 };
 
 extern TxConfig config;
@@ -182,6 +201,11 @@ private:
     rx_config_t m_config;
     ELRS_EEPROM *m_eeprom;
     bool        m_modified;
+#if defined(CONFIG_USE_JOURNAL)
+    ConfigJournal m_journal;
+    static uint8_t JournalRecord(void *ctx, uint8_t key, uint8_t *data);
+    void JournalLoad();
+#endif
 };
 
 extern RxConfig config;
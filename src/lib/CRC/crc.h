@@ -27,4 +27,15 @@ private:
 public:
     void init(uint8_t bits, uint16_t poly);
     uint16_t calc(uint8_t *data, uint8_t len, uint16_t crc);
+
+    /* As calc() with the width fixed at compile time, for inlining in the packet path */
+    template <uint8_t BITS>
+    inline uint16_t calc(uint8_t *data, uint8_t len, uint16_t crc)
+    {
+        while (len--)
+        {
+            crc = (crc << 8) ^ _crctab[((crc >> (BITS - 8)) ^ (uint16_t) *data++) & 0x00FF];
+        }
+        return crc & ((1 << BITS) - 1);
+    }
 };
@@ -1,15 +1,18 @@
 #include "CRSF.h"
+#include "mavlink_serial.h"
 #include "device.h"
 #include "FIFO.h"
 #include "telemetry_protocol.h"
 #include "logging.h"
 #include "helpers.h"
+#include "UARTSlotScheduler.h"
 
 #if defined(PLATFORM_ESP32)
 // UART0 is used since for DupleTX we can connect directly through IO_MUX and not the Matrix
 // for better performance, and on other targets (mostly using pin 13), it always uses Matrix
 HardwareSerial CRSF::Port(0);
 portMUX_TYPE FIFOmux = portMUX_INITIALIZER_UNLOCKED;
+static portMUX_TYPE handsetSyncMux = portMUX_INITIALIZER_UNLOCKED;
 
 RTC_DATA_ATTR int rtcModelId = 0;
 #elif defined(PLATFORM_ESP8266)
@@ -35,6 +38,12 @@ CROSSFIRE2MSP CRSF::crsf2msp;
 MSP2CROSSFIRE CRSF::msp2crsf;
 #endif
 
+#if defined(CRSF_RX_MODULE)
+extern MAVLinkSerial mavlink;
+// RC_CHANNELS_OVERRIDE is several times the size of a CRSF RC frame so it is sent at a lower rate
+#define MAVLINK_RC_OVERRIDE_INTERVAL_MS 20
+#endif
+
 /// Out FIFO to buffer messages///
 static FIFO SerialOutFIFO;
 
@@ -44,12 +53,14 @@ inBuffer_U CRSF::inBuffer;
 
 volatile crsfPayloadLinkstatistics_s CRSF::LinkStatistics;
 
-uint8_t CRSF::ParameterUpdateData[3] = {0};
+uint8_t CRSF::ParameterUpdateData[4] = {0};
 
 #if CRSF_TX_MODULE
 #define HANDSET_TELEMETRY_FIFO_SIZE 128 // this is the smallest telemetry FIFO size in ETX with CRSF defined
 
 static FIFO MspWriteFIFO;
+// When the handset's half-duplex line is free for the TX
+static UARTSlotScheduler UARTslots;
 
 void (*CRSF::disconnected)() = nullptr; // called when CRSF stream is lost
 void (*CRSF::connected)() = nullptr;    // called when CRSF stream is regained
@@ -65,6 +76,7 @@ bool CRSF::CRSFframeActive = false; //since we get a copy of the serial data use
 
 uint32_t CRSF::GoodPktsCountResult = 0;
 uint32_t CRSF::BadPktsCountResult = 0;
+uint32_t CRSF::CollisionCountResult = 0;
 
 uint8_t CRSF::modelId = 0;
 bool CRSF::ForwardDevicePings = false;
@@ -76,7 +88,7 @@ uint32_t CRSF::RequestedRCpacketInterval = 5000; // default to 200hz as per 'nor
 volatile uint32_t CRSF::RCdataLastRecv = 0;
 volatile int32_t CRSF::OpenTXsyncOffset = 0;
 bool CRSF::OpentxSyncActive = true;
-uint32_t CRSF::OpenTXsyncOffsetSafeMargin = 1000; // 100us
+HandsetSync CRSF::handsetSync;
 
 /// UART Handling ///
 uint32_t CRSF::GoodPktsCount = 0;
@@ -262,6 +274,19 @@ void CRSF::packetQueueExtended(uint8_t type, void *data, uint8_t len)
 #endif
 }
 
+uint16_t CRSF::packetQueueFree()
+{
+#ifdef PLATFORM_ESP32
+    portENTER_CRITICAL(&FIFOmux);
+#endif
+    const uint16_t used = SerialOutFIFO.size();
+#ifdef PLATFORM_ESP32
+    portEXIT_CRITICAL(&FIFOmux);
+#endif
+    // FIFO::available() keeps at least one byte free
+    return FIFO_SIZE - 1 - used;
+}
+
 void ICACHE_RAM_ATTR CRSF::sendTelemetryToTX(uint8_t *data)
 {
     if (CRSF::CRSFstate)
@@ -291,6 +316,7 @@ void ICACHE_RAM_ATTR CRSF::sendTelemetryToTX(uint8_t *data)
 void ICACHE_RAM_ATTR CRSF::setSyncParams(uint32_t PacketInterval)
 {
     CRSF::RequestedRCpacketInterval = PacketInterval;
+    handsetSync.setPeriod(PacketInterval);
     adjustMaxPacketSize();
 }
 
@@ -307,7 +333,13 @@ void ICACHE_RAM_ATTR CRSF::JustSentRFpacket()
     {
         CRSF::OpenTXsyncOffset = -(CRSF::OpenTXsyncOffset % CRSF::RequestedRCpacketInterval);
     }
-    //DBGLN("%d, %d", CRSF::OpenTXsyncOffset, CRSF::OpenTXsyncOffsetSafeMargin / 10);
+#ifdef PLATFORM_ESP32
+    portENTER_CRITICAL_ISR(&handsetSyncMux);
+#endif
+    handsetSync.rfPacketSent(CRSF::OpenTXsyncOffset);
+#ifdef PLATFORM_ESP32
+    portEXIT_CRITICAL_ISR(&handsetSyncMux);
+#endif
 }
 
 void CRSF::disableOpentxSync()
@@ -323,10 +355,27 @@ void CRSF::enableOpentxSync()
 void ICACHE_RAM_ATTR CRSF::sendSyncPacketToTX() // in values in us.
 {
     uint32_t now = millis();
-    if (CRSF::CRSFstate && (now - OpenTXsyncLastSent) >= OpenTXsyncPacketInterval)
+    int32_t correction;
+    if (!CRSF::CRSFstate || (now - OpenTXsyncLastSent) < handsetSync.getInterval())
+        return;
+
+    // The sums and the average are updated from the timer ISR each RF packet
+#ifdef PLATFORM_ESP32
+    portENTER_CRITICAL(&handsetSyncMux);
+#else
+    noInterrupts();
+#endif
+    const bool haveCorrection = handsetSync.nextCorrection(&correction);
+#ifdef PLATFORM_ESP32
+    portEXIT_CRITICAL(&handsetSyncMux);
+#else
+    interrupts();
+#endif
+
+    if (haveCorrection)
     {
         uint32_t packetRate = CRSF::RequestedRCpacketInterval * 10; //convert from us to right format
-        int32_t offset = CRSF::OpenTXsyncOffset * 10 - CRSF::OpenTXsyncOffsetSafeMargin; // + 400us offset that that opentx always has some headroom
+        int32_t offset = correction * 10; // the target keeps opentx some headroom
 
         struct otxSyncData {
             uint8_t extendedType; // CRSF_FRAMETYPE_OPENTX_SYNC
@@ -379,7 +428,7 @@ void ICACHE_RAM_ATTR CRSF::RcPacketToChannelsData() // data is packed as 11 bits
     if (prev_AUX1 != ChannelData[4])
     {
     #if defined(PLATFORM_ESP32)
-        devicesTriggerEvent();
+        devicesTriggerEvent(EVENT_ARM_CHANGED);
     #endif
     }
 }
@@ -401,9 +450,17 @@ bool ICACHE_RAM_ATTR CRSF::ProcessPacket()
     if (packetType == CRSF_FRAMETYPE_RC_CHANNELS_PACKED)
     {
         CRSF::RCdataLastRecv = micros();
+        UARTslots.rcFrameReceived(CRSF::RCdataLastRecv, CRSF::inBuffer.asRCPacket_t.header.frame_size + 2);
         RcPacketToChannelsData();
         packetReceived = true;
     }
+    // MAVLink envelopes have no addresses, they all go up to the RX
+    else if (packetType == CRSF_FRAMETYPE_MAVLINK_ENVELOPE)
+    {
+        const uint8_t length = CRSF::inBuffer.asRCPacket_t.header.frame_size + 2;
+        AddMspMessage(length, SerialInBuffer);
+        packetReceived = true;
+    }
     // check for all extended frames that are a broadcast or a message to the FC
     else if (packetType >= CRSF_FRAMETYPE_DEVICE_PING &&
             (SerialInBuffer[3] == CRSF_ADDRESS_FLIGHT_CONTROLLER || SerialInBuffer[3] == CRSF_ADDRESS_BROADCAST || SerialInBuffer[3] == CRSF_ADDRESS_CRSF_RECEIVER))
@@ -438,6 +495,7 @@ bool ICACHE_RAM_ATTR CRSF::ProcessPacket()
             ParameterUpdateData[0] = packetType;
             ParameterUpdateData[1] = SerialInBuffer[5];
             ParameterUpdateData[2] = SerialInBuffer[6];
+            ParameterUpdateData[3] = SerialInBuffer[7];
             if (RecvParameterUpdate) RecvParameterUpdate();
         }
 
@@ -611,7 +669,7 @@ void ICACHE_RAM_ATTR CRSF::handleUARTin()
 
             if (SerialInPacketPtr >= (SerialInPacketLen + 2)) // plus 2 because the packlen is referenced from the start of the 'type' flag, IE there are an extra 2 bytes.
             {
-                char CalculatedCRC = crsf_crc.calc(SerialInBuffer + 2, SerialInPacketPtr - 3);
+                uint8_t CalculatedCRC = crsf_crc.calc(SerialInBuffer + 2, SerialInPacketPtr - 3);
 
                 if (CalculatedCRC == SerialInBuffer[SerialInPacketPtr-1])
                 {
@@ -651,9 +709,16 @@ void ICACHE_RAM_ATTR CRSF::handleUARTout()
 
     // if partial package remaining, or data in the output FIFO that needs to be written
     if (packageLengthRemaining > 0 || SerialOutFIFO.size() > 0) {
+        // only what is done before the handset's next RC frame, if the line is shared with it
+        const uint32_t start = micros();
+        const uint8_t window = UARTslots.windowBytes(start);
+        const uint8_t periodBytes = window < maxPeriodBytes ? window : maxPeriodBytes;
+        if (periodBytes == 0)
+            return;
+
         duplex_set_TX();
 
-        uint8_t periodBytesRemaining = maxPeriodBytes;
+        uint8_t periodBytesRemaining = periodBytes;
         while (periodBytesRemaining)
         {
 #ifdef PLATFORM_ESP32
@@ -672,7 +737,7 @@ void ICACHE_RAM_ATTR CRSF::handleUARTout()
             // if the package is long we need to split it up so it fits in the sending interval
             uint8_t writeLength;
             if (packageLengthRemaining > periodBytesRemaining) {
-                if (periodBytesRemaining < maxPeriodBytes) {  // only start to send a split packet as the first packet
+                if (periodBytesRemaining < periodBytes) {  // only start to send a split packet as the first packet
                     break;
                 }
                 writeLength = periodBytesRemaining;
@@ -695,6 +760,7 @@ void ICACHE_RAM_ATTR CRSF::handleUARTout()
         }
         CRSF::Port.flush();
         duplex_set_RX();
+        UARTslots.sent(start, periodBytes - periodBytesRemaining);
 
         // make sure there is no garbage on the UART left over
         flush_port_input();
@@ -773,6 +839,19 @@ void ICACHE_RAM_ATTR CRSF::adjustMaxPacketSize()
     maxPeriodBytes = maxPeriodBytes < 10 ? 10 : maxPeriodBytes;
     maxPacketBytes = maxPeriodBytes > CRSF_MAX_PACKET_LEN ? CRSF_MAX_PACKET_LEN : maxPeriodBytes;
     DBGLN("Adjusted max packet size %u-%u", maxPacketBytes, maxPeriodBytes);
+    UARTslots.setTiming(RequestedRCpacketInterval, UARTrequestedBaud);
+    // The same cases duplex_set_TX() switches the line for
+#if defined(PLATFORM_ESP32)
+    UARTslots.setHalfDuplex(GPIO_PIN_RCSIGNAL_TX == GPIO_PIN_RCSIGNAL_RX);
+#elif defined(PLATFORM_ESP8266)
+    UARTslots.setHalfDuplex(false);
+#elif defined(GPIO_PIN_BUFFER_OE) && (GPIO_PIN_BUFFER_OE != UNDEF_PIN)
+    UARTslots.setHalfDuplex(true);
+#elif (GPIO_PIN_RCSIGNAL_TX == GPIO_PIN_RCSIGNAL_RX)
+    UARTslots.setHalfDuplex(true);
+#else
+    UARTslots.setHalfDuplex(false);
+#endif
 }
 
 #if defined(PLATFORM_ESP32)
@@ -875,7 +954,7 @@ bool CRSF::UARTwdt()
 
             retval = true;
         }
-        DBGLN("UART STATS Bad:Good = %u:%u", BadPktsCount, GoodPktsCount);
+        DBGLN("UART STATS Bad:Good = %u:%u Collisions = %u", BadPktsCount, GoodPktsCount, UARTslots.getCollisions());
 
         UARTwdtLastChecked = now;
         if (retval)
@@ -886,6 +965,8 @@ bool CRSF::UARTwdt()
 
         GoodPktsCountResult = GoodPktsCount;
         BadPktsCountResult = BadPktsCount;
+        CollisionCountResult = UARTslots.getCollisions();
+        UARTslots.resetCollisions();
         BadPktsCount = 0;
         GoodPktsCount = 0;
     }
@@ -915,13 +996,30 @@ bool CRSF::RXhandleUARTout()
             }
         #endif
 
-        while (SerialOutFIFO.size() > SerialOutFIFO.peek() && (bytesWritten + SerialOutFIFO.peek()) < maxBytesPerCall)
+        for (;;)
         {
+            // The frames are pushed from the other core on the ESP32, the length
+            // and the frame must be taken together or every frame after is off
+            uint8_t OutData[UINT8_MAX];
+#ifdef PLATFORM_ESP32
+            portENTER_CRITICAL(&FIFOmux);
+#else
             noInterrupts();
-            uint8_t OutPktLen = SerialOutFIFO.pop();
-            uint8_t OutData[OutPktLen];
-            SerialOutFIFO.popBytes(OutData, OutPktLen);
+#endif
+            uint8_t OutPktLen = SerialOutFIFO.peek();
+            const bool haveFrame = SerialOutFIFO.size() > OutPktLen && (bytesWritten + OutPktLen) < maxBytesPerCall;
+            if (haveFrame)
+            {
+                SerialOutFIFO.pop();
+                SerialOutFIFO.popBytes(OutData, OutPktLen);
+            }
+#ifdef PLATFORM_ESP32
+            portEXIT_CRITICAL(&FIFOmux);
+#else
             interrupts();
+#endif
+            if (!haveFrame)
+                break;
             this->_dev->write(OutData, OutPktLen); // write the packet out
             bytesWritten += OutPktLen;
             retVal = true;
@@ -945,12 +1043,24 @@ void CRSF::sendLinkStatisticsToFC()
         uint8_t crc = crsf_crc.calc(outBuffer[3]);
         crc = crsf_crc.calc((byte *)&LinkStatistics, LinkStatisticsFrameLength, crc);
 
+        // The RC frame path also pushes to the FIFO, from the packet
+        // interrupt or, on the ESP32, a task on the other core
+#ifdef PLATFORM_ESP32
+        portENTER_CRITICAL(&FIFOmux);
+#else
+        noInterrupts();
+#endif
         if (SerialOutFIFO.ensure(outBuffer[0] + 1))
         {
             SerialOutFIFO.pushBytes(outBuffer, sizeof(outBuffer));
             SerialOutFIFO.pushBytes((byte *)&LinkStatistics, LinkStatisticsFrameLength);
             SerialOutFIFO.push(crc);
         }
+#ifdef PLATFORM_ESP32
+        portEXIT_CRITICAL(&FIFOmux);
+#else
+        interrupts();
+#endif
     }
 #endif // DEBUG_CRSF_NO_OUTPUT
 }
@@ -961,14 +1071,28 @@ void CRSF::sendRCFrameToFC()
     if (OPT_CRSF_RCVR_NO_SERIAL)
         return;
 
-    constexpr uint8_t outBuffer[] = {
-        // No need for length prefix as we aren't using the FIFO
+    if (firmwareOptions.rcvr_mavlink)
+    {
+        // Through the FIFO, a MAVLink frame can't be interleaved with the others going to the FC
+        static uint32_t MAVLinkRCLastSent;
+        const uint32_t now = millis();
+        if (now - MAVLinkRCLastSent >= MAVLINK_RC_OVERRIDE_INTERVAL_MS)
+        {
+            MAVLinkRCLastSent = now;
+            uint8_t frame[MAVLINK_MAX_FRAME_LEN];
+            sendRawToFC(frame, mavlink.BuildRcOverride(frame, ChannelData));
+        }
+        return;
+    }
+
+    // No need for length prefix as we aren't using the FIFO
+    uint8_t outBuffer[RCframeLength + 4] = {
         CRSF_ADDRESS_FLIGHT_CONTROLLER,
         RCframeLength + 2,
         CRSF_FRAMETYPE_RC_CHANNELS_PACKED
     };
 
-    crsf_channels_s PackedRCdataOut;
+    crsf_channels_s &PackedRCdataOut = *(crsf_channels_s *)&outBuffer[3];
     PackedRCdataOut.ch0 = ChannelData[0];
     PackedRCdataOut.ch1 = ChannelData[1];
     PackedRCdataOut.ch2 = ChannelData[2];
@@ -986,14 +1110,11 @@ void CRSF::sendRCFrameToFC()
     PackedRCdataOut.ch14 = ChannelData[14];
     PackedRCdataOut.ch15 = ChannelData[15];
 
-    uint8_t crc = crsf_crc.calc(outBuffer[2]);
-    crc = crsf_crc.calc((byte *)&PackedRCdataOut, RCframeLength, crc);
+    outBuffer[RCframeLength + 3] = crsf_crc.calc(&outBuffer[2], RCframeLength + 1);
 
-    //SerialOutFIFO.push(RCframeLength + 4);
-    //SerialOutFIFO.pushBytes(outBuffer, RCframeLength + 4);
+    // In one write, the frame may go out from a task other than the one
+    // writing the rest, and must not end up in the middle of another frame
     this->_dev->write(outBuffer, sizeof(outBuffer));
-    this->_dev->write((byte *)&PackedRCdataOut, RCframeLength);
-    this->_dev->write(crc);
 #endif // CRSF_RCVR_NO_SERIAL
 }
 
@@ -1006,9 +1127,44 @@ void CRSF::sendMSPFrameToFC(uint8_t* data)
         if (totalBufferLen <= CRSF_FRAME_SIZE_MAX)
         {
             data[0] = CRSF_ADDRESS_FLIGHT_CONTROLLER;
-            SerialOutFIFO.push(totalBufferLen);
-            SerialOutFIFO.pushBytes(data, totalBufferLen);
+#ifdef PLATFORM_ESP32
+            portENTER_CRITICAL(&FIFOmux);
+#endif
+            if (SerialOutFIFO.ensure(totalBufferLen + 1))
+            {
+                SerialOutFIFO.push(totalBufferLen);
+                SerialOutFIFO.pushBytes(data, totalBufferLen);
+            }
+#ifdef PLATFORM_ESP32
+            portEXIT_CRITICAL(&FIFOmux);
+#endif
+        }
+    }
+#endif // DEBUG_CRSF_NO_OUTPUT
+}
+
+void CRSF::sendRawToFC(const uint8_t *data, uint8_t len)
+{
+#if !defined(DEBUG_CRSF_NO_OUTPUT)
+    if (!OPT_CRSF_RCVR_NO_SERIAL)
+    {
+        // Also called from the RC frame path, the packet interrupt or on the
+        // ESP32 the RC output task on the other core
+#ifdef PLATFORM_ESP32
+        portENTER_CRITICAL(&FIFOmux);
+#else
+        noInterrupts();
+#endif
+        if (SerialOutFIFO.ensure(len + 1))
+        {
+            SerialOutFIFO.push(len);
+            SerialOutFIFO.pushBytes(data, len);
         }
+#ifdef PLATFORM_ESP32
+        portEXIT_CRITICAL(&FIFOmux);
+#else
+        interrupts();
+#endif
     }
 #endif // DEBUG_CRSF_NO_OUTPUT
 }
@@ -1052,7 +1208,7 @@ uint32_t CRSF::VersionStrToU32(const char *verStr)
     return retVal;
 }
 
-void CRSF::GetDeviceInformation(uint8_t *frame, uint8_t fieldCount)
+void CRSF::GetDeviceInformation(uint8_t *frame, uint8_t fieldCount, uint8_t parameterVersion)
 {
     const uint8_t size = strlen(device_name)+1;
     deviceInformationPacket_t *device = (deviceInformationPacket_t *)(frame + sizeof(crsf_ext_header_t) + size);
@@ -1063,7 +1219,7 @@ void CRSF::GetDeviceInformation(uint8_t *frame, uint8_t fieldCount)
     device->hardwareVer = 0; // unused currently by us, seen [ 0x00, 0x0b, 0x10, 0x01 ] // "Hardware: V 1.01" / "Bootloader: V 3.06"
     device->softwareVer = htobe32(VersionStrToU32(version)); // seen [ 0x00, 0x00, 0x05, 0x0f ] // "Firmware: V 5.15"
     device->fieldCnt = fieldCount;
-    device->parameterVersion = 0;
+    device->parameterVersion = parameterVersion;
 }
 
 void CRSF::SetHeaderAndCrc(uint8_t *frame, uint8_t frameType, uint8_t frameSize, uint8_t destAddr)
@@ -15,6 +15,7 @@
 #include "LowPassFilter.h"
 #include "../CRC/crc.h"
 #include "telemetry_protocol.h"
+#include "HandsetSync.h"
 
 #ifdef PLATFORM_ESP32
 #include "esp32-hal-uart.h"
@@ -51,7 +52,7 @@ public:
     /////Variables/////
 
 
-    static uint8_t ParameterUpdateData[3];
+    static uint8_t ParameterUpdateData[4];
 
     #ifdef CRSF_TX_MODULE
     static void (*disconnected)();
@@ -69,6 +70,9 @@ public:
     /// UART Handling ///
     static uint32_t GoodPktsCountResult; // need to latch the results
     static uint32_t BadPktsCountResult; // need to latch the results
+    static uint32_t CollisionCountResult; // sends which ran into the handset's next RC frame
+
+    static HandsetSync handsetSync; // when the handset's RC frames arrive, against the RF packets
     #endif
 
     static volatile crsfPayloadLinkstatistics_s LinkStatistics; // Link Statisitics Stored as Struct
@@ -76,7 +80,7 @@ public:
     static void Begin(); //setup timers etc
     static void End(); //stop timers etc
 
-    static void GetDeviceInformation(uint8_t *frame, uint8_t fieldCount);
+    static void GetDeviceInformation(uint8_t *frame, uint8_t fieldCount, uint8_t parameterVersion = 0);
     static void SetHeaderAndCrc(uint8_t *frame, uint8_t frameType, uint8_t frameSize, uint8_t destAddr);
     static void SetExtendedHeaderAndCrc(uint8_t *frame, uint8_t frameType, uint8_t frameSize, uint8_t senderAddr, uint8_t destAddr);
     static uint32_t VersionStrToU32(const char *verStr);
@@ -87,11 +91,12 @@ public:
     static void ICACHE_RAM_ATTR sendTelemetryToTX(uint8_t *data);
 
     static void packetQueueExtended(uint8_t type, void *data, uint8_t len);
+    // Bytes packetQueueExtended can take without dropping frames already queued
+    static uint16_t packetQueueFree();
 
     static void ICACHE_RAM_ATTR sendSetVTXchannel(uint8_t band, uint8_t channel);
 
     ///// Variables for OpenTX Syncing //////////////////////////
-    #define OpenTXsyncPacketInterval 200 // in ms
     static void ICACHE_RAM_ATTR setSyncParams(uint32_t PacketInterval);
     static void ICACHE_RAM_ATTR JustSentRFpacket();
     static void ICACHE_RAM_ATTR sendSyncPacketToTX();
@@ -120,6 +125,8 @@ public:
     void ICACHE_RAM_ATTR sendRCFrameToFC();
     void ICACHE_RAM_ATTR sendMSPFrameToFC(uint8_t* data);
     void sendLinkStatisticsToFC();
+    // Bytes which go to the FC as they are, for the MAVLink mode
+    void ICACHE_RAM_ATTR sendRawToFC(const uint8_t *data, uint8_t len);
     #endif
 
     /////////////////////////////////////////////////////////////
@@ -135,7 +142,6 @@ private:
     static uint32_t RequestedRCpacketInterval;
     static volatile uint32_t RCdataLastRecv;
     static volatile int32_t OpenTXsyncOffset;
-    static uint32_t OpenTXsyncOffsetSafeMargin;
     static bool OpentxSyncActive;
     static uint8_t CRSFoutBuffer[CRSF_MAX_PACKET_LEN];
 
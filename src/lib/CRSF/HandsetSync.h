@@ -0,0 +1,169 @@
+#pragma once
+
+#include "targets.h"
+
+#define HANDSET_SYNC_BINS             8
+#define HANDSET_SYNC_BIN_US           25  // the last bin is everything later
+#define HANDSET_SYNC_HIST_MAX         4096 // counts are halved past this, to follow changes
+#define HANDSET_SYNC_TARGET_US        100 // until the histogram says otherwise
+#define HANDSET_SYNC_LOCK_US          HANDSET_SYNC_BIN_US
+#define HANDSET_SYNC_INTERVAL_MIN_MS  50
+#define HANDSET_SYNC_INTERVAL_MAX_MS  400
+
+/**
+ * Keeps the handset's RC frames arriving just before the RF packets they go
+ * out in, so the sticks are as fresh as they can be when sent.
+ *
+ * Each RF packet the time since the last RC frame arrived is measured, the
+ * age of the data sent. The handset is told how far the average age since
+ * the last sync is from the target and moves its frames by that much, once.
+ * Using the average, not the last frame's age, keeps one frame's jitter out
+ * of where the handset puts all of the frames after it.
+ *
+ * How much later than usual each frame arrives goes in a histogram. A frame
+ * later than the target misses its RF packet, and the one before it is sent
+ * instead, a whole period old. The target is the bin edge with the lowest
+ * average age counting those misses, so a steady handset gets a small target
+ * and a jittery one a bigger one.
+ *
+ * Syncs are sent often while the age is off target, and less often as it
+ * stays on it.
+ */
+class HandsetSync
+{
+public:
+    HandsetSync() : periodUs(5000)
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        for (unsigned i = 0; i < HANDSET_SYNC_BINS; ++i)
+            hist[i] = 0;
+        histEarly = 0;
+        histTotal = 0;
+        averageValid = false;
+        averageAge = 0;
+        sumAge = 0;
+        samples = 0;
+        target = HANDSET_SYNC_TARGET_US;
+        interval = HANDSET_SYNC_INTERVAL_MIN_MS;
+    }
+
+    void setPeriod(uint32_t period)
+    {
+        if (period != periodUs)
+        {
+            periodUs = period;
+            reset();
+        }
+    }
+
+    /* An RF packet went out with RC data ageUs old, negative if the RC frame hasn't come yet */
+    void ICACHE_RAM_ATTR rfPacketSent(int32_t ageUs)
+    {
+        sumAge += ageUs;
+        ++samples;
+        if (!averageValid)
+        {
+            averageAge = ageUs * 16;
+            averageValid = true;
+            return;
+        }
+        // Later than usual is younger
+        const int32_t late = (averageAge >> 4) - ageUs;
+        averageAge += ageUs - (averageAge >> 4);
+        if (late < 0)
+            ++histEarly;
+        else
+        {
+            const uint32_t bin = late / HANDSET_SYNC_BIN_US;
+            ++hist[bin < HANDSET_SYNC_BINS ? bin : HANDSET_SYNC_BINS - 1];
+        }
+        if (++histTotal > HANDSET_SYNC_HIST_MAX)
+        {
+            histTotal = 0;
+            histEarly >>= 1;
+            histTotal += histEarly;
+            for (unsigned i = 0; i < HANDSET_SYNC_BINS; ++i)
+            {
+                hist[i] >>= 1;
+                histTotal += hist[i];
+            }
+        }
+    }
+
+    /* How long to wait after the last sync before the next */
+    uint32_t getInterval() const { return interval; }
+
+    /**
+     * Take the correction to send the handset, in us, and start measuring for
+     * the next. False if there is nothing to go on yet. Call with rfPacketSent
+     * held off, it updates the same sums.
+     **/
+    bool nextCorrection(int32_t *correction)
+    {
+        if (samples == 0)
+            return false;
+        updateTarget();
+        const int32_t error = sumAge / (int32_t)samples - (int32_t)target;
+        *correction = error;
+        sumAge = 0;
+        samples = 0;
+        // The handset moves by this, the frames to come will be that much younger
+        averageAge -= error * 16;
+
+        if (error > HANDSET_SYNC_LOCK_US || error < -HANDSET_SYNC_LOCK_US)
+            interval = HANDSET_SYNC_INTERVAL_MIN_MS;
+        else if (interval < HANDSET_SYNC_INTERVAL_MAX_MS)
+            interval *= 2;
+        return true;
+    }
+
+    uint32_t getTarget() const { return target; }
+
+    /* Share of the frames in a bin of the histogram, in percent */
+    uint8_t getHistogramPercent(uint8_t bin) const
+    {
+        if (histTotal == 0 || bin >= HANDSET_SYNC_BINS)
+            return 0;
+        // The early ones are counted in the first bin, they never miss
+        const uint32_t count = hist[bin] + (bin == 0 ? histEarly : 0);
+        return count * 100 / histTotal;
+    }
+
+private:
+    void updateTarget()
+    {
+        if (histTotal < HANDSET_SYNC_HIST_MAX / 8)
+            return;
+        // Average age over the target, of a target at the end of each bin
+        uint32_t best = 0;
+        uint32_t bestCost = UINT32_MAX;
+        uint32_t later = histTotal - histEarly;
+        for (unsigned i = 0; i < HANDSET_SYNC_BINS - 1; ++i)
+        {
+            later -= hist[i];
+            const uint32_t edge = (i + 1) * HANDSET_SYNC_BIN_US;
+            const uint32_t cost = edge + (uint64_t)periodUs * later / histTotal;
+            if (cost < bestCost)
+            {
+                best = edge;
+                bestCost = cost;
+            }
+        }
+        target = best;
+    }
+
+    uint32_t periodUs;
+    uint16_t hist[HANDSET_SYNC_BINS]; // how much later than average the frames came
+    uint16_t histEarly;
+    uint16_t histTotal;
+    int32_t averageAge;  // << 4
+    bool averageValid;
+    int32_t sumAge;
+    uint32_t samples;    // since the last sync
+    uint32_t target;
+    uint32_t interval;
+};
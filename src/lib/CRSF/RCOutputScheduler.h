@@ -0,0 +1,131 @@
+#pragma once
+
+#include "targets.h"
+
+#define RC_OUTPUT_RESTART_INTERVALS 8 // intervals without packets before starting over
+
+/**
+ * Which of the RC packets the RX receives go on to the flight controller, and
+ * how evenly they get there.
+ *
+ * Channels are ready at the same point of each packet period, so sending the
+ * frame then, rather than whenever the main loop gets to it, gives the FC
+ * frames as evenly spaced as the air rate. With an output interval set the
+ * frames are thinned out to it, sent with the first packet in each interval
+ * counted from the first frame sent. A frame due in a lost packet isn't sent
+ * late, the next one goes when it is due, so the phase holds.
+ * An output interval of 0, or one shorter than the packet interval, sends
+ * every packet.
+ *
+ * How far each frame goes out from a whole number of intervals after the
+ * last is kept as the jitter, and latched for showing along with how many
+ * intervals went by without a frame.
+ */
+class RCOutputScheduler
+{
+public:
+    RCOutputScheduler() : packetIntervalUs(4000), outputIntervalUs(0),
+        sumJitterUs(0), maxJitterUs(0), frames(0), missed(0)
+    {
+        restart();
+        latch();
+    }
+
+    void setIntervals(uint32_t packetInterval, uint32_t outputInterval)
+    {
+        packetIntervalUs = packetInterval;
+        outputIntervalUs = outputInterval;
+        restart();
+    }
+
+    /* The interval frames should reach the FC at */
+    uint32_t getInterval() const
+    {
+        return outputIntervalUs > packetIntervalUs ? outputIntervalUs : packetIntervalUs;
+    }
+
+    /* New channels are ready at now, true if they are to go to the FC */
+    bool ICACHE_RAM_ATTR due(uint32_t now)
+    {
+        if (outputIntervalUs <= packetIntervalUs)
+            return true;
+        int32_t untilDue = nextDueUs - now;
+        if (!scheduled || untilDue < -(int32_t)outputIntervalUs * RC_OUTPUT_RESTART_INTERVALS)
+        {
+            scheduled = true;
+            nextDueUs = now;
+            untilDue = 0;
+        }
+        // The packet the frame was due in was lost, it waits for the next one due
+        while (untilDue < -(int32_t)packetIntervalUs / 2)
+        {
+            nextDueUs += outputIntervalUs;
+            untilDue += outputIntervalUs;
+        }
+        // Within half a packet of when it is due is the packet it is due in
+        if (untilDue > (int32_t)packetIntervalUs / 2)
+            return false;
+        nextDueUs += outputIntervalUs;
+        return true;
+    }
+
+    /* A frame started going out to the FC at now */
+    void ICACHE_RAM_ATTR sent(uint32_t now)
+    {
+        if (haveLastSent)
+        {
+            const uint32_t interval = getInterval();
+            const uint32_t since = now - lastSentUs;
+            const uint32_t periods = (since + interval / 2) / interval;
+            const int32_t jitter = since - periods * interval;
+            const uint32_t absJitter = jitter < 0 ? -jitter : jitter;
+            sumJitterUs += absJitter;
+            if (absJitter > maxJitterUs)
+                maxJitterUs = absJitter;
+            if (periods > 1)
+                missed += periods - 1;
+            ++frames;
+        }
+        haveLastSent = true;
+        lastSentUs = now;
+    }
+
+    /* Take the stats since the last latch */
+    void latch()
+    {
+        avgJitterResult = frames ? sumJitterUs / frames : 0;
+        maxJitterResult = maxJitterUs;
+        missedResult = missed;
+        sumJitterUs = 0;
+        maxJitterUs = 0;
+        frames = 0;
+        missed = 0;
+    }
+
+    uint32_t getAvgJitter() const { return avgJitterResult; }
+    uint32_t getMaxJitter() const { return maxJitterResult; }
+    uint32_t getMissed() const { return missedResult; }
+
+private:
+    void restart()
+    {
+        scheduled = false;
+        haveLastSent = false;
+        nextDueUs = 0;
+        lastSentUs = 0;
+    }
+
+    uint32_t packetIntervalUs;
+    uint32_t outputIntervalUs;
+    uint32_t nextDueUs;
+    uint32_t lastSentUs;
+    bool scheduled;
+    bool haveLastSent;
+    uint32_t sumJitterUs;
+    uint32_t maxJitterUs;
+    uint32_t frames;
+    uint32_t missed;     // intervals without a frame
+    uint32_t avgJitterResult;
+    uint32_t maxJitterResult;
+    uint32_t missedResult;
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "targets.h"
+
+#define UART_SLOT_TURNAROUND_US 50  // switching the line to TX and the first start bit
+#define UART_SLOT_GUARD_US      150 // left clear before the handset's next frame, for its jitter
+#define UART_SLOT_DRIFT_MAX_US  2   // the most the arrival moves later each frame, 500ppm at 250Hz
+#define UART_SLOT_JITTER_US     50  // how much earlier than expected a frame can be processed
+#define UART_SLOT_RELOCK_FRAMES 32  // frames all processed late before the arrival is moved to them
+
+/**
+ * When the TX can talk on a half-duplex handset UART without stepping on the
+ * handset's next RC frame.
+ *
+ * The handset sends an RC frame each period, and the line is the TX's from
+ * the end of that frame until the next one starts. RC frames are only seen
+ * once the main loop gets to them, which may be well after they arrive, so
+ * sending "just after the RC frame" can run into the next one. Instead the
+ * time the frames really arrive is tracked: a frame is never processed before
+ * it arrives, so the earliest of them (projected onto the period) is the
+ * arrival, allowed to drift later a little each frame for the clocks not
+ * quite matching.
+ * A frame processed later than expected is always taken as the one expected,
+ * even if it is nearly a period late, so a late frame never makes the TX
+ * think it has the whole period ahead of it. If the handset's frames really
+ * have moved, every frame for a while is late and the arrival is moved then.
+ * From that the bytes which fit before the next frame, less a guard, are
+ * worked out at the current baud whenever the TX has something to send.
+ *
+ * Anything still being sent when the next frame started is counted as a
+ * collision, the handset will have seen a CRC error on it.
+ *
+ * A full-duplex UART has its own line to the handset, so there is no window
+ * and nothing can collide.
+ */
+class UARTSlotScheduler
+{
+public:
+    UARTSlotScheduler() : periodUs(5000), baud(400000), frameUs(0), arrivalUs(0),
+        txEndUs(0), minLate(0), relockFrames(0), halfDuplex(true), arrivalValid(false), txPending(false), collisions(0) {}
+
+    void setTiming(uint32_t period, uint32_t baudRate)
+    {
+        if (period != periodUs || baudRate != baud)
+            arrivalValid = false;
+        periodUs = period;
+        baud = baudRate;
+    }
+
+    void setHalfDuplex(bool half)
+    {
+        halfDuplex = half;
+    }
+
+    uint32_t ICACHE_RAM_ATTR bytesToUs(uint32_t bytes) const
+    {
+        // 10 bits a byte: start, 8 data, stop
+        return (uint64_t)bytes * 10000000 / baud;
+    }
+
+    uint32_t ICACHE_RAM_ATTR usToBytes(uint32_t us) const
+    {
+        return (uint64_t)us * baud / 10000000;
+    }
+
+    /* An RC frame of frameBytes was processed at now */
+    void ICACHE_RAM_ATTR rcFrameReceived(uint32_t now, uint8_t frameBytes)
+    {
+        frameUs = bytesToUs(frameBytes);
+        if (arrivalValid)
+        {
+            uint32_t predicted = arrivalUs + periodUs;
+            // Frames missed, or not processed at all
+            const uint32_t sincePredicted = now - predicted + UART_SLOT_JITTER_US;
+            if ((int32_t)sincePredicted >= (int32_t)periodUs)
+                predicted += sincePredicted / periodUs * periodUs;
+            const int32_t late = now - predicted;
+            if (late < 0)
+            {
+                arrivalUs = now;
+                relockFrames = 0;
+            }
+            else
+            {
+                arrivalUs = predicted + (late < UART_SLOT_DRIFT_MAX_US ? late : UART_SLOT_DRIFT_MAX_US);
+                if (relockFrames == 0 || late < minLate)
+                    minLate = late;
+                if (++relockFrames == UART_SLOT_RELOCK_FRAMES)
+                {
+                    // Nothing close to when they were expected, they've moved
+                    if (minLate > UART_SLOT_GUARD_US)
+                        arrivalUs += minLate - UART_SLOT_DRIFT_MAX_US;
+                    relockFrames = 0;
+                }
+            }
+        }
+        else
+        {
+            arrivalUs = now;
+            arrivalValid = true;
+            relockFrames = 0;
+        }
+
+        // Whatever was sent last had to be done before this frame started
+        if (txPending && (int32_t)(txEndUs - (arrivalUs - frameUs)) > 0)
+            ++collisions;
+        txPending = false;
+    }
+
+    /* How many bytes sent from now get done before the handset's next frame */
+    uint8_t ICACHE_RAM_ATTR windowBytes(uint32_t now) const
+    {
+        if (!halfDuplex)
+            return 255;
+        if (!arrivalValid)
+            return 0;
+        const uint32_t nextFrameStart = arrivalUs + periodUs - frameUs;
+        const int32_t left = nextFrameStart - UART_SLOT_GUARD_US - UART_SLOT_TURNAROUND_US - now;
+        if (left <= 0)
+            return 0;
+        const uint32_t bytes = usToBytes(left);
+        return bytes > 255 ? 255 : bytes;
+    }
+
+    /* bytes were sent starting at now */
+    void ICACHE_RAM_ATTR sent(uint32_t now, uint8_t bytes)
+    {
+        txEndUs = now + UART_SLOT_TURNAROUND_US + bytesToUs(bytes);
+        txPending = halfDuplex;
+    }
+
+    uint32_t getCollisions() const { return collisions; }
+    void resetCollisions() { collisions = 0; }
+
+private:
+    uint32_t periodUs;
+    uint32_t baud;
+    uint32_t frameUs;    // time the last RC frame took on the wire
+    uint32_t arrivalUs;  // when the last RC frame finished arriving
+    uint32_t txEndUs;
+    int32_t minLate;     // the least late of the frames since relockFrames was 0
+    uint8_t relockFrames;
+    bool halfDuplex;
+    bool arrivalValid;
+    bool txPending;
+    uint32_t collisions;
+};
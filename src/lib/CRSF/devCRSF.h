@@ -6,3 +6,11 @@
 
 extern device_t CRSF_device;
 extern void crsfRCFrameAvailable();
+
+#if defined(CRSF_RX_MODULE)
+class RCOutputScheduler;
+// The interval new channels come at, all sends of a packet, and the interval
+// RC frames go to the FC at, 0 for every packet
+extern void crsfSetPacketInterval(uint32_t intervalUs, uint32_t outputIntervalUs);
+extern const RCOutputScheduler *crsfGetRCOutput();
+#endif
@@ -1,34 +1,110 @@
 #include "targets.h"
 #include "devCRSF.h"
+#include "RCOutputScheduler.h"
 
 #ifdef CRSF_RX_MODULE
 extern CRSF crsf;
 
-static volatile bool sendFrame = false;
+static RCOutputScheduler rcOutput;
+static uint32_t rcOutputLastLatched;
+
+#if defined(PLATFORM_ESP32)
+static TaskHandle_t xRCOutputTask;
+// The stats are updated by the output task and latched from the device task,
+// due() runs in the packet interrupt on the other core
+static portMUX_TYPE rcOutputMux = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * The UART can't be written from an interrupt on the ESP32, so frames go out
+ * from this task instead of the main loop. It is above the device task on the
+ * same core, so it runs as soon as the packet interrupt wakes it.
+ **/
+static void rcOutputTask(void *pvArgs)
+{
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        portENTER_CRITICAL(&rcOutputMux);
+        rcOutput.sent(micros());
+        portEXIT_CRITICAL(&rcOutputMux);
+        crsf.sendRCFrameToFC();
+    }
+}
+#endif
 
 void ICACHE_RAM_ATTR crsfRCFrameAvailable()
 {
     #if defined(PLATFORM_ESP32)
-    sendFrame = true;
+    portENTER_CRITICAL(&rcOutputMux);
+    const bool due = rcOutput.due(micros());
+    portEXIT_CRITICAL(&rcOutputMux);
+    #else
+    const bool due = rcOutput.due(micros());
+    #endif
+    if (!due)
+        return;
+
+    #if defined(PLATFORM_ESP32)
+    if (xRCOutputTask)
+    {
+        if (xPortInIsrContext())
+        {
+            BaseType_t woken = pdFALSE;
+            vTaskNotifyGiveFromISR(xRCOutputTask, &woken);
+            portYIELD_FROM_ISR(woken);
+        }
+        else
+            xTaskNotifyGive(xRCOutputTask);
+    }
     #else
+    rcOutput.sent(micros());
     crsf.sendRCFrameToFC();
     #endif
 }
 
+void crsfSetPacketInterval(uint32_t intervalUs, uint32_t outputIntervalUs)
+{
+    // The pair must change together, due() reads both from the packet interrupt
+    #if defined(PLATFORM_ESP32)
+    portENTER_CRITICAL(&rcOutputMux);
+    rcOutput.setIntervals(intervalUs, outputIntervalUs);
+    portEXIT_CRITICAL(&rcOutputMux);
+    #else
+    noInterrupts();
+    rcOutput.setIntervals(intervalUs, outputIntervalUs);
+    interrupts();
+    #endif
+}
+
+const RCOutputScheduler *crsfGetRCOutput()
+{
+    return &rcOutput;
+}
+
 static int start()
 {
+    #if defined(PLATFORM_ESP32)
+    xTaskCreatePinnedToCore(rcOutputTask, "rcOutputTask", 2000, NULL, 1, &xRCOutputTask, 0);
+    #endif
     return DURATION_IMMEDIATELY;
 }
 
 static int timeout()
 {
-    #if defined(PLATFORM_ESP32)
-    if (sendFrame)
+    const uint32_t now = millis();
+    if (now - rcOutputLastLatched >= 1000)
     {
-        sendFrame = false;
-        crsf.sendRCFrameToFC();
+        rcOutputLastLatched = now;
+        #if defined(PLATFORM_ESP32)
+        portENTER_CRITICAL(&rcOutputMux);
+        rcOutput.latch();
+        portEXIT_CRITICAL(&rcOutputMux);
+        #else
+        noInterrupts();
+        rcOutput.latch();
+        interrupts();
+        #endif
     }
-    #endif
     crsf.RXhandleUARTout();
     return DURATION_IMMEDIATELY;
 }
@@ -49,6 +49,7 @@ device_t CRSF_device = {
     .initialize = nullptr,
     .start = start,
     .event = event,
-    .timeout = timeout
+    .timeout = timeout,
+    .subscriptions = EVENT_MASK(EVENT_POWER_CHANGED)
 };
 #endif
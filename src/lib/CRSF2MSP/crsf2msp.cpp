@@ -4,17 +4,30 @@ extern GENERIC_CRC8 crsf_crc; // defined in crsf.cpp reused here
 
 CROSSFIRE2MSP::CROSSFIRE2MSP()
 {
+    framesDropped = 0;
     reset();
 }
 
 void CROSSFIRE2MSP::reset()
 {
+    FIFOout.flush();
+    committed = 0;
     pktLen = 0;
     idx = 0;
-    frameComplete = false;
+    inFrame = false;
     MSPvers = MSP_FRAME_UNKNOWN;
 }
 
+void CROSSFIRE2MSP::dropFrame()
+{
+    if (inFrame)
+    {
+        FIFOout.truncate(committed);
+        inFrame = false;
+        ++framesDropped;
+    }
+}
+
 void CROSSFIRE2MSP::parse(const uint8_t *data)
 {
     uint8_t CRSFpayloadLen = data[CRSF_FRAME_PAYLOAD_LEN_IDX] - CRSF_EXT_FRAME_PAYLOAD_LEN_SIZE_OFFSET;
@@ -31,40 +44,73 @@ void CROSSFIRE2MSP::parse(const uint8_t *data)
 
     if ((!newFrame && seqError) || error)
     {
-        reset();
+        dropFrame();
         return;
     }
 
     if (newFrame) // If it's a new frame then out a header on first
     {
-        idx = 3; // skip the header start wiring at offset 3.
+        dropFrame(); // the previous frame never finished
         MSPvers = getVersion(data);
         src = data[CRSF_MSP_SRC_OFFSET];
         dest = data[CRSF_MSP_DEST_OFFSET];
-        outBuffer[0] = '$';
-        outBuffer[1] = (MSPvers == MSP_FRAME_V1 || MSPvers == MSP_FRAME_V1_JUMBO) ? 'M' : 'X';
-        outBuffer[2] = error ? '!' : getHeaderDir(data);
         pktLen = getFrameLen(data, MSPvers);
+        // +3 header, +1 crc, +2 for the size in the FIFO
+        if (MSPvers == MSP_FRAME_UNKNOWN || FIFOout.free() < pktLen + 6)
+        {
+            ++framesDropped;
+            return;
+        }
+
+        const uint8_t header[3] = {
+            '$',
+            (uint8_t)((MSPvers == MSP_FRAME_V1 || MSPvers == MSP_FRAME_V1_JUMBO) ? 'M' : 'X'),
+            getHeaderDir(data)};
+        FIFOout.pushSize(pktLen + 4);
+        FIFOout.pushBytes(header, sizeof(header));
+        idx = 0;
+        checksum = 0;
+        inFrame = true;
+    }
+
+    if (!inFrame)
+    {
+        return;
     }
 
     // process the chunk of MSP frame
     // if the last CRSF frame is zero padded we can't use the CRSF payload length
     // but if this isn't the last chunk we can't use the MSP payload length
     // the solution is to use the minimum of the two lengths
-    uint32_t frameLen = pktLen - (idx - 3);
+    uint32_t frameLen = pktLen - idx;
     uint32_t minLen = frameLen < CRSFpayloadLen ? frameLen : CRSFpayloadLen;
-    memcpy(&outBuffer[idx], &data[CRSF_MSP_FRAME_OFFSET], minLen); // chunk of MSP data
+    FIFOout.pushBytes(&data[CRSF_MSP_FRAME_OFFSET], minLen); // chunk of MSP data
+    checksum = updateChecksum(checksum, &data[CRSF_MSP_FRAME_OFFSET], minLen, MSPvers);
     idx += minLen;
 
-    if (idx - 3 == pktLen) // we have a complete MSP frame, -3 because the header isn't counted
+    if (idx == pktLen) // we have a complete MSP frame
     {
         // we need to append the MSP checksum
-        outBuffer[idx] = getChecksum(outBuffer + 3, pktLen, MSPvers); // +3 because the header isn't in checksum
-        frameComplete = true;
+        FIFOout.push(checksum);
+        committed = FIFOout.size();
+        inFrame = false;
+    }
+}
+
+uint16_t CROSSFIRE2MSP::peekFrameLen()
+{
+    return committed ? FIFOout.peekSize() : 0;
+}
 
-        FIFOout.pushSize(idx + 1);
-        FIFOout.pushBytes(outBuffer, idx + 1);
+void CROSSFIRE2MSP::popFrame(uint8_t *data)
+{
+    if (committed == 0)
+    {
+        return;
     }
+    const uint16_t len = FIFOout.popSize();
+    FIFOout.popBytes(data, len);
+    committed -= len + 2;
 }
 
 bool CROSSFIRE2MSP::isNewFrame(const uint8_t *data)
@@ -114,27 +160,21 @@ MSPframeType_e CROSSFIRE2MSP::getVersion(const uint8_t *data)
     return MSPvers;
 }
 
-uint8_t CROSSFIRE2MSP::getChecksum(const uint8_t *data, const uint32_t len, MSPframeType_e mspVersion)
+uint8_t CROSSFIRE2MSP::updateChecksum(uint8_t crc, const uint8_t *data, const uint32_t len, MSPframeType_e mspVersion)
 {
-    uint8_t checkSum = 0;
-
     if (mspVersion == MSP_FRAME_V1 || mspVersion == MSP_FRAME_V1_JUMBO)
     {
         for (uint32_t i = 0; i < len; i++)
         {
-            checkSum ^= data[i];
+            crc ^= data[i];
         }
-        return checkSum;
+        return crc;
     }
     else if (mspVersion == MSP_FRAME_V2)
     {
-        checkSum = crsf_crc.calc(data, len);
+        return crsf_crc.calc(data, len, crc);
     }
-    else
-    {
-        checkSum = 0;
-    }
-    return checkSum;
+    return 0;
 }
 
 uint32_t CROSSFIRE2MSP::getFrameLen(const uint8_t *data, MSPframeType_e mspVersion)
@@ -181,21 +221,6 @@ uint8_t CROSSFIRE2MSP::getHeaderDir(const uint8_t *data)
     }
 }
 
-bool CROSSFIRE2MSP::isFrameReady()
-{
-    return frameComplete;
-}
-
-const uint8_t *CROSSFIRE2MSP::getFrame()
-{
-    return outBuffer;
-}
-
-uint32_t CROSSFIRE2MSP::getFrameLen()
-{
-    return idx + 1; // include the last byte (crc)
-}
-
 uint8_t CROSSFIRE2MSP::getSrc()
 {
     return src;
@@ -8,16 +8,24 @@
 
 /*  Takes a CRSF(MSP) frame and converts it to raw MSP frame
     adding the MSP header and checksum. Handles chunked MSP messages.
+
+    Each chunk is written straight into FIFOout as it arrives, the size and
+    header go in with the first chunk and the checksum is accumulated as the
+    chunks go past. A frame is only visible to peekFrameLen() once the last
+    chunk is in, and a partial frame is dropped from the FIFO again if a chunk
+    goes missing.
 */
 
 class CROSSFIRE2MSP
 {
 private:
-    uint8_t outBuffer[MSP_FRAME_MAX_LEN];
-    uint32_t pktLen; // packet length of the incomming msp frame
-    uint32_t idx;    // number of bytes received in the current msp frame
+    FIFO_GENERIC<MSP_FRAME_MAX_LEN> FIFOout;
+    uint32_t committed; // bytes in FIFOout which belong to complete frames
+    uint32_t pktLen;    // packet length of the incomming msp frame
+    uint32_t idx;       // number of bytes received in the current msp frame
+    uint8_t checksum;   // of the bytes received so far
     uint8_t seqNumberPrev;
-    bool frameComplete;
+    bool inFrame;
     uint8_t src;            // source of the msp frame (from CRSF ext header)
     uint8_t dest;           // destination of the msp frame (from CRSF ext header)
     MSPframeType_e MSPvers; // need to store the MSP version since it can only be inferred from the first frame
@@ -28,16 +36,16 @@ private:
     uint8_t getSeqNumber(const uint8_t *data);
     MSPframeType_e getVersion(const uint8_t *data);
     uint8_t getHeaderDir(const uint8_t *data);
-    uint8_t getChecksum(const uint8_t *data, const uint32_t packetLen, MSPframeType_e mspVersion);
+    uint8_t updateChecksum(uint8_t crc, const uint8_t *data, const uint32_t len, MSPframeType_e mspVersion);
     uint32_t getFrameLen(const uint8_t *data, MSPframeType_e mspVersion);
+    void dropFrame();
 
 public:
     CROSSFIRE2MSP();
-    FIFO_GENERIC<MSP_FRAME_MAX_LEN> FIFOout;
     void parse(const uint8_t *data); // accept crsf frame input
-    bool isFrameReady();
-    const uint8_t *getFrame();
-    uint32_t getFrameLen();
+    uint16_t peekFrameLen();         // length of the next complete MSP frame, 0 if there isn't one
+    void popFrame(uint8_t *data);
+    uint32_t framesDropped;
     void reset();
     uint8_t getSrc();
     uint8_t getDest();
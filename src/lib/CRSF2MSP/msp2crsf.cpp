@@ -2,7 +2,11 @@
 
 extern GENERIC_CRC8 crsf_crc;
 
-MSP2CROSSFIRE::MSP2CROSSFIRE() {} // empty constructor
+MSP2CROSSFIRE::MSP2CROSSFIRE()
+    : seqNum(0), state(STATE_SYNC), chunkLen(0),
+      src(CRSF_ADDRESS_CRSF_RECEIVER), dest(CRSF_ADDRESS_FLIGHT_CONTROLLER)
+{
+}
 
 void MSP2CROSSFIRE::setSeqNumber(uint8_t &data, uint8_t seqNumber)
 {
@@ -155,46 +159,161 @@ MSPframeType_e MSP2CROSSFIRE::getVersion(const uint8_t *data)
     return frameType;
 }
 
-void MSP2CROSSFIRE::parse(const uint8_t *data, uint32_t frameLen, uint8_t src, uint8_t dest)
+/**
+ * Called once the header has been gathered far enough to know the frame length
+ * Returns: false if this isn't an MSP frame
+ **/
+bool MSP2CROSSFIRE::startFrame()
+{
+    MSPframeType_e mspVersion = getVersion(header);
+    uint8_t type = getHeaderDir(header[2]);
+    if (mspVersion == MSP_FRAME_UNKNOWN || (type == 0 && header[2] != '!'))
+    {
+        return false;
+    }
+
+    status = 0;
+    setVersion(status, mspVersion);
+    firstChunk = true;
+
+    // The header after $M< is sent as part of the chunked frame
+    chunkLen = headerLen - 3;
+    memcpy(chunk, &header[3], chunkLen);
+    bodyRemaining = getFrameLen(getPayloadLen(header, mspVersion), mspVersion) - chunkLen;
+    return true;
+}
+
+bool MSP2CROSSFIRE::sendChunk(const uint8_t *data, uint8_t len)
 {
-    MSPframeType_e mspVersion = getVersion(data);
-    uint32_t MSPpayloadLen = getPayloadLen(data, mspVersion);
-    uint32_t MSPframeLen = getFrameLen(MSPpayloadLen, mspVersion);
-    uint8_t numChunks = (MSPframeLen / CRSF_MSP_MAX_BYTES_PER_CHUNK) + 1; // gotta count the first chunk!
-    uint8_t chunkRemainder = MSPframeLen % CRSF_MSP_MAX_BYTES_PER_CHUNK;
+    // TOTAL length of the CRSF packet, (what the FIFO cares about) and the size byte itself
+    if (FIFOout.free() < len + CRSF_EXT_FRAME_PAYLOAD_LEN_SIZE_OFFSET + 3)
+    {
+        return false;
+    }
+
+    setSeqNumber(status, (seqNum++ & 0b1111));
+    setNewFrame(status, firstChunk);
+    setError(status, false);
+    firstChunk = false;
 
-    uint8_t header[7];
+    uint8_t crsfHeader[7];
     // first element has to be size of the fifo chunk (can't be bigger than CRSF_MAX_PACKET_LEN)
-    header[0] = 0; // CRSFpktLen; will be set later
-    header[1] = CRSF_ADDRESS_FLIGHT_CONTROLLER;
-    header[2] = 0;                     // CRSFpktLen - CRSF_EXT_FRAME_PAYLOAD_LEN_SIZE_OFFSET;
-    header[3] = getHeaderDir(data[2]); // 3rd byte is the header direction < or >
-    header[4] = dest;
-    header[5] = src;
-    header[6] = 0;
+    crsfHeader[0] = len + CRSF_EXT_FRAME_PAYLOAD_LEN_SIZE_OFFSET + 2;
+    crsfHeader[1] = CRSF_ADDRESS_FLIGHT_CONTROLLER;
+    crsfHeader[2] = len + CRSF_EXT_FRAME_PAYLOAD_LEN_SIZE_OFFSET;
+    crsfHeader[3] = getHeaderDir(header[2]); // 3rd byte is the header direction < or >
+    crsfHeader[4] = dest;
+    crsfHeader[5] = src;
+    crsfHeader[6] = status;
 
-    setVersion(header[6], mspVersion);
+    uint8_t crc = crsf_crc.calc(&crsfHeader[3], 4, 0x00); // don't include the MSP header
+    crc = crsf_crc.calc(data, len, crc);
+
+    FIFOout.pushBytes(crsfHeader, sizeof(crsfHeader));
+    FIFOout.pushBytes(data, len);
+    FIFOout.push(crc);
+    return true;
+}
+
+uint32_t MSP2CROSSFIRE::write(const uint8_t *data, uint32_t len)
+{
+    const uint8_t *start = data;
 
-    for (uint8_t i = 0; i < numChunks; i++)
+    while (len)
     {
-        setSeqNumber(header[6], (seqNum++ & 0b1111));
-        setNewFrame(header[6], (i == 0 ? true : false)); // if first chunk then set to true, else false
-        setError(header[6], false);
+        switch (state)
+        {
+        case STATE_SYNC:
+            if (*data == '$')
+            {
+                headerLen = 0;
+                state = STATE_HEADER;
+            }
+            else
+            {
+                ++data;
+                --len;
+            }
+            break;
 
-        uint32_t startIdx = (i * CRSF_MSP_MAX_BYTES_PER_CHUNK) + 3; // we don't xmit the MSP header
-        uint8_t CRSFpktLen;                                         // TOTAL length of the CRSF packet, (what the FIFO cares about)
+        case STATE_HEADER:
+        {
+            header[headerLen++] = *data++;
+            --len;
+            // The length is the last thing in the header: $M<len, $M<0xFF cmd len(2), $X<flag cmd(2) len(2)
+            bool complete = (header[1] == 'M' && headerLen == 4 && header[3] != 0xFF) ||
+                            (header[1] == 'M' && headerLen == 7) ||
+                            (header[1] != 'M' && headerLen == 8);
+            if (headerLen == 2 && header[1] != 'M' && header[1] != 'X')
+            {
+                state = STATE_SYNC;
+            }
+            else if (complete)
+            {
+                state = startFrame() ? STATE_BODY : STATE_SYNC;
+            }
+            break;
+        }
 
-        CRSFpktLen = (i == (numChunks - 1)) ? chunkRemainder : (CRSF_MSP_MAX_BYTES_PER_CHUNK);
+        case STATE_BODY:
+        {
+            uint32_t want = CRSF_MSP_MAX_BYTES_PER_CHUNK - chunkLen;
+            if (want > bodyRemaining)
+            {
+                want = bodyRemaining;
+            }
 
-        header[0] = CRSFpktLen + CRSF_EXT_FRAME_PAYLOAD_LEN_SIZE_OFFSET + 2;
-        header[2] = CRSFpktLen + CRSF_EXT_FRAME_PAYLOAD_LEN_SIZE_OFFSET;
-        uint8_t crc = crsf_crc.calc(&header[3], 4, 0x00); // don't include the MSP header
-        crc = crsf_crc.calc(&data[startIdx], CRSFpktLen, crc);
+            if (want == 0 || (chunkLen == 0 && len >= want))
+            {
+                // Either the staged chunk is complete or the input holds the whole of the next one
+                const bool staged = want == 0;
+                if (!sendChunk(staged ? chunk : data, staged ? chunkLen : want))
+                {
+                    return data - start;
+                }
+                if (staged)
+                {
+                    chunkLen = 0;
+                }
+                else
+                {
+                    data += want;
+                    len -= want;
+                    bodyRemaining -= want;
+                }
+                if (bodyRemaining == 0 && chunkLen == 0)
+                {
+                    state = STATE_CRC;
+                }
+                break;
+            }
 
-        FIFOout.pushBytes(header, sizeof(header));
-        FIFOout.pushBytes(&data[startIdx], CRSFpktLen);
-        FIFOout.push(crc);
+            const uint32_t count = want < len ? want : len;
+            memcpy(&chunk[chunkLen], data, count);
+            chunkLen += count;
+            bodyRemaining -= count;
+            data += count;
+            len -= count;
+            break;
+        }
+
+        case STATE_CRC:
+            // The MSP checksum isn't sent over CRSF, the other end recreates it
+            ++data;
+            --len;
+            state = STATE_SYNC;
+            break;
+        }
     }
+
+    return data - start;
+}
+
+bool MSP2CROSSFIRE::parse(const uint8_t *data, uint32_t frameLen, uint8_t src, uint8_t dest)
+{
+    this->src = src;
+    this->dest = dest;
+    return write(data, frameLen) == frameLen;
 }
 
 bool MSP2CROSSFIRE::validate(const uint8_t *data, uint32_t expectLen)
@@ -7,8 +7,18 @@
 #include "crc.h"
 #include "logging.h"
 
+// Enough for a few CRSF frames, RXhandleUARTout sends at most 128 bytes at a time
+#define MSP2CRSF_FIFO_SIZE (4 * CRSF_MAX_PACKET_LEN)
+
 /* Takes a MSP frame and converts it to raw CRSF frame
    adding the CRSF header and checksum. Handles chunking of messages
+
+   MSP bytes can be written in any number of pieces and each CRSF chunk is
+   queued in FIFOout as soon as it is full, taken straight from the input
+   where a whole chunk is there. Only one partial chunk is held, so the MSP
+   frame length is not limited by any buffer here. When FIFOout is full write()
+   stops early and returns how much it took, the rest should be offered again
+   once the UART has drained the FIFO.
 */
 
 class MSP2CROSSFIRE
@@ -20,15 +30,34 @@ private:
     void setVersion(uint8_t &data, MSPframeType_e version);
     uint8_t getHeaderDir(uint8_t headerDir);
     void setError(uint8_t &data, bool isError);
-    uint8_t seqNum; 
+    uint8_t seqNum;
+
+    enum {
+        STATE_SYNC,
+        STATE_HEADER,
+        STATE_BODY,
+        STATE_CRC
+    } state;
+    uint8_t header[8];  // MSP header up to and including the length
+    uint8_t headerLen;
+    uint8_t chunk[CRSF_MSP_MAX_BYTES_PER_CHUNK];
+    uint8_t chunkLen;
+    uint32_t bodyRemaining; // bytes of the frame still to be chunked, excluding the crc
+    uint8_t status;         // CRSF MSP status byte for the current frame
+    bool firstChunk;
+    uint8_t src;
+    uint8_t dest;
 
     uint32_t getFrameLen(uint32_t payloadLen, uint8_t mspVersion);
     MSPframeType_e getVersion(const uint8_t *data);
     uint32_t getPayloadLen(const uint8_t *data, MSPframeType_e mspVersion);
+    bool startFrame();
+    bool sendChunk(const uint8_t *data, uint8_t len);
 
 public:
     MSP2CROSSFIRE();
-    FIFO_GENERIC<MSP_FRAME_MAX_LEN> FIFOout;
-    void parse(const uint8_t *data, uint32_t frameLen, uint8_t src = CRSF_ADDRESS_CRSF_RECEIVER, uint8_t dest = CRSF_ADDRESS_FLIGHT_CONTROLLER);
+    FIFO_GENERIC<MSP2CRSF_FIFO_SIZE> FIFOout;
+    uint32_t write(const uint8_t *data, uint32_t len);
+    bool parse(const uint8_t *data, uint32_t frameLen, uint8_t src = CRSF_ADDRESS_CRSF_RECEIVER, uint8_t dest = CRSF_ADDRESS_FLIGHT_CONTROLLER);
     bool validate(const uint8_t *data, uint32_t expectLen);
 };
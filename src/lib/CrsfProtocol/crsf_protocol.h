@@ -54,6 +54,7 @@
 #define CRSF_TELEMETRY_TYPE_INDEX 2
 #define CRSF_TELEMETRY_FIELD_ID_INDEX 5
 #define CRSF_TELEMETRY_FIELD_CHUNK_INDEX 6
+#define CRSF_TELEMETRY_FIELD_VERSION_INDEX 7
 #define CRSF_TELEMETRY_CRC_LENGTH 1
 #define CRSF_TELEMETRY_TOTAL_SIZE(x) (x + CRSF_FRAME_LENGTH_EXT_TYPE_CRC)
 
@@ -107,6 +108,8 @@ typedef enum
     CRSF_FRAMETYPE_MSP_WRITE = 0x7C, // write with 8 byte chunked binary (OpenTX outbound telemetry buffer limit)
     // Ardupilot frames
     CRSF_FRAMETYPE_ARDUPILOT_RESP = 0x80,
+    // MAVLink stream in chunks, [total_chunks:4 current_chunk:4] [data_size] [data]
+    CRSF_FRAMETYPE_MAVLINK_ENVELOPE = 0xAA,
 } crsf_frame_type_e;
 
 typedef enum {
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include "targets.h"
+
+/**
+ * Bounded lock-free multi-producer multi-consumer queue.
+ *
+ * Producers can be ISRs or tasks on either core, push() never blocks and
+ * fails if the queue is full. Each cell carries a sequence number so a
+ * producer which has claimed a cell but not yet written it holds up the
+ * consumer instead of letting it read a half-written item, which keeps
+ * items in the order their cells were claimed.
+ * N must be a power of 2.
+ */
+template <typename T, uint32_t N>
+class EventQueue
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "EventQueue size must be a power of 2");
+
+public:
+    EventQueue()
+    {
+        for (uint32_t i = 0; i < N; ++i)
+            cells[i].seq.store(i, std::memory_order_relaxed);
+        enqueuePos.store(0, std::memory_order_relaxed);
+        dequeuePos.store(0, std::memory_order_relaxed);
+    }
+
+    bool ICACHE_RAM_ATTR push(const T &item)
+    {
+        uint32_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell *cell = &cells[pos & (N - 1)];
+            int32_t diff = (int32_t)(cell->seq.load(std::memory_order_acquire) - pos);
+            if (diff == 0)
+            {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell->data = item;
+                    cell->seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+                // pos was updated by the failed exchange, try again
+            }
+            else if (diff < 0)
+                return false; // full
+            else
+                pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool ICACHE_RAM_ATTR pop(T &item)
+    {
+        uint32_t pos = dequeuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell *cell = &cells[pos & (N - 1)];
+            int32_t diff = (int32_t)(cell->seq.load(std::memory_order_acquire) - (pos + 1));
+            if (diff == 0)
+            {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    item = cell->data;
+                    cell->seq.store(pos + N, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false; // empty
+            else
+                pos = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct Cell {
+        std::atomic<uint32_t> seq;
+        T data;
+    };
+    Cell cells[N];
+    std::atomic<uint32_t> enqueuePos;
+    std::atomic<uint32_t> dequeuePos;
+};
@@ -3,6 +3,7 @@
 #include "logging.h"
 #include "helpers.h"
 #include "device.h"
+#include "EventQueue.h"
 
 ///////////////////////////////////////
 // Even though we aren't using anything this keeps the PIO dependency analyzer happy!
@@ -22,11 +23,21 @@ extern bool connectionHasModelMatch;
 static device_affinity_t *uiDevices;
 static uint8_t deviceCount;
 
-static bool eventFired[2] = {false, false};
+// Events for the devices on each core, if a queue overflows an EVENT_GENERIC is delivered instead
+static EventQueue<device_event_t, 16> eventQueue[2];
+static volatile bool eventOverflow[2] = {false, false};
+static const device_event_t *currentEvent[2] = {nullptr, nullptr};
 static connectionState_e lastConnectionState[2] = {disconnected, disconnected};
 static bool lastModelMatch[2] = {false, false};
 
-static unsigned long deviceTimeout[16] = {0};
+// Deadlines are in micros() and compared with wrap-around, so a device can be
+// scheduled at most ~35 minutes into the future
+#define DEVICE_MAX_DELAY_US 0x7FFFFFFFU
+static uint32_t deviceDeadline[16] = {0};
+static bool deviceScheduled[16] = {false};
+static device_stats_t deviceStats[16] = {};
+// The earliest deadline of any device on each core, nothing is run before then unless there is an event
+static uint32_t nextDeadline[2] = {0, 0};
 
 #if defined(PLATFORM_ESP32)
 static TaskHandle_t xDeviceTask = NULL;
@@ -34,14 +45,66 @@ static SemaphoreHandle_t taskSemaphore;
 static SemaphoreHandle_t completeSemaphore;
 static void deviceTask(void *pvArgs);
 #define CURRENT_CORE  xPortGetCoreID()
+// Longest the device task will sleep without an event
+#define DEVICE_MAX_SLEEP_MS 10
 #else
 #define CURRENT_CORE -1
 #endif
 
+#if defined(DEBUG_DEVICE_STATS)
+// How often each core logs the run time statistics of its devices
+#define DEVICE_STATS_LOG_MS 10000
+#endif
+
+static void scheduleDevice(size_t i, int delay, uint32_t nowUs)
+{
+    deviceScheduled[i] = delay != DURATION_NEVER;
+    deviceDeadline[i] = nowUs + delay * 1000U;
+}
+
+static int runDevice(size_t i, int (*fn)())
+{
+    uint32_t const start = micros();
+    int const delay = fn();
+    uint32_t const duration = micros() - start;
+
+    device_stats_t * const stats = &deviceStats[i];
+    ++stats->runCount;
+    stats->runTimeUs += duration;
+    if (duration > stats->maxRunUs)
+        stats->maxRunUs = duration > 0xFFFF ? 0xFFFF : duration;
+    if (duration > DEVICE_OVERRUN_US)
+        ++stats->overrunCount;
+
+    return delay;
+}
+
+static void updateNextDeadline(int32_t core, uint32_t nowUs)
+{
+    uint32_t earliest = DEVICE_MAX_DELAY_US;
+    for (size_t i=0 ; i<deviceCount ; i++)
+    {
+        if ((uiDevices[i].core == core || core == -1) && deviceScheduled[i])
+        {
+            int32_t const untilDue = deviceDeadline[i] - nowUs;
+            if (untilDue <= 0)
+            {
+                earliest = 0;
+                break;
+            }
+            if ((uint32_t)untilDue < earliest)
+                earliest = untilDue;
+        }
+    }
+    nextDeadline[core==-1?0:core] = nowUs + earliest;
+}
+
 void devicesRegister(device_affinity_t *devices, uint8_t count)
 {
     uiDevices = devices;
     deviceCount = count;
+    for (size_t i=0 ; i<deviceCount ; i++)
+        deviceStats[i] = {};
 
     #if defined(PLATFORM_ESP32)
         taskSemaphore = xSemaphoreCreateBinary();
@@ -74,19 +137,19 @@ void devicesInit()
 void devicesStart()
 {
     int32_t core = CURRENT_CORE;
-    unsigned long now = millis();
+    uint32_t nowUs = micros();
 
     for(size_t i=0 ; i<deviceCount ; i++)
     {
         if (uiDevices[i].core == core || core == -1) {
-            deviceTimeout[i] = 0xFFFFFFFF;
+            deviceScheduled[i] = false;
             if (uiDevices[i].device->start)
             {
-                int delay = (uiDevices[i].device->start)();
-                deviceTimeout[i] = delay == DURATION_NEVER ? 0xFFFFFFFF : now + delay;
+                scheduleDevice(i, (uiDevices[i].device->start)(), nowUs);
             }
         }
     }
+    updateNextDeadline(core, nowUs);
     #if defined(PLATFORM_ESP32)
     if (core == 1)
     {
@@ -103,45 +166,146 @@ void devicesStop()
     #endif
 }
 
-void devicesTriggerEvent()
+static void ICACHE_RAM_ATTR queueEvent(unsigned idx, const device_event_t &event)
 {
-    eventFired[0] = true;
-    eventFired[1] = true;
+    if (!eventQueue[idx].push(event))
+        eventOverflow[idx] = true;
 }
 
-void devicesUpdate(unsigned long now)
+void ICACHE_RAM_ATTR devicesTriggerEvent(deviceEvent_e type)
 {
-    int32_t core = CURRENT_CORE;
-
-    bool handleEvents = eventFired[core==-1?0:core] || lastConnectionState[core==-1?0:core] != connectionState || lastModelMatch[core==-1?0:core] != connectionHasModelMatch;
-    eventFired[core==-1?0:core] = false;
-    lastConnectionState[core==-1?0:core] = connectionState;
-    lastModelMatch[core==-1?0:core] = connectionHasModelMatch;
+    device_event_t const event = { (uint32_t)micros(), type };
+    queueEvent(0, event);
+    #if defined(PLATFORM_ESP32)
+    queueEvent(1, event);
+    // Wake the device task if it is waiting for its next deadline
+    if (xDeviceTask)
+    {
+        if (xPortInIsrContext())
+            vTaskNotifyGiveFromISR(xDeviceTask, NULL);
+        else
+            xTaskNotifyGive(xDeviceTask);
+    }
+    #endif
+}
 
+/**
+ * Call event() on every device if there has been an event, and timeout() on
+ * any device which is due. `now` is the millis() of the caller's loop, the
+ * devices are scheduled using micros() for less jitter.
+ **/
+static void dispatchEvent(int32_t core, const device_event_t &event, uint32_t nowUs)
+{
+    currentEvent[core==-1?0:core] = &event;
     for(size_t i=0 ; i<deviceCount ; i++)
     {
         if (uiDevices[i].core == core || core == -1) {
-            if (handleEvents && uiDevices[i].device->event)
+            device_t * const device = uiDevices[i].device;
+            bool const subscribed = device->subscriptions == 0
+                || event.type == EVENT_GENERIC
+                || (device->subscriptions & EVENT_MASK(event.type));
+            if (subscribed && device->event)
             {
-                int delay = (uiDevices[i].device->event)();
+                int delay = runDevice(i, device->event);
                 if (delay != DURATION_IGNORE)
                 {
-                    deviceTimeout[i] = delay == DURATION_NEVER ? 0xFFFFFFFF : now + delay;
+                    scheduleDevice(i, delay, nowUs);
                 }
             }
         }
     }
+    currentEvent[core==-1?0:core] = nullptr;
+}
+
+const device_event_t *devicesCurrentEvent()
+{
+    int32_t core = CURRENT_CORE;
+    return currentEvent[core==-1?0:core];
+}
+
+void devicesUpdate(unsigned long now)
+{
+    int32_t core = CURRENT_CORE;
+    unsigned idx = core==-1?0:core;
+    uint32_t nowUs = micros();
+
+#if defined(DEBUG_DEVICE_STATS)
+    static unsigned long lastStatsLog[2] = {0, 0};
+    if (now - lastStatsLog[idx] >= DEVICE_STATS_LOG_MS)
+    {
+        lastStatsLog[idx] = now;
+        devicesLogStats();
+    }
+#else
+    (void)now;
+#endif
+
+    // The connection state is set directly all over the place, so changes are
+    // turned into events here
+    if (lastConnectionState[idx] != connectionState)
+    {
+        lastConnectionState[idx] = connectionState;
+        queueEvent(idx, { nowUs, EVENT_CONNECTION_STATE });
+    }
+    if (lastModelMatch[idx] != connectionHasModelMatch)
+    {
+        lastModelMatch[idx] = connectionHasModelMatch;
+        queueEvent(idx, { nowUs, EVENT_MODEL_MATCH });
+    }
+
+    // Deliver the events in the order they were triggered
+    bool handledEvents = false;
+    device_event_t event;
+    while (eventQueue[idx].pop(event))
+    {
+        dispatchEvent(core, event, nowUs);
+        handledEvents = true;
+    }
+    if (eventOverflow[idx])
+    {
+        eventOverflow[idx] = false;
+        dispatchEvent(core, { nowUs, EVENT_GENERIC }, nowUs);
+        handledEvents = true;
+    }
+
+    // Nothing to do until the next device is due
+    if (!handledEvents && (int32_t)(nowUs - nextDeadline[idx]) < 0)
+        return;
 
     for(size_t i=0 ; i<deviceCount ; i++)
     {
         if (uiDevices[i].core == core || core == -1) {
-            if (uiDevices[i].device->timeout && now >= deviceTimeout[i])
+            int32_t const overdue = nowUs - deviceDeadline[i];
+            if (uiDevices[i].device->timeout && deviceScheduled[i] && overdue >= 0)
             {
-                int delay = (uiDevices[i].device->timeout)();
-                deviceTimeout[i] = delay == DURATION_NEVER ? 0xFFFFFFFF : now + delay;
+                if (overdue > DEVICE_LATE_US)
+                    ++deviceStats[i].lateCount;
+                scheduleDevice(i, runDevice(i, uiDevices[i].device->timeout), micros());
             }
         }
     }
+
+    updateNextDeadline(core, micros());
+}
+
+const device_stats_t *devicesGetStats(uint8_t idx)
+{
+    return idx < deviceCount ? &deviceStats[idx] : nullptr;
+}
+
+void devicesLogStats()
+{
+    int32_t core = CURRENT_CORE;
+
+    for (size_t i=0 ; i<deviceCount ; i++)
+    {
+        if (uiDevices[i].core == core || core == -1)
+        {
+            DBGLN("dev%u: %u runs avg %uus max %uus, %u overrun %u late", (unsigned)i, deviceStats[i].runCount,
+                deviceStats[i].runCount ? deviceStats[i].runTimeUs / deviceStats[i].runCount : 0U,
+                deviceStats[i].maxRunUs, deviceStats[i].overrunCount, deviceStats[i].lateCount);
+        }
+    }
 }
 
 #if defined(PLATFORM_ESP32)
@@ -156,6 +320,15 @@ static void deviceTask(void *pvArgs)
     for (;;)
     {
         devicesUpdate(millis());
+
+        // Release the core until the next device is due or an event wakes the task.
+        // Connection state changes don't notify, so never sleep longer than
+        // DEVICE_MAX_SLEEP_MS. Devices polling with DURATION_IMMEDIATELY keep it spinning.
+        int32_t const idleMs = (int32_t)(nextDeadline[0] - micros()) / 1000;
+        if (idleMs >= portTICK_PERIOD_MS)
+        {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(idleMs < DEVICE_MAX_SLEEP_MS ? idleMs : DEVICE_MAX_SLEEP_MS));
+        }
     }
 }
 #endif
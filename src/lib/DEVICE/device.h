@@ -7,6 +7,24 @@
 #define DURATION_NEVER -1       // timeout() will not be called, only event()
 #define DURATION_IMMEDIATELY 0  // timeout() will be called each loop
 
+typedef enum : uint8_t {
+    EVENT_GENERIC,          // Anything may have changed, delivered to every device
+    EVENT_CONNECTION_STATE, // connectionState changed
+    EVENT_MODEL_MATCH,      // connectionHasModelMatch changed
+    EVENT_CONFIG_CHANGED,   // Config was changed or committed
+    EVENT_POWER_CHANGED,    // Output power changed
+    EVENT_VTX_CHANGED,      // VTX settings changed
+    EVENT_ARM_CHANGED,      // AUX1 (arm) changed
+    EVENT_BINDING,          // Entered or exited binding mode
+} deviceEvent_e;
+
+#define EVENT_MASK(e) (1U << (e))
+
+typedef struct {
+    uint32_t timestamp;     // micros() when the event was triggered
+    deviceEvent_e type;
+} device_event_t;
+
 typedef struct {
     // Called at the beginning of setup() so the device can configure IO pins etc
     void (*initialize)();
@@ -16,6 +34,8 @@ typedef struct {
     int (*event)();
     // The duration has passed so take appropriate action and return a new duration, this function should never return DURATION_IGNORE
     int (*timeout)();
+    // EVENT_MASK()s of the events to call event() for, 0 for all events. EVENT_GENERIC is always delivered
+    uint32_t subscriptions;
 } device_t;
 
 typedef struct {
@@ -23,9 +43,30 @@ typedef struct {
   int8_t core; // 0 = UART core or 1 = loopcore
 } device_affinity_t;
 
+// A single event() or timeout() call longer than this counts as an overrun
+#define DEVICE_OVERRUN_US   1000
+// A timeout() called this long after it was due counts as late
+#define DEVICE_LATE_US      2000
+
+typedef struct {
+    uint32_t runCount;      // number of event() and timeout() calls
+    uint32_t runTimeUs;     // total time spent in event() and timeout()
+    uint16_t maxRunUs;      // longest single call
+    uint16_t overrunCount;  // calls longer than DEVICE_OVERRUN_US
+    uint16_t lateCount;     // timeout() calls more than DEVICE_LATE_US after being due
+} device_stats_t;
+
 void devicesRegister(device_affinity_t *devices, uint8_t count);
 void devicesInit();
 void devicesStart();
 void devicesUpdate(unsigned long now);
-void devicesTriggerEvent();
+// Queue an event for the devices, can be called from ISRs or either core
+void devicesTriggerEvent(deviceEvent_e type = EVENT_GENERIC);
+// The event being delivered, only valid during a device's event()
+const device_event_t *devicesCurrentEvent();
 void devicesStop();
+// Run time statistics of the idx'th registered device
+const device_stats_t *devicesGetStats(uint8_t idx);
+// Log the run time statistics of the devices on the calling core, done every
+// DEVICE_STATS_LOG_MS by devicesUpdate() when built with DEBUG_DEVICE_STATS
+void devicesLogStats();
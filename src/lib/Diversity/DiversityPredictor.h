@@ -0,0 +1,219 @@
+#pragma once
+
+#include "targets.h"
+
+#define DIVERSITY_MAX_CHANNELS   128 // channels beyond this get no history of their own
+#define DIVERSITY_HYSTERESIS     (2 * 16)  // 2dB, Q4 dB
+#define DIVERSITY_MISS_PENALTY   (3 * 16)  // a missed packet counts this far below sensitivity
+#define DIVERSITY_STALE_HALFLIFE 4
+#define DIVERSITY_MEAN_SLOTS     64        // the long term mean is over about this many slots
+#define DIVERSITY_TX_FRESH_SLOTS 16        // the TX only goes by feedback at most this old
+
+/**
+ * Picks the antenna for the next packet on a receiver with one radio and an
+ * antenna switch, before the packet arrives instead of after one is missed.
+ *
+ * Each packet slot is measured on the antenna in use only, as the signal
+ * strength (RSSI, less any negative SNR as the RSSI is then mostly noise).
+ * From that it keeps:
+ *  - a fast moving level per antenna, which follows fading as the model moves
+ *  - a long term mean of both, what an antenna is expected to see without
+ *    knowing anything more recent
+ *  - per FHSS channel and antenna, how far that channel sits from the level,
+ *    which is how multipath treats each frequency on each antenna
+ * The estimate for the next channel is the level, moved on by its trend,
+ * plus that channel's offset.
+ * The antenna not in use is only known from when it was last used, so its
+ * level is drawn back to the long term mean the longer ago that was. When
+ * the antenna in use fades it is predicted to be worse than the other one,
+ * which is switched to ahead of the next packet, and frequencies one antenna
+ * is known to do badly on are received on the other.
+ *
+ * All values are Q4 dB (1/16 dB) unless noted.
+ */
+class DiversityPredictor
+{
+public:
+    DiversityPredictor()
+    {
+        setSensitivity(-100);
+        reset();
+    }
+
+    /* The RSSI (dBm) packets stop being received at, for the air rate in use */
+    void setSensitivity(int8_t dBm)
+    {
+        missedStrength = dBm * 16 - DIVERSITY_MISS_PENALTY;
+    }
+
+    void reset()
+    {
+        mean = missedStrength;
+        meanCount = 0;
+        for (uint8_t a = 0; a < 2; ++a)
+        {
+            level[a] = missedStrength;
+            age[a] = UINT8_MAX;
+            trend[a] = 0;
+        }
+        for (unsigned c = 0; c < DIVERSITY_MAX_CHANNELS; ++c)
+        {
+            channelOffset[c][0] = 0;
+            channelOffset[c][1] = 0;
+        }
+    }
+
+    /**
+     * Learn from the slot which has just ended, received on antenna on channel
+     * rssi (dBm) and snr (dB) are ignored if nothing was received
+     **/
+    void ICACHE_RAM_ATTR update(uint8_t antenna, uint8_t channel, bool received, int8_t rssi, int8_t snr)
+    {
+        int32_t measured = missedStrength;
+        if (received)
+            measured = (rssi + (snr < 0 ? snr : 0)) * 16;
+
+        // Nothing to go on for the first reading
+        if (meanCount == 0)
+            mean = measured;
+
+        // The level follows the reading less what is known of the channel,
+        // and the channel's offset is from the level before this reading, so
+        // neither a fade is put down to the channel nor the channel to a fade
+        const int32_t before = expectedLevel(antenna);
+        int32_t normalized = measured;
+        if (channel < DIVERSITY_MAX_CHANNELS)
+        {
+            int32_t offset = channelOffset[channel][antenna];
+            normalized -= offset * 4;
+            offset += ((measured - before) / 4 - offset) / 2;
+            channelOffset[channel][antenna] = constrain(offset, INT8_MIN, INT8_MAX);
+        }
+        // A miss is only known to be below sensitivity, but unless the channel
+        // explains it, it's reason enough to try the other antenna
+        const int32_t prev = level[antenna];
+        if (received)
+            level[antenna] = before + (normalized - before) * 3 / 4;
+        else
+            level[antenna] = normalized;
+        trend[antenna] = (age[antenna] == 0) ? level[antenna] - prev : 0;
+
+        if (meanCount < DIVERSITY_MEAN_SLOTS)
+            ++meanCount;
+        mean += (measured - mean) / meanCount;
+
+        age[antenna] = 0;
+        if (age[!antenna] < UINT8_MAX)
+            ++age[!antenna];
+    }
+
+    /**
+     * A slot went by without being measured on either antenna, as most of the
+     * TX's packets are, only some are reported on by the RX
+     **/
+    void ICACHE_RAM_ATTR skip()
+    {
+        for (uint8_t a = 0; a < 2; ++a)
+        {
+            if (age[a] < UINT8_MAX)
+                ++age[a];
+        }
+    }
+
+    /* The antenna clearly better on channel, -1 if neither is */
+    int8_t ICACHE_RAM_ATTR preferred(uint8_t channel) const
+    {
+        const int32_t diff = estimate(1, channel) - estimate(0, channel);
+        if (diff > DIVERSITY_HYSTERESIS)
+            return 1;
+        if (diff < -DIVERSITY_HYSTERESIS)
+            return 0;
+        return -1;
+    }
+
+    /* The antenna to receive the next packet on, on channel */
+    uint8_t ICACHE_RAM_ATTR predict(uint8_t antenna, uint8_t channel) const
+    {
+        const int32_t current = estimate(antenna, channel);
+        const int32_t other = estimate(!antenna, channel);
+        return (other > current + DIVERSITY_HYSTERESIS) ? !antenna : antenna;
+    }
+
+    /* The predicted strength for the next packet on an antenna and channel */
+    int32_t ICACHE_RAM_ATTR estimate(uint8_t antenna, uint8_t channel) const
+    {
+        int32_t est = expectedLevel(antenna);
+        // Half the last change carries on, a fade is seen coming a slot early
+        if (age[antenna] == 0)
+            est += trend[antenna] / 2;
+        if (channel < DIVERSITY_MAX_CHANNELS)
+            est += channelOffset[channel][antenna] * 4;
+        return est;
+    }
+
+private:
+    // The level of an antenna now, drawn back to the mean by its age
+    int32_t ICACHE_RAM_ATTR expectedLevel(uint8_t antenna) const
+    {
+        const uint8_t halvings = age[antenna] / DIVERSITY_STALE_HALFLIFE;
+        if (halvings >= 16)
+            return mean;
+        return mean + (level[antenna] - mean) / (1 << halvings);
+    }
+
+    int32_t level[2];       // fast moving average per antenna
+    int32_t trend[2];       // the change in level at the last reading
+    uint8_t age[2];         // slots since the antenna was last measured
+    int32_t mean;           // long term, both antennas
+    uint8_t meanCount;
+    int32_t missedStrength; // what a missed packet counts as
+    int8_t channelOffset[DIVERSITY_MAX_CHANNELS][2]; // Q2 dB from the level
+};
+
+/**
+ * Picks the antenna a TX sends each new packet on, from the RSSI the RX reports
+ * of single packets. The reports are few and far between, so the packets are
+ * alternated between the antennas as they always were, unless there has been
+ * a report in the last DIVERSITY_TX_FRESH_SLOTS packets and the predictor
+ * says one antenna is clearly better on the channel. Ages are in packets.
+ */
+class TxDiversitySelector
+{
+public:
+    TxDiversitySelector()
+    {
+        reset(-100);
+    }
+
+    /* sensitivity (dBm) of the air rate in use */
+    void reset(int8_t sensitivity)
+    {
+        predictor.setSensitivity(sensitivity);
+        predictor.reset();
+        sinceFeedback = UINT8_MAX;
+    }
+
+    /* The RX reported the packet sent on antenna and channel at -lastRSSI dBm, 0 if it was missed */
+    void ICACHE_RAM_ATTR feedback(uint8_t antenna, uint8_t channel, uint8_t lastRSSI)
+    {
+        predictor.update(antenna, channel, lastRSSI != 0, -(int8_t)lastRSSI, 0);
+        sinceFeedback = 0;
+    }
+
+    /* The antenna for a new packet on channel, the last one went on antenna */
+    uint8_t ICACHE_RAM_ATTR select(uint8_t antenna, uint8_t channel)
+    {
+        int8_t best = -1;
+        if (sinceFeedback <= DIVERSITY_TX_FRESH_SLOTS)
+            best = predictor.preferred(channel);
+        // This packet isn't measured, unless it happens to be the one reported on
+        predictor.skip();
+        if (sinceFeedback < UINT8_MAX)
+            ++sinceFeedback;
+        return best < 0 ? !antenna : best;
+    }
+
+private:
+    DiversityPredictor predictor;
+    uint8_t sinceFeedback; // packets
+};
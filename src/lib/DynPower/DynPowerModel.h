@@ -0,0 +1,150 @@
+#pragma once
+
+#include <stdint.h>
+
+// The margin above the rate's sensitivity to aim for, and how long to stay at a
+// power level before stepping down one, by whether the model is armed
+#if !defined(DYNPOWER_MARGIN_ARMED)
+#define DYNPOWER_MARGIN_ARMED     15 // dB
+#endif
+#if !defined(DYNPOWER_MARGIN_DISARMED)
+#define DYNPOWER_MARGIN_DISARMED  10 // dB
+#endif
+#define DYNPOWER_HOLD_ARMED_MS    3000
+#define DYNPOWER_HOLD_DISARMED_MS 1000
+#define DYNPOWER_HYSTERESIS       2  // dB a lower level must clear what's needed by
+#define DYNPOWER_LEVELS           8
+
+// The nominal output of each PowerLevels_e (10mW to 2000mW)
+static const int8_t DynPowerLevelDbm[DYNPOWER_LEVELS] = { 10, 14, 17, 20, 24, 27, 30, 33 };
+
+/**
+ * Picks the TX power from a model of the link instead of stepping one level
+ * at a time. Each link stats report gives the signal at the RX of packets
+ * sent at a known power, so the path loss between them. The power needed is
+ * what puts the signal the margin above the rate's sensitivity over that
+ * loss, and that level is jumped to directly.
+ *
+ * The path loss estimate takes any increase at once and follows decreases
+ * slowly. Raising power is immediate, lowering is one level at a time, each
+ * after the power has been held for a while, so a dive behind a structure
+ * gets all the power it needs on the next report and cruising settles down
+ * to the lowest level which keeps the margin.
+ *
+ * On rates with SNR thresholds the SNR has the last word as before: each dB
+ * it is short of the raise threshold needs a dB more, and power is not
+ * lowered below the lower threshold.
+ */
+class DynPowerModel
+{
+public:
+    DynPowerModel()
+    {
+        setRate(-100, 0, 0, false);
+        reset(0);
+    }
+
+    /**
+     * sensitivity (dBm) of the air rate, SNR (dB) at or below which power must
+     * go up and at or above which it may go down, if useSnr
+     **/
+    void setRate(int16_t sensitivity, int8_t snrUp, int8_t snrDn, bool useSnr)
+    {
+        this->sensitivity = sensitivity;
+        this->snrUp = snrUp;
+        this->snrDn = snrDn;
+        this->useSnr = useSnr;
+    }
+
+    /* Forget the link, e.g. when the air rate changes */
+    void reset(uint32_t now)
+    {
+        pathLoss = -1;
+        snr = 0;
+        lastChange = now;
+        lastLevel = DYNPOWER_LEVELS;
+    }
+
+    /* A link stats report: rssi (dBm) and snr (dB) of packets sent at level */
+    void update(uint8_t level, int8_t rssi, int8_t snr)
+    {
+        // A negative SNR means the RSSI is mostly noise, the signal is below it
+        const int32_t signal = rssi + (snr < 0 ? snr : 0);
+        const int32_t loss = (DynPowerLevelDbm[level] - signal) * 16;
+        if (pathLoss < 0 || loss > pathLoss)
+            pathLoss = loss;
+        else
+            pathLoss += (loss - pathLoss) / 4;
+        this->snr = snr;
+    }
+
+    bool hasEstimate() const { return pathLoss >= 0; }
+
+    /* The path loss estimate in dB */
+    int16_t getPathLoss() const { return (pathLoss + 8) / 16; }
+
+    /* The output (dBm) needed to keep the margin with the current estimate */
+    int16_t getRequiredDbm(uint8_t currentLevel, bool armed) const
+    {
+        int16_t required = sensitivity + (armed ? DYNPOWER_MARGIN_ARMED : DYNPOWER_MARGIN_DISARMED) + getPathLoss();
+        if (useSnr && snr <= snrUp)
+        {
+            const int16_t snrRequired = DynPowerLevelDbm[currentLevel] + snrUp - snr + 1;
+            if (snrRequired > required)
+                required = snrRequired;
+        }
+        return required;
+    }
+
+    /**
+     * The power level to use from now, between minLevel and maxLevel. Lowering
+     * is held off when !canLower, e.g. while LQ is not yet good
+     **/
+    uint8_t selectLevel(uint32_t now, uint8_t current, uint8_t minLevel, uint8_t maxLevel, bool armed, bool canLower)
+    {
+        // Changed by someone else, e.g. a boost, which counts as a raise
+        if (current != lastLevel)
+            lastChange = now;
+
+        uint8_t level = current;
+        if (level > maxLevel)
+            level = maxLevel;
+        if (level < minLevel)
+            level = minLevel;
+
+        if (hasEstimate())
+        {
+            const int16_t required = getRequiredDbm(current, armed);
+            uint8_t target = minLevel;
+            while (target < maxLevel && DynPowerLevelDbm[target] < required)
+                ++target;
+
+            if (target > level)
+            {
+                level = target;
+            }
+            else if (target < level && canLower
+                && (now - lastChange) >= (armed ? DYNPOWER_HOLD_ARMED_MS : DYNPOWER_HOLD_DISARMED_MS)
+                && DynPowerLevelDbm[level - 1] >= required + DYNPOWER_HYSTERESIS
+                && !(useSnr && snr < snrDn))
+            {
+                --level;
+            }
+        }
+
+        if (level != current)
+            lastChange = now;
+        lastLevel = level;
+        return level;
+    }
+
+private:
+    int32_t pathLoss;   // Q4 dB, negative until the first report
+    int8_t snr;         // of the last report
+    int16_t sensitivity;
+    int8_t snrUp;
+    int8_t snrDn;
+    bool useSnr;
+    uint32_t lastChange;
+    uint8_t lastLevel;
+};
@@ -2,11 +2,12 @@
 
 #include "targets.h"
 #include "random.h"
+#include "FreqCorrector.h"
 
 #if defined(RADIO_SX127X)
-#define FreqCorrectionMax ((int32_t)(100000/FREQ_STEP))
+#define FreqCorrectionMax ((int32_t)(FREQ_CORR_LIMIT_HZ_900/FREQ_STEP))
 #elif defined(RADIO_SX128X)
-#define FreqCorrectionMax ((int32_t)(200000/FREQ_STEP))
+#define FreqCorrectionMax ((int32_t)(FREQ_CORR_LIMIT_HZ_2G4/FREQ_STEP))
 #endif
 #define FreqCorrectionMin (-FreqCorrectionMax)
 
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "targets.h"
+
+typedef struct {
+    int32_t hzToRegQ16; // 65536 / FREQ_STEP, converts Hz to register units in Q16
+    int16_t kp;         // proportional gain, Q8 (256 = 1.0)
+    int16_t ki;         // integral gain, Q8
+    int32_t maxStep;    // largest single adjustment applied per hop (register units)
+    int32_t limit;      // absolute limit of the correction (register units)
+} freqcorr_tuning_t;
+
+// How far the correction may pull the radio, in Hz
+#define FREQ_CORR_LIMIT_HZ_900  100000
+#define FREQ_CORR_LIMIT_HZ_2G4  200000
+
+// The tuning for each band, given the radio's FREQ_STEP
+// SX127x FEI is noisy at SF6 and the PPM offset reg must follow, favour averaging
+#define FREQ_CORR_TUNING_900(step) { (int32_t)(65536 / (step)), 128, 16, \
+    (int32_t)(FREQ_CORR_LIMIT_HZ_900 / (step)) / 8, (int32_t)(FREQ_CORR_LIMIT_HZ_900 / (step)) }
+#define FREQ_CORR_TUNING_2G4(step) { (int32_t)(65536 / (step)), 192, 16, \
+    (int32_t)(FREQ_CORR_LIMIT_HZ_2G4 / (step)) / 4, (int32_t)(FREQ_CORR_LIMIT_HZ_2G4 / (step)) }
+
+/**
+ * Proportional-integral estimator of the crystal offset between the TX and RX
+ * using the frequency error measured by the radio (FEI) on each good packet.
+ *
+ * The measured error is the residual after the current correction, and only
+ * changes once the correction is applied to the synthesizer at the next hop,
+ * so samples are averaged over a hop dwell and applied once when hopping.
+ * A positive sample means the correction needs to increase.
+ */
+class FreqCorrector
+{
+public:
+    FreqCorrector(const freqcorr_tuning_t &tuning) : tuning(tuning)
+    {
+        reset();
+    }
+
+    void ICACHE_RAM_ATTR reset()
+    {
+        correctionQ8 = 0;
+        integralQ8 = 0;
+        sampleSum = 0;
+        sampleCount = 0;
+    }
+
+    /* Add a frequency error sample (Hz), to be applied on the next apply() */
+    void ICACHE_RAM_ATTR addSample(int32_t errorHz)
+    {
+        sampleSum += errorHz;
+        ++sampleCount;
+    }
+
+    /**
+     * Fold any samples collected since the last call into the correction
+     * Returns true if the correction (register units) was changed
+     **/
+    bool ICACHE_RAM_ATTR apply(int32_t &correction)
+    {
+        if (sampleCount == 0)
+            return false;
+
+        int32_t errQ8 = (sampleSum / sampleCount) * tuning.hzToRegQ16 / 256;
+        sampleSum = 0;
+        sampleCount = 0;
+
+        const int32_t maxStepQ8 = tuning.maxStep * 256;
+        // Only integrate once pulled in, so the large initial error doesn't wind up
+        // the integral and overshoot. The integral then tracks slow drift.
+        if (errQ8 < maxStepQ8 / 8 && errQ8 > -maxStepQ8 / 8)
+            integralQ8 = clamp(integralQ8 + errQ8 * tuning.ki / 256, maxStepQ8);
+        int32_t deltaQ8 = clamp(errQ8 * tuning.kp / 256 + integralQ8, maxStepQ8);
+        correctionQ8 = clamp(correctionQ8 + deltaQ8, tuning.limit * 256);
+
+        // Round to nearest register step
+        int32_t newCorrection = (correctionQ8 + 128) >> 8;
+        if (newCorrection == correction)
+            return false;
+        correction = newCorrection;
+        return true;
+    }
+
+private:
+    const freqcorr_tuning_t &tuning;
+    int32_t correctionQ8;
+    int32_t integralQ8;
+    int32_t sampleSum;
+    int32_t sampleCount;
+
+    static int32_t clamp(int32_t val, int32_t limit)
+    {
+        if (val > limit)
+            return limit;
+        if (val < -limit)
+            return -limit;
+        return val;
+    }
+};
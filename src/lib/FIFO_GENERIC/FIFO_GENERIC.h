@@ -160,11 +160,23 @@ public:
     {
         if (size() > 1)
         {
-            return (uint16_t)pop() + ((uint16_t)pop() << 8);
+            // Two statements, the order of the pops within one expression is unspecified
+            uint16_t size = pop();
+            return size + ((uint16_t)pop() << 8);
         }
         return 0;
     }
 
+    // Discard everything pushed after the FIFO held len elements
+    void truncate(uint32_t len)
+    {
+        if (len < numElements)
+        {
+            numElements = len;
+            tail = (head + len) % FIFO_SIZE;
+        }
+    }
+
     void flush()
     {
         head = 0;
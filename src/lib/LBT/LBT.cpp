@@ -2,6 +2,7 @@
 #include "common.h"
 #include "logging.h"
 #include "LBT.h"
+#include "LBTAssessor.h"
 
 extern SX1280Driver Radio;
 
@@ -12,6 +13,23 @@ static uint32_t rxStartTime;
   #define LBT_RSSI_THRESHOLD_OFFSET_DB 0
 #endif
 
+// How long a busy channel is reassessed for, the packet must still fit in the slot after it
+#define LBT_RETRY_MAX_US  300
+#define LBT_TX_SLACK_US   100
+
+// The radio as LBTAssessChannel uses it
+struct LBTRadio
+{
+  int8_t ICACHE_RAM_ATTR rssi() { return Radio.GetRssiInst(); }
+  uint32_t ICACHE_RAM_ATTR now() { return micros(); }
+  void ICACHE_RAM_ATTR waitUntil(uint32_t us)
+  {
+    int32_t remaining = us - micros();
+    if (remaining > 0)
+      delayMicroseconds(remaining);
+  }
+};
+
 bool LBTEnabled = false;
 static bool LBTStarted = false;
 
@@ -64,6 +82,22 @@ int8_t ICACHE_RAM_ATTR PowerEnumToLBTLimit(PowerLevels_e txPower)
   }
 }
 
+static uint32_t ICACHE_RAM_ATTR RetryBudgetUs()
+{
+  int32_t budget = (int32_t)ExpressLRS_currAirRate_Modparams->interval
+    - ExpressLRS_currAirRate_RFperfParams->TOA - LBT_TX_SLACK_US;
+  return constrain(budget, 0, LBT_RETRY_MAX_US);
+}
+
+// Extended CCA length in observation slots, 1..LBT_ECCA_Q. Not the FHSS rng,
+// drawing from that would change the hop sequence
+static uint8_t ICACHE_RAM_ATTR EccaSlots()
+{
+  static uint32_t state = 1;
+  state = state * 1103515245 + 12345 + micros();
+  return 1 + (state >> 16) % LBT_ECCA_Q;
+}
+
 void ICACHE_RAM_ATTR BeginClearChannelAssessment(void)
 {
   if (!LBTEnabled)
@@ -90,32 +124,17 @@ bool ICACHE_RAM_ATTR ChannelIsClear(void)
 
   LBTStarted = false;
 
-  // Read rssi after waiting the minimum RSSI valid delay.
-  // If this function is called long enough after RX enable,
-  // this will always be ok on first try as is the case for TX.
-
-  // TODO: Better way than busypolling this for RX?
-  // this loop should only run for RX, where listen before talk RX is started right after FHSS hop
-  // so there is no dead-time to run RX before telemetry TX is supposed to happen.
-  // if flipping the logic, so telemetry TX happens right before FHSS hop, then TX-side ends up with polling here instead?
-  // Maybe it could be skipped if there was only TX of telemetry happening when FHSShop does not happen.
-  // Then RX for LBT could stay enabled from last received packet, and RSSI would be valid instantly.
-  // But for now, FHSShops and telemetry rates does not divide evenly, so telemetry will some times happen
-  // right after FHSS and we need wait here.
-
+  // Energy detect from when the RSSI is valid after RX enable. If this function
+  // is called long enough after RX enable, as is the case for TX, that's now.
+  // Otherwise wait for it, which is the case on the RX where telemetry is sent
+  // right after the FHSS hop.
+  // If busy, reassess while the packet can still go out in this slot.
   uint32_t validRSSIdelayUs = SpreadingFactorToRSSIvalidDelayUs((SX1280_RadioLoRaSpreadingFactors_t)ExpressLRS_currAirRate_Modparams->sf);
-  uint32_t elapsed = micros() - rxStartTime;
-  if(elapsed < validRSSIdelayUs)
-  {
-    delayMicroseconds(validRSSIdelayUs - elapsed);
-  }
-
-  int8_t rssiInst = Radio.GetRssiInst();
+  uint32_t deadline = micros() + RetryBudgetUs();
+  LBTRadio radio;
+  bool channelClear = LBTAssessChannel(radio, PowerEnumToLBTLimit((PowerLevels_e)POWERMGNT::currPower()),
+    rxStartTime + validRSSIdelayUs, deadline, EccaSlots());
   Radio.SetTxIdleMode();
-  bool channelClear = rssiInst < PowerEnumToLBTLimit((PowerLevels_e)POWERMGNT::currPower());
-  
-  // Useful to debug if and how long the rssi wait is, and rssi threshold level
-  // DBGLN("wait: %d, rssi: %d", delayRemaining, rssiInst);
 
   if(channelClear)
   {
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "targets.h"
+
+#define LBT_OBSERVATION_US  20  // CCA observation slot, EN 300 328 requires at least 18us
+#define LBT_ECCA_Q          4   // Extended CCA lasts 1..q observation slots, drawn at random
+
+/**
+ * Clear channel assessment for listen before talk.
+ *
+ * One RSSI reading when it becomes valid, clear if it is under the limit,
+ * as it always was. If it is busy the packet is not skipped straight away,
+ * an Extended CCA is done as EN 300 328 allows for adaptive equipment: the
+ * channel must be seen clear for `ecca` more observation slots, the count
+ * pausing while it is busy. If that can't finish by `deadline`, the last
+ * moment the packet can start and still end inside its slot, the channel is
+ * busy and the packet is skipped.
+ *
+ * The radio is anything which has rssi() giving an instant RSSI reading in
+ * dBm, now() and waitUntil(us).
+ */
+template <class R>
+bool ICACHE_RAM_ATTR LBTAssessChannel(R &radio, int8_t limit, uint32_t validAt, uint32_t deadline, uint8_t ecca)
+{
+    radio.waitUntil(validAt);
+    if (radio.rssi() < limit)
+        return true;
+
+    uint32_t next = radio.now();
+    while (ecca > 0)
+    {
+        next += LBT_OBSERVATION_US;
+        // Even if every slot from here is clear it will be too late
+        if ((int32_t)(next + (ecca - 1) * LBT_OBSERVATION_US - deadline) > 0)
+            return false;
+        radio.waitUntil(next);
+        if (radio.rssi() < limit)
+            --ecca;
+    }
+    return true;
+}
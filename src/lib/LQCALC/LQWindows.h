@@ -0,0 +1,206 @@
+#pragma once
+
+#include <stdint.h>
+
+// The windows LQ is kept over, the bucket is the resolution of the longer ones
+#define LQ_BUCKET_US        100000U
+#define LQ_WINDOW_SHORT_US  100000U
+#define LQ_WINDOW_MEDIUM_US 1000000U
+#define LQ_WINDOW_LONG_US   10000000U
+#define LQ_SHORT_MAX_SLOTS  128     // 100ms at 1000Hz fits
+#define LQ_BUCKETS          100     // 10s of 100ms buckets
+#define LQ_BURST_BINS       8       // 1, 2, 3-4, 5-8, 9-16, 17-32, 33-64, 65+ slots
+
+enum lq_window_e {
+    LQ_WINDOW_SHORT,
+    LQ_WINDOW_MEDIUM,
+    LQ_WINDOW_LONG,
+};
+
+/**
+ * LQ over time-based windows (100ms, 1s, 10s) whatever the packet rate, and a
+ * histogram of how many consecutive packets were lost at a time.
+ *
+ * The short window is exact, a running total over a bitmask of the last
+ * 100ms of slots. The longer ones are running totals of 100ms buckets, so
+ * they move in 100ms steps. add() is O(1) so it can be called from the timer.
+ */
+class LQWindows
+{
+public:
+    LQWindows(void) : interval(0)
+    {
+        setInterval(LQ_BUCKET_US);
+    }
+
+    /* Set the time between slots, starting again if it has changed */
+    void setInterval(uint32_t intervalUs)
+    {
+        if (intervalUs == interval)
+            return;
+        interval = intervalUs;
+        shortSlots = LQ_WINDOW_SHORT_US / intervalUs;
+        if (shortSlots > LQ_SHORT_MAX_SLOTS)
+            shortSlots = LQ_SHORT_MAX_SLOTS;
+        if (shortSlots == 0)
+            shortSlots = 1;
+        slotsPerBucket = (LQ_BUCKET_US + intervalUs / 2) / intervalUs;
+        if (slotsPerBucket == 0)
+            slotsPerBucket = 1;
+        const uint32_t bucketUs = slotsPerBucket * intervalUs;
+        windowBuckets[LQ_WINDOW_MEDIUM] = constrainBuckets(LQ_WINDOW_MEDIUM_US / bucketUs);
+        windowBuckets[LQ_WINDOW_LONG] = constrainBuckets(LQ_WINDOW_LONG_US / bucketUs);
+        reset();
+        resetBursts();
+    }
+
+    /* Record the outcome of a slot */
+    void ICACHE_RAM_ATTR add(bool received)
+    {
+        // Short window, drop the slot leaving it then add this one
+        const uint8_t pos = shortHead % LQ_SHORT_MAX_SLOTS;
+        const uint32_t mask = 1U << (pos % 32);
+        if (shortCount == shortSlots)
+        {
+            const uint8_t oldest = (shortHead + LQ_SHORT_MAX_SLOTS - shortSlots) % LQ_SHORT_MAX_SLOTS;
+            if (shortBits[oldest / 32] & (1U << (oldest % 32)))
+                --shortReceived;
+        }
+        else
+        {
+            ++shortCount;
+        }
+        if (received)
+        {
+            shortBits[pos / 32] |= mask;
+            ++shortReceived;
+        }
+        else
+        {
+            shortBits[pos / 32] &= ~mask;
+        }
+        shortHead = (pos + 1) % LQ_SHORT_MAX_SLOTS;
+
+        // Buckets
+        if (received)
+            ++bucketReceived;
+        if (++bucketSlots == slotsPerBucket)
+            closeBucket();
+
+        // Bursts of loss are counted when they end
+        if (received)
+        {
+            if (lossRun)
+                endBurst();
+        }
+        else if (lossRun < UINT16_MAX)
+        {
+            ++lossRun;
+        }
+    }
+
+    /* LQ in percent over one of the windows, up to the slots recorded so far */
+    uint8_t getLQ(lq_window_e window) const
+    {
+        if (window == LQ_WINDOW_SHORT)
+            return shortCount ? (uint32_t)shortReceived * 100U / shortCount : 0;
+        const uint8_t w = window;
+        return windowSlots[w] ? windowReceived[w] * 100U / windowSlots[w] : 0;
+    }
+
+    /* Count of loss bursts by length, bin n holds bursts of 2^(n-1)+1 to 2^n slots */
+    uint16_t getBurstCount(uint8_t bin) const { return bursts[bin]; }
+    /* The longest run of lost slots since resetBursts() */
+    uint16_t getLongestBurst() const { return longestBurst; }
+
+    /* Forget the windows, the burst histogram is kept */
+    void reset()
+    {
+        for (uint8_t i = 0; i < (LQ_SHORT_MAX_SLOTS / 32); i++)
+            shortBits[i] = 0;
+        shortHead = 0;
+        shortCount = 0;
+        shortReceived = 0;
+        bucketSlots = 0;
+        bucketReceived = 0;
+        bucketHead = 0;
+        bucketsFilled = 0;
+        for (uint8_t w = LQ_WINDOW_MEDIUM; w <= LQ_WINDOW_LONG; w++)
+        {
+            windowSlots[w] = 0;
+            windowReceived[w] = 0;
+        }
+        lossRun = 0;
+    }
+
+    void resetBursts()
+    {
+        for (uint8_t i = 0; i < LQ_BURST_BINS; i++)
+            bursts[i] = 0;
+        longestBurst = 0;
+    }
+
+private:
+    static uint8_t constrainBuckets(uint32_t n)
+    {
+        return n == 0 ? 1 : (n > LQ_BUCKETS ? LQ_BUCKETS : n);
+    }
+
+    void ICACHE_RAM_ATTR closeBucket()
+    {
+        bucketReceivedRing[bucketHead] = bucketReceived;
+        bucketSlotsRing[bucketHead] = bucketSlots;
+        if (bucketsFilled < LQ_BUCKETS)
+            ++bucketsFilled;
+        for (uint8_t w = LQ_WINDOW_MEDIUM; w <= LQ_WINDOW_LONG; w++)
+        {
+            windowReceived[w] += bucketReceived;
+            windowSlots[w] += bucketSlots;
+            // Take off the bucket which just fell out of this window
+            if (bucketsFilled > windowBuckets[w])
+            {
+                const uint8_t old = (bucketHead + LQ_BUCKETS - windowBuckets[w]) % LQ_BUCKETS;
+                windowReceived[w] -= bucketReceivedRing[old];
+                windowSlots[w] -= bucketSlotsRing[old];
+            }
+        }
+        bucketHead = (bucketHead + 1) % LQ_BUCKETS;
+        bucketSlots = 0;
+        bucketReceived = 0;
+    }
+
+    void ICACHE_RAM_ATTR endBurst()
+    {
+        uint8_t bin = 0;
+        while (bin < LQ_BURST_BINS - 1 && (1U << bin) < lossRun)
+            ++bin;
+        if (bursts[bin] < UINT16_MAX)
+            ++bursts[bin];
+        if (lossRun > longestBurst)
+            longestBurst = lossRun;
+        lossRun = 0;
+    }
+
+    uint32_t interval;
+    uint32_t shortBits[LQ_SHORT_MAX_SLOTS / 32];
+    uint8_t shortSlots;     // slots in the short window
+    uint8_t shortHead;      // next bit of shortBits to write
+    uint8_t shortCount;     // slots in the short window so far
+    uint8_t shortReceived;
+
+    uint8_t slotsPerBucket;
+    uint8_t bucketSlots;    // in the bucket being filled
+    uint8_t bucketReceived;
+    uint8_t bucketHead;     // next entry of the rings to write
+    uint8_t bucketsFilled;
+    uint8_t bucketSlotsRing[LQ_BUCKETS];
+    uint8_t bucketReceivedRing[LQ_BUCKETS];
+    // Indexed by lq_window_e, the short window doesn't use these
+    uint8_t windowBuckets[LQ_WINDOW_LONG + 1];
+    uint16_t windowSlots[LQ_WINDOW_LONG + 1];
+    uint16_t windowReceived[LQ_WINDOW_LONG + 1];
+
+    uint16_t lossRun;       // slots lost since the last one received
+    uint16_t longestBurst;
+    uint16_t bursts[LQ_BURST_BINS];
+};
@@ -1,4 +1,5 @@
 #include "lua.h"
+#include "luaParamCache.h"
 #include "common.h"
 #include "CRSF.h"
 #include "logging.h"
@@ -22,7 +23,13 @@ static uint8_t luaWarningFlags = 0b00000000; //8 flag, 1 bit for each flag. set
 static void (*devicePingCallback)() = nullptr;
 #endif
 
-#define LUA_MAX_PARAMS 32
+// Batch frames sent for each request, as many as the queue to the handset takes
+#ifdef TARGET_TX
+#define LUA_BATCH_FRAMES 3
+#else
+#define LUA_BATCH_FRAMES 1
+#endif
+static LuaParamCache luaParams;
 static struct luaPropertiesCommon *paramDefinitions[LUA_MAX_PARAMS] = {0}; // array of luaItem_*
 static luaCallback paramCallbacks[LUA_MAX_PARAMS] = {0};
 static uint8_t lastLuaField = 0;
@@ -127,30 +134,26 @@ static uint8_t *luaFolderStructToArray(const void *luaStruct, uint8_t *next)
     return (uint8_t *)stpcpy((char *)next, p1->common.name) + 1;
   }
 }
-static uint8_t sendCRSFparam(crsf_frame_type_e frameType, uint8_t fieldChunk, struct luaPropertiesCommon *luaData)
+// Serialize a field the way the handset reads it: Parent + Type + Name + value.
+// Returns the length, 0 if it can't be sent
+static uint8_t luaSerializeEntry(struct luaPropertiesCommon *luaData, uint8_t *entry)
 {
   uint8_t dataType = luaData->type & CRSF_FIELD_TYPE_MASK;
 
-  // 256 max payload + (FieldID + ChunksRemain + Parent + Type)
-  // Chunk 1: (FieldID + ChunksRemain + Parent + Type) + fieldChunk0 data
-  // Chunk 2-N: (FieldID + ChunksRemain) + fieldChunk1 data
-  uint8_t chunkBuffer[256+4];
-  // Start the field payload at 2 to leave room for (FieldID + ChunksRemain)
-  chunkBuffer[2] = luaData->parent;
-  chunkBuffer[3] = dataType;
+  entry[0] = luaData->parent;
+  entry[1] = dataType;
 #ifdef TARGET_TX
   // Set the hidden flag
-  chunkBuffer[3] |= luaData->type & CRSF_FIELD_HIDDEN ? 0x80 : 0;
+  entry[1] |= luaData->type & CRSF_FIELD_HIDDEN ? 0x80 : 0;
   if (crsf.elrsLUAmode) {
-    chunkBuffer[3] |= luaData->type & CRSF_FIELD_ELRS_HIDDEN ? 0x80 : 0;
+    entry[1] |= luaData->type & CRSF_FIELD_ELRS_HIDDEN ? 0x80 : 0;
   }
 #else
-  chunkBuffer[3] |= luaData->type;
-  uint8_t paramInformation[DEVICE_INFORMATION_LENGTH];
+  entry[1] |= luaData->type;
 #endif
 
-  // Copy the name to the buffer starting at chunkBuffer[4]
-  uint8_t *chunkStart = (uint8_t *)stpcpy((char *)&chunkBuffer[4], luaData->name) + 1;
+  // Copy the name to the buffer starting at entry[2]
+  uint8_t *chunkStart = (uint8_t *)stpcpy((char *)&entry[2], luaData->name) + 1;
   uint8_t *dataEnd;
 
   switch(dataType) {
@@ -175,7 +178,7 @@ static uint8_t sendCRSFparam(crsf_frame_type_e frameType, uint8_t fieldChunk, st
     case CRSF_FOLDER:
       // re-fetch the lua data name, because luaFolderStructToArray will decide whether
       //to return the fixed name or dynamic name.
-      chunkStart = luaFolderStructToArray(luaData, &chunkBuffer[4]);
+      chunkStart = luaFolderStructToArray(luaData, &entry[2]);
       // subtract 1 because dataSize expects the end to not include the null
       // which is already accounted for in chunkStart
       dataEnd = chunkStart - 1;
@@ -186,37 +189,98 @@ static uint8_t sendCRSFparam(crsf_frame_type_e frameType, uint8_t fieldChunk, st
       return 0;
   }
 
-  // dataEnd points to the end of the last string
-  // -2 bytes Lua chunk header: FieldId, ChunksRemain
-  // +1 for the null on the last string
-  uint8_t dataSize = (dataEnd - chunkBuffer) - 2 + 1;
-  // Maximum number of chunked bytes that can be sent in one response
-  // 6 bytes CRSF header/CRC: Dest, Len, Type, ExtSrc, ExtDst, CRC
-  // 2 bytes Lua chunk header: FieldId, ChunksRemain
+  // dataEnd points to the end of the last string, +1 for its null
+  return (dataEnd - entry) + 1;
+}
+
+// Maximum payload of a PARAMETER_SETTINGS_ENTRY frame
+// 6 bytes CRSF header/CRC: Dest, Len, Type, ExtSrc, ExtDst, CRC
+static uint8_t luaMaxPayload()
+{
 #ifdef TARGET_TX
-  uint8_t chunkMax = CRSF::GetMaxPacketBytes() - 6 - 2;
+  return CRSF::GetMaxPacketBytes() - 6;
 #else
-  uint8_t chunkMax = CRSF_MAX_PACKET_LEN - 6 - 2;
+  return CRSF_MAX_PACKET_LEN - 6;
 #endif
+}
+
+static void sendLuaPayload(crsf_frame_type_e frameType, uint8_t *payload, uint8_t len)
+{
+#ifdef TARGET_TX
+  CRSF::packetQueueExtended(frameType, payload, len);
+#else
+  uint8_t paramInformation[CRSF_MAX_PACKET_LEN];
+  memcpy(paramInformation + sizeof(crsf_ext_header_t), payload, len);
+
+  crsf.SetExtendedHeaderAndCrc(paramInformation, frameType, len + CRSF_FRAME_LENGTH_EXT_TYPE_CRC, CRSF_ADDRESS_CRSF_RECEIVER, CRSF_ADDRESS_CRSF_TRANSMITTER);
+
+  telemetry.AppendTelemetryPackage(paramInformation);
+#endif
+}
+
+static uint8_t sendCRSFparam(crsf_frame_type_e frameType, uint8_t fieldChunk, struct luaPropertiesCommon *luaData)
+{
+  // 256 max payload + (FieldID + ChunksRemain + Parent + Type)
+  // Chunk 1: (FieldID + ChunksRemain + Parent + Type) + fieldChunk0 data
+  // Chunk 2-N: (FieldID + ChunksRemain) + fieldChunk1 data
+  uint8_t chunkBuffer[256+4];
+  // Start the field payload at 2 to leave room for (FieldID + ChunksRemain)
+  uint8_t dataSize = luaSerializeEntry(luaData, &chunkBuffer[2]);
+  if (dataSize == 0)
+    return 0;
+  luaParams.update(luaData->id, &chunkBuffer[2], dataSize);
+
+  // Maximum number of chunked bytes that can be sent in one response
+  // less 2 bytes Lua chunk header: FieldId, ChunksRemain
+  uint8_t chunkMax = luaMaxPayload() - 2;
   // How many chunks needed to send this field (rounded up)
   uint8_t chunkCnt = (dataSize + chunkMax - 1) / chunkMax;
   // Data left to send is adjustedSize - chunks sent already
   uint8_t chunkSize = min((uint8_t)(dataSize - (fieldChunk * chunkMax)), chunkMax);
 
   // Move chunkStart back 2 bytes to add (FieldId + ChunksRemain) to each packet
-  chunkStart = &chunkBuffer[fieldChunk * chunkMax];
+  uint8_t *chunkStart = &chunkBuffer[fieldChunk * chunkMax];
   chunkStart[0] = luaData->id;                 // FieldId
   chunkStart[1] = chunkCnt - (fieldChunk + 1); // ChunksRemain
-#ifdef TARGET_TX
-  CRSF::packetQueueExtended(frameType, chunkStart, chunkSize + 2);
-#else
-  memcpy(paramInformation + sizeof(crsf_ext_header_t),chunkStart,chunkSize + 2);
+  sendLuaPayload(frameType, chunkStart, chunkSize + 2);
+  return chunkCnt - (fieldChunk+1);
+}
 
-  crsf.SetExtendedHeaderAndCrc(paramInformation, frameType, chunkSize + CRSF_FRAME_LENGTH_EXT_TYPE_CRC + 2, CRSF_ADDRESS_CRSF_RECEIVER, CRSF_ADDRESS_CRSF_TRANSMITTER);
+static uint8_t luaSerializeField(uint8_t id, uint8_t *entry)
+{
+  if (id >= LUA_MAX_PARAMS || paramDefinitions[id] == nullptr)
+    return 0;
+  return luaSerializeEntry(paramDefinitions[id], entry);
+}
 
-  telemetry.AppendTelemetryPackage(paramInformation);
+// Look for fields which changed without the handset writing them
+static void luaCheckParamChanges()
+{
+  uint8_t entry[256];
+  for (uint8_t id = 1; id <= lastLuaField; ++id)
+  {
+    const uint8_t len = luaSerializeField(id, entry);
+    if (len)
+      luaParams.update(id, entry, len);
+  }
+}
+
+static void sendLuaBatchFrame(uint8_t *frame, uint8_t len)
+{
+  sendLuaPayload(CRSF_FRAMETYPE_PARAMETER_SETTINGS_ENTRY, frame, len);
+}
+
+static void sendLuaParamBatch(uint8_t from, uint8_t since)
+{
+  DBGVLN("Lua batch from %u since %u", from, since);
+#ifdef TARGET_TX
+  // Queueing more than fits would drop telemetry already waiting to go out,
+  // a frame is the payload plus 7 bytes: Len + CRSF header/CRC
+  const uint8_t frames = LuaParamCache::framesFitting(CRSF::packetQueueFree(), luaMaxPayload(), 7, LUA_BATCH_FRAMES);
+#else
+  const uint8_t frames = LUA_BATCH_FRAMES;
 #endif
-  return chunkCnt - (fieldChunk+1);
+  luaParams.buildBatches(from, lastLuaField, since, luaMaxPayload(), frames, luaSerializeField, sendLuaBatchFrame);
 }
 
 static void pushResponseChunk(struct luaItem_command *cmd) {
@@ -283,6 +347,7 @@ void sendELRSstatus()
           break;
       }
   }
+  // +1 for the params version after the message's null
   uint8_t buffer[sizeof(tagLuaElrsParams) + strlen(warningInfo) + 1];
   struct tagLuaElrsParams * const params = (struct tagLuaElrsParams *)buffer;
 
@@ -292,6 +357,9 @@ void sendELRSstatus()
   // to support sending a params.msg, buffer should be extended by the strlen of the message
   // and copied into params->msg (with trailing null)
   strcpy(params->msg, warningInfo);
+  // The handset polls this, so it is where it finds out parameters changed
+  luaCheckParamChanges();
+  buffer[sizeof(buffer) - 1] = luaParams.getVersion();
   crsf.packetQueueExtended(0x2E, &buffer, sizeof(buffer));
 }
 
@@ -390,7 +458,12 @@ bool luaHandleUpdateParameter()
         uint8_t fieldId = crsf.ParameterUpdateData[1];
         uint8_t fieldChunk = crsf.ParameterUpdateData[2];
         DBGVLN("Read lua param %u %u", fieldId, fieldChunk);
-        if (fieldId < LUA_MAX_PARAMS && paramDefinitions[fieldId])
+        if (fieldId == LUA_FIELD_BATCH)
+        {
+          // The chunk is the field to start from, followed by the params version the handset has
+          sendLuaParamBatch(fieldChunk, crsf.ParameterUpdateData[3]);
+        }
+        else if (fieldId < LUA_MAX_PARAMS && paramDefinitions[fieldId])
         {
           struct luaItem_command *field = (struct luaItem_command *)paramDefinitions[fieldId];
           uint8_t dataType = field->common.type & CRSF_FIELD_TYPE_MASK;
@@ -416,7 +489,8 @@ bool luaHandleUpdateParameter()
 void sendLuaDevicePacket(void)
 {
   uint8_t deviceInformation[DEVICE_INFORMATION_LENGTH];
-  crsf.GetDeviceInformation(deviceInformation, lastLuaField);
+  luaCheckParamChanges();
+  crsf.GetDeviceInformation(deviceInformation, lastLuaField, luaParams.getVersion());
   // does append header + crc again so substract size from length
 #ifdef TARGET_TX
   crsf.packetQueueExtended(CRSF_FRAMETYPE_DEVICE_INFO, deviceInformation + sizeof(crsf_ext_header_t), DEVICE_INFORMATION_PAYLOAD_LENGTH);
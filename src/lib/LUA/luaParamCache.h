@@ -0,0 +1,186 @@
+#pragma once
+
+#include "targets.h"
+#include <string.h>
+
+#define LUA_MAX_PARAMS      32
+#define LUA_FIELD_BATCH     0xFE // PARAMETER_READ of this field reads a batch of fields
+#define LUA_BATCH_HEADER    4    // FieldId(LUA_FIELD_BATCH) + FromField + NextField + ParamsVersion
+#define LUA_BATCH_MORE      0x80 // set in NextField when another frame follows without asking
+#define LUA_BATCH_ENTRY_HDR 2    // FieldId + EntryLen
+#define LUA_VERSION_MAX_AGE 127  // a handset further behind than this reloads everything
+
+/**
+ * Version stamps for the Lua parameters, so the handset only fetches what
+ * changed since it last loaded them.
+ *
+ * The parameters version goes up by one each time any field's serialized
+ * entry changes, and the field is stamped with it. It is never 0, the
+ * handset asking for fields changed since version 0 gets all of them.
+ * Rather than keeping a copy of every entry, each field has a checksum of
+ * the last one seen to tell when it changed, whether through a callback,
+ * a setLua*Value() or a dynamic folder name.
+ *
+ * Versions are compared by how many changes ago they were, so they can
+ * wrap. A stamp so old it wraps looks recent, which costs resending the
+ * field but never misses one.
+ *
+ * A batch is PARAMETER_SETTINGS_ENTRY frames packed with as many fields
+ * changed since the handset's version as fit, a few sent for each request:
+ *   LUA_FIELD_BATCH, FromField, NextField (0 = done), ParamsVersion,
+ *   then for each field: FieldId, EntryLen, Entry
+ * where the entry is what a single chunked read of the field carries,
+ * Parent + Type + Name + value. A field too big for any frame on its own
+ * has an EntryLen of 0, and is read the chunked way.
+ * The handset asks for NextField once a frame without LUA_BATCH_MORE comes,
+ * ignoring any which don't start where it expects so a lost frame is asked
+ * for again. It keeps the ParamsVersion of the first frame of a pass,
+ * anything changing while the rest are read is then fetched again next time.
+ */
+class LuaParamCache
+{
+public:
+    LuaParamCache()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        version = 1;
+        for (unsigned i = 0; i < LUA_MAX_PARAMS; ++i)
+        {
+            fieldVersion[i] = 0;
+            checksum[i] = 0;
+        }
+    }
+
+    uint8_t getVersion() const { return version; }
+
+    /* Record the serialized entry of a field, returns true if it changed */
+    bool update(uint8_t id, const uint8_t *entry, uint8_t len)
+    {
+        if (id >= LUA_MAX_PARAMS)
+            return false;
+        const uint16_t sum = fletcher16(entry, len);
+        if (fieldVersion[id] != 0 && checksum[id] == sum)
+            return false;
+        // The first entry of a field is as of the current version, so
+        // startup doesn't count as a change
+        if (fieldVersion[id] != 0 && ++version == 0)
+            version = 1;
+        checksum[id] = sum;
+        fieldVersion[id] = version;
+        return true;
+    }
+
+    /* Has the field changed since the handset loaded version since */
+    bool changedSince(uint8_t id, uint8_t since) const
+    {
+        if (id >= LUA_MAX_PARAMS || fieldVersion[id] == 0)
+            return true;
+        const uint8_t sinceAge = version - since;
+        if (since == 0 || sinceAge > LUA_VERSION_MAX_AGE)
+            return true;
+        return (uint8_t)(version - fieldVersion[id]) < sinceAge;
+    }
+
+    /**
+     * How many batch frames fit in freeBytes of an output queue now, each
+     * at most maxLen of payload plus overhead bytes of framing. At most
+     * maxFrames, and always one, as a single field read would send.
+     **/
+    static uint8_t framesFitting(uint16_t freeBytes, uint8_t maxLen, uint8_t overhead, uint8_t maxFrames)
+    {
+        const uint16_t fit = freeBytes / (maxLen + overhead);
+        if (fit < 1)
+            return 1;
+        return fit < maxFrames ? fit : maxFrames;
+    }
+
+    /**
+     * Build up to frames batch frames of the fields from..last changed since
+     * the given version, send(frame, len) for each.
+     **/
+    template <class S, class F>
+    void buildBatches(uint8_t from, uint8_t last, uint8_t since, uint8_t maxLen, uint8_t frames, S serialize, F send)
+    {
+        uint8_t frame[256];
+        while (frames--)
+        {
+            const uint8_t len = buildBatch(from, last, since, frame, maxLen, serialize);
+            from = frame[2];
+            if (from != 0 && frames != 0)
+                frame[2] |= LUA_BATCH_MORE;
+            send(frame, len);
+            if (from == 0)
+                break;
+        }
+    }
+
+    /**
+     * Build one batch frame of the fields from..last changed since the given
+     * version into out, at most maxLen bytes. serialize(id, entry) writes the field's
+     * entry and returns its length, 0 if there is no such field.
+     * Every field looked at is checked for changes. Returns the batch length.
+     **/
+    template <class S>
+    uint8_t buildBatch(uint8_t from, uint8_t last, uint8_t since, uint8_t *out, uint8_t maxLen, S serialize)
+    {
+        uint8_t entry[256];
+        uint8_t pos = LUA_BATCH_HEADER;
+        uint8_t next = 0;
+        for (uint8_t id = from; id != 0 && id <= last; ++id)
+        {
+            const uint8_t len = serialize(id, entry);
+            if (len == 0)
+                continue;
+            update(id, entry, len);
+            if (!changedSince(id, since))
+                continue;
+            if (LUA_BATCH_HEADER + LUA_BATCH_ENTRY_HDR + len > maxLen)
+            {
+                // Never fits, left to a chunked read
+                if (pos + LUA_BATCH_ENTRY_HDR > maxLen)
+                {
+                    next = id;
+                    break;
+                }
+                out[pos++] = id;
+                out[pos++] = 0;
+                continue;
+            }
+            if (pos + LUA_BATCH_ENTRY_HDR + len > maxLen)
+            {
+                next = id;
+                break;
+            }
+            out[pos++] = id;
+            out[pos++] = len;
+            memcpy(&out[pos], entry, len);
+            pos += len;
+        }
+        out[0] = LUA_FIELD_BATCH;
+        out[1] = from;
+        out[2] = next;
+        // Changes found while building are in this version
+        out[3] = version;
+        return pos;
+    }
+
+private:
+    static uint16_t fletcher16(const uint8_t *data, uint8_t len)
+    {
+        uint16_t a = 0, b = 0;
+        while (len--)
+        {
+            a = (a + *data++) % 255;
+            b = (b + a) % 255;
+        }
+        return (b << 8) | a;
+    }
+
+    uint8_t version;
+    uint8_t fieldVersion[LUA_MAX_PARAMS]; // 0 = not seen yet
+    uint16_t checksum[LUA_MAX_PARAMS];
+};
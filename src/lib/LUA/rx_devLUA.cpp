@@ -1,5 +1,6 @@
 #ifdef TARGET_RX
 
+#include <functional>
 #include "common.h"
 #include "device.h"
 
@@ -11,14 +12,21 @@
 #include "OTA.h"
 #include "hwTimer.h"
 #include "FHSS.h"
+#include "LQWindows.h"
+#include "devCRSF.h"
+#include "RCOutputScheduler.h"
 
 extern void deferExecution(uint32_t ms, std::function<void()> f);
 
+extern LQWindows uplinkLQWindows;
 extern bool InLoanBindingMode;
 extern bool returnModelFromLoan;
 
 static const char emptySpace[1] = {0};
 static char modelString[] = "000";
+static char lqWindowsString[12];   // "100/100/100"
+static char lqBurstsString[48];    // count of each burst length, '/' separated
+static char rcOutputString[20];    // "2/12us 0", average/max jitter and frames missed
 
 #ifdef POWER_OUTPUT_VALUES
 static char strPowerLevels[] = "10;25;50;100;250;500;1000;2000";
@@ -50,6 +58,21 @@ static struct luaItem_string luaModelNumber = {
     modelString
 };
 
+static struct luaItem_string luaLQWindows = {
+    {"LQ .1/1/10s", CRSF_INFO},
+    lqWindowsString
+};
+
+static struct luaItem_string luaLossBursts = {
+    {"Loss 1/2/4..", CRSF_INFO},
+    lqBurstsString
+};
+
+static struct luaItem_string luaRCOutput = {
+    {"FC Jitter", CRSF_INFO},
+    rcOutputString
+};
+
 static struct luaItem_string luaELRSversion = {
     {version, CRSF_INFO},
     commit
@@ -145,6 +168,9 @@ static void registerLuaParameters()
   });
 
   registerLUAParameter(&luaModelNumber);
+  registerLUAParameter(&luaLQWindows);
+  registerLUAParameter(&luaLossBursts);
+  registerLUAParameter(&luaRCOutput);
   registerLUAParameter(&luaELRSversion);
   registerLUAParameter(NULL);
 }
@@ -173,8 +199,50 @@ static int event()
   return DURATION_IMMEDIATELY;
 }
 
+static void luadevUpdateLQWindows()
+{
+  char *out = lqWindowsString;
+  for (uint8_t w = LQ_WINDOW_SHORT; w <= LQ_WINDOW_LONG; w++)
+  {
+    if (w != LQ_WINDOW_SHORT)
+      *out++ = '/';
+    itoa(uplinkLQWindows.getLQ((lq_window_e)w), out, 10);
+    out += strlen(out);
+  }
+
+  out = lqBurstsString;
+  for (uint8_t bin = 0; bin < LQ_BURST_BINS; bin++)
+  {
+    if (bin)
+      *out++ = '/';
+    itoa(uplinkLQWindows.getBurstCount(bin), out, 10);
+    out += strlen(out);
+  }
+}
+
+static void luadevUpdateRCOutput()
+{
+  const RCOutputScheduler *rcOutput = crsfGetRCOutput();
+  char *out = rcOutputString;
+  itoa(rcOutput->getAvgJitter(), out, 10);
+  strcat(out, "/");
+  itoa(rcOutput->getMaxJitter(), out + strlen(out), 10);
+  strcat(out, "us ");
+  itoa(rcOutput->getMissed(), out + strlen(out), 10);
+}
+
 static int timeout()
 {
+  // Keep the link quality info fresh for whenever it is read
+  static uint32_t lastLQUpdate;
+  const uint32_t now = millis();
+  if (now - lastLQUpdate >= 1000)
+  {
+    lastLQUpdate = now;
+    luadevUpdateLQWindows();
+    luadevUpdateRCOutput();
+  }
+
   luaHandleUpdateParameter();
   return DURATION_IMMEDIATELY;
 }
@@ -182,6 +250,8 @@ static int timeout()
 static int start()
 {
   registerLuaParameters();
+  luadevUpdateLQWindows();
+  luadevUpdateRCOutput();
   event();
   return DURATION_IMMEDIATELY;
 }
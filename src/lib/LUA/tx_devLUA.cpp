@@ -108,6 +108,16 @@ static struct luaItem_string luaInfo = {
     emptySpace
 };
 
+static struct luaItem_string luaCollisions = {
+    {"Collisions", (crsf_value_type_e)(CRSF_INFO | CRSF_FIELD_ELRS_HIDDEN)},
+    emptySpace
+};
+
+static struct luaItem_string luaSyncJitter = {
+    {"Sync Jitter", CRSF_INFO},
+    emptySpace
+};
+
 static struct luaItem_string luaELRSversion = {
     {version_domain, CRSF_INFO},
     commit
@@ -232,6 +242,8 @@ static struct luaItem_selection luaDvrStopDelay = {
 //---------------------------- BACKPACK ------------------
 
 static char luaBadGoodString[10];
+static char luaCollisionsString[11];
+static char luaSyncJitterString[32];
 
 extern TxConfig config;
 extern void VtxTriggerSend();
@@ -502,6 +514,41 @@ static void luadevUpdateBadGood()
   itoa(CRSF::GoodPktsCountResult, luaBadGoodString + strlen(luaBadGoodString), 10);
 }
 
+/***
+ * @brief: Update the luaCollisionsString with how many sends ran into the
+ * handset's next RC frame over the same period as the bad/good count
+ * Called from luaRegisterDevicePingCallback
+ ****/
+static void luadevUpdateCollisions()
+{
+  itoa(CRSF::CollisionCountResult, luaCollisionsString, 10);
+}
+
+/***
+ * @brief: Update the luaSyncJitterString with the handset sync target and how
+ * late the handset's frames come, in percent per HANDSET_SYNC_BIN_US, e.g. "100us 61/30/6/2/1/0/0/0"
+ * Called from luaRegisterDevicePingCallback
+ ****/
+static void luadevUpdateSyncJitter()
+{
+  char *pos = luaSyncJitterString;
+  itoa(CRSF::handsetSync.getTarget(), pos, 10);
+  strcat(pos, "us");
+  for (uint8_t bin = 0; bin < HANDSET_SYNC_BINS; ++bin)
+  {
+    pos += strlen(pos);
+    *pos++ = bin == 0 ? ' ' : '/';
+    itoa(CRSF::handsetSync.getHistogramPercent(bin), pos, 10);
+  }
+}
+
+static void luadevUpdateDevicePing()
+{
+  luadevUpdateBadGood();
+  luadevUpdateCollisions();
+  luadevUpdateSyncJitter();
+}
+
 /***
  * @brief: Update the dynamic strings used for folder names and labels
  ***/
@@ -671,6 +718,8 @@ static void registerLuaParameters()
   }
 
   registerLUAParameter(&luaInfo);
+  registerLUAParameter(&luaCollisions);
+  registerLUAParameter(&luaSyncJitter);
   if (strlen(version) < 21) {
     strlcpy(version_domain, version, 21);
     strlcat(version_domain, " ", sizeof(version_domain));
@@ -740,7 +789,9 @@ static int start()
   registerLuaParameters();
 
   setLuaStringValue(&luaInfo, luaBadGoodString);
-  luaRegisterDevicePingCallback(&luadevUpdateBadGood);
+  setLuaStringValue(&luaCollisions, luaCollisionsString);
+  setLuaStringValue(&luaSyncJitter, luaSyncJitterString);
+  luaRegisterDevicePingCallback(&luadevUpdateDevicePing);
 
   luadevUpdateFolderNames();
   event();
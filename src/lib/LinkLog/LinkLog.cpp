@@ -0,0 +1,60 @@
+#include "LinkLog.h"
+
+#if defined(HAS_LINK_LOG)
+#include <string.h>
+
+LinkLog::LinkLog(uint8_t role)
+    : head(0), count(0), total(0), remaining(-1), role(role)
+{
+}
+
+void LinkLog::trigger(uint16_t after)
+{
+    if (remaining < 0)
+        remaining = after;
+}
+
+size_t LinkLog::read(size_t offset, uint8_t *buf, size_t len, uint8_t snrScale, uint8_t rate)
+{
+    size_t copied = 0;
+    if (offset < sizeof(link_log_header_t))
+    {
+        const link_log_header_t header = {
+            .magic = LINK_LOG_MAGIC,
+            .version = LINK_LOG_VERSION,
+            .recordSize = sizeof(link_log_record_t),
+            .role = role,
+            .snrScale = snrScale,
+            .rate = rate,
+            .frozen = isFrozen(),
+            .count = count,
+            .total = total,
+        };
+        copied = sizeof(header) - offset;
+        if (copied > len)
+            copied = len;
+        memcpy(buf, (const uint8_t *)&header + offset, copied);
+        offset += copied;
+    }
+
+    // The records, oldest first, as bytes of one contiguous array
+    const size_t end = exportSize();
+    const uint16_t oldest = (head + LINK_LOG_RECORDS - count) % LINK_LOG_RECORDS;
+    while (copied < len && offset < end)
+    {
+        const size_t pos = offset - sizeof(link_log_header_t);
+        const uint16_t idx = (oldest + pos / sizeof(link_log_record_t)) % LINK_LOG_RECORDS;
+        const size_t within = pos % sizeof(link_log_record_t);
+        size_t n = sizeof(link_log_record_t) - within;
+        if (n > len - copied)
+            n = len - copied;
+        memcpy(&buf[copied], (const uint8_t *)&records[idx] + within, n);
+        copied += n;
+        offset += n;
+    }
+
+    if (offset == end && copied)
+        rearm();
+    return copied;
+}
+#endif
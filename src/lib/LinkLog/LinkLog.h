@@ -0,0 +1,112 @@
+#pragma once
+
+#include "targets.h"
+
+// Only the ESP targets can hand the log over, on WiFi, and the records take
+// a lot of RAM so it is only built in with DEBUG_LINK_LOG
+#if defined(DEBUG_LINK_LOG) && defined(PLATFORM_ESP32)
+#define HAS_LINK_LOG
+#define LINK_LOG_RECORDS 4096 // 48kB
+#elif defined(DEBUG_LINK_LOG) && defined(PLATFORM_ESP8266)
+#define HAS_LINK_LOG
+#define LINK_LOG_RECORDS 768 // 9kB
+#elif defined(TARGET_NATIVE)
+#define HAS_LINK_LOG
+#define LINK_LOG_RECORDS 64
+#endif
+
+#define LINK_LOG_MAGIC      0x474C4C45 // "ELLG"
+#define LINK_LOG_VERSION    1
+
+#define LINK_LOG_ROLE_TX    0
+#define LINK_LOG_ROLE_RX    1
+
+// link_log_record_t flags
+#define LINK_LOG_RECEIVED   0x01 // a good packet was received in this slot
+#define LINK_LOG_CRC_ERROR  0x02 // a packet was received but failed its CRC
+#define LINK_LOG_ANTENNA    0x04 // the antenna in use, rssi[1] is the fresh reading if set
+#define LINK_LOG_TELEMETRY  0x08 // a telemetry slot, sent by the RX and received by the TX
+#define LINK_LOG_FREQ_ERROR 0x10 // freqError holds a reading
+#define LINK_LOG_CONNECTED  0x20 // connectionState was connected
+
+/**
+ * One packet slot, written from the timer ISR
+ */
+typedef struct {
+    uint16_t timeMs;    // low 16 bits of millis()
+    uint8_t  nonce;
+    uint8_t  fhssIndex; // the channel hopped to, from FHSSsequence[]
+    int8_t   rssi[2];   // dBm, the latest reading of each antenna
+    int8_t   snr;       // RADIO_SNR_SCALE units
+    uint8_t  flags;
+    int16_t  freqError; // raw from the radio, clamped
+    int16_t  pfdOffset; // us, RX only
+} __attribute__((packed)) link_log_record_t;
+
+/**
+ * Precedes the records in the exported blob, the records follow oldest first
+ */
+typedef struct {
+    uint32_t magic;
+    uint8_t  version;
+    uint8_t  recordSize;
+    uint8_t  role;
+    uint8_t  snrScale;
+    uint8_t  rate;      // enum_rate when exported
+    uint8_t  frozen;    // recording stopped after a connection loss
+    uint16_t count;     // records in the blob
+    uint32_t total;     // records written since boot
+} __attribute__((packed)) link_log_header_t;
+
+/**
+ * Ring of per-packet link records kept in RAM, so a fade or interference can
+ * be looked at after the flight by downloading it over WiFi (the radio is
+ * stopped then, so nothing is written while it is read).
+ *
+ * The first connection loss starts a countdown after which recording stops,
+ * keeping what led up to the failsafe instead of the time spent without a link
+ * that follows. Downloading the log starts recording again.
+ */
+class LinkLog
+{
+public:
+    explicit LinkLog(uint8_t role);
+
+    void ICACHE_RAM_ATTR add(link_log_record_t const &rec)
+    {
+        if (remaining == 0)
+            return;
+        records[head] = rec;
+        head = (head + 1) % LINK_LOG_RECORDS;
+        if (count < LINK_LOG_RECORDS)
+            ++count;
+        ++total;
+        if (remaining > 0)
+            --remaining;
+    }
+
+    // Stop recording after `after` more records, unless already counting down
+    void trigger(uint16_t after);
+    // Keep recording, with the records so far kept
+    void rearm() { remaining = -1; }
+    bool isFrozen() const { return remaining == 0; }
+
+    uint16_t getCount() const { return count; }
+    uint32_t getTotal() const { return total; }
+    // The size of the blob read() returns
+    size_t exportSize() const { return sizeof(link_log_header_t) + count * sizeof(link_log_record_t); }
+
+    /**
+     * Copy part of the exported blob, in pieces as a chunked HTTP response asks for them
+     * Returns: the number of bytes copied, 0 once offset is past the end
+     **/
+    size_t read(size_t offset, uint8_t *buf, size_t len, uint8_t snrScale, uint8_t rate);
+
+private:
+    link_log_record_t records[LINK_LOG_RECORDS];
+    uint16_t head;
+    uint16_t count;
+    uint32_t total;
+    int32_t remaining; // records before recording stops, -1 to keep going
+    const uint8_t role;
+};
@@ -0,0 +1,263 @@
+#include "mavlink_serial.h"
+#include "crc.h"
+#include <cstring>
+
+extern GENERIC_CRC8 crsf_crc;
+
+#define MAVLINK_CRC_EXTRA_RC_CHANNELS_OVERRIDE 124
+#define MAVLINK_CRC_EXTRA_RADIO_STATUS 185
+
+// The ids a SiK radio uses for its RADIO_STATUS, which ArduPilot recognises
+#define MAVLINK_RADIO_SYS_ID '3'
+#define MAVLINK_RADIO_COMP_ID 'D'
+// RC overrides are only accepted from the GCS
+#define MAVLINK_GCS_SYS_ID 255
+#define MAVLINK_GCS_COMP_ID 190
+
+MAVLinkSerial::MAVLinkSerial()
+    : FramesIn(0), FramesDropped(0), seq(0), fcSysId(1), fcCompId(MAVLINK_COMP_ID_AUTOPILOT)
+{
+    Reset();
+}
+
+void MAVLinkSerial::Reset()
+{
+    for (uint8_t q = 0; q < QUEUE_COUNT; ++q)
+    {
+        queue[q].flush();
+        committed[q] = 0;
+    }
+    headerLen = 0;
+    bodyRemaining = 0;
+    target = QUEUE_NONE;
+    splitRemaining = 0;
+}
+
+uint16_t MAVLinkSerial::Checksum(const uint8_t *data, uint32_t len, uint16_t crc)
+{
+    // CRC-16/MCRF4XX as used by MAVLink
+    while (len--)
+    {
+        uint8_t tmp = *data++ ^ (uint8_t)crc;
+        tmp ^= tmp << 4;
+        crc = (crc >> 8) ^ (tmp << 8) ^ (tmp << 3) ^ (tmp >> 4);
+    }
+    return crc;
+}
+
+void MAVLinkSerial::RXhandleUARTin(uint8_t data)
+{
+    if (bodyRemaining)
+    {
+        if (target != QUEUE_NONE)
+        {
+            queue[target].push(data);
+        }
+        if (--bodyRemaining == 0 && target != QUEUE_NONE)
+        {
+            committed[target] = queue[target].size();
+            ++FramesIn;
+        }
+        return;
+    }
+
+    if (headerLen == 0 && data != MAVLINK_V1_STX && data != MAVLINK_V2_STX)
+    {
+        return;
+    }
+    header[headerLen++] = data;
+    if (headerLen == (header[0] == MAVLINK_V1_STX ? MAVLINK_V1_HEADER_LEN : MAVLINK_V2_HEADER_LEN))
+    {
+        frameHeaderComplete();
+    }
+}
+
+void MAVLinkSerial::frameHeaderComplete()
+{
+    const bool v1 = header[0] == MAVLINK_V1_STX;
+    const bool isSigned = !v1 && (header[2] & MAVLINK_IFLAG_SIGNED);
+    const uint16_t frameLen = headerLen + header[1] + MAVLINK_CHECKSUM_LEN + (isSigned ? MAVLINK_SIGNATURE_LEN : 0);
+    const uint32_t msgId = v1 ? header[5] : (header[7] | (header[8] << 8) | ((uint32_t)header[9] << 16));
+    const uint8_t sysId = header[v1 ? 3 : 5];
+    const uint8_t compId = header[v1 ? 4 : 6];
+
+    // Learn who to address the RC overrides to
+    if (msgId == MAVLINK_MSG_ID_HEARTBEAT && compId == MAVLINK_COMP_ID_AUTOPILOT)
+    {
+        fcSysId = sysId;
+        fcCompId = compId;
+    }
+
+    const bool priority = (msgId == MAVLINK_MSG_ID_HEARTBEAT || msgId == MAVLINK_MSG_ID_ATTITUDE || msgId == MAVLINK_MSG_ID_ATTITUDE_QUATERNION) &&
+                          frameLen <= MAVLINK_ENVELOPE_MAX_DATA;
+    target = priority ? QUEUE_PRIORITY : QUEUE_BULK;
+    if (queue[target].free() < frameLen + 2)
+    {
+        // The rest of the frame is skipped
+        target = QUEUE_NONE;
+        ++FramesDropped;
+    }
+    else
+    {
+        queue[target].pushSize(frameLen);
+        queue[target].pushBytes(header, headerLen);
+    }
+    bodyRemaining = frameLen - headerLen;
+    headerLen = 0;
+}
+
+uint8_t MAVLinkSerial::fillEnvelope(uint8_t *data, uint8_t maxLen)
+{
+    uint8_t dataLen = 0;
+    for (uint8_t q = 0; q < QUEUE_COUNT; ++q)
+    {
+        while (committed[q])
+        {
+            const uint16_t frameLen = queue[q].peekSize();
+            if (dataLen + frameLen > maxLen)
+            {
+                // Priority frames always go before bulk ones
+                return dataLen;
+            }
+            queue[q].popSize();
+            queue[q].popBytes(&data[dataLen], frameLen);
+            committed[q] -= frameLen + 2;
+            dataLen += frameLen;
+        }
+    }
+    return dataLen;
+}
+
+bool MAVLinkSerial::GetNextPayload(uint8_t *nextPayloadSize, uint8_t **payloadData)
+{
+    uint8_t *data = &envelope[MAVLINK_ENVELOPE_HEADER_LEN];
+    uint8_t dataLen = 0;
+    uint8_t chunks = 1 << 4;
+
+    if (splitRemaining == 0)
+    {
+        dataLen = fillEnvelope(data, MAVLINK_ENVELOPE_MAX_DATA);
+        if (dataLen == 0 && committed[QUEUE_BULK])
+        {
+            // The next frame doesn't fit in one envelope so it gets a series of its own
+            splitRemaining = queue[QUEUE_BULK].popSize();
+            committed[QUEUE_BULK] -= 2;
+            splitChunks = (splitRemaining + MAVLINK_ENVELOPE_MAX_DATA - 1) / MAVLINK_ENVELOPE_MAX_DATA;
+            splitChunk = 0;
+        }
+    }
+
+    if (splitRemaining)
+    {
+        dataLen = splitRemaining < MAVLINK_ENVELOPE_MAX_DATA ? splitRemaining : MAVLINK_ENVELOPE_MAX_DATA;
+        queue[QUEUE_BULK].popBytes(data, dataLen);
+        committed[QUEUE_BULK] -= dataLen;
+        splitRemaining -= dataLen;
+        chunks = (splitChunks << 4) | splitChunk++;
+    }
+
+    if (dataLen == 0)
+    {
+        *nextPayloadSize = 0;
+        return false;
+    }
+
+    envelope[0] = CRSF_SYNC_BYTE;
+    envelope[1] = dataLen + MAVLINK_ENVELOPE_HEADER_LEN - CRSF_FRAME_NOT_COUNTED_BYTES + 1;
+    envelope[2] = CRSF_FRAMETYPE_MAVLINK_ENVELOPE;
+    envelope[3] = chunks;
+    envelope[4] = dataLen;
+    envelope[MAVLINK_ENVELOPE_HEADER_LEN + dataLen] = crsf_crc.calc(&envelope[2], dataLen + MAVLINK_ENVELOPE_HEADER_LEN - 2);
+
+    *nextPayloadSize = CRSF_FRAME_SIZE(envelope[1]);
+    *payloadData = envelope;
+    return true;
+}
+
+uint8_t MAVLinkSerial::TxBufferFree()
+{
+    return queue[QUEUE_BULK].free() * 100 / MAVLINK_QUEUE_SIZE;
+}
+
+uint8_t MAVLinkSerial::UnwrapEnvelope(const uint8_t *frame, const uint8_t **data)
+{
+    const uint8_t dataLen = frame[4];
+    if (frame[CRSF_TELEMETRY_TYPE_INDEX] != CRSF_FRAMETYPE_MAVLINK_ENVELOPE || dataLen > MAVLINK_ENVELOPE_MAX_DATA)
+    {
+        return 0;
+    }
+    *data = &frame[MAVLINK_ENVELOPE_HEADER_LEN];
+    return dataLen;
+}
+
+uint8_t MAVLinkSerial::buildFrame(uint8_t *frame, uint8_t sysId, uint8_t compId, uint32_t msgId,
+                                  const uint8_t *payload, uint8_t len, uint8_t crcExtra)
+{
+    // MAVLink2 leaves off trailing zeros from the payload
+    while (len > 1 && payload[len - 1] == 0)
+    {
+        --len;
+    }
+
+    frame[0] = MAVLINK_V2_STX;
+    frame[1] = len;
+    frame[2] = 0; // incompat flags
+    frame[3] = 0; // compat flags
+    frame[4] = seq++;
+    frame[5] = sysId;
+    frame[6] = compId;
+    frame[7] = msgId;
+    frame[8] = msgId >> 8;
+    frame[9] = msgId >> 16;
+    memcpy(&frame[MAVLINK_V2_HEADER_LEN], payload, len);
+
+    uint16_t crc = Checksum(&frame[1], MAVLINK_V2_HEADER_LEN - 1 + len);
+    crc = Checksum(&crcExtra, 1, crc);
+    frame[MAVLINK_V2_HEADER_LEN + len] = crc;
+    frame[MAVLINK_V2_HEADER_LEN + len + 1] = crc >> 8;
+    return MAVLINK_V2_HEADER_LEN + len + MAVLINK_CHECKSUM_LEN;
+}
+
+uint8_t MAVLinkSerial::BuildRadioStatus(uint8_t *frame, uint8_t rssi, uint8_t remrssi, uint16_t rxerrors)
+{
+    const uint8_t payload[] = {
+        (uint8_t)rxerrors, (uint8_t)(rxerrors >> 8),
+        0, 0, // fixed
+        rssi,
+        remrssi,
+        TxBufferFree(),
+        0, // noise
+        0  // remnoise
+    };
+    const uint8_t len = buildFrame(frame, MAVLINK_RADIO_SYS_ID, MAVLINK_RADIO_COMP_ID, MAVLINK_MSG_ID_RADIO_STATUS,
+                                   payload, sizeof(payload), MAVLINK_CRC_EXTRA_RADIO_STATUS);
+
+    // The GCS gets a copy, unless a frame from the FC is part way into the queue
+    FIFO_GENERIC<MAVLINK_QUEUE_SIZE> &q = queue[QUEUE_PRIORITY];
+    if (!(bodyRemaining && target == QUEUE_PRIORITY) && q.free() >= len + 2)
+    {
+        q.pushSize(len);
+        q.pushBytes(frame, len);
+        committed[QUEUE_PRIORITY] = q.size();
+    }
+    return len;
+}
+
+uint8_t MAVLinkSerial::BuildRcOverride(uint8_t *frame, const uint32_t *channels)
+{
+    // chan1-8, target system and component, chan9-18
+    uint8_t payload[38] = {0};
+    for (uint8_t ch = 0; ch < CRSF_NUM_CHANNELS; ++ch)
+    {
+        const uint16_t us = CRSF_to_US(channels[ch]);
+        const uint8_t pos = ch < 8 ? ch * 2 : ch * 2 + 2;
+        payload[pos] = us;
+        payload[pos + 1] = us >> 8;
+    }
+    payload[16] = fcSysId;
+    payload[17] = fcCompId;
+    // chan17 and chan18 are left at 0, ignored
+
+    return buildFrame(frame, MAVLINK_GCS_SYS_ID, MAVLINK_GCS_COMP_ID, MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE,
+                      payload, sizeof(payload), MAVLINK_CRC_EXTRA_RC_CHANNELS_OVERRIDE);
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include "FIFO_GENERIC.h"
+#include "crsf_protocol.h"
+
+#define MAVLINK_V1_STX 0xFE
+#define MAVLINK_V2_STX 0xFD
+#define MAVLINK_V1_HEADER_LEN 6  // stx len seq sysid compid msgid
+#define MAVLINK_V2_HEADER_LEN 10 // stx len incompat compat seq sysid compid msgid(3)
+#define MAVLINK_CHECKSUM_LEN 2
+#define MAVLINK_SIGNATURE_LEN 13
+#define MAVLINK_IFLAG_SIGNED 0x01
+#define MAVLINK_MAX_FRAME_LEN (MAVLINK_V2_HEADER_LEN + 255 + MAVLINK_CHECKSUM_LEN + MAVLINK_SIGNATURE_LEN)
+
+#define MAVLINK_MSG_ID_HEARTBEAT 0
+#define MAVLINK_MSG_ID_ATTITUDE 30
+#define MAVLINK_MSG_ID_ATTITUDE_QUATERNION 31
+#define MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE 70
+#define MAVLINK_MSG_ID_RADIO_STATUS 109
+
+#define MAVLINK_COMP_ID_AUTOPILOT 1
+
+// [sync] [len] [type] [chunks] [data_size] data... [crc]
+#define MAVLINK_ENVELOPE_HEADER_LEN 5
+#define MAVLINK_ENVELOPE_MAX_DATA (CRSF_MAX_PACKET_LEN - MAVLINK_ENVELOPE_HEADER_LEN - 1)
+
+// Each of the priority and bulk queues, holding frames waiting to go down the link
+#define MAVLINK_QUEUE_SIZE 512
+
+/**
+ * Transparent MAVLink on the receiver UART.
+ *
+ * MAVLink from the FC is split into frames by their length alone (the CRC
+ * can't be checked without the message definitions), and each frame queued
+ * whole to go down the link. HEARTBEAT and attitude frames have their own
+ * queue which is always emptied first. GetNextPayload() packs as many whole
+ * frames as fit into a CRSF MAVLink envelope for the TelemetrySender; frames
+ * longer than one envelope are sent alone across consecutive envelopes so a
+ * frame never has another interleaved into it.
+ *
+ * Envelopes coming up the link are unwrapped and written to the FC as is.
+ * RADIO_STATUS reports how full the downlink queue is, which ArduPilot uses
+ * to slow its streams before frames start being dropped, and the same status
+ * goes down to the GCS. RC comes in as RC_CHANNELS_OVERRIDE.
+ */
+class MAVLinkSerial
+{
+public:
+    MAVLinkSerial();
+    void Reset();
+
+    // A byte from the FC
+    void RXhandleUARTin(uint8_t data);
+    // Same contract as Telemetry::GetNextPayload, the data stays valid until the next call
+    bool GetNextPayload(uint8_t *nextPayloadSize, uint8_t **payloadData);
+    // Percentage of the downlink queue which is free
+    uint8_t TxBufferFree();
+
+    /**
+     * The MAVLink data in a CRSF frame which came up the link
+     * Returns: the number of bytes at *data, 0 if this isn't a MAVLink envelope
+     **/
+    static uint8_t UnwrapEnvelope(const uint8_t *frame, const uint8_t **data);
+
+    /**
+     * Build a frame to send to the FC, frame needs MAVLINK_MAX_FRAME_LEN bytes
+     * Returns: the frame length
+     **/
+    uint8_t BuildRadioStatus(uint8_t *frame, uint8_t rssi, uint8_t remrssi, uint16_t rxerrors);
+    uint8_t BuildRcOverride(uint8_t *frame, const uint32_t *channels); // CRSF channel values
+
+    uint32_t FramesIn;
+    uint32_t FramesDropped;
+
+    static uint16_t Checksum(const uint8_t *data, uint32_t len, uint16_t crc = 0xFFFF);
+
+private:
+    enum {
+        QUEUE_PRIORITY,
+        QUEUE_BULK,
+        QUEUE_COUNT,
+        QUEUE_NONE = QUEUE_COUNT
+    };
+    FIFO_GENERIC<MAVLINK_QUEUE_SIZE> queue[QUEUE_COUNT];
+    uint32_t committed[QUEUE_COUNT]; // bytes of each queue which are complete frames
+
+    // frame being received from the FC
+    uint8_t header[MAVLINK_V2_HEADER_LEN];
+    uint8_t headerLen;
+    uint16_t bodyRemaining;
+    uint8_t target;
+
+    // frame too long for one envelope which is part way through being sent
+    uint16_t splitRemaining;
+    uint8_t splitChunk;
+    uint8_t splitChunks;
+
+    uint8_t envelope[CRSF_MAX_PACKET_LEN];
+    uint8_t seq;
+    uint8_t fcSysId;
+    uint8_t fcCompId;
+
+    void frameHeaderComplete();
+    uint8_t fillEnvelope(uint8_t *data, uint8_t maxLen);
+    uint8_t buildFrame(uint8_t *frame, uint8_t sysId, uint8_t compId, uint32_t msgId,
+                       const uint8_t *payload, uint8_t len, uint8_t crcExtra);
+};
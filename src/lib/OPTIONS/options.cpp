@@ -120,6 +120,16 @@ __attribute__ ((used)) const firmware_options_t firmwareOptions = {
 #else
     .r9mm_mini_sbus = false,
 #endif
+#if defined(RCVR_MAVLINK)
+    .rcvr_mavlink = true,
+#else
+    .rcvr_mavlink = false,
+#endif
+#if defined(RCVR_OUTPUT_RATE)
+    .rcvr_output_rate = RCVR_OUTPUT_RATE,
+#else
+    .rcvr_output_rate = 0,
+#endif
 #endif
 #if defined(TARGET_TX)
 #if defined(TLM_REPORT_INTERVAL_MS)
@@ -217,6 +227,9 @@ const char PROGMEM compile_options[] = {
     #ifdef RCVR_INVERT_TX
         "-DRCVR_INVERT_TX "
     #endif
+    #ifdef RCVR_MAVLINK
+        "-DRCVR_MAVLINK "
+    #endif
     #ifdef USE_R9MM_R9MINI_SBUS
         "-DUSE_R9MM_R9MINI_SBUS "
     #endif
@@ -372,6 +385,8 @@ bool options_init()
     firmwareOptions.uart_baud = doc["rcvr-uart-baud"] | 420000;
     firmwareOptions.invert_tx = doc["rcvr-invert-tx"] | false;
     firmwareOptions.lock_on_first_connection = doc["lock-on-first-connection"] | true;
+    firmwareOptions.rcvr_mavlink = doc["rcvr-mavlink"] | false;
+    firmwareOptions.rcvr_output_rate = doc["rcvr-output-rate"] | 0;
     #endif
     firmwareOptions.domain = doc["domain"] | 0;
 
@@ -404,6 +419,8 @@ void saveOptions()
     doc["rcvr-uart-baud"] = firmwareOptions.uart_baud;
     doc["rcvr-invert-tx"] = firmwareOptions.invert_tx;
     doc["lock-on-first-connection"] = firmwareOptions.lock_on_first_connection;
+    doc["rcvr-mavlink"] = firmwareOptions.rcvr_mavlink;
+    doc["rcvr-output-rate"] = firmwareOptions.rcvr_output_rate;
     #endif
     doc["domain"] = firmwareOptions.domain;
 
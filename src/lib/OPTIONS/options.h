@@ -38,6 +38,8 @@ typedef struct _options {
     bool        invert_tx:1;
     bool        lock_on_first_connection:1;
     bool        r9mm_mini_sbus:1;
+    bool        rcvr_mavlink:1;     // MAVLink on the UART instead of CRSF
+    uint16_t    rcvr_output_rate;   // Hz of RC frames to the FC, 0 for every packet
 #endif
 #if defined(TARGET_TX)
     uint32_t    tlm_report_interval;
@@ -0,0 +1,106 @@
+#include "DvdaCombiner.h"
+
+// The bits which are the same in every RC packet of a DVDA group: the packet
+// type, the 4x 10-bit channels and ch4. crcHigh/crcLow/switches may differ.
+static const uint8_t SharedBitsMask[OTA4_PACKET_SIZE] = {
+    0x03, 0xff, 0xff, 0xff, 0xff, 0xff, 0x80, 0x00
+};
+static_assert(sizeof(OTA_Packet4_s) == OTA4_PACKET_SIZE, "SharedBitsMask must cover OTA_Packet4_s");
+
+bool ICACHE_RAM_ATTR DvdaCombiner::tryCandidate(OTA_Packet4_s const * const candidate)
+{
+    // Only RC data is repeated within the group
+    if (candidate->type != PACKET_TYPE_RCDATA)
+        return false;
+
+    OTA_Packet_s pkt;
+    pkt.std = *candidate;
+    return OtaValidatePacketCrc(&pkt);
+}
+
+bool ICACHE_RAM_ATTR DvdaCombiner::add(OTA_Packet_s * const otaPktPtr, uint8_t const group)
+{
+    // DVDA is only used with the 4-byte packets
+    if (OtaIsFullRes)
+        return false;
+
+    if (group != currentGroup)
+    {
+        count = 0;
+        currentGroup = group;
+    }
+
+    OTA_Packet4_s * const current = &otaPktPtr->std;
+    if (count > 0)
+    {
+        OTA_Packet4_s candidate = *current;
+        uint8_t * const cand = (uint8_t *)&candidate;
+        uint8_t const copyCount = count + 1;
+
+        // Vote each shared bit, recording where the copies disagree
+        uint8_t tryByte[DVDA_COMBINER_MAX_TRY_BITS];
+        uint8_t tryMask[DVDA_COMBINER_MAX_TRY_BITS];
+        unsigned disagreeCount = 0;
+        for (unsigned i = 0; i < OTA4_PACKET_SIZE; ++i)
+        {
+            for (uint8_t bit = 0x01; bit != 0; bit <<= 1)
+            {
+                if (!(SharedBitsMask[i] & bit))
+                    continue;
+
+                unsigned ones = (cand[i] & bit) ? 1 : 0;
+                for (unsigned c = 0; c < count; ++c)
+                    ones += (((uint8_t *)&copies[c])[i] & bit) ? 1 : 0;
+                if (ones == 0 || ones == copyCount)
+                    continue;
+
+                // A strict majority wins, a tie keeps the current copy's bit
+                if (ones * 2 > copyCount)
+                    cand[i] |= bit;
+                else if (ones * 2 < copyCount)
+                    cand[i] &= ~bit;
+
+                if (disagreeCount < DVDA_COMBINER_MAX_TRY_BITS)
+                {
+                    tryByte[disagreeCount] = i;
+                    tryMask[disagreeCount] = bit;
+                }
+                ++disagreeCount;
+            }
+        }
+
+        // With two copies the vote is just the current copy, which already failed
+        bool found = copyCount > 2 && tryCandidate(&candidate);
+
+        // Then every combination of the disagreeing bits, if there are few enough
+        // that the extra CRC checks don't noticeably raise the chance of a false match
+        if (!found && disagreeCount <= DVDA_COMBINER_MAX_TRY_BITS)
+        {
+            for (unsigned combo = 1; combo < (1U << disagreeCount) && !found; ++combo)
+            {
+                OTA_Packet4_s trial = candidate;
+                for (unsigned b = 0; b < disagreeCount; ++b)
+                {
+                    if (combo & (1U << b))
+                        ((uint8_t *)&trial)[tryByte[b]] ^= tryMask[b];
+                }
+                if (tryCandidate(&trial))
+                {
+                    candidate = trial;
+                    found = true;
+                }
+            }
+        }
+
+        if (found)
+        {
+            *current = candidate;
+            count = 0;
+            return true;
+        }
+    }
+
+    if (count < DVDA_COMBINER_MAX_COPIES)
+        copies[count++] = *current;
+    return false;
+}
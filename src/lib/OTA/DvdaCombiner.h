@@ -0,0 +1,49 @@
+#pragma once
+
+#include "targets.h"
+#include "OTA.h"
+
+// Most copies held, a DVDA group is at most 4 sends and the last never needs storing
+#define DVDA_COMBINER_MAX_COPIES    3
+// Most disagreeing bits tried in all combinations, 2^N CRC checks worst case.
+// Each extra check is another chance for noise to pass the 14-bit CRC, so at
+// most the vote and one flipped bit are tried, 2 candidates per copy.
+#define DVDA_COMBINER_MAX_TRY_BITS  1
+
+/**
+ * Recovers DVDA RC packets where no single copy passed the CRC check.
+ *
+ * In DVDA modes the TX sends the same channel data numOfSends times per group,
+ * but the CRC and switch bits differ per copy (the switch index rotates and Wide
+ * mode injects the nonce into the CRC), so only the type and analog channel bits
+ * are shared between copies. Failed copies of a group are held and each new
+ * failure is repaired by bitwise majority vote of those shared bits across all
+ * copies, then if the copies disagree on a single bit by trying it flipped.
+ * A candidate is only accepted if it passes the normal CRC check for the
+ * current nonce.
+ */
+class DvdaCombiner
+{
+public:
+    DvdaCombiner() { reset(); }
+
+    void ICACHE_RAM_ATTR reset()
+    {
+        count = 0;
+        currentGroup = 0;
+    }
+
+    /**
+     * Add a copy that failed the CRC check to the DVDA group `group`. Copies from
+     * a previous group are discarded.
+     * Returns true if a packet passing the CRC check was recovered into otaPktPtr
+     **/
+    bool add(OTA_Packet_s * const otaPktPtr, uint8_t const group);
+
+private:
+    OTA_Packet4_s copies[DVDA_COMBINER_MAX_COPIES];
+    uint8_t count;
+    uint8_t currentGroup;
+
+    bool tryCandidate(OTA_Packet4_s const * const candidate);
+};
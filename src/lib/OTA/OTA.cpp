@@ -22,6 +22,8 @@ OtaSwitchMode_e OtaSwitchModeCurrent;
 static Crc2Byte ota_crc;
 ValidatePacketCrc_t OtaValidatePacketCrc;
 GeneratePacketCrc_t OtaGeneratePacketCrc;
+#define OTA4_CRC_BITS 14
+#define OTA8_CRC_BITS 16
 
 void OtaUpdateCrcInitFromUid()
 {
@@ -70,7 +72,8 @@ static uint32_t ICACHE_RAM_ATTR Decimate11to10_Div2(uint32_t ch11bit)
  *        Betaflight, but depends on which decimate function is used if it is legacy or CRSFv3 10-bit
  *        destChannels4x10 must be zeroed before this call, the channels are ORed into it
  ***/
-static void ICACHE_RAM_ATTR PackUInt11ToChannels4x10(uint32_t const * const src, OTA_Channels_4x10 * const destChannels4x10, Decimate11to10_fn decimate)
+template <Decimate11to10_fn decimate>
+static void ICACHE_RAM_ATTR PackUInt11ToChannels4x10(uint32_t const * const src, OTA_Channels_4x10 * const destChannels4x10)
 {
     const unsigned DEST_PRECISION = 10; // number of bits for each dest, must be <SRC
     uint8_t *dest = (uint8_t *)destChannels4x10;
@@ -103,28 +106,137 @@ static void ICACHE_RAM_ATTR PackChannelDataHybridCommon(OTA_Packet4_s * const ot
 #else
     // CRSF input is 11bit and OTA will carry only 10bit. Discard the Extended Limits (E.Limits)
     // range and use the full 10bits to carry only 998us - 2012us
-    PackUInt11ToChannels4x10(&crsf->ChannelData[0], &ota4->rc.ch, &Decimate11to10_Limit);
+    PackUInt11ToChannels4x10<Decimate11to10_Limit>(&crsf->ChannelData[0], &ota4->rc.ch);
     ota4->rc.ch4 = CRSF_to_BIT(crsf->ChannelData[4]);
 #endif /* !DEBUG_RCVR_LINKSTATS */
 }
 
+/**
+ * Return the OTA value representation of a Hybrid8 switch, where 0=AUX2 and 6=AUX8
+ */
+static uint8_t ICACHE_RAM_ATTR Hybrid8SwitchToOta(CRSF const * const crsf, uint8_t const switchIdx)
+{
+    // AUX8 is High Resolution 16-pos (4-bit)
+    if (switchIdx == 6)
+        return CRSF_to_N(crsf->ChannelData[6 + 1 + 4], 16);
+
+    // AUX2-7 are Low Resolution, "7pos" 6+center (3-bit)
+    // The output is mapped evenly across 6 output values (0-5)
+    // with a special value 7 indicating the middle so it works
+    // with switches with a middle position as well as 6-position
+    const uint16_t CHANNEL_BIN_COUNT = 6;
+    const uint16_t CHANNEL_BIN_SIZE = (CRSF_CHANNEL_VALUE_MAX - CRSF_CHANNEL_VALUE_MIN) / CHANNEL_BIN_COUNT;
+    uint16_t ch = crsf->ChannelData[switchIdx + 1 + 4];
+    // If channel is within 1/4 a BIN of being in the middle use special value 7
+    if (ch < (CRSF_CHANNEL_VALUE_MID-CHANNEL_BIN_SIZE/4)
+        || ch > (CRSF_CHANNEL_VALUE_MID+CHANNEL_BIN_SIZE/4))
+        return CRSF_to_N(ch, CHANNEL_BIN_COUNT);
+    return 7;
+}
+
+/**
+ * Hybrid8 switch scheduling
+ *
+ * A switch whose OTA value has changed is sent in the next packet, and again
+ * in the packets after that up to HYBRID8_CHANGE_REPEATS times in all so one
+ * lost packet doesn't hold it back a whole round. The other switches are sent
+ * round-robin in the slots left over, and get at least one slot in every
+ * HYBRID8_MAX_CHANGED_RUN + 1 so a switch being moved continuously can't keep
+ * the rest from being refreshed. The index is in the packet so the receiver
+ * doesn't care about the order.
+ */
+#define HYBRID8_SWITCH_COUNT    7
+#define HYBRID8_CHANGE_REPEATS  3
+#define HYBRID8_MAX_CHANGED_RUN 3
+#define HYBRID8_VALUE_UNKNOWN   0xff
+// The next switch index to send round-robin, where 0=AUX2 and 6=AUX8
+static uint8_t Hybrid8NextSwitchIndex;
+// Where to start looking for a changed switch, so several changed together take turns
+static uint8_t Hybrid8NextChangedIndex;
+// Changed switches sent since the last round-robin one
+static uint8_t Hybrid8ChangedRun;
+// The OTA value of each switch when it was last checked, and how many more times to send it
+static uint8_t Hybrid8LastValue[HYBRID8_SWITCH_COUNT] = {
+    HYBRID8_VALUE_UNKNOWN, HYBRID8_VALUE_UNKNOWN, HYBRID8_VALUE_UNKNOWN, HYBRID8_VALUE_UNKNOWN,
+    HYBRID8_VALUE_UNKNOWN, HYBRID8_VALUE_UNKNOWN, HYBRID8_VALUE_UNKNOWN
+};
+static uint8_t Hybrid8Repeats[HYBRID8_SWITCH_COUNT];
+
+#if defined(UNIT_TEST)
+// Send idx next, starting again with all the switches unchanged
+void OtaSetHybrid8NextSwitchIndex(uint8_t idx)
+{
+    Hybrid8NextSwitchIndex = idx;
+    Hybrid8NextChangedIndex = 0;
+    Hybrid8ChangedRun = 0;
+    for (unsigned i = 0; i < HYBRID8_SWITCH_COUNT; ++i)
+    {
+        Hybrid8LastValue[i] = HYBRID8_VALUE_UNKNOWN;
+        Hybrid8Repeats[i] = 0;
+    }
+}
+#endif
+
+/**
+ * Pick the switch to send in this packet and return its OTA value
+ * Outputs: switchIdx
+ */
+static uint8_t ICACHE_RAM_ATTR Hybrid8NextSwitch(CRSF const * const crsf, uint8_t * const switchIdx)
+{
+    uint8_t values[HYBRID8_SWITCH_COUNT];
+    for (unsigned i = 0; i < HYBRID8_SWITCH_COUNT; ++i)
+    {
+        values[i] = Hybrid8SwitchToOta(crsf, i);
+        // Unknown is the first packet, not a change, the round-robin covers it
+        if (values[i] != Hybrid8LastValue[i] && Hybrid8LastValue[i] != HYBRID8_VALUE_UNKNOWN)
+            Hybrid8Repeats[i] = HYBRID8_CHANGE_REPEATS;
+        Hybrid8LastValue[i] = values[i];
+    }
+
+    uint8_t idx = Hybrid8NextChangedIndex;
+    unsigned checked = 0;
+    if (Hybrid8ChangedRun < HYBRID8_MAX_CHANGED_RUN)
+    {
+        while (checked < HYBRID8_SWITCH_COUNT && Hybrid8Repeats[idx] == 0)
+        {
+            idx = (idx + 1) % HYBRID8_SWITCH_COUNT;
+            ++checked;
+        }
+    }
+    else
+        checked = HYBRID8_SWITCH_COUNT;
+
+    if (checked < HYBRID8_SWITCH_COUNT)
+    {
+        Hybrid8NextChangedIndex = (idx + 1) % HYBRID8_SWITCH_COUNT;
+        ++Hybrid8ChangedRun;
+    }
+    else
+    {
+        idx = Hybrid8NextSwitchIndex;
+        Hybrid8NextSwitchIndex = (idx + 1) % HYBRID8_SWITCH_COUNT;
+        Hybrid8ChangedRun = 0;
+    }
+    // A changed switch which comes up round-robin counts as a repeat
+    if (Hybrid8Repeats[idx])
+        --Hybrid8Repeats[idx];
+
+    *switchIdx = idx;
+    return values[idx];
+}
+
 /**
  * Hybrid switches packet encoding for sending over the air
  *
  * Analog channels are reduced to 10 bits to allow for switch encoding
  * Switch[0] is sent on every packet.
- * A 3 bit switch index and 3-4 bit value is used to send the remaining switches
- * in a round-robin fashion.
+ * A 3 bit switch index and 3-4 bit value is used to send the remaining switches,
+ * the changed ones first then the rest in a round-robin fashion.
  *
- * Inputs: crsf.ChannelData, crsf.currentSwitches
- * Outputs: OTA_Packet4_s, side-effects the sentSwitch value
+ * Inputs: crsf.ChannelData
+ * Outputs: OTA_Packet4_s, side-effects the Hybrid8 switch schedule
  */
-// The next switch index to send, where 0=AUX2 and 6=AUX8
-static uint8_t Hybrid8NextSwitchIndex;
-#if defined(UNIT_TEST)
-void OtaSetHybrid8NextSwitchIndex(uint8_t idx) { Hybrid8NextSwitchIndex = idx; }
-#endif
-void ICACHE_RAM_ATTR GenerateChannelDataHybrid8(OTA_Packet_s * const otaPktPtr, CRSF const * const crsf,
+static void ICACHE_RAM_ATTR GenerateChannelDataHybrid8(OTA_Packet_s * const otaPktPtr, CRSF const * const crsf,
                                                 bool const TelemetryStatus, uint8_t const tlmDenom)
 {
     (void)tlmDenom;
@@ -135,27 +247,8 @@ void ICACHE_RAM_ATTR GenerateChannelDataHybrid8(OTA_Packet_s * const otaPktPtr,
     // Actually send switchIndex - 1 in the packet, to shift down 1-7 (0b111) to 0-6 (0b110)
     // If the two high bits are 0b11, the receiver knows it is the last switch and can use
     // that bit to store data
-    uint8_t bitclearedSwitchIndex = Hybrid8NextSwitchIndex;
-    uint8_t value;
-    // AUX8 is High Resolution 16-pos (4-bit)
-    if (bitclearedSwitchIndex == 6)
-        value = CRSF_to_N(crsf->ChannelData[6 + 1 + 4], 16);
-    else
-    {
-        // AUX2-7 are Low Resolution, "7pos" 6+center (3-bit)
-        // The output is mapped evenly across 6 output values (0-5)
-        // with a special value 7 indicating the middle so it works
-        // with switches with a middle position as well as 6-position
-        const uint16_t CHANNEL_BIN_COUNT = 6;
-        const uint16_t CHANNEL_BIN_SIZE = (CRSF_CHANNEL_VALUE_MAX - CRSF_CHANNEL_VALUE_MIN) / CHANNEL_BIN_COUNT;
-        uint16_t ch = crsf->ChannelData[bitclearedSwitchIndex + 1 + 4];
-        // If channel is within 1/4 a BIN of being in the middle use special value 7
-        if (ch < (CRSF_CHANNEL_VALUE_MID-CHANNEL_BIN_SIZE/4)
-            || ch > (CRSF_CHANNEL_VALUE_MID+CHANNEL_BIN_SIZE/4))
-            value = CRSF_to_N(ch, CHANNEL_BIN_COUNT);
-        else
-            value = 7;
-    } // If not 16-pos
+    uint8_t bitclearedSwitchIndex;
+    uint8_t value = Hybrid8NextSwitch(crsf, &bitclearedSwitchIndex);
 
     ota4->rc.switches =
         TelemetryStatus << 6 |
@@ -163,9 +256,6 @@ void ICACHE_RAM_ATTR GenerateChannelDataHybrid8(OTA_Packet_s * const otaPktPtr,
         bitclearedSwitchIndex << 3 |
         // include the switch value
         value;
-
-    // update the sent value
-    Hybrid8NextSwitchIndex = (bitclearedSwitchIndex + 1) % 7;
 }
 
 /**
@@ -194,7 +284,7 @@ static uint8_t ICACHE_RAM_ATTR HybridWideSwitchToOta(CRSF const * const crsf, ui
  * Inputs: crsf.ChannelData, crsf.LinkStatistics.uplink_TX_Power
  * Outputs: OTA_Packet4_s
  **/
-void ICACHE_RAM_ATTR GenerateChannelDataHybridWide(OTA_Packet_s * const otaPktPtr, CRSF const * const crsf,
+static void ICACHE_RAM_ATTR GenerateChannelDataHybridWide(OTA_Packet_s * const otaPktPtr, CRSF const * const crsf,
                                                    bool const TelemetryStatus, uint8_t const tlmDenom)
 {
     OTA_Packet4_s * const ota4 = &otaPktPtr->std;
@@ -223,6 +313,7 @@ void ICACHE_RAM_ATTR GenerateChannelDataHybridWide(OTA_Packet_s * const otaPktPt
     ota4->rc.switches = value;
 }
 
+template <OtaSwitchMode_e switchMode>
 static void ICACHE_RAM_ATTR GenerateChannelData8ch12ch(OTA_Packet8_s * const ota8, CRSF const * const crsf, bool const TelemetryStatus, bool const isHighAux)
 {
     // All channel data is 10 bit apart from AUX1 which is 1 bit
@@ -243,7 +334,7 @@ static void ICACHE_RAM_ATTR GenerateChannelData8ch12ch(OTA_Packet8_s * const ota
     // 16ch isHighAux=true:  low=8 high=12
     uint8_t chSrcLow;
     uint8_t chSrcHigh;
-    if (OtaSwitchModeCurrent == smHybridOr16ch)
+    if (switchMode == smHybridOr16ch)
     {
         // 16ch mode
         if (isHighAux)
@@ -262,8 +353,8 @@ static void ICACHE_RAM_ATTR GenerateChannelData8ch12ch(OTA_Packet8_s * const ota
         chSrcLow = 0;
         chSrcHigh = isHighAux ? 9 : 5;
     }
-    PackUInt11ToChannels4x10(&crsf->ChannelData[chSrcLow], &ota8->rc.chLow, &Decimate11to10_Div2);
-    PackUInt11ToChannels4x10(&crsf->ChannelData[chSrcHigh], &ota8->rc.chHigh, &Decimate11to10_Div2);
+    PackUInt11ToChannels4x10<Decimate11to10_Div2>(&crsf->ChannelData[chSrcLow], &ota8->rc.chLow);
+    PackUInt11ToChannels4x10<Decimate11to10_Div2>(&crsf->ChannelData[chSrcHigh], &ota8->rc.chHigh);
 #endif
 }
 
@@ -271,13 +362,14 @@ static void ICACHE_RAM_ATTR GenerateChannelData8ch(OTA_Packet_s * const otaPktPt
 {
     (void)tlmDenom;
 
-    GenerateChannelData8ch12ch((OTA_Packet8_s * const)otaPktPtr, crsf, TelemetryStatus, false);
+    GenerateChannelData8ch12ch<smWideOr8ch>((OTA_Packet8_s * const)otaPktPtr, crsf, TelemetryStatus, false);
 }
 
 static bool FullResIsHighAux;
 #if defined(UNIT_TEST)
 void OtaSetFullResNextChannelSet(bool next) { FullResIsHighAux = next; }
 #endif
+template <OtaSwitchMode_e switchMode>
 static void ICACHE_RAM_ATTR GenerateChannelData12ch(OTA_Packet_s * const otaPktPtr, CRSF const * const crsf, bool const TelemetryStatus, uint8_t const tlmDenom)
 {
     (void)tlmDenom;
@@ -285,7 +377,7 @@ static void ICACHE_RAM_ATTR GenerateChannelData12ch(OTA_Packet_s * const otaPktP
     // Every time this function is called, the opposite high Aux channels are sent
     // This tries to ensure a fair split of high and low aux channels packets even
     // at 1:2 ratio and around sync packets
-    GenerateChannelData8ch12ch((OTA_Packet8_s * const)otaPktPtr, crsf, TelemetryStatus, FullResIsHighAux);
+    GenerateChannelData8ch12ch<switchMode>((OTA_Packet8_s * const)otaPktPtr, crsf, TelemetryStatus, FullResIsHighAux);
     FullResIsHighAux = !FullResIsHighAux;
 }
 #endif
@@ -359,7 +451,7 @@ static void ICACHE_RAM_ATTR UnpackChannelDataHybridCommon(OTA_Packet4_s const *
  * Output: crsf->ChannelData
  * Returns: TelemetryStatus bit
  */
-bool ICACHE_RAM_ATTR UnpackChannelDataHybridSwitch8(OTA_Packet_s const * const otaPktPtr, CRSF * const crsf,
+static bool ICACHE_RAM_ATTR UnpackChannelDataHybridSwitch8(OTA_Packet_s const * const otaPktPtr, CRSF * const crsf,
                                                     uint8_t const tlmDenom)
 {
     (void)tlmDenom;
@@ -399,7 +491,7 @@ bool ICACHE_RAM_ATTR UnpackChannelDataHybridSwitch8(OTA_Packet_s const * const o
  * Output: crsf.ChannelData, crsf.LinkStatistics.uplink_TX_Power
  * Returns: TelemetryStatus bit
  */
-bool ICACHE_RAM_ATTR UnpackChannelDataHybridWide(OTA_Packet_s const * const otaPktPtr, CRSF * const crsf,
+static bool ICACHE_RAM_ATTR UnpackChannelDataHybridWide(OTA_Packet_s const * const otaPktPtr, CRSF * const crsf,
                                                  uint8_t const tlmDenom)
 {
     static bool TelemetryStatus = false;
@@ -438,7 +530,8 @@ bool ICACHE_RAM_ATTR UnpackChannelDataHybridWide(OTA_Packet_s const * const otaP
     return TelemetryStatus;
 }
 
-bool ICACHE_RAM_ATTR UnpackChannelData8ch(OTA_Packet_s const * const otaPktPtr, CRSF * const crsf, uint8_t const tlmDenom)
+template <OtaSwitchMode_e switchMode>
+static bool ICACHE_RAM_ATTR UnpackChannelData8ch(OTA_Packet_s const * const otaPktPtr, CRSF * const crsf, uint8_t const tlmDenom)
 {
     (void)tlmDenom;
 
@@ -449,7 +542,7 @@ bool ICACHE_RAM_ATTR UnpackChannelData8ch(OTA_Packet_s const * const otaPktPtr,
 #else
     uint8_t chDstLow;
     uint8_t chDstHigh;
-    if (OtaSwitchModeCurrent == smHybridOr16ch)
+    if (switchMode == smHybridOr16ch)
     {
         if (ota8->rc.isHighAux)
         {
@@ -479,20 +572,21 @@ bool ICACHE_RAM_ATTR UnpackChannelData8ch(OTA_Packet_s const * const otaPktPtr,
 }
 #endif
 
-bool ICACHE_RAM_ATTR ValidatePacketCrcFull(OTA_Packet_s * const otaPktPtr)
+static bool ICACHE_RAM_ATTR ValidatePacketCrcFull(OTA_Packet_s * const otaPktPtr)
 {
     uint16_t const calculatedCRC =
-        ota_crc.calc((uint8_t*)otaPktPtr, OTA8_CRC_CALC_LEN, OtaCrcInitializer);
+        ota_crc.calc<OTA8_CRC_BITS>((uint8_t*)otaPktPtr, OTA8_CRC_CALC_LEN, OtaCrcInitializer);
     return otaPktPtr->full.crc == calculatedCRC;
 }
 
-bool ICACHE_RAM_ATTR ValidatePacketCrcStd(OTA_Packet_s * const otaPktPtr)
+template <OtaSwitchMode_e switchMode>
+static bool ICACHE_RAM_ATTR ValidatePacketCrcStd(OTA_Packet_s * const otaPktPtr)
 {
     uint16_t const inCRC = ((uint16_t)otaPktPtr->std.crcHigh << 8) + otaPktPtr->std.crcLow;
     // For smHybrid the CRC only has the packet type in byte 0
     // For smWide the FHSS slot is added to the CRC in byte 0 on PACKET_TYPE_RCDATAs
 #if defined(TARGET_RX)
-    if (otaPktPtr->std.type == PACKET_TYPE_RCDATA && OtaSwitchModeCurrent == smWideOr8ch)
+    if (switchMode == smWideOr8ch && otaPktPtr->std.type == PACKET_TYPE_RCDATA)
     {
         otaPktPtr->std.crcHigh = (OtaNonce % ExpressLRS_currAirRate_Modparams->FHSShopInterval) + 1;
     }
@@ -502,76 +596,101 @@ bool ICACHE_RAM_ATTR ValidatePacketCrcStd(OTA_Packet_s * const otaPktPtr)
         otaPktPtr->std.crcHigh = 0;
     }
     uint16_t const calculatedCRC =
-        ota_crc.calc((uint8_t*)otaPktPtr, OTA4_CRC_CALC_LEN, OtaCrcInitializer);
+        ota_crc.calc<OTA4_CRC_BITS>((uint8_t*)otaPktPtr, OTA4_CRC_CALC_LEN, OtaCrcInitializer);
+    // Leave the packet as received, failed packets may still be used by the DvdaCombiner
+    otaPktPtr->std.crcHigh = inCRC >> 8;
     return inCRC == calculatedCRC;
 }
 
-void ICACHE_RAM_ATTR GeneratePacketCrcFull(OTA_Packet_s * const otaPktPtr)
+static void ICACHE_RAM_ATTR GeneratePacketCrcFull(OTA_Packet_s * const otaPktPtr)
 {
-    otaPktPtr->full.crc = ota_crc.calc((uint8_t*)otaPktPtr, OTA8_CRC_CALC_LEN, OtaCrcInitializer);
+    otaPktPtr->full.crc = ota_crc.calc<OTA8_CRC_BITS>((uint8_t*)otaPktPtr, OTA8_CRC_CALC_LEN, OtaCrcInitializer);
 }
 
-void ICACHE_RAM_ATTR GeneratePacketCrcStd(OTA_Packet_s * const otaPktPtr)
+template <OtaSwitchMode_e switchMode>
+static void ICACHE_RAM_ATTR GeneratePacketCrcStd(OTA_Packet_s * const otaPktPtr)
 {
 #if defined(TARGET_TX)
     // artificially inject the low bits of the nonce on data packets, this will be overwritten with the CRC after it's calculated
-    if (otaPktPtr->std.type == PACKET_TYPE_RCDATA && OtaSwitchModeCurrent == smWideOr8ch)
+    if (switchMode == smWideOr8ch && otaPktPtr->std.type == PACKET_TYPE_RCDATA)
     {
         otaPktPtr->std.crcHigh = (OtaNonce % ExpressLRS_currAirRate_Modparams->FHSShopInterval) + 1;
     }
 #endif
-    uint16_t crc = ota_crc.calc((uint8_t*)otaPktPtr, OTA4_CRC_CALC_LEN, OtaCrcInitializer);
+    uint16_t crc = ota_crc.calc<OTA4_CRC_BITS>((uint8_t*)otaPktPtr, OTA4_CRC_CALC_LEN, OtaCrcInitializer);
     otaPktPtr->std.crcHigh = (crc >> 8);
     otaPktPtr->std.crcLow  = crc;
 }
 
-void OtaUpdateSerializers(OtaSwitchMode_e const switchMode, uint8_t packetSize)
-{
-    OtaIsFullRes = (packetSize == OTA8_PACKET_SIZE);
+/**
+ * The serializers for each packet size and switch mode. Each one is built for
+ * its combination, so the mode checks and the CRC width are constants the
+ * compiler folds away, and the packet path makes one plain call for each of
+ * packing and CRC instead of testing the mode per packet.
+ * Std packets have no 12ch mode and use the Hybrid8 encoding for it.
+ */
+typedef struct {
+    ValidatePacketCrc_t validate;
+    GeneratePacketCrc_t generate;
+#if defined(TARGET_TX) || defined(UNIT_TEST)
+    PackChannelData_t pack;
+#endif
+#if defined(TARGET_RX) || defined(UNIT_TEST)
+    UnpackChannelData_t unpack;
+#endif
+} OtaSerializers_t;
 
-    if (OtaIsFullRes)
+#if (defined(TARGET_TX) || defined(UNIT_TEST)) && (defined(TARGET_RX) || defined(UNIT_TEST))
+#define OTA_SERIALIZERS(validate, generate, pack, unpack) { validate, generate, pack, unpack }
+#elif defined(TARGET_TX)
+#define OTA_SERIALIZERS(validate, generate, pack, unpack) { validate, generate, pack }
+#else
+#define OTA_SERIALIZERS(validate, generate, pack, unpack) { validate, generate, unpack }
+#endif
+
+// Indexed by [OtaIsFullRes][OtaSwitchMode_e]
+static const OtaSerializers_t OtaSerializers[2][3] = {
+    {
+        OTA_SERIALIZERS(&ValidatePacketCrcStd<smWideOr8ch>, &GeneratePacketCrcStd<smWideOr8ch>,
+                        &GenerateChannelDataHybridWide, &UnpackChannelDataHybridWide),
+        OTA_SERIALIZERS(&ValidatePacketCrcStd<smHybridOr16ch>, &GeneratePacketCrcStd<smHybridOr16ch>,
+                        &GenerateChannelDataHybrid8, &UnpackChannelDataHybridSwitch8),
+        OTA_SERIALIZERS(&ValidatePacketCrcStd<sm12ch>, &GeneratePacketCrcStd<sm12ch>,
+                        &GenerateChannelDataHybrid8, &UnpackChannelDataHybridSwitch8),
+    },
     {
-        OtaValidatePacketCrc = &ValidatePacketCrcFull;
-        OtaGeneratePacketCrc = &GeneratePacketCrcFull;
-        ota_crc.init(16, ELRS_CRC16_POLY);
+        OTA_SERIALIZERS(&ValidatePacketCrcFull, &GeneratePacketCrcFull,
+                        &GenerateChannelData8ch, &UnpackChannelData8ch<smWideOr8ch>),
+        OTA_SERIALIZERS(&ValidatePacketCrcFull, &GeneratePacketCrcFull,
+                        &GenerateChannelData12ch<smHybridOr16ch>, &UnpackChannelData8ch<smHybridOr16ch>),
+        OTA_SERIALIZERS(&ValidatePacketCrcFull, &GeneratePacketCrcFull,
+                        &GenerateChannelData12ch<sm12ch>, &UnpackChannelData8ch<sm12ch>),
+    },
+};
+
+void OtaUpdateSerializers(OtaSwitchMode_e switchMode, uint8_t packetSize)
+{
+    // The mode comes from the config or a sync packet, anything unknown is the
+    // mode both ends start in rather than a read past the table
+    if ((unsigned)switchMode >= sizeof(OtaSerializers[0]) / sizeof(OtaSerializers[0][0]))
+        switchMode = smWideOr8ch;
 
-        #if defined(TARGET_TX) || defined(UNIT_TEST)
-        if (switchMode == smWideOr8ch)
-            OtaPackChannelData = &GenerateChannelData8ch;
-        else
-            OtaPackChannelData = &GenerateChannelData12ch;
-        #endif
-        #if defined(TARGET_RX) || defined(UNIT_TEST)
-        OtaUnpackChannelData = &UnpackChannelData8ch;
-        #endif
-    } // is8ch
+    OtaIsFullRes = (packetSize == OTA8_PACKET_SIZE);
 
+    if (OtaIsFullRes)
+        ota_crc.init(OTA8_CRC_BITS, ELRS_CRC16_POLY);
     else
-    {
-        OtaValidatePacketCrc = &ValidatePacketCrcStd;
-        OtaGeneratePacketCrc = &GeneratePacketCrcStd;
-        ota_crc.init(14, ELRS_CRC14_POLY);
-
-        if (switchMode == smWideOr8ch)
-        {
-            #if defined(TARGET_TX) || defined(UNIT_TEST)
-            OtaPackChannelData = &GenerateChannelDataHybridWide;
-            #endif
-            #if defined(TARGET_RX) || defined(UNIT_TEST)
-            OtaUnpackChannelData = &UnpackChannelDataHybridWide;
-            #endif
-        } // !is8ch and smWideOr8ch
+        ota_crc.init(OTA4_CRC_BITS, ELRS_CRC14_POLY);
 
-        else
-        {
-            #if defined(TARGET_TX) || defined(UNIT_TEST)
-            OtaPackChannelData = &GenerateChannelDataHybrid8;
-            #endif
-            #if defined(TARGET_RX) || defined(UNIT_TEST)
-            OtaUnpackChannelData = &UnpackChannelDataHybridSwitch8;
-            #endif
-        } // !is8ch and smHybridOr16ch
-    }
+    OtaSerializers_t const * const serializers = &OtaSerializers[OtaIsFullRes][switchMode];
+    OtaValidatePacketCrc = serializers->validate;
+    OtaGeneratePacketCrc = serializers->generate;
+#if defined(TARGET_TX) || defined(UNIT_TEST)
+    OtaPackChannelData = serializers->pack;
+#endif
+#if defined(TARGET_RX) || defined(UNIT_TEST)
+    OtaUnpackChannelData = serializers->unpack;
+#endif
 
     OtaSwitchModeCurrent = switchMode;
 }
@@ -1,7 +1,6 @@
 #ifndef H_OTA
 #define H_OTA
 
-#include <functional>
 #include "crc.h"
 #include "CRSF.h"
 
@@ -19,6 +18,11 @@
 // Mask used to XOR the ModelId into the SYNC packet for ModelMatch
 #define MODELMATCH_MASK 0x3f
 
+// A 4ch LinkStats doesn't use packageIndex, it carries the uplink LQ over the
+// last 100ms as 1 + LQ/2. An RX which sends neither that nor lastRSSI sends 0
+#define OTA4_LQ_SHORT_TO_INDEX(lq)  (1 + (lq) / 2)
+#define OTA4_INDEX_TO_LQ_SHORT(idx) (((idx) - 1) * 2)
+
 typedef struct {
     uint8_t fhssIndex;
     uint8_t nonce;
@@ -74,7 +78,10 @@ typedef struct {
             union {
                 struct {
                     OTA_LinkStats_s stats;
-                    uint8_t free;
+                    // RSSI of the uplink packet just before this one, positivized
+                    // like uplink_RSSI_1, 0 if it was missed. For TX diversity,
+                    // only valid if packageIndex isn't 0
+                    uint8_t lastRSSI;
                 } PACKED ul_link_stats;
                 uint8_t payload[ELRS4_TELEMETRY_BYTES_PER_CALL];
             };
@@ -149,8 +156,8 @@ void OtaUpdateSerializers(OtaSwitchMode_e const mode, uint8_t packetSize);
 extern OtaSwitchMode_e OtaSwitchModeCurrent;
 
 // CRC
-typedef std::function<bool (OTA_Packet_s * const otaPktPtr)> ValidatePacketCrc_t;
-typedef std::function<void (OTA_Packet_s * const otaPktPtr)> GeneratePacketCrc_t;
+typedef bool (*ValidatePacketCrc_t)(OTA_Packet_s * const otaPktPtr);
+typedef void (*GeneratePacketCrc_t)(OTA_Packet_s * const otaPktPtr);
 extern ValidatePacketCrc_t OtaValidatePacketCrc;
 extern GeneratePacketCrc_t OtaGeneratePacketCrc;
 // Value is implicit leading 1, comment is Koopman formatting (implicit trailing 1) https://users.ece.cmu.edu/~koopman/crc/
@@ -159,7 +166,7 @@ extern GeneratePacketCrc_t OtaGeneratePacketCrc;
 #define ELRS_CRC16_POLY 0x3D65 // 0x9eb2
 
 #if defined(TARGET_TX) || defined(UNIT_TEST)
-typedef std::function<void (OTA_Packet_s * const otaPktPtr, CRSF const * const crsf, bool TelemetryStatus, uint8_t tlmDenom)> PackChannelData_t;
+typedef void (*PackChannelData_t)(OTA_Packet_s * const otaPktPtr, CRSF const * const crsf, bool TelemetryStatus, uint8_t tlmDenom);
 extern PackChannelData_t OtaPackChannelData;
 #if defined(UNIT_TEST)
 void OtaSetHybrid8NextSwitchIndex(uint8_t idx);
@@ -168,7 +175,7 @@ void OtaSetFullResNextChannelSet(bool next);
 #endif
 
 #if defined(TARGET_RX) || defined(UNIT_TEST)
-typedef std::function<bool (OTA_Packet_s const * const otaPktPtr, CRSF * const crsf, uint8_t tlmDenom)> UnpackChannelData_t;
+typedef bool (*UnpackChannelData_t)(OTA_Packet_s const * const otaPktPtr, CRSF * const crsf, uint8_t tlmDenom);
 extern UnpackChannelData_t OtaUnpackChannelData;
 #endif
 
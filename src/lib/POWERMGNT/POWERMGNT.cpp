@@ -272,7 +272,7 @@ void POWERMGNT::setPower(PowerLevels_e Power)
     }
 #endif
     CurrentPower = Power;
-    devicesTriggerEvent();
+    devicesTriggerEvent(EVENT_POWER_CHANGED);
 }
 
 #endif /* !UNIT_TEST */
\ No newline at end of file
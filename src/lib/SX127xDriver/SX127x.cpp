@@ -111,12 +111,12 @@ void SX127xDriver::SetBandwidthCodingRate(SX127x_Bandwidth bw, SX127x_CodingRate
     if (bw == SX127x_BW_500_00_KHZ)
     {
       //datasheet errata reconmendation http://caxapa.ru/thumbs/972894/SX1276_77_8_ErrataNote_1.1_STD.pdf
-      hal.writeRegister(0x36, 0x02);
-      hal.writeRegister(0x3a, 0x64);
+      hal.writeRegister(SX127X_REG_HIGH_BW_OPTIMIZE_1, 0x02);
+      hal.writeRegister(SX127X_REG_HIGH_BW_OPTIMIZE_2, 0x64);
     }
     else
     {
-      hal.writeRegister(0x36, 0x03);
+      hal.writeRegister(SX127X_REG_HIGH_BW_OPTIMIZE_1, 0x03);
     }
     currCR = cr;
     currBW = bw;
@@ -464,6 +464,10 @@ bool ICACHE_RAM_ATTR SX127xDriver::GetFrequencyErrorbool()
   return (hal.readRegister(SX127X_REG_FEI_MSB) & 0b1000) >> 3; // returns true if pos freq error, neg if false
 }
 
+/**
+ * Get the frequency error of the last received packet in Hz
+ * Negative when GetFrequencyErrorbool() would return true
+ */
 int32_t ICACHE_RAM_ATTR SX127xDriver::GetFrequencyError()
 {
 
@@ -479,8 +483,9 @@ int32_t ICACHE_RAM_ATTR SX127xDriver::GetFrequencyError()
     intFreqError -= 524288; // Sign bit is on
   }
 
-  int32_t fErrorHZ = (intFreqError >> 3) * (SX127xDriver::GetCurrBandwidthNormalisedShifted()); // bit shift hackery so we don't have to use floaty bois; the >> 3 is intentional and is a simplification of the formula on page 114 of sx1276 datasheet
-  fErrorHZ >>= 4;
+  // Datasheet: FreqError * 2^24 / Fxtal * BW[kHz] / 500, with a 32MHz xtal
+  // 2^24 / 32e6 / 500 = 1 / 953.67, the 20-bit FEI * 500 still fits in an int32
+  int32_t fErrorHZ = intFreqError * (int32_t)(GetCurrBandwidth() / 1000U) / 954;
 
   return fErrorHZ;
 }
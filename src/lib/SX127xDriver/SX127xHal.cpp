@@ -1,8 +1,8 @@
-#ifndef UNIT_TEST
-
 #include "SX127xHal.h"
 #include "logging.h"
 
+#ifndef UNIT_TEST
+
 SX127xHal *SX127xHal::instance = NULL;
 
 SX127xHal::SX127xHal()
@@ -21,6 +21,7 @@ void SX127xHal::end()
 void SX127xHal::init()
 {
   DBGLN("Hal Init");
+  invalidateShadow();
 
   if (GPIO_PIN_PA_ENABLE != UNDEF_PIN)
   {
@@ -85,17 +86,6 @@ void SX127xHal::init()
   attachInterrupt(digitalPinToInterrupt(GPIO_PIN_DIO0), dioISR, RISING);
 }
 
-uint8_t ICACHE_RAM_ATTR SX127xHal::getRegValue(uint8_t reg, uint8_t msb, uint8_t lsb)
-{
-  if ((msb > 7) || (lsb > 7) || (lsb > msb))
-  {
-    return (ERR_INVALID_BIT_RANGE);
-  }
-  uint8_t rawValue = readRegister(reg);
-  uint8_t maskedValue = rawValue & ((0b11111111 << lsb) & (0b11111111 >> (7 - msb)));
-  return (maskedValue);
-}
-
 void ICACHE_RAM_ATTR SX127xHal::readRegisterBurst(uint8_t reg, uint8_t numBytes, uint8_t *inBytes)
 {
   WORD_ALIGNED_ATTR uint8_t buf[numBytes + 1];
@@ -121,20 +111,6 @@ uint8_t ICACHE_RAM_ATTR SX127xHal::readRegister(uint8_t reg)
   return (buf[1]);
 }
 
-uint8_t ICACHE_RAM_ATTR SX127xHal::setRegValue(uint8_t reg, uint8_t value, uint8_t msb, uint8_t lsb)
-{
-  if ((msb > 7) || (lsb > 7) || (lsb > msb))
-  {
-    return (ERR_INVALID_BIT_RANGE);
-  }
-
-  uint8_t currentValue = readRegister(reg);
-  uint8_t mask = ~((0b11111111 << (msb + 1)) | (0b11111111 >> (8 - lsb)));
-  uint8_t newValue = (currentValue & ~mask) | (value & mask);
-  writeRegister(reg, newValue);
-  return (ERR_NONE);
-}
-
 void ICACHE_RAM_ATTR SX127xHal::writeRegisterFIFO(volatile uint8_t *data, uint8_t numBytes)
 {
   WORD_ALIGNED_ATTR uint8_t buf[numBytes + 1];
@@ -169,7 +145,7 @@ void ICACHE_RAM_ATTR SX127xHal::readRegisterFIFO(volatile uint8_t *data, uint8_t
   }
 }
 
-void ICACHE_RAM_ATTR SX127xHal::writeRegisterBurst(uint8_t reg, uint8_t *data, uint8_t numBytes)
+void ICACHE_RAM_ATTR SX127xHal::writeRegisterRaw(uint8_t reg, uint8_t *data, uint8_t numBytes)
 {
   WORD_ALIGNED_ATTR uint8_t buf[numBytes + 1];
   buf[0] = reg | SPI_WRITE;
@@ -184,22 +160,6 @@ void ICACHE_RAM_ATTR SX127xHal::writeRegisterBurst(uint8_t reg, uint8_t *data, u
   digitalWrite(GPIO_PIN_NSS, HIGH);
 }
 
-void ICACHE_RAM_ATTR SX127xHal::writeRegister(uint8_t reg, uint8_t data)
-{
-  WORD_ALIGNED_ATTR uint8_t buf[2];
-
-  buf[0] = reg | SPI_WRITE;
-  buf[1] = data;
-
-  digitalWrite(GPIO_PIN_NSS, LOW);
-#ifdef PLATFORM_STM32
-  SPI.transfer(buf, 2);
-#else
-  SPI.writeBytes(buf, 2);
-#endif
-  digitalWrite(GPIO_PIN_NSS, HIGH);
-}
-
 void ICACHE_RAM_ATTR SX127xHal::TXenable()
 {
   if (GPIO_PIN_RX_ENABLE != UNDEF_PIN)
@@ -255,3 +215,126 @@ void ICACHE_RAM_ATTR SX127xHal::dioISR()
 }
 
 #endif // UNIT_TEST
+
+/////////////////////////////////////Register shadow/////////////////////////////////////
+
+bool ICACHE_RAM_ATTR SX127xHal::isShadowed(uint8_t reg)
+{
+  switch (reg)
+  {
+  case SX127X_REG_FRF_MSB:
+  case SX127X_REG_FRF_MID:
+  case SX127X_REG_FRF_LSB:
+  case SX127X_REG_PA_CONFIG:
+  case SX127X_REG_PA_RAMP:
+  case SX127X_REG_OCP:
+  case SX127X_REG_LNA:
+  case SX127X_REG_FIFO_TX_BASE_ADDR:
+  case SX127X_REG_FIFO_RX_BASE_ADDR:
+  case SX127X_REG_IRQ_FLAGS_MASK:
+  case SX127X_REG_MODEM_CONFIG_1:
+  case SX127X_REG_MODEM_CONFIG_2:
+  case SX127X_REG_SYMB_TIMEOUT_LSB:
+  case SX127X_REG_PREAMBLE_MSB:
+  case SX127X_REG_PREAMBLE_LSB:
+  case SX127X_REG_PAYLOAD_LENGTH:
+  case SX127X_REG_MAX_PAYLOAD_LENGTH:
+  case SX127X_REG_HOP_PERIOD:
+  case SX1278_REG_MODEM_CONFIG_3:
+  case SX127x_PPMOFFSET:
+  case SX127X_REG_DETECT_OPTIMIZE:
+  case SX127X_REG_INVERT_IQ:
+  case SX127X_REG_HIGH_BW_OPTIMIZE_1:
+  case SX127X_REG_DETECTION_THRESHOLD:
+  case SX127X_REG_SYNC_WORD:
+  case SX127X_REG_HIGH_BW_OPTIMIZE_2:
+  case SX127X_REG_DIO_MAPPING_1:
+  case SX127X_REG_DIO_MAPPING_2:
+  case SX1278_REG_PA_DAC:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/**
+ * Forget the shadow, when the radio is reset or may have been written to
+ * other than through here
+ */
+void ICACHE_RAM_ATTR SX127xHal::invalidateShadow()
+{
+  for (uint8_t reg = 0; reg < SX127X_SHADOW_REGS; ++reg)
+  {
+    shadowValid[reg] = false;
+  }
+}
+
+uint8_t ICACHE_RAM_ATTR SX127xHal::getRegValue(uint8_t reg, uint8_t msb, uint8_t lsb)
+{
+  if ((msb > 7) || (lsb > 7) || (lsb > msb))
+  {
+    return (ERR_INVALID_BIT_RANGE);
+  }
+  uint8_t rawValue = readRegister(reg);
+  uint8_t maskedValue = rawValue & ((0b11111111 << lsb) & (0b11111111 >> (7 - msb)));
+  return (maskedValue);
+}
+
+uint8_t ICACHE_RAM_ATTR SX127xHal::setRegValue(uint8_t reg, uint8_t value, uint8_t msb, uint8_t lsb)
+{
+  if ((msb > 7) || (lsb > 7) || (lsb > msb))
+  {
+    return (ERR_INVALID_BIT_RANGE);
+  }
+
+  // Only read the register if the shadow doesn't know it yet, after which
+  // this is a pure write
+  uint8_t currentValue;
+  if (isShadowed(reg) && shadowValid[reg])
+  {
+    currentValue = shadow[reg];
+  }
+  else
+  {
+    currentValue = readRegister(reg);
+  }
+  uint8_t mask = ~((0b11111111 << (msb + 1)) | (0b11111111 >> (8 - lsb)));
+  uint8_t newValue = (currentValue & ~mask) | (value & mask);
+  writeRegister(reg, newValue);
+  return (ERR_NONE);
+}
+
+void ICACHE_RAM_ATTR SX127xHal::writeRegister(uint8_t reg, uint8_t data)
+{
+  writeRegisterBurst(reg, &data, 1);
+}
+
+/**
+ * Write numBytes registers from reg, starting at the first which the shadow
+ * doesn't know already has its value, skipping the write if none changed.
+ * Everything after the first change is written, the frequency only takes
+ * effect when FRF_LSB is written.
+ */
+void ICACHE_RAM_ATTR SX127xHal::writeRegisterBurst(uint8_t reg, uint8_t *data, uint8_t numBytes)
+{
+  uint8_t first = 0;
+  while (first < numBytes && isShadowed(reg + first) && shadowValid[reg + first] && shadow[reg + first] == data[first])
+  {
+    ++first;
+  }
+  if (first == numBytes)
+  {
+    return;
+  }
+
+  writeRegisterRaw(reg + first, data + first, numBytes - first);
+
+  for (uint8_t i = first; i < numBytes; ++i)
+  {
+    if (isShadowed(reg + i))
+    {
+      shadow[reg + i] = data[i];
+      shadowValid[reg + i] = true;
+    }
+  }
+}
@@ -34,4 +34,20 @@ public:
     void ICACHE_RAM_ATTR writeRegisterFIFO(volatile uint8_t *data, uint8_t numBytes);
     void ICACHE_RAM_ATTR readRegisterFIFO(volatile uint8_t *data, uint8_t numBytes);
     void ICACHE_RAM_ATTR writeRegisterBurst(uint8_t reg, uint8_t *data, uint8_t numBytes);
+
+    void ICACHE_RAM_ATTR invalidateShadow();
+
+private:
+    /**
+     * Shadow of the configuration registers, what was last written to each.
+     * Writes of the value a register already has are skipped and bitfields are
+     * set without reading the register first. Registers the radio changes
+     * itself (OP_MODE, FIFO pointers, IRQ flags, status) are never shadowed.
+     **/
+    #define SX127X_SHADOW_REGS (SX1278_REG_PA_DAC + 1)
+    uint8_t shadow[SX127X_SHADOW_REGS];
+    bool shadowValid[SX127X_SHADOW_REGS];
+
+    static bool ICACHE_RAM_ATTR isShadowed(uint8_t reg);
+    void ICACHE_RAM_ATTR writeRegisterRaw(uint8_t reg, uint8_t *data, uint8_t numBytes);
 };
\ No newline at end of file
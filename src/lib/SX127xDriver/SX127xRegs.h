@@ -94,8 +94,10 @@ typedef enum
 #define SX127X_REG_RSSI_WIDEBAND 0x2C
 #define SX127X_REG_DETECT_OPTIMIZE 0x31
 #define SX127X_REG_INVERT_IQ 0x33
+#define SX127X_REG_HIGH_BW_OPTIMIZE_1 0x36 // errata 2.1, sensitivity at 500kHz
 #define SX127X_REG_DETECTION_THRESHOLD 0x37
 #define SX127X_REG_SYNC_WORD 0x39
+#define SX127X_REG_HIGH_BW_OPTIMIZE_2 0x3A
 #define SX127X_REG_DIO_MAPPING_1 0x40
 #define SX127X_REG_DIO_MAPPING_2 0x41
 #define SX127X_REG_VERSION 0x42
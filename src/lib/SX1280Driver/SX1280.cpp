@@ -247,6 +247,22 @@ void SX1280Driver::ConfigModParamsLoRa(uint8_t bw, uint8_t sf, uint8_t cr)
     }
     // Enable frequency compensation
     hal.WriteRegister(SX1280_REG_FREQ_ERR_CORRECTION, 0x1, SX1280_Radio_All);
+
+    // FEI LSB is 1.55 * BW / 1600kHz Hz, precompute in Q10
+    switch (bw)
+    {
+    case SX1280_LORA_BW_0200:
+        feiScaleQ10 = 202;
+        break;
+    case SX1280_LORA_BW_0400:
+        feiScaleQ10 = 403;
+        break;
+    case SX1280_LORA_BW_1600:
+        feiScaleQ10 = 1612;
+        break;
+    default:
+        feiScaleQ10 = 806; // SX1280_LORA_BW_0800
+    }
 }
 
 void SX1280Driver::SetPacketParamsLoRa(uint8_t PreambleLength, SX1280_RadioLoRaPacketLengthsModes_t HeaderType,
@@ -451,7 +467,8 @@ bool ICACHE_RAM_ATTR SX1280Driver::RXnbISR(uint16_t const irqStatus, SX1280_Radi
         // but because we have AUTO_FS enabled we automatically transition to state SX1280_MODE_FS
         currOpmode = SX1280_MODE_FS;
     }
-    if (fail == SX12XX_RX_OK)
+    // Packets which only failed the CRC are read too, DVDA repeats can still be combined
+    if ((fail & ~SX12XX_RX_CRC_FAIL) == SX12XX_RX_OK)
     {
         uint8_t const FIFOaddr = GetRxBufferAddr(radioNumber);
         hal.ReadBuffer(FIFOaddr, RXdataBuffer, PayloadLength, radioNumber);
@@ -491,6 +508,22 @@ bool ICACHE_RAM_ATTR SX1280Driver::GetFrequencyErrorbool()
         return !IQinverted;
 }
 
+/**
+ * Get the frequency error of the last received packet in Hz
+ * Negative when GetFrequencyErrorbool() would return true
+ */
+int32_t ICACHE_RAM_ATTR SX1280Driver::GetFrequencyError()
+{
+    WORD_ALIGNED_ATTR uint8_t fei[3];
+    hal.ReadRegister(SX1280_REG_LR_ESTIMATED_FREQUENCY_ERROR_MSB, fei, sizeof(fei), lastSuccessfulPacketRadio);
+    // Sign extend the 20-bit FEI
+    int32_t raw = (int32_t)(((uint32_t)(fei[0] & 0x0F) << 28) | ((uint32_t)fei[1] << 20) | ((uint32_t)fei[2] << 12)) >> 12;
+    // Same sign convention as GetFrequencyErrorbool()
+    if (!IQinverted)
+        raw = -raw;
+    return raw * feiScaleQ10 / 1024;
+}
+
 int8_t ICACHE_RAM_ATTR SX1280Driver::GetRssiInst()
 {
     uint8_t status = 0;
@@ -33,6 +33,7 @@ public:
 
 
     bool GetFrequencyErrorbool();
+    int32_t GetFrequencyError();
     bool FrequencyErrorAvailable() const { return modeSupportsFei && (LastPacketSNRRaw > 0); }
 
     void TXnb(uint8_t * data, uint8_t size);
@@ -51,6 +52,7 @@ private:
     SX1280_RadioOperatingModes_t currOpmode = SX1280_MODE_SLEEP;
     uint8_t packet_mode;
     bool modeSupportsFei;
+    int32_t feiScaleQ10;
     SX1280_Radio_Number_t processingPacketRadio;
     SX1280_Radio_Number_t lastSuccessfulPacketRadio = SX1280_Radio_1;
 
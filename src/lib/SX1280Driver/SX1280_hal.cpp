@@ -16,12 +16,13 @@ Maintainer: Miguel Luis, Gregory Cristian and Matthieu Verdy
 Modified and adapted by Alessandro Carcione for ELRS project
 */
 
-#ifndef UNIT_TEST
 #include "SX1280_Regs.h"
 #include "SX1280_hal.h"
-#include <SPI.h>
 #include "logging.h"
 
+#ifndef UNIT_TEST
+#include <SPI.h>
+
 SX1280Hal *SX1280Hal::instance = NULL;
 
 SX1280Hal::SX1280Hal()
@@ -140,6 +141,7 @@ void ICACHE_RAM_ATTR SX1280Hal::setNss(uint8_t radioNumber, bool state)
 void SX1280Hal::reset(void)
 {
     DBGLN("SX1280 Reset");
+    InvalidateShadow(SX1280_Radio_All);
 
     if (GPIO_PIN_RST != UNDEF_PIN)
     {
@@ -157,12 +159,7 @@ void SX1280Hal::reset(void)
     DBGLN("SX1280 Ready!");
 }
 
-void ICACHE_RAM_ATTR SX1280Hal::WriteCommand(SX1280_RadioCommands_t command, uint8_t val, SX1280_Radio_Number_t radioNumber, uint32_t busyDelay)
-{
-    WriteCommand(command, &val, 1, radioNumber, busyDelay);
-}
-
-void ICACHE_RAM_ATTR SX1280Hal::WriteCommand(SX1280_RadioCommands_t command, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber, uint32_t busyDelay)
+void ICACHE_RAM_ATTR SX1280Hal::WriteCommandRaw(SX1280_RadioCommands_t command, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber, uint32_t busyDelay)
 {
     WORD_ALIGNED_ATTR uint8_t OutBuffer[size + 1];
 
@@ -204,7 +201,7 @@ void ICACHE_RAM_ATTR SX1280Hal::ReadCommand(SX1280_RadioCommands_t command, uint
     setNss(radioNumber, HIGH);
 }
 
-void ICACHE_RAM_ATTR SX1280Hal::WriteRegister(uint16_t address, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber)
+void ICACHE_RAM_ATTR SX1280Hal::WriteRegisterRaw(uint16_t address, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber)
 {
     WORD_ALIGNED_ATTR uint8_t OutBuffer[size + 3];
 
@@ -222,11 +219,6 @@ void ICACHE_RAM_ATTR SX1280Hal::WriteRegister(uint16_t address, uint8_t *buffer,
     BusyDelay(15);
 }
 
-void ICACHE_RAM_ATTR SX1280Hal::WriteRegister(uint16_t address, uint8_t value, SX1280_Radio_Number_t radioNumber)
-{
-    WriteRegister(address, &value, 1, radioNumber);
-}
-
 void ICACHE_RAM_ATTR SX1280Hal::ReadRegister(uint16_t address, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber)
 {
     WORD_ALIGNED_ATTR uint8_t OutBuffer[size + 4];
@@ -408,3 +400,163 @@ void ICACHE_RAM_ATTR SX1280Hal::TXRXdisable()
 }
 
 #endif // UNIT_TEST
+
+/////////////////////////////////////Parameter shadow/////////////////////////////////////
+
+int8_t ICACHE_RAM_ATTR SX1280Hal::commandShadowSlot(SX1280_RadioCommands_t command)
+{
+    switch (command)
+    {
+    case SX1280_RADIO_SET_PACKETTYPE:
+        return SX1280_SHADOW_PACKETTYPE;
+    case SX1280_RADIO_SET_MODULATIONPARAMS:
+        return SX1280_SHADOW_MODULATIONPARAMS;
+    case SX1280_RADIO_SET_PACKETPARAMS:
+        return SX1280_SHADOW_PACKETPARAMS;
+    case SX1280_RADIO_SET_RFFREQUENCY:
+        return SX1280_SHADOW_RFFREQUENCY;
+    case SX1280_RADIO_SET_TXPARAMS:
+        return SX1280_SHADOW_TXPARAMS;
+    case SX1280_RADIO_SET_BUFFERBASEADDRESS:
+        return SX1280_SHADOW_BUFFERBASEADDRESS;
+    case SX1280_RADIO_SET_DIOIRQPARAMS:
+        return SX1280_SHADOW_DIOIRQPARAMS;
+    case SX1280_RADIO_SET_AUTOFS:
+        return SX1280_SHADOW_AUTOFS;
+    case SX1280_RADIO_SET_REGULATORMODE:
+        return SX1280_SHADOW_REGULATORMODE;
+    default:
+        return SX1280_SHADOW_NONE;
+    }
+}
+
+int8_t ICACHE_RAM_ATTR SX1280Hal::registerShadowSlot(uint16_t address)
+{
+    switch (address)
+    {
+    case SX1280_REG_SF_ADDITIONAL_CONFIG:
+        return SX1280_SHADOW_SF_ADDITIONAL_CONFIG;
+    case SX1280_REG_FREQ_ERR_CORRECTION:
+        return SX1280_SHADOW_FREQ_ERR_CORRECTION;
+    case SX1280_REG_FLRC_CRC_SEED:
+        return SX1280_SHADOW_FLRC_CRC_SEED;
+    case SX1280_REG_FLRC_SYNC_WORD:
+        return SX1280_SHADOW_FLRC_SYNC_WORD;
+    default:
+        return SX1280_SHADOW_NONE;
+    }
+}
+
+/**
+ * Forget what the radios were sent, when they are reset or put to sleep,
+ * which loses their configuration
+ */
+void ICACHE_RAM_ATTR SX1280Hal::InvalidateShadow(SX1280_Radio_Number_t radioNumber)
+{
+    for (uint8_t radio = 0; radio < 2; ++radio)
+    {
+        if (radioNumber & (1 << radio))
+        {
+            for (uint8_t slot = 0; slot < SX1280_SHADOW_SLOTS; ++slot)
+            {
+                shadow[radio][slot].size = 0;
+            }
+        }
+    }
+}
+
+// Every radio addressed already has these parameters
+bool ICACHE_RAM_ATTR SX1280Hal::shadowMatches(int8_t slot, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber)
+{
+    if (slot == SX1280_SHADOW_NONE || size > SX1280_SHADOW_MAX_SIZE)
+    {
+        return false;
+    }
+    for (uint8_t radio = 0; radio < 2; ++radio)
+    {
+        if (radioNumber & (1 << radio))
+        {
+            const SX1280_Shadow_t &entry = shadow[radio][slot];
+            if (entry.size != size || memcmp(entry.data, buffer, size) != 0)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void ICACHE_RAM_ATTR SX1280Hal::updateShadow(int8_t slot, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber)
+{
+    if (slot == SX1280_SHADOW_NONE || size > SX1280_SHADOW_MAX_SIZE)
+    {
+        return;
+    }
+    for (uint8_t radio = 0; radio < 2; ++radio)
+    {
+        if (radioNumber & (1 << radio))
+        {
+            shadow[radio][slot].size = size;
+            memcpy(shadow[radio][slot].data, buffer, size);
+        }
+    }
+}
+
+void ICACHE_RAM_ATTR SX1280Hal::forgetShadow(int8_t slot, SX1280_Radio_Number_t radioNumber)
+{
+    for (uint8_t radio = 0; radio < 2; ++radio)
+    {
+        if (radioNumber & (1 << radio))
+        {
+            shadow[radio][slot].size = 0;
+        }
+    }
+}
+
+void ICACHE_RAM_ATTR SX1280Hal::WriteCommand(SX1280_RadioCommands_t command, uint8_t val, SX1280_Radio_Number_t radioNumber, uint32_t busyDelay)
+{
+    WriteCommand(command, &val, 1, radioNumber, busyDelay);
+}
+
+void ICACHE_RAM_ATTR SX1280Hal::WriteCommand(SX1280_RadioCommands_t command, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber, uint32_t busyDelay)
+{
+    const int8_t slot = commandShadowSlot(command);
+    if (shadowMatches(slot, buffer, size, radioNumber))
+    {
+        return;
+    }
+
+    WriteCommandRaw(command, buffer, size, radioNumber, busyDelay);
+
+    // Sleep loses the configuration, and parameters are only valid for the
+    // packet type they were sent for
+    if (command == SX1280_RADIO_SET_SLEEP || command == SX1280_RADIO_SET_PACKETTYPE)
+    {
+        InvalidateShadow(radioNumber);
+    }
+    // The SF additional config and frequency error correction registers have
+    // to be written again after every change of modulation parameters
+    else if (command == SX1280_RADIO_SET_MODULATIONPARAMS)
+    {
+        forgetShadow(SX1280_SHADOW_SF_ADDITIONAL_CONFIG, radioNumber);
+        forgetShadow(SX1280_SHADOW_FREQ_ERR_CORRECTION, radioNumber);
+    }
+    updateShadow(slot, buffer, size, radioNumber);
+}
+
+void ICACHE_RAM_ATTR SX1280Hal::WriteRegister(uint16_t address, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber)
+{
+    const int8_t slot = registerShadowSlot(address);
+    if (shadowMatches(slot, buffer, size, radioNumber))
+    {
+        return;
+    }
+
+    WriteRegisterRaw(address, buffer, size, radioNumber);
+    updateShadow(slot, buffer, size, radioNumber);
+}
+
+void ICACHE_RAM_ATTR SX1280Hal::WriteRegister(uint16_t address, uint8_t value, SX1280_Radio_Number_t radioNumber)
+{
+    WriteRegister(address, &value, 1, radioNumber);
+}
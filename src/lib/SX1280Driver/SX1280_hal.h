@@ -73,4 +73,47 @@ public:
             BusyDelayDuration = duration;
         }
     }
+
+    void ICACHE_RAM_ATTR InvalidateShadow(SX1280_Radio_Number_t radioNumber);
+
+private:
+    /**
+     * Shadow of the configuration commands and registers, the parameters each
+     * radio was last sent. Sending a radio what it already has is skipped, so
+     * a Config() or SetFrequency() only goes out over SPI for what changed.
+     **/
+    enum
+    {
+        SX1280_SHADOW_PACKETTYPE,
+        SX1280_SHADOW_MODULATIONPARAMS,
+        SX1280_SHADOW_PACKETPARAMS,
+        SX1280_SHADOW_RFFREQUENCY,
+        SX1280_SHADOW_TXPARAMS,
+        SX1280_SHADOW_BUFFERBASEADDRESS,
+        SX1280_SHADOW_DIOIRQPARAMS,
+        SX1280_SHADOW_AUTOFS,
+        SX1280_SHADOW_REGULATORMODE,
+        SX1280_SHADOW_SF_ADDITIONAL_CONFIG,
+        SX1280_SHADOW_FREQ_ERR_CORRECTION,
+        SX1280_SHADOW_FLRC_CRC_SEED,
+        SX1280_SHADOW_FLRC_SYNC_WORD,
+        SX1280_SHADOW_SLOTS,
+        SX1280_SHADOW_NONE = -1,
+    };
+    #define SX1280_SHADOW_MAX_SIZE 8
+    typedef struct
+    {
+        uint8_t size; // 0 until known
+        uint8_t data[SX1280_SHADOW_MAX_SIZE];
+    } SX1280_Shadow_t;
+    SX1280_Shadow_t shadow[2][SX1280_SHADOW_SLOTS];
+
+    static int8_t ICACHE_RAM_ATTR commandShadowSlot(SX1280_RadioCommands_t command);
+    static int8_t ICACHE_RAM_ATTR registerShadowSlot(uint16_t address);
+    bool ICACHE_RAM_ATTR shadowMatches(int8_t slot, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber);
+    void ICACHE_RAM_ATTR updateShadow(int8_t slot, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber);
+    void ICACHE_RAM_ATTR forgetShadow(int8_t slot, SX1280_Radio_Number_t radioNumber);
+
+    void ICACHE_RAM_ATTR WriteCommandRaw(SX1280_RadioCommands_t command, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber, uint32_t busyDelay);
+    void ICACHE_RAM_ATTR WriteRegisterRaw(uint16_t address, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber);
 };
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdint.h>
+
+#define LEDC_TIMER_PAIRS 8 // 4 high speed + 4 low speed timers
+
+/**
+ * Hands out ESP32 LEDC channels so outputs only share a timer when they
+ * share a refresh rate.
+ *
+ * Arduino's ledc drives channels 2n and 2n+1 from the same timer, so
+ * ledcSetup() on one changes the frequency of the other, and restarting the
+ * timer for a synced frame restarts both. An output is put on the other half
+ * of a pair already running at its rate (the key, the interval and anything
+ * else which has to match such as being synced), else on a free pair.
+ * When every pair is taken by other rates the output gets no channel.
+ */
+class LedcTimerAlloc
+{
+public:
+    static constexpr uint8_t NONE = 0xff;
+
+    LedcTimerAlloc()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        for (unsigned p = 0; p < LEDC_TIMER_PAIRS; ++p)
+        {
+            _key[p] = 0;
+            _user[p][0] = NONE;
+            _user[p][1] = NONE;
+        }
+    }
+
+    /* LEDC channel for output ch at the rate key, or NONE if there is no timer left for it */
+    uint8_t assign(uint8_t ch, uint32_t key)
+    {
+        release(ch);
+
+        // Share a timer already at this rate
+        for (uint8_t p = 0; p < LEDC_TIMER_PAIRS; ++p)
+        {
+            if (!inUse(p) || _key[p] != key)
+                continue;
+            for (uint8_t half = 0; half < 2; ++half)
+            {
+                if (_user[p][half] == NONE)
+                {
+                    _user[p][half] = ch;
+                    return p * 2 + half;
+                }
+            }
+        }
+
+        for (uint8_t p = 0; p < LEDC_TIMER_PAIRS; ++p)
+        {
+            if (!inUse(p))
+            {
+                _key[p] = key;
+                _user[p][0] = ch;
+                return p * 2;
+            }
+        }
+        return NONE;
+    }
+
+    /* Free the channel of output ch, if it has one */
+    void release(uint8_t ch)
+    {
+        for (unsigned p = 0; p < LEDC_TIMER_PAIRS; ++p)
+        {
+            if (_user[p][0] == ch)
+                _user[p][0] = NONE;
+            if (_user[p][1] == ch)
+                _user[p][1] = NONE;
+        }
+    }
+
+    /* The ledc_mode_t and ledc_timer_t of a channel */
+    static uint8_t speedMode(uint8_t ledcCh) { return ledcCh / 8; }
+    static uint8_t timer(uint8_t ledcCh) { return (ledcCh / 2) % 4; }
+
+private:
+    uint32_t _key[LEDC_TIMER_PAIRS];
+    uint8_t _user[LEDC_TIMER_PAIRS][2]; // output on each channel of the pair
+
+    bool inUse(uint8_t p) const { return _user[p][0] != NONE || _user[p][1] != NONE; }
+};
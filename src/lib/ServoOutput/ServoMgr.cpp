@@ -2,13 +2,23 @@
 
 #include <ServoMgr.h>
 #include <waveform_8266.h>
+#if defined(PLATFORM_ESP32)
+#include <driver/ledc.h>
+#endif
 
 ServoMgr::ServoMgr(const uint8_t * const pins, const uint8_t outputCnt, uint32_t defaultInterval)
   : _pins(pins), _outputCnt(outputCnt), _refreshInterval(new uint16_t[outputCnt]), _activePwmChannels(0)
+#if defined(PLATFORM_ESP32)
+  , _frameStart(new uint32_t[outputCnt]), _ledcChannel(new uint8_t[outputCnt])
+#endif
 {
     for (uint8_t ch=0; ch<_outputCnt; ++ch)
     {
         _refreshInterval[ch] = defaultInterval;
+#if defined(PLATFORM_ESP32)
+        _frameStart[ch] = 0;
+        _ledcChannel[ch] = LedcTimerAlloc::NONE;
+#endif
     }
 }
 
@@ -30,23 +40,61 @@ void ServoMgr::writeMicroseconds(uint8_t ch, uint16_t valueUs)
     const uint8_t pin = _pins[ch];
     if (pin == PIN_DISCONNECTED)
         return;
-    _activePwmChannels |= (1 << pin);
 #if defined(PLATFORM_ESP32)
-    ledcWrite(ch, map(valueUs, 0, _refreshInterval[ch], 0, 65535));
+    if (_ledcChannel[ch] == LedcTimerAlloc::NONE)
+        return;
+    _activePwmChannels |= (1 << ch);
+    ledcWrite(_ledcChannel[ch], map(valueUs, 0, _refreshInterval[ch], 0, 65535));
 #else
+    _activePwmChannels |= (1 << ch);
     startWaveform8266(pin, valueUs, _refreshInterval[ch] - valueUs);
 #endif
 }
 
-void ServoMgr::setRefreshInterval(uint8_t ch, uint16_t intervalUs)
+void ServoMgr::writeMicrosecondsSync(uint8_t ch, uint16_t valueUs, uint16_t minIntervalUs)
+{
+    const uint8_t pin = _pins[ch];
+    if (pin == PIN_DISCONNECTED)
+        return;
+#if defined(PLATFORM_ESP32)
+    if (_ledcChannel[ch] == LedcTimerAlloc::NONE)
+        return;
+    writeMicroseconds(ch, valueUs);
+    // The timer free-runs at the refresh interval since it was last restarted
+    // Restarting it begins a new frame with the duty just written
+    const uint32_t now = micros();
+    if ((now - _frameStart[ch]) % _refreshInterval[ch] >= minIntervalUs)
+    {
+        // Only outputs synced at this rate share the timer
+        const uint8_t ledcCh = _ledcChannel[ch];
+        ledc_timer_rst((ledc_mode_t)LedcTimerAlloc::speedMode(ledcCh), LedcTimerAlloc::timer(ledcCh));
+        _frameStart[ch] = now;
+    }
+#else
+    _activePwmChannels |= (1 << ch);
+    syncWaveform8266(pin, valueUs, _refreshInterval[ch] - valueUs, minIntervalUs);
+#endif
+}
+
+void ServoMgr::setRefreshInterval(uint8_t ch, uint16_t intervalUs, bool sync)
 {
     if (intervalUs != 0)
     {
         _refreshInterval[ch] = intervalUs;
 #if defined(PLATFORM_ESP32)
         const uint8_t pin = _pins[ch];
-        ledcSetup(ch, 1000000U / intervalUs, 16);
-        ledcAttachPin(pin, ch);
+        if (pin == PIN_DISCONNECTED)
+            return;
+        // The channel's timer is shared, so it only goes with another output at the same rate
+        _ledcChannel[ch] = _ledcAlloc.assign(ch, ((uint32_t)sync << 16) | intervalUs);
+        if (_ledcChannel[ch] == LedcTimerAlloc::NONE)
+        {
+            ledcDetachPin(pin);
+            return;
+        }
+        ledcSetup(_ledcChannel[ch], 1000000U / intervalUs, 16);
+        ledcAttachPin(pin, _ledcChannel[ch]);
+        _frameStart[ch] = micros();
 #endif
     }
 }
@@ -56,7 +104,7 @@ void ServoMgr::stopPwm(uint8_t ch)
     const uint8_t pin = _pins[ch];
     if (pin == PIN_DISCONNECTED)
         return;
-    _activePwmChannels &= ~(1 << pin);
+    _activePwmChannels &= ~(1 << ch);
 #if defined(PLATFORM_ESP32)
     ledcDetachPin(pin);
 #else
@@ -2,17 +2,29 @@
 #pragma once
 
 #include <Arduino.h>
+#if defined(PLATFORM_ESP32)
+#include "LedcTimerAlloc.h"
+#endif
 
 class ServoMgr
 {
 public:
     ServoMgr(const uint8_t * const pins, const uint8_t outputCnt, uint32_t defaultInterval = 20000U);
-    ~ServoMgr() { delete [] _refreshInterval; }
+    ~ServoMgr()
+    {
+        delete [] _refreshInterval;
+#if defined(PLATFORM_ESP32)
+        delete [] _frameStart;
+        delete [] _ledcChannel;
+#endif
+    }
 
     // Initialize the pins for output
     void initialize();
     // Start/Update PWM
     void writeMicroseconds(uint8_t ch, uint16_t valueUs);
+    // Start/Update PWM, and begin the next frame now if the current one started at least minIntervalUs ago
+    void writeMicrosecondsSync(uint8_t ch, uint16_t valueUs, uint16_t minIntervalUs);
     // Stop PWM
     void stopPwm(uint8_t ch);
     // Stop any active PWM channels (and set LOW)
@@ -21,7 +33,8 @@ public:
     void writeDigital(uint8_t ch, bool value);
 
     uint16_t getRefreshInterval(uint8_t ch) const { return _refreshInterval[ch]; }
-    void setRefreshInterval(uint8_t ch, uint16_t intervalUs);
+    // Set the PWM frame interval, sync if writes will be with writeMicrosecondsSync
+    void setRefreshInterval(uint8_t ch, uint16_t intervalUs, bool sync = false);
     bool isPwmActive(uint8_t ch) const { return _activePwmChannels & (1 << ch); }
     bool isAnyPwmActive() const { return _activePwmChannels; }
     uint8_t getOutputCnt() const { return _outputCnt; }
@@ -32,6 +45,11 @@ private:
     const uint8_t _outputCnt;
     uint16_t *_refreshInterval;
     uint32_t _activePwmChannels;
+#if defined(PLATFORM_ESP32)
+    uint32_t *_frameStart; // micros() the LEDC timer was last restarted
+    uint8_t *_ledcChannel; // LedcTimerAlloc::NONE if there was no timer for its rate
+    LedcTimerAlloc _ledcAlloc;
+#endif
 };
 
 #endif
\ No newline at end of file
@@ -5,14 +5,37 @@
 #include "CRSF.h"
 #include "helpers.h"
 
+// Shortest frame in somSync mode, frames are only started by a packet after this long
+constexpr uint16_t SERVO_SYNC_MIN_INTERVAL_US = (1000000U / 400U);
+
 static uint8_t SERVO_PINS[PWM_MAX_CHANNELS];
 static ServoMgr *servoMgr;
 // true when the RX has a new channels packet
-static bool newChannelsAvailable;
+static volatile bool newChannelsAvailable;
+
+#if defined(PLATFORM_ESP32)
+// How often the output task checks for failsafe when there are no packets
+#define SERVO_TASK_IDLE_MS 100
+static TaskHandle_t xServoOutputTask;
+#endif
 
 void ICACHE_RAM_ATTR servoNewChannelsAvaliable()
 {
     newChannelsAvailable = true;
+#if defined(PLATFORM_ESP32)
+    // Latch the outputs from the packet, not whenever the device loop gets to it
+    if (xServoOutputTask)
+    {
+        if (xPortInIsrContext())
+        {
+            BaseType_t woken = pdFALSE;
+            vTaskNotifyGiveFromISR(xServoOutputTask, &woken);
+            portYIELD_FROM_ISR(woken);
+        }
+        else
+            xTaskNotifyGive(xServoOutputTask);
+    }
+#endif
 }
 
 uint16_t servoOutputModeToUs(eServoOutputMode mode)
@@ -25,6 +48,8 @@ uint16_t servoOutputModeToUs(eServoOutputMode mode)
         case som160Hz: return (1000000U / 160U);
         case som333Hz: return (1000000U / 333U);
         case som400Hz: return (1000000U / 400U);
+        // The free-running rate if packets stop, packets start frames sooner
+        case somSync: return (1000000U / 50U);
         default:
             return 0;
     }
@@ -65,8 +90,11 @@ static int servosUpdate(unsigned long now)
             if (chConfig->val.inverted)
                 us = 3000U - us;
 
-            if ((eServoOutputMode)chConfig->val.mode == somOnOff)
+            eServoOutputMode mode = (eServoOutputMode)chConfig->val.mode;
+            if (mode == somOnOff)
                 servoMgr->writeDigital(ch, us > 1500U);
+            else if (mode == somSync)
+                servoMgr->writeMicrosecondsSync(ch, us / (chConfig->val.narrow + 1), SERVO_SYNC_MIN_INTERVAL_US);
             else
                 servoMgr->writeMicroseconds(ch, us / (chConfig->val.narrow + 1));
         } /* for each servo */
@@ -82,6 +110,31 @@ static int servosUpdate(unsigned long now)
     return DURATION_IMMEDIATELY;
 }
 
+#if defined(PLATFORM_ESP32)
+/**
+ * The LEDC can't be written from an interrupt, so the outputs are written
+ * from this task, woken by each packet. It is above the device task on the
+ * same core so the frame starts as soon as the packet is in, and it does the
+ * failsafe timing too so only it writes the outputs.
+ **/
+static void servoOutputTask(void *pvArgs)
+{
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SERVO_TASK_IDLE_MS));
+        if (connectionState == wifiUpdate)
+        {
+            // Woken by event(), stop the outputs here rather than in the
+            // device task while this one may be writing them. Nothing is
+            // output again until the reboot after the update.
+            servoMgr->stopAllPwm();
+            vTaskSuspend(NULL);
+        }
+        servosUpdate(millis());
+    }
+}
+#endif
+
 static void initialize()
 {
     if (!OPT_HAS_SERVO_OUTPUT)
@@ -111,9 +164,14 @@ static int start()
     for (unsigned ch=0; servoMgr && ch<servoMgr->getOutputCnt(); ++ch)
     {
         const rx_config_pwm_t *chConfig = config.GetPwmChannel(ch);
-        servoMgr->setRefreshInterval(ch, servoOutputModeToUs((eServoOutputMode)chConfig->val.mode));
+        const eServoOutputMode mode = (eServoOutputMode)chConfig->val.mode;
+        servoMgr->setRefreshInterval(ch, servoOutputModeToUs(mode), mode == somSync);
     }
 
+#if defined(PLATFORM_ESP32)
+    if (servoMgr)
+        xTaskCreatePinnedToCore(servoOutputTask, "servoOutputTask", 2000, NULL, 1, &xServoOutputTask, 0);
+#endif
     return DURATION_NEVER;
 }
 
@@ -127,11 +185,24 @@ static int event()
     }
     else if (connectionState == wifiUpdate)
     {
+#if defined(PLATFORM_ESP32)
+        // Only the output task writes the outputs
+        if (xServoOutputTask)
+            xTaskNotifyGive(xServoOutputTask);
+#else
         servoMgr->stopAllPwm();
+#endif
         return DURATION_NEVER;
     }
     else
+    {
+#if defined(PLATFORM_ESP32)
+        // The output task does the writes
+        return DURATION_NEVER;
+#else
         return DURATION_IMMEDIATELY;
+#endif
+    }
 }
 
 static int timeout()
@@ -143,7 +214,8 @@ device_t ServoOut_device = {
   .initialize = initialize,
   .start = start,
   .event = event,
-  .timeout = timeout
+  .timeout = timeout,
+  .subscriptions = EVENT_MASK(EVENT_CONNECTION_STATE)
 };
 
 #endif
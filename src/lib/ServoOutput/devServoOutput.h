@@ -15,6 +15,7 @@ enum eServoOutputMode {
     somPwm,     // True PWM mode (NOT SUPPORTED)
     somCrsfTx,  // CRSF output TX (NOT SUPPORTED)
     somCrsfRx,  // CRSF output RX (NOT SUPPORTED)
+    somSync,    // Servo PWM with each frame started by an RC packet, up to 400Hz
 };
 
 extern device_t ServoOut_device;
@@ -65,6 +65,9 @@ typedef struct {
   uint32_t nextHighLowUs;      // Waveform ideal (us) "on deck", waiting to be changed next cycle
                                // packed into 32 bits to be atomic read/write, 65535us max
   uint32_t lastEdge;           // Cycle when this generator last changed
+  uint32_t lastRiseCycle;      // Cycle when this generator last went high
+  uint32_t syncMinCycles;      // Shortest period allowed when starting the next period early
+  uint32_t syncRequested;      // Set by the app to start the next period early, cleared in the NMI
 } Waveform;
 
 class WVFState {
@@ -144,6 +147,7 @@ void startWaveform8266(uint8_t pin, uint32_t timeHighUS, uint32_t timeLowUS) {
     wave->timeLowCycles = wave->desiredLowCycles = microsecondsToClockCycles(timeLowUS);
     wave->nextHighLowUs = 0;
     wave->lastEdge = 0;
+    wave->syncRequested = 0;
     wave->nextServiceCycle = ESP.getCycleCount() + microsecondsToClockCycles(1);
     wvfState.waveformToEnable |= mask;
     MEMBARRIER();
@@ -156,6 +160,29 @@ void startWaveform8266(uint8_t pin, uint32_t timeHighUS, uint32_t timeLowUS) {
   }
 }
 
+// Change the waveform on a pin like startWaveform8266(), but if the pin is low and the
+// current period started at least minPeriodUS ago, begin the next period immediately
+// instead of waiting for the end of the current one.
+void syncWaveform8266(uint8_t pin, uint32_t timeHighUS, uint32_t timeLowUS, uint32_t minPeriodUS) {
+  if ((pin > 16) || (timeHighUS == 0)) {
+    return;
+  }
+  uint32_t mask = 1<<pin;
+  MEMBARRIER();
+  if (!(wvfState.waveformEnabled & mask)) {
+    // A newly started waveform begins immediately anyway
+    startWaveform8266(pin, timeHighUS, timeLowUS);
+    return;
+  }
+  Waveform *wave = &wvfState.waveform[pin];
+  wave->nextHighLowUs = (timeHighUS << 16) | timeLowUS;
+  wave->syncMinCycles = microsecondsToClockCycles(minPeriodUS);
+  MEMBARRIER();
+  wave->syncRequested = 1;
+  MEMBARRIER();
+  forceTimerInterrupt();
+}
+
 // Stops a waveform on a pin
 void stopWaveform8266(uint8_t pin) {
   // Can't possibly need to stop anything if there is no timer active
@@ -250,6 +277,14 @@ static IRAM_ATTR void timer1Interrupt() {
         Waveform *wave = &wvfState.waveform[i];
         uint32_t now = GetCycleCountIRQ();
 
+        // Start the next period now if requested, the pin is low and the period has run long enough
+        if (wave->syncRequested) {
+          wave->syncRequested = 0;
+          if (!(wvfState.waveformState & mask) && (now - wave->lastRiseCycle) >= adjust(wave->syncMinCycles)) {
+            wave->nextServiceCycle = now - 1;
+          }
+        }
+
         // Check for toggles
         int32_t cyclesToGo = wave->nextServiceCycle - now;
         if (cyclesToGo < 0) {
@@ -262,6 +297,7 @@ static IRAM_ATTR void timer1Interrupt() {
               GP16O = 1;
             }
             GPOS = mask;
+            wave->lastRiseCycle = now;
 
             if (wave->nextHighLowUs != 0) {
               // Copy over next full-cycle timings
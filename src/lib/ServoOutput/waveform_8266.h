@@ -2,6 +2,7 @@
 
 void startWaveform8266(uint8_t pin, uint32_t timeHighUS, uint32_t timeLowUS);
 void stopWaveform8266(uint8_t pin);
+void syncWaveform8266(uint8_t pin, uint32_t timeHighUS, uint32_t timeLowUS, uint32_t minPeriodUS);
 
 // This section below is a hack to prevent the use of the core's core_esp8266_waveform functions by
 // overriding their implementations. It seems to work and save about 800 bytes of RAM and 500 bytes of code
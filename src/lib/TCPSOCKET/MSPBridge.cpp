@@ -0,0 +1,268 @@
+#include "MSPBridge.h"
+#include <cstring>
+
+static_assert(MSP_BRIDGE_POOL_SIZE <= 32, "poolFree is a 32 bit mask");
+
+MSPBridge::MSPBridge()
+    : framesIn(0), framesOut(0), framesDropped(0), pendingCount(0)
+{
+    poolFree.store((1ULL << MSP_BRIDGE_POOL_SIZE) - 1);
+    for (uint8_t client = 0; client < MSP_BRIDGE_MAX_CLIENTS; ++client)
+    {
+        connected[client] = false;
+        assembling[client] = -1;
+    }
+}
+
+int8_t MSPBridge::alloc()
+{
+    uint32_t free = poolFree.load();
+    uint8_t idx;
+    do
+    {
+        if (free == 0)
+            return -1;
+        idx = __builtin_ctz(free);
+    } while (!poolFree.compare_exchange_weak(free, free & ~(1UL << idx)));
+    return idx;
+}
+
+void MSPBridge::release(uint8_t idx)
+{
+    poolFree.fetch_or(1UL << idx);
+}
+
+int32_t MSPBridge::frameLen(const uint8_t *data, uint32_t len)
+{
+    if (len < 1)
+        return 0;
+    if (data[0] != '$')
+        return -1;
+    if (len < 3)
+        return 0;
+    if ((data[1] != 'M' && data[1] != 'X') || (data[2] != '<' && data[2] != '>' && data[2] != '!'))
+        return -1;
+
+    if (data[1] == 'M')
+    {
+        // $M< len cmd payload crc
+        if (len < 5)
+            return 0;
+        if (data[3] != 0xFF)
+            return data[3] + 6;
+        // Jumbo: $M< 0xff cmd len(2) payload crc
+        if (len < 7)
+            return 0;
+        return (data[5] | (data[6] << 8)) + 8;
+    }
+
+    // $X< flag cmd(2) len(2) payload crc
+    if (len < 8)
+        return 0;
+    return (data[6] | (data[7] << 8)) + 9;
+}
+
+uint16_t MSPBridge::frameFunction(const uint8_t *data)
+{
+    if (data[1] == 'M')
+        return data[4];
+    return data[4] | (data[5] << 8);
+}
+
+void MSPBridge::connect(uint8_t client)
+{
+    assembling[client] = -1;
+    connected[client] = true;
+}
+
+void MSPBridge::disconnect(uint8_t client)
+{
+    connected[client] = false;
+    if (assembling[client] >= 0)
+    {
+        release(assembling[client]);
+        assembling[client] = -1;
+    }
+    while (peekOutput(client))
+        popOutput(client);
+
+    // Responses to its requests will be dropped
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < pendingCount; ++i)
+    {
+        if (pending[i].client != client)
+            pending[kept++] = pending[i];
+    }
+    pendingCount = kept;
+}
+
+void MSPBridge::receive(uint8_t client, const uint8_t *data, uint32_t len)
+{
+    while (len)
+    {
+        int8_t idx = assembling[client];
+        if (idx < 0)
+        {
+            // Skip anything between frames
+            const uint8_t *start = (const uint8_t *)memchr(data, '$', len);
+            if (start == nullptr)
+                return;
+            len -= start - data;
+            data = start;
+
+            idx = alloc();
+            if (idx < 0)
+            {
+                // Out of buffers, this frame is lost and the next '$' resyncs
+                ++framesDropped;
+                ++data;
+                --len;
+                continue;
+            }
+            pool[idx].len = 0;
+            pool[idx].client = client;
+            assembling[client] = idx;
+        }
+
+        msp_bridge_buffer_t * const buf = &pool[idx];
+        int32_t total = frameLen(buf->data, buf->len);
+        if (total == 0)
+        {
+            // The header is taken a byte at a time until the length is known
+            buf->data[buf->len++] = *data++;
+            --len;
+            total = frameLen(buf->data, buf->len);
+        }
+        if (total < 0 || total > MSP_BRIDGE_FRAME_MAX)
+        {
+            ++framesDropped;
+            release(idx);
+            assembling[client] = -1;
+            continue;
+        }
+        if (total == 0)
+            continue;
+
+        // Then the rest of the frame in one go
+        uint32_t count = total - buf->len;
+        if (count > len)
+            count = len;
+        memcpy(&buf->data[buf->len], data, count);
+        buf->len += count;
+        data += count;
+        len -= count;
+
+        if (buf->len == total)
+        {
+            assembling[client] = -1;
+            if (toFc.push(idx))
+                ++framesIn;
+            else
+            {
+                ++framesDropped;
+                release(idx);
+            }
+        }
+    }
+}
+
+const msp_bridge_buffer_t *MSPBridge::peekRequest()
+{
+    uint8_t idx;
+    return toFc.peek(idx) ? &pool[idx] : nullptr;
+}
+
+void MSPBridge::popRequest()
+{
+    uint8_t idx;
+    if (!toFc.peek(idx))
+        return;
+    toFc.pop();
+
+    // Remember who asked, forgetting the oldest if they never got an answer
+    if (pendingCount == MSP_BRIDGE_PENDING)
+    {
+        memmove(&pending[0], &pending[1], sizeof(pending[0]) * (MSP_BRIDGE_PENDING - 1));
+        --pendingCount;
+    }
+    pending[pendingCount].client = pool[idx].client;
+    pending[pendingCount].function = frameFunction(pool[idx].data);
+    ++pendingCount;
+    release(idx);
+}
+
+uint8_t MSPBridge::takeRequester(uint16_t function)
+{
+    for (uint8_t i = 0; i < pendingCount; ++i)
+    {
+        if (pending[i].function == function)
+        {
+            uint8_t client = pending[i].client;
+            memmove(&pending[i], &pending[i + 1], sizeof(pending[0]) * (pendingCount - i - 1));
+            --pendingCount;
+            return client;
+        }
+    }
+    return MSP_BRIDGE_BROADCAST;
+}
+
+void MSPBridge::queueOutput(uint8_t client, uint8_t idx)
+{
+    if (toClient[client].push(idx))
+        ++pool[idx].refs;
+    else
+        ++framesDropped;
+}
+
+void MSPBridge::response(const uint8_t *data, uint32_t len)
+{
+    if (len < 5 || len > MSP_BRIDGE_FRAME_MAX)
+    {
+        ++framesDropped;
+        return;
+    }
+
+    uint8_t client = takeRequester(frameFunction(data));
+    int8_t idx = alloc();
+    if (idx < 0)
+    {
+        ++framesDropped;
+        return;
+    }
+    msp_bridge_buffer_t * const buf = &pool[idx];
+    memcpy(buf->data, data, len);
+    buf->len = len;
+    buf->client = client;
+    buf->refs = 0;
+
+    if (client == MSP_BRIDGE_BROADCAST)
+    {
+        for (uint8_t c = 0; c < MSP_BRIDGE_MAX_CLIENTS; ++c)
+        {
+            if (connected[c])
+                queueOutput(c, idx);
+        }
+    }
+    else if (connected[client])
+        queueOutput(client, idx);
+
+    if (buf->refs == 0)
+        release(idx);
+}
+
+const msp_bridge_buffer_t *MSPBridge::peekOutput(uint8_t client)
+{
+    uint8_t idx;
+    return toClient[client].peek(idx) ? &pool[idx] : nullptr;
+}
+
+void MSPBridge::popOutput(uint8_t client)
+{
+    uint8_t idx;
+    if (!toClient[client].peek(idx))
+        return;
+    toClient[client].pop();
+    ++framesOut;
+    if (--pool[idx].refs == 0)
+        release(idx);
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "crsfmsp_common.h"
+
+#define MSP_BRIDGE_MAX_CLIENTS  4
+// Frames held at once, across all clients and both directions
+#define MSP_BRIDGE_POOL_SIZE    8
+// Largest MSPv2 frame: $X< flag cmd(2) len(2) payload crc
+#define MSP_BRIDGE_FRAME_MAX    (MSP_FRAME_MAX_LEN + 9)
+// Requests remembered to route their responses
+#define MSP_BRIDGE_PENDING      16
+#define MSP_BRIDGE_BROADCAST    0xFF
+
+typedef struct {
+    uint16_t len;
+    uint8_t  client;
+    uint8_t  refs;
+    uint8_t  data[MSP_BRIDGE_FRAME_MAX];
+} msp_bridge_buffer_t;
+
+/**
+ * Index queue for one producer and one consumer, which may be different tasks
+ */
+template <uint8_t N>
+class MSPBridgeQueue
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "MSPBridgeQueue size must be a power of 2");
+
+public:
+    MSPBridgeQueue() : head(0), tail(0) {}
+    bool push(uint8_t idx)
+    {
+        uint8_t t = tail.load(std::memory_order_relaxed);
+        if ((uint8_t)(t - head.load(std::memory_order_acquire)) == N)
+            return false;
+        items[t & (N - 1)] = idx;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    bool peek(uint8_t &idx) const
+    {
+        uint8_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire))
+            return false;
+        idx = items[h & (N - 1)];
+        return true;
+    }
+    void pop() { head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+private:
+    uint8_t items[N];
+    std::atomic<uint8_t> head;
+    std::atomic<uint8_t> tail;
+};
+
+/**
+ * Connects several TCP clients to the one MSP link to the flight controller.
+ *
+ * Each client's byte stream is split into whole MSP frames on its own, so
+ * frames from different clients never interleave however TCP chunks them.
+ * Complete requests are queued for the FC in arrival order, and the function
+ * of each request forwarded is remembered so the response with the same
+ * function goes back to the client which asked. Frames nobody asked for go to
+ * every client. Frames live in a fixed pool of buffers and only the buffer
+ * index moves between queues; a frame sent to several clients is shared.
+ *
+ * receive() is called from the network task, everything else from the loop.
+ */
+class MSPBridge
+{
+public:
+    MSPBridge();
+
+    void connect(uint8_t client);
+    void disconnect(uint8_t client);
+    bool isConnected(uint8_t client) const { return connected[client]; }
+
+    // Bytes from a client, in whatever pieces TCP delivered them
+    void receive(uint8_t client, const uint8_t *data, uint32_t len);
+
+    // The next complete request for the FC, pop it once it has been sent on
+    const msp_bridge_buffer_t *peekRequest();
+    void popRequest();
+
+    // A complete frame from the FC, queued for the client that requested it
+    void response(const uint8_t *data, uint32_t len);
+
+    // The next frame to send to a client, pop it once TCP has taken it
+    const msp_bridge_buffer_t *peekOutput(uint8_t client);
+    void popOutput(uint8_t client);
+
+    uint32_t framesIn;
+    uint32_t framesOut;
+    uint32_t framesDropped;
+
+    /**
+     * Length of the MSP frame starting in data
+     * Returns: the frame length, 0 if more bytes are needed to tell, -1 if this is not a valid frame
+     **/
+    static int32_t frameLen(const uint8_t *data, uint32_t len);
+    static uint16_t frameFunction(const uint8_t *data);
+
+private:
+    msp_bridge_buffer_t pool[MSP_BRIDGE_POOL_SIZE];
+    std::atomic<uint32_t> poolFree; // bitmask of free buffers
+    MSPBridgeQueue<MSP_BRIDGE_POOL_SIZE> toFc;
+    MSPBridgeQueue<MSP_BRIDGE_POOL_SIZE> toClient[MSP_BRIDGE_MAX_CLIENTS];
+    bool connected[MSP_BRIDGE_MAX_CLIENTS];
+    int8_t assembling[MSP_BRIDGE_MAX_CLIENTS]; // buffer being filled for each client, -1 if none
+
+    struct {
+        uint8_t client;
+        uint16_t function;
+    } pending[MSP_BRIDGE_PENDING];
+    uint8_t pendingCount;
+
+    int8_t alloc();
+    void release(uint8_t idx);
+    void queueOutput(uint8_t client, uint8_t idx);
+    uint8_t takeRequester(uint16_t function);
+};
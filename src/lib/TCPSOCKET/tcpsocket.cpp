@@ -18,91 +18,90 @@ void TCPSOCKET::begin()
     TCPserver->begin();
 }
 
+void TCPSOCKET::removeClient(uint8_t idx)
+{
+    bridge.disconnect(idx);
+    clients[idx] = NULL;
+    clientGone[idx] = false;
+}
+
 void TCPSOCKET::handle()
 {
-    if (TCPclient == NULL)
+    const uint32_t now = millis();
+    for (uint8_t idx = 0; idx < MSP_BRIDGE_MAX_CLIENTS; ++idx)
     {
-        //DBGLN("no client");
-        return; // nothing to do
-    }
+        AsyncClient *client = clients[idx];
+        if (client == NULL)
+        {
+            continue;
+        }
 
-    // check timeout
-    if (millis() - clientTimeoutLastData > clientTimeoutPeriod)
-    {
-        TCPclient = NULL;
-        DBGLN("TCP client timeout");
-        return;
-    }
+        if (clientGone[idx])
+        {
+            removeClient(idx);
+            continue;
+        }
 
-    // check if there is data to send out the TCP port
-    if ((FIFOout.size()) > 0)
-    {
-        const uint16_t len = FIFOout.peekSize();
-        if (TCPclient->canSend() && TCPclient->space() > len)
+        // check timeout
+        if (now - clientTimeoutLastData[idx] > clientTimeoutPeriod)
         {
-            FIFOout.popSize();
-            uint8_t data[len];
-            FIFOout.popBytes(data, len);
-            TCPclient->write((const char *)data, len);
-            TCPclient->send();
-            DBGLN("TCP OUT SENT: Sent!: len: %d", len);
+            DBGLN("TCP client %u timeout", idx);
+            client->onDisconnect(NULL, NULL);
+            client->close(true);
+            removeClient(idx);
+            continue;
         }
-        else
+
+        // send out as many frames as TCP will take, without waiting for each to be acked
+        const msp_bridge_buffer_t *frame;
+        bool added = false;
+        while ((frame = bridge.peekOutput(idx)) != NULL && client->canSend() && client->space() >= frame->len)
         {
-            DBGLN("TCP OUT SENT: Have data but TCP not ready!: len: %d", len);
+            client->add((const char *)frame->data, frame->len);
+            bridge.popOutput(idx);
+            added = true;
+        }
+        if (added)
+        {
+            client->send();
         }
     }
 }
 
 bool TCPSOCKET::write(uint8_t *data, uint16_t len) // doesn't send, just ques it up.
 {
-    if (TCPclient == NULL)
+    if (!hasClient())
     {
         return false; // nothing to do
     }
 
-    if (FIFOout.free() > (uint32_t)(len + 2))
-    {
-        FIFOout.pushSize(len);
-        FIFOout.pushBytes(data, len);
-        DBGLN("TCP OUT QUE: queued %d bytes", len);
-        return true;
-    }
-    else
-    {
-        DBGLN("TCP OUT QUE: No space in FIFOout! len: %d", len);
-        return false;
-    }
+    const uint32_t dropped = bridge.framesDropped;
+    bridge.response(data, len);
+    return bridge.framesDropped == dropped;
 }
 
-void TCPSOCKET::read(uint8_t *data)
+const uint8_t *TCPSOCKET::peek()
 {
-    // assume we have already checked that there is data to receive and we know how much
-    // we always recieve a single chunk so no need to give len parameter
-    uint16_t len = FIFOin.popSize();
-    FIFOin.popBytes(data, len);
+    const msp_bridge_buffer_t *frame = bridge.peekRequest();
+    return frame == NULL ? NULL : frame->data;
+}
+
+void TCPSOCKET::pop()
+{
+    bridge.popRequest();
 }
 
 uint16_t TCPSOCKET::bytesReady()
 {
-    return FIFOin.peekSize();
+    const msp_bridge_buffer_t *frame = bridge.peekRequest();
+    return frame == NULL ? 0 : frame->len;
 }
 
 void TCPSOCKET::handleDataIn(void *arg, AsyncClient *client, void *data, size_t len)
 {
-    instance->TCPclient = client;
-    instance->clientTimeoutLastData = millis();
-
-    if (instance->FIFOin.free() > (uint32_t)(len + 2)) // +2 because it takes 2 bytes to store the size of the FIFO chunk
-    {
-        instance->FIFOin.pushSize(len);
-        instance->FIFOin.pushBytes((uint8_t *)data, len);
-        DBGLN("TCP IN: queued %d bytes", len);
-    }
-    else
-    {
-        DBGLN("TCP IN: buffer full! wanted: %d, free: %d", (len + 2), instance->FIFOin.free());
-    }
+    const uint8_t idx = (uintptr_t)arg;
+    instance->clientTimeoutLastData[idx] = millis();
+    instance->bridge.receive(idx, (uint8_t *)data, len);
 }
 
 void TCPSOCKET::handleError(void *arg, AsyncClient *client, int8_t error)
@@ -113,9 +112,7 @@ void TCPSOCKET::handleError(void *arg, AsyncClient *client, int8_t error)
 void TCPSOCKET::handleDisconnect(void *arg, AsyncClient *client)
 {
     DBGLN("\n client %s disconnected \n", client->remoteIP().toString().c_str());
-    instance->TCPclient = NULL;
-    instance->FIFOin.flush();
-    instance->FIFOout.flush();
+    instance->clientGone[(uintptr_t)arg] = true;
 }
 
 void TCPSOCKET::handleTimeOut(void *arg, AsyncClient *client, uint32_t time)
@@ -125,24 +122,42 @@ void TCPSOCKET::handleTimeOut(void *arg, AsyncClient *client, uint32_t time)
 
 bool TCPSOCKET::hasClient()
 {
-    return (TCPclient == NULL) ? false : true;
+    for (uint8_t idx = 0; idx < MSP_BRIDGE_MAX_CLIENTS; ++idx)
+    {
+        if (clients[idx] != NULL)
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
 void TCPSOCKET::handleNewClient(void *arg, AsyncClient *client)
 {
     DBGLN("\n new client has been connected to server, ip: %s", client->remoteIP().toString().c_str());
 
-    instance->TCPclient = client;
-    instance->clientTimeoutLastData = millis();
+    uintptr_t idx = 0;
+    while (idx < MSP_BRIDGE_MAX_CLIENTS && (instance->clients[idx] != NULL || instance->bridge.isConnected(idx)))
+    {
+        ++idx;
+    }
+    if (idx == MSP_BRIDGE_MAX_CLIENTS)
+    {
+        DBGLN("TCP client limit reached");
+        client->close(true);
+        return;
+    }
 
-    // add to list
-    //instance->clients.push_back(client); // not using right now
+    instance->clientTimeoutLastData[idx] = millis();
+    instance->bridge.connect(idx);
+    instance->clients[idx] = client;
 
     // register events
-    client->onData(handleDataIn, NULL);
-    client->onError(handleError, NULL);
-    client->onDisconnect(handleDisconnect, NULL);
-    client->onTimeout(handleTimeOut, NULL);
+    client->setNoDelay(true);
+    client->onData(handleDataIn, (void *)idx);
+    client->onError(handleError, (void *)idx);
+    client->onDisconnect(handleDisconnect, (void *)idx);
+    client->onTimeout(handleTimeOut, (void *)idx);
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -4,24 +4,22 @@
 #include <cstdint>
 #include <cstring>
 #include "ESPAsyncWebServer.h"
-#include "FIFO_GENERIC.h"
+#include "MSPBridge.h"
 
-#define BUFFER_OUTPUT_SIZE 1024
-#define BUFFER_INPUT_SIZE 1024
-
-// buffers reads and write to the specified TCP port
+// bridges MSP frames between the clients on the specified TCP port and the FC
 
 class TCPSOCKET
 {
 private:
     static TCPSOCKET *instance;
-    //std::vector<AsyncClient *> clients; // a list to hold all clients for MSP to WIFI bridge nut not using multi-client for now
 
     AsyncServer *TCPserver;
-    AsyncClient *TCPclient = NULL;
+    AsyncClient *clients[MSP_BRIDGE_MAX_CLIENTS] = {};
     uint32_t TCPport;
     const uint32_t clientTimeoutPeriod = 2000;
-    uint32_t clientTimeoutLastData;
+    uint32_t clientTimeoutLastData[MSP_BRIDGE_MAX_CLIENTS];
+    // set by the network task, the client is removed from the loop
+    volatile bool clientGone[MSP_BRIDGE_MAX_CLIENTS] = {};
 
     static void handleNewClient(void *arg, AsyncClient *client);
     static void handleDataIn(void *arg, AsyncClient *client, void *data, size_t len);
@@ -29,17 +27,19 @@ private:
     static void handleTimeOut(void *arg, AsyncClient *client, uint32_t time);
     static void handleError(void *arg, AsyncClient *client, int8_t error);
 
-    FIFO_GENERIC<BUFFER_OUTPUT_SIZE> FIFOout;
-    FIFO_GENERIC<BUFFER_INPUT_SIZE> FIFOin;
+    void removeClient(uint8_t idx);
+
+    MSPBridge bridge;
 
 public:
     TCPSOCKET(const uint32_t port);
     void begin();
     void handle();
     bool hasClient();
-    uint16_t bytesReady(); // has x bytes in the input buffer ready
+    uint16_t bytesReady(); // length of the next complete MSP frame for the FC, 0 if none
     bool write(uint8_t *data, uint16_t len);
-    void read(uint8_t *data);
+    const uint8_t *peek(); // the next frame for the FC, in place, bytesReady() long
+    void pop();
 };
 
-#endif
\ No newline at end of file
+#endif
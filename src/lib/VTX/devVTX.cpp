@@ -25,7 +25,7 @@ static enum VtxSendState_e
 void VtxTriggerSend()
 {
     VtxSendState = VTXSS_MODIFIED;
-    devicesTriggerEvent();
+    devicesTriggerEvent(EVENT_VTX_CHANGED);
 }
 
 void VtxPitmodeSwitchUpdate()
@@ -0,0 +1,179 @@
+#if defined(PLATFORM_ESP32)
+#include "GzipInflater.h"
+#include "rom/crc.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define GZIP_HEADER_LEN     10
+#define GZIP_TRAILER_LEN    8
+#define GZIP_METHOD_DEFLATE 8
+
+#define GZIP_FLAG_HCRC      0x02
+#define GZIP_FLAG_EXTRA     0x04
+#define GZIP_FLAG_NAME      0x08
+#define GZIP_FLAG_COMMENT   0x10
+
+bool GzipInflater::begin()
+{
+    decomp = (tinfl_decompressor *)malloc(sizeof(tinfl_decompressor));
+    dict = (uint8_t *)malloc(TINFL_LZ_DICT_SIZE);
+    if (!decomp || !dict)
+    {
+        end();
+        state = STATE_ERROR;
+        return false;
+    }
+
+    tinfl_init(decomp);
+    state = STATE_HEADER;
+    status = TINFL_STATUS_NEEDS_MORE_INPUT;
+    dictOfs = 0;
+    collectedLen = 0;
+    crc = 0;
+    outSize = 0;
+    return true;
+}
+
+void GzipInflater::end()
+{
+    free(decomp);
+    free(dict);
+    decomp = nullptr;
+    dict = nullptr;
+}
+
+/**
+ * Gather a fixed size field which may be split across writes into collected
+ * Returns: true once all count bytes are there
+ **/
+bool GzipInflater::collect(const uint8_t *&data, size_t &len, uint8_t count)
+{
+    while (len && collectedLen < count)
+    {
+        collected[collectedLen++] = *data++;
+        --len;
+    }
+    if (collectedLen < count)
+        return false;
+    collectedLen = 0;
+    return true;
+}
+
+// The optional header fields come in this order when their flag is set
+void GzipInflater::nextHeaderState()
+{
+    if (flags & GZIP_FLAG_EXTRA)
+        state = STATE_EXTRA_LEN;
+    else if (flags & GZIP_FLAG_NAME)
+        state = STATE_NAME;
+    else if (flags & GZIP_FLAG_COMMENT)
+        state = STATE_COMMENT;
+    else if (flags & GZIP_FLAG_HCRC)
+        state = STATE_HEADER_CRC;
+    else
+        state = STATE_DEFLATE;
+}
+
+bool GzipInflater::inflate(const uint8_t *&data, size_t &len, inflate_sink_t sink)
+{
+    size_t inBytes = len;
+    size_t outBytes = TINFL_LZ_DICT_SIZE - dictOfs;
+    status = tinfl_decompress(decomp, data, &inBytes, dict, dict + dictOfs, &outBytes, TINFL_FLAG_HAS_MORE_INPUT);
+    data += inBytes;
+    len -= inBytes;
+
+    if (outBytes)
+    {
+        crc = crc32_le(crc, dict + dictOfs, outBytes);
+        outSize += outBytes;
+        if (!sink(dict + dictOfs, outBytes))
+            return false;
+        // The output wraps around the window, which the decompressor refers back into
+        dictOfs = (dictOfs + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+    }
+
+    if (status == TINFL_STATUS_DONE)
+        state = STATE_TRAILER;
+    return status >= TINFL_STATUS_DONE;
+}
+
+bool GzipInflater::write(const uint8_t *data, size_t len, inflate_sink_t sink)
+{
+    // Keep going while there's input, or output the decompressor couldn't fit in the window last time
+    while ((len || (state == STATE_DEFLATE && status == TINFL_STATUS_HAS_MORE_OUTPUT)) && state != STATE_ERROR)
+    {
+        switch (state)
+        {
+        case STATE_HEADER:
+            if (!collect(data, len, GZIP_HEADER_LEN))
+                break;
+            if (collected[0] != 0x1F || collected[1] != 0x8B || collected[2] != GZIP_METHOD_DEFLATE)
+            {
+                state = STATE_ERROR;
+                break;
+            }
+            flags = collected[3];
+            nextHeaderState();
+            break;
+        case STATE_EXTRA_LEN:
+            if (!collect(data, len, 2))
+                break;
+            skipLen = collected[0] | (collected[1] << 8);
+            state = STATE_EXTRA;
+            break;
+        case STATE_EXTRA:
+            while (len && skipLen)
+            {
+                ++data;
+                --len;
+                --skipLen;
+            }
+            if (skipLen == 0)
+            {
+                flags &= ~GZIP_FLAG_EXTRA;
+                nextHeaderState();
+            }
+            break;
+        case STATE_NAME:
+        case STATE_COMMENT:
+            // Zero terminated strings
+            while (len)
+            {
+                --len;
+                if (*data++ == 0)
+                {
+                    flags &= ~(state == STATE_NAME ? GZIP_FLAG_NAME : GZIP_FLAG_COMMENT);
+                    nextHeaderState();
+                    break;
+                }
+            }
+            break;
+        case STATE_HEADER_CRC:
+            if (!collect(data, len, 2))
+                break;
+            flags &= ~GZIP_FLAG_HCRC;
+            nextHeaderState();
+            break;
+        case STATE_DEFLATE:
+            if (!inflate(data, len, sink))
+                state = STATE_ERROR;
+            break;
+        case STATE_TRAILER:
+        {
+            if (!collect(data, len, GZIP_TRAILER_LEN))
+                break;
+            uint32_t expectedCrc = collected[0] | (collected[1] << 8) | (collected[2] << 16) | ((uint32_t)collected[3] << 24);
+            uint32_t expectedSize = collected[4] | (collected[5] << 8) | (collected[6] << 16) | ((uint32_t)collected[7] << 24);
+            state = (crc == expectedCrc && (uint32_t)outSize == expectedSize) ? STATE_DONE : STATE_ERROR;
+            break;
+        }
+        default:
+            // Anything after the trailer is ignored
+            len = 0;
+            break;
+        }
+    }
+
+    return state != STATE_ERROR;
+}
+#endif
@@ -0,0 +1,68 @@
+#pragma once
+
+#if defined(PLATFORM_ESP32)
+#include <stdint.h>
+#include <stddef.h>
+#include "rom/miniz.h"
+
+/**
+ * Receives each block of decompressed data
+ * Returns: false to stop the decompression
+ **/
+typedef bool (*inflate_sink_t)(const uint8_t *data, size_t len);
+
+/**
+ * Streaming gzip decoder for firmware uploads.
+ *
+ * Compressed data is fed in whatever chunks the web server receives them in
+ * and the output is handed to the sink as it is produced, so only the 32KB
+ * deflate window and the decompressor state are needed regardless of the
+ * image size. The gzip trailer's CRC32 and length are checked against the
+ * output once the stream ends. Uses the inflate code in the ESP32 ROM.
+ */
+class GzipInflater
+{
+public:
+    bool begin();
+    void end();
+
+    /**
+     * Decompress len bytes of the gzip stream
+     * Returns: false if the stream is corrupt, memory ran out or the sink failed
+     **/
+    bool write(const uint8_t *data, size_t len, inflate_sink_t sink);
+
+    // True once the whole stream has been decompressed and matches its trailer
+    bool verified() const { return state == STATE_DONE; }
+    size_t outputSize() const { return outSize; }
+
+private:
+    enum {
+        STATE_HEADER,
+        STATE_EXTRA_LEN,
+        STATE_EXTRA,
+        STATE_NAME,
+        STATE_COMMENT,
+        STATE_HEADER_CRC,
+        STATE_DEFLATE,
+        STATE_TRAILER,
+        STATE_DONE,
+        STATE_ERROR
+    } state;
+
+    tinfl_decompressor *decomp;
+    uint8_t *dict;
+    size_t dictOfs;
+    tinfl_status status;
+    uint8_t flags;
+    uint8_t collected[10];
+    uint8_t collectedLen;
+    uint16_t skipLen;
+    uint32_t crc;
+    size_t outSize;
+
+    bool collect(const uint8_t *&data, size_t &len, uint8_t count);
+    void nextHeaderState();
+    bool inflate(const uint8_t *&data, size_t &len, inflate_sink_t sink);
+};
+#endif
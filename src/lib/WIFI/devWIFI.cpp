@@ -17,6 +17,7 @@
 #include <Update.h>
 #include <esp_partition.h>
 #include <esp_ota_ops.h>
+#include "GzipInflater.h"
 #else
 #include <ESP8266WiFi.h>
 #include <ESP8266mDNS.h>
@@ -37,6 +38,7 @@
 #include "options.h"
 #include "helpers.h"
 #include "devVTXSPI.h"
+#include "LinkLog.h"
 
 #include "WebContent.h"
 
@@ -47,6 +49,9 @@ extern TxConfig config;
 extern RxConfig config;
 #endif
 extern unsigned long rebootTime;
+#if defined(HAS_LINK_LOG)
+extern LinkLog linkLog;
+#endif
 
 static char station_ssid[33];
 static char station_password[65];
@@ -84,6 +89,11 @@ static String target_found;
 static bool target_complete = false;
 static bool force_update = false;
 static uint32_t totalSize;
+static bool inflating = false;
+static bool inflateFailed = false;
+#if defined(PLATFORM_ESP32)
+static GzipInflater inflater;
+#endif
 
 /** Is this an IP? */
 static boolean isIp(String str)
@@ -447,7 +457,8 @@ static void WebUpdateHandleNotFound(AsyncWebServerRequest *request)
 static void WebUploadResponseHandler(AsyncWebServerRequest *request) {
   if (target_seen) {
     String msg;
-    if (Update.end()) {
+    // The size of a decompressed image is only known at the end
+    if (!inflateFailed && Update.end(inflating)) {
       DBGLN("Update complete, rebooting");
       msg = String("{\"status\": \"ok\", \"msg\": \"Update complete. ");
       #if defined(TARGET_RX)
@@ -458,7 +469,9 @@ static void WebUploadResponseHandler(AsyncWebServerRequest *request) {
       rebootTime = millis() + 200;
     } else {
       StreamString p = StreamString();
-      if (Update.hasError()) {
+      if (inflateFailed) {
+        p.println("Compressed firmware is corrupt or incomplete!");
+      } else if (Update.hasError()) {
         Update.printError(p);
       } else {
         p.println("Not enough data uploaded!");
@@ -481,18 +494,67 @@ static void WebUploadResponseHandler(AsyncWebServerRequest *request) {
   }
 }
 
+static void WebUploadCheckTarget(const uint8_t *data, size_t len) {
+  if (force_update)
+    target_seen = true;
+  if (target_seen)
+    return;
+  for (size_t i=0 ; i<len ;i++) {
+    if (!target_complete && (target_pos >= 4 || target_found.length() > 0)) {
+      if (target_pos == 4) {
+        target_found.clear();
+      }
+      if (data[i] == 0 || target_found.length() > 50) {
+        target_complete = true;
+      }
+      else {
+        target_found += (char)data[i];
+      }
+    }
+    if (data[i] == target_name[target_pos]) {
+      ++target_pos;
+      if (target_pos >= target_name_size) {
+        target_seen = true;
+      }
+    }
+    else {
+      target_pos = 0; // Startover
+    }
+  }
+}
+
+static bool WebUploadWrite(const uint8_t *data, size_t len) {
+  if (Update.write((uint8_t *)data, len) != len) {
+    DBGLN("write failed to write %d", len);
+    return false;
+  }
+  WebUploadCheckTarget(data, len);
+  totalSize += len;
+  return true;
+}
+
 static void WebUploadDataHandler(AsyncWebServerRequest *request, const String& filename, size_t index, uint8_t *data, size_t len, bool final) {
   force_update = force_update || request->hasArg("force");
   if (index == 0) {
     size_t filesize = request->header("X-FileSize").toInt();
     DBGLN("Update: '%s' size %u", filename.c_str(), filesize);
+    inflateFailed = false;
     #if defined(PLATFORM_ESP8266)
     Update.runAsync(true);
     uint32_t maxSketchSpace = (ESP.getFreeSketchSpace() - 0x1000) & 0xFFFFF000;
     DBGLN("Free space = %u", maxSketchSpace);
     UNUSED(maxSketchSpace); // for warning
+    #else
+    // A gzip image is decompressed as it arrives, only needing the 32KB window in RAM
+    inflating = len >= 2 && data[0] == 0x1F && data[1] == 0x8B;
+    if (inflating && !inflater.begin()) {
+      DBGLN("Not enough memory to decompress firmware");
+      inflateFailed = true;
+    }
+    if (inflating)
+      filesize = UPDATE_SIZE_UNKNOWN;
     #endif
-    if (!Update.begin(filesize, U_FLASH)) { // pass the size provided
+    if (!inflateFailed && !Update.begin(filesize, U_FLASH)) { // pass the size provided
       Update.printError(LOGGING_UART);
     }
     target_seen = false;
@@ -503,38 +565,37 @@ static void WebUploadDataHandler(AsyncWebServerRequest *request, const String& f
   }
   if (len) {
     DBGVLN("writing %d", len);
-    if (Update.write(data, len) == len) {
-      if (force_update || (totalSize == 0 && *data == 0x1F))
-        target_seen = true;
-      if (!target_seen) {
-        for (size_t i=0 ; i<len ;i++) {
-          if (!target_complete && (target_pos >= 4 || target_found.length() > 0)) {
-            if (target_pos == 4) {
-              target_found.clear();
-            }
-            if (data[i] == 0 || target_found.length() > 50) {
-              target_complete = true;
-            }
-            else {
-              target_found += (char)data[i];
-            }
-          }
-          if (data[i] == target_name[target_pos]) {
-            ++target_pos;
-            if (target_pos >= target_name_size) {
-              target_seen = true;
-            }
-          }
-          else {
-            target_pos = 0; // Startover
-          }
-        }
+    #if defined(PLATFORM_ESP32)
+    if (inflating) {
+      if (!inflateFailed && !inflater.write(data, len, &WebUploadWrite)) {
+        DBGLN("Failed to decompress firmware after %u bytes", index + len);
+        inflateFailed = true;
+        inflater.end();
+        Update.abort();
       }
-      totalSize += len;
+    }
+    else
+    #endif
+    {
+      // The ESP8266 bootloader decompresses gzip images itself, but then the target can't be checked
+      if (totalSize == 0 && *data == 0x1F)
+        target_seen = true;
+      WebUploadWrite(data, len);
+    }
+  }
+  #if defined(PLATFORM_ESP32)
+  if (final && inflating && !inflateFailed) {
+    // The CRC and size in the gzip trailer must match what was written
+    if (!inflater.verified()) {
+      DBGLN("Compressed firmware failed verification");
+      inflateFailed = true;
+      Update.abort();
     } else {
-      DBGLN("write failed to write %d", len);
+      DBGLN("Update: %u bytes decompressed to %u", index + len, inflater.outputSize());
     }
+    inflater.end();
   }
+  #endif
 }
 
 static void WebUploadForceUpdateHandler(AsyncWebServerRequest *request) {
@@ -593,6 +654,22 @@ static void WebUpdateGetFirmware(AsyncWebServerRequest *request) {
   request->send(response);
 }
 
+#if defined(HAS_LINK_LOG)
+static size_t getLinkLogChunk(uint8_t *data, size_t len, size_t pos)
+{
+  return linkLog.read(pos, data, len, RADIO_SNR_SCALE, ExpressLRS_currAirRate_Modparams->enum_rate);
+}
+
+static void WebUpdateGetLinkLog(AsyncWebServerRequest *request)
+{
+  // The radio is stopped while WiFi is running so the log doesn't change while it is sent
+  AsyncWebServerResponse *response = request->beginResponse("application/octet-stream", linkLog.exportSize(), &getLinkLogChunk);
+  String filename = String("attachment; filename=\"") + (const char *)&target_name[4] + "_linklog.bin\"";
+  response->addHeader("Content-Disposition", filename);
+  request->send(response);
+}
+#endif
+
 static void wifiOff()
 {
   wifiStarted = false;
@@ -711,6 +788,9 @@ static void startServices()
   server.on("/access", WebUpdateAccessPoint);
   server.on("/target", WebUpdateGetTarget);
   server.on("/firmware.bin", WebUpdateGetFirmware);
+#if defined(HAS_LINK_LOG)
+  server.on("/linklog.bin", WebUpdateGetLinkLog);
+#endif
 
   server.on("/generate_204", WebUpdateHandleRoot); // handle Andriod phones doing shit to detect if there is 'real' internet and possibly dropping conn.
   server.on("/gen_204", WebUpdateHandleRoot);
@@ -836,21 +916,26 @@ void HandleMSP2WIFI()
 {
   #if defined(USE_MSP_WIFI) && defined(TARGET_RX)
   // check is there is any data to write out
-  if (crsf.crsf2msp.FIFOout.peekSize() > 0)
+  const uint16_t len = crsf.crsf2msp.peekFrameLen();
+  if (len > 0)
   {
-    const uint16_t len = crsf.crsf2msp.FIFOout.popSize();
     uint8_t data[len];
-    crsf.crsf2msp.FIFOout.popBytes(data, len);
+    crsf.crsf2msp.popFrame(data);
     wifi2tcp.write(data, len);
   }
 
-  // check if there is any data to read in
+  // check if there is any data to read in, it is chunked straight from the
+  // TCP buffer as fast as the UART takes it
+  static uint16_t bytesSent = 0;
   const uint16_t bytesReady = wifi2tcp.bytesReady();
   if (bytesReady > 0)
   {
-    uint8_t data[bytesReady];
-    wifi2tcp.read(data);
-    crsf.msp2crsf.parse(data, bytesReady);
+    bytesSent += crsf.msp2crsf.write(wifi2tcp.peek() + bytesSent, bytesReady - bytesSent);
+    if (bytesSent == bytesReady)
+    {
+      wifi2tcp.pop();
+      bytesSent = 0;
+    }
   }
 
   wifi2tcp.handle();
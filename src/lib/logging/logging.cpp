@@ -1,6 +1,7 @@
 #include "targets.h"
 #include <cstdarg>
 #include "logging.h"
+#include "EventQueue.h"
 
 #ifdef LOG_USE_PROGMEM
   #define GETCHAR pgm_read_byte(fmt)
@@ -60,6 +61,55 @@ void debugPrintf(const char* fmt, ...)
   va_end(vlist);
 }
 
+#if defined(DEBUG_LOG_TOKENIZED) || defined(UNIT_TEST)
+// Entries logged from anywhere, including ISRs and the other core, until the loop drains them
+static EventQueue<log_entry_t, 64> logQueue;
+static std::atomic<uint32_t> logDropped;
+
+void ICACHE_RAM_ATTR debugLogPush(const log_entry_t &entry)
+{
+  if (!logQueue.push(entry))
+  {
+    logDropped.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+static void debugLogWriteFrame(Stream &out, uintptr_t token, uint8_t flags, const uint8_t *args, uint8_t argsLen)
+{
+  uint8_t frame[2 + 4 + 1 + LOG_TOKENIZED_ARGS_LEN + 1];
+  frame[0] = (flags & LOG_FLAG_NEWLINE) ? LOG_TOKENIZED_SYNC : LOG_TOKENIZED_SYNC_NONL;
+  frame[1] = 4 + 1 + argsLen;
+  frame[2] = token;
+  frame[3] = token >> 8;
+  frame[4] = token >> 16;
+  frame[5] = token >> 24;
+  frame[6] = flags;
+  memcpy(&frame[7], args, argsLen);
+  uint8_t sum = 0;
+  for (uint8_t i = 1; i < 7 + argsLen; ++i)
+  {
+    sum += frame[i];
+  }
+  frame[7 + argsLen] = sum;
+  out.write(frame, 8 + argsLen);
+}
+
+void debugLogDrain(Stream &out, uint8_t maxEntries)
+{
+  const uint32_t dropped = logDropped.exchange(0, std::memory_order_relaxed);
+  if (dropped)
+  {
+    debugLogWriteFrame(out, LOG_TOKEN_DROPPED, LOG_FLAG_NEWLINE, (const uint8_t *)&dropped, sizeof(dropped));
+  }
+
+  log_entry_t entry;
+  while (maxEntries-- && logQueue.pop(entry))
+  {
+    debugLogWriteFrame(out, (uintptr_t)entry.fmt, entry.flags, entry.args, entry.len);
+  }
+}
+#endif
+
 #if defined(DEBUG_INIT)
 // Create a UART to send DBGLN to during preinit
 void debugCreateInitLogger()
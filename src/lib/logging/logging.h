@@ -1,6 +1,8 @@
 #ifndef DEBUG_H
 #define DEBUG_H
 
+#include <string.h>
+#include <type_traits>
 #include "VA_OPT.h"
 
 /**
@@ -32,6 +34,93 @@ extern Stream *SerialLogger;
 // #define LOG_USE_PROGMEM
 
 void debugPrintf(const char* fmt, ...);
+
+/**
+ * Tokenized logging, define DEBUG_LOG_TOKENIZED to use it for all the macros.
+ * Nothing is formatted on the device: the address of the format string goes in
+ * a queue with the raw arguments, and debugLogDrain() writes them out from the
+ * loop as binary frames which python/log_decode.py turns back into text using
+ * the strings in the firmware ELF. Logging from an ISR only copies the
+ * arguments, so it costs too little to upset the timing.
+ *
+ * Frame: [0xEC or 0xED if no newline] [len] [token u32] [flags] [args] [sum]
+ * Arguments are 4 bytes each, floats as float, strings as [len] [chars].
+ **/
+#define LOG_TOKENIZED_ARGS_LEN  24
+#define LOG_TOKENIZED_SYNC      0xEC
+#define LOG_TOKENIZED_SYNC_NONL 0xED
+#define LOG_FLAG_NEWLINE        0x01
+#define LOG_FLAG_ERROR          0x02
+#define LOG_TOKEN_DROPPED       0   // arg is how many entries didn't fit in the queue
+
+typedef struct {
+    const char *fmt;
+    uint8_t flags;
+    uint8_t len;
+    uint8_t args[LOG_TOKENIZED_ARGS_LEN];
+} log_entry_t;
+
+void ICACHE_RAM_ATTR debugLogPush(const log_entry_t &entry);
+// Write out up to maxEntries of the queued entries
+void debugLogDrain(Stream &out, uint8_t maxEntries);
+
+static inline void ICACHE_RAM_ATTR logPutBytes(log_entry_t &e, const void *data, uint8_t len)
+{
+    if (e.len + len <= LOG_TOKENIZED_ARGS_LEN)
+    {
+        memcpy(&e.args[e.len], data, len);
+        e.len += len;
+    }
+}
+
+template <typename T>
+static inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+ICACHE_RAM_ATTR logPutArg(log_entry_t &e, T val)
+{
+    // Every integer goes in 4 bytes, as %d/%u/%x take on the MCUs
+    static_assert(sizeof(T) <= sizeof(uint32_t), "64-bit values can't be logged tokenized");
+    const uint32_t v = (uint32_t)val;
+    logPutBytes(e, &v, sizeof(v));
+}
+
+static inline void ICACHE_RAM_ATTR logPutArg(log_entry_t &e, double val)
+{
+    const float v = val;
+    logPutBytes(e, &v, sizeof(v));
+}
+
+static inline void ICACHE_RAM_ATTR logPutArg(log_entry_t &e, const char *val)
+{
+    // The string may not outlive the call so it is copied, as much as fits
+    uint8_t len = strlen(val);
+    if (e.len + 1 + len > LOG_TOKENIZED_ARGS_LEN)
+        len = e.len < LOG_TOKENIZED_ARGS_LEN ? LOG_TOKENIZED_ARGS_LEN - 1 - e.len : 0;
+    if (e.len < LOG_TOKENIZED_ARGS_LEN)
+    {
+        e.args[e.len++] = len;
+        logPutBytes(e, val, len);
+    }
+}
+
+static inline void ICACHE_RAM_ATTR logPutArgs(log_entry_t &e) { (void)e; }
+
+template <typename T, typename... Rest>
+static inline void ICACHE_RAM_ATTR logPutArgs(log_entry_t &e, T val, Rest... rest)
+{
+    logPutArg(e, val);
+    logPutArgs(e, rest...);
+}
+
+template <typename... Args>
+static inline void ICACHE_RAM_ATTR debugLogTokenized(uint8_t flags, const char *fmt, Args... args)
+{
+    log_entry_t e;
+    e.fmt = fmt;
+    e.flags = flags;
+    e.len = 0;
+    logPutArgs(e, args...);
+    debugLogPush(e);
+}
 #if defined(LOG_INIT)
 void debugCreateInitLogger();
 void debugFreeInitLogger();
@@ -43,6 +132,9 @@ void debugFreeInitLogger();
 #if defined(CRITICAL_FLASH) || ((defined(DEBUG_RCVR_LINKSTATS)) && !defined(DEBUG_LOG))
   #define INFOLN(msg, ...)
   #define ERRLN(msg, ...)
+#elif defined(DEBUG_LOG_TOKENIZED)
+  #define INFOLN(msg, ...) { debugLogTokenized(LOG_FLAG_NEWLINE, msg, ##__VA_ARGS__); }
+  #define ERRLN(msg, ...) { debugLogTokenized(LOG_FLAG_NEWLINE | LOG_FLAG_ERROR, msg, ##__VA_ARGS__); }
 #else
   #define INFOLN(msg, ...) { \
       debugPrintf(msg, ##__VA_ARGS__); \
@@ -57,15 +149,22 @@ void debugFreeInitLogger();
 #endif
 
 #if defined(DEBUG_LOG) && !defined(CRITICAL_FLASH)
-  #define DBGCR   LOGGING_UART.println()
-  #define DBGW(c) LOGGING_UART.write(c)
-  #ifndef LOG_USE_PROGMEM
+  #if defined(DEBUG_LOG_TOKENIZED)
+    #define DBGCR   debugLogTokenized(LOG_FLAG_NEWLINE, "")
+    #define DBGW(c) debugLogTokenized(0, "%c", c)
+    #define DBG(msg, ...)   debugLogTokenized(0, msg, ##__VA_ARGS__)
+    #define DBGLN(msg, ...) { debugLogTokenized(LOG_FLAG_NEWLINE, msg, ##__VA_ARGS__); }
+  #elif !defined(LOG_USE_PROGMEM)
+    #define DBGCR   LOGGING_UART.println()
+    #define DBGW(c) LOGGING_UART.write(c)
     #define DBG(msg, ...)   debugPrintf(msg, ##__VA_ARGS__)
     #define DBGLN(msg, ...) { \
       debugPrintf(msg, ##__VA_ARGS__); \
       LOGGING_UART.println(); \
     }
   #else
+    #define DBGCR   LOGGING_UART.println()
+    #define DBGW(c) LOGGING_UART.write(c)
     #define DBG(msg, ...)   debugPrintf(PSTR(msg), ##__VA_ARGS__)
     #define DBGLN(msg, ...) { \
       debugPrintf(PSTR(msg), ##__VA_ARGS__); \
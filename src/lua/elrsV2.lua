@@ -39,6 +39,15 @@ local devicesRefreshTimeout = 50
 local folderAccess = nil
 local commandRunningIndicator = 1
 local expectChunksRemain = -1
+local paramsVersion = 0 -- device's parameters version, 0 = it can't batch
+local loadedVersion = 0 -- version the fields were last batch loaded at
+local batchFrom = 0 -- next field of a batch read, 0 = none running
+local batchVersion = nil
+local batchMore = false
+local batchRetries = 0 -- batch requests gone unanswered
+local batchUnanswered = false -- the device never answered a batch, read fields one by one
+local BATCH_MAX_RETRIES = 3
+local BATCH_MIN_PARAMS_VERSION = 1 -- ELRS without batching sends 0
 local deviceIsELRS_TX = nil
 local linkstatTimeout = 100
 local titleShowWarn = nil
@@ -66,11 +75,24 @@ local function allocateFields()
   fields[exitButtonId] = {id = exitButtonId, name="----EXIT----", parent = nil, type=17}
 end
 
+local function startBatch(since)
+  loadedVersion = since
+  batchFrom = 1
+  batchVersion = nil
+  batchMore = false
+  batchRetries = 0
+end
+
 local function reloadAllField()
   fieldChunk = 0
   fieldData = {}
   -- loadQ is actually a stack
   loadQ = {}
+  if paramsVersion ~= 0 then
+    -- Fields come in batches, only those too big for one are read one by one
+    startBatch(0)
+    return
+  end
   for fieldId = fields_count, 1, -1 do
     loadQ[#loadQ+1] = fieldId
   end
@@ -393,6 +415,7 @@ local function changeDeviceId(devId) --change to selected device ID
     handsetId = 0xEA
   end
   deviceId = devId
+  batchUnanswered = false
   fields_count = 0  --set this because next target wouldn't have the same count, and this trigger to request the new count
 end
 
@@ -426,8 +449,14 @@ local function parseDeviceInfoMessage(data)
   end
   if deviceId == id then
     deviceName = newName
-    deviceIsELRS_TX = ((fieldGetValue(data,offset,4) == 0x454C5253) and (deviceId == 0xEE)) or nil -- SerialNumber = 'E L R S' and ID is TX module
+    local isELRS = fieldGetValue(data,offset,4) == 0x454C5253 -- SerialNumber = 'E L R S'
+    deviceIsELRS_TX = (isELRS and (deviceId == 0xEE)) or nil -- and ID is TX module
     local newFieldCount = data[offset+12]
+    -- Other devices are free to put anything in the parameter version, only batch ELRS
+    paramsVersion = 0
+    if isELRS and not batchUnanswered and (data[offset+13] or 0) >= BATCH_MIN_PARAMS_VERSION then
+      paramsVersion = data[offset+13]
+    end
     if newFieldCount ~= fields_count or newFieldCount == 0 then
       fields_count = newFieldCount
       allocateFields()
@@ -462,7 +491,67 @@ local functions = {
   { load=nil, save=UIexitExec, display=fieldCommandDisplay }, --18 exit(17)
 }
 
+local function parseField(field, fieldId, data)
+  local offset
+  field.id = fieldId
+  field.parent = (data[1] ~= 0) and data[1] or nil
+  field.type = bit32.band(data[2], 0x7f)
+  field.hidden = bit32.btest(data[2], 0x80) or nil
+  field.name, offset = fieldGetString(data, 3, field.name)
+  if functions[field.type+1].load then
+    functions[field.type+1].load(field, data, offset)
+  end
+  if field.min == 0 then field.min = nil end
+  if field.max == 0 then field.max = nil end
+end
+
+local function parseBatchMessage(data)
+  -- FieldId(0xFE), FromField, NextField, ParamsVersion, then FieldId + EntryLen + Entry for each
+  if data[4] ~= batchFrom then
+    -- Not the frame expected, a lost one is asked for again on the timeout
+    return
+  end
+  if batchVersion == nil then
+    batchVersion = data[6]
+  end
+  batchRetries = 0
+  local pos = 7
+  while pos + 1 <= #data do
+    local fieldId = data[pos]
+    local len = data[pos+1]
+    local field = fields[fieldId]
+    if len == 0 then
+      -- Too big for a batch, read it in chunks
+      loadQ[#loadQ+1] = fieldId
+    elseif field then
+      local entry = {}
+      for i=1, len do
+        entry[i] = data[pos+1+i]
+      end
+      -- Only sent because it changed, so nothing cached can be used
+      field.name = nil
+      field.unit = nil
+      field.nc = true
+      parseField(field, fieldId, entry)
+    end
+    pos = pos + 2 + len
+  end
+  batchFrom = bit32.band(data[5], 0x7f)
+  -- More frames on their way without asking
+  batchMore = bit32.btest(data[5], 0x80)
+  if batchFrom == 0 then
+    loadedVersion = batchVersion
+    if #loadQ == 0 then
+      createDeviceFields()
+    end
+  end
+end
+
 local function parseParameterInfoMessage(data)
+  if data[2] == deviceId and data[3] == 0xFE and batchFrom ~= 0 then
+    parseBatchMessage(data)
+    return
+  end
   local fieldId = (fieldPopup and fieldPopup.id) or loadQ[#loadQ]
   if data[2] ~= deviceId or data[3] ~= fieldId then
     fieldData = {}
@@ -485,24 +574,14 @@ local function parseParameterInfoMessage(data)
     loadQ[#loadQ] = nil
     -- Populate field from fieldData
     if #fieldData > 3 then
-      local offset
-      field.id = fieldId
-      field.parent = (fieldData[1] ~= 0) and fieldData[1] or nil
-      field.type = bit32.band(fieldData[2], 0x7f)
-      field.hidden = bit32.btest(fieldData[2], 0x80) or nil
-      field.name, offset = fieldGetString(fieldData, 3, field.name)
-      if functions[field.type+1].load then
-        functions[field.type+1].load(field, fieldData, offset)
-      end
-      if field.min == 0 then field.min = nil end
-      if field.max == 0 then field.max = nil end
+      parseField(field, fieldId, fieldData)
     end
 
     fieldChunk = 0
     fieldData = {}
 
     -- Last field loaded, add the list of devices to the end
-    if #loadQ == 0 then
+    if #loadQ == 0 and batchFrom == 0 then
       createDeviceFields()
     end
   end
@@ -523,7 +602,14 @@ local function parseElrsInfoMessage(data)
     elrsFlags = newFlags
     titleShowWarnTimeout = 0
   end
-  elrsFlagsInfo = fieldGetString(data, 7)
+  local offset
+  elrsFlagsInfo, offset = fieldGetString(data, 7)
+  -- Followed by the parameters version, when it moves fetch what changed
+  local newVersion = data[offset] or 0
+  if paramsVersion ~= 0 and newVersion ~= 0 and loadedVersion ~= 0 and newVersion ~= loadedVersion
+    and batchFrom == 0 and #loadQ == 0 and not fieldPopup then
+    startBatch(loadedVersion)
+  end
 
   local state = (bit32.btest(elrsFlags, 1) and "C") or "-"
   goodBadPkt = string.format("%u/%u   %s", badPkt, goodPkt, state)
@@ -547,7 +633,9 @@ local function refreshNext()
     parseDeviceInfoMessage(data)
   elseif command == 0x2B then
     parseParameterInfoMessage(data)
-    if #loadQ > 0 then
+    if batchFrom ~= 0 and batchMore then
+      fieldTimeout = getTime() + 50 -- wait for the rest of the batch
+    elseif #loadQ > 0 or batchFrom ~= 0 then
       fieldTimeout = 0 -- request next chunk immediately
     elseif fieldPopup then
       fieldTimeout = getTime() + fieldPopup.timeout
@@ -575,7 +663,18 @@ local function refreshNext()
     end
     linkstatTimeout = time + 100
   elseif time > fieldTimeout and fields_count ~= 0 and not edit then
-    if #loadQ > 0 then
+    if batchFrom ~= 0 and batchRetries >= BATCH_MAX_RETRIES then
+      -- It doesn't do batches after all, load the fields one by one
+      batchUnanswered = true
+      paramsVersion = 0
+      batchFrom = 0
+      reloadAllField()
+      fieldTimeout = 0
+    elseif batchFrom ~= 0 then
+      crossfireTelemetryPush(0x2C, { deviceId, handsetId, 0xFE, batchFrom, loadedVersion })
+      batchRetries = batchRetries + 1
+      fieldTimeout = time + 50 -- 0.5s
+    elseif #loadQ > 0 then
       crossfireTelemetryPush(0x2C, { deviceId, handsetId, loadQ[#loadQ], fieldChunk })
       fieldTimeout = time + 50 -- 0.5s
     end
@@ -668,6 +767,13 @@ local function reloadCurField()
 end
 
 local function reloadRelatedFields(field)
+  if paramsVersion ~= 0 then
+    -- Whatever the write changed comes in the next batch
+    startBatch(loadedVersion)
+    fieldTimeout = getTime() + 20
+    return
+  end
+
   -- Reload the parent folder to update the description
   if field.parent then
     loadQ[#loadQ+1] = field.parent
@@ -89,8 +89,15 @@ def patch_rx_params(mm, pos, args):
     if args.r9mm_mini_sbus != None:
         val &= ~4
         val |= (args.r9mm_mini_sbus << 2)
+    if args.rcvr_mavlink != None:
+        val &= ~8
+        val |= (args.rcvr_mavlink << 3)
     mm[pos] = val
-    return pos + 1
+    pos += 1
+    if args.rcvr_output_rate != None:
+        mm[pos + 0] = (args.rcvr_output_rate >> 0) & 0xFF
+        mm[pos + 1] = (args.rcvr_output_rate >> 8) & 0xFF
+    return pos + 2
 
 def patch_tx_params(mm, pos, args):
     pos = write32(mm, pos, args.tlm_report)
@@ -291,10 +298,15 @@ def print_config(mm, pos):
         invert_tx = (val & 1) == 1
         lock_on_first_connection = (val & 2) == 2
         r9mm_mini_sbus = (val & 4) == 4
+        rcvr_mavlink = (val & 8) == 8
+        rcvr_output_rate = mm[pos] + (mm[pos + 1] << 8)
+        pos += 2
         print(f'Receiver CRSF baud rate = {baud}')
         print(f'RCVR_INVERT_TX is {invert_tx}')
         print(f'LOCK_ON_FIRST_CONNECTION is {lock_on_first_connection}')
         print(f'USE_R9MM_MINI_SBUS is {r9mm_mini_sbus}')
+        print(f'RCVR_MAVLINK is {rcvr_mavlink}')
+        print(f'RCVR_OUTPUT_RATE = {rcvr_output_rate}')
     elif _deviceType == 2:  # TXBP
         None
     elif _deviceType == 3:  # VRX
@@ -330,6 +342,10 @@ def main():
     parser.add_argument('--r9mm-mini-sbus', dest='r9mm_mini_sbus', action='store_true', help='Use the SBUS pin for CRSF output, not it will be inverted')
     parser.add_argument('--no-r9mm-mini-sbus', dest='r9mm_mini_sbus', action='store_false', help='Use the normal serial pins for CRSF')
     parser.set_defaults(r9mm_mini_sbus=None)
+    parser.add_argument('--rcvr-mavlink', dest='rcvr_mavlink', action='store_true', help='Talk MAVLink to the flight controller instead of CRSF')
+    parser.add_argument('--no-rcvr-mavlink', dest='rcvr_mavlink', action='store_false', help='Talk CRSF to the flight controller')
+    parser.set_defaults(rcvr_mavlink=None)
+    parser.add_argument('--rcvr-output-rate', type=int, const=0, nargs='?', action='store', help='The rate (in Hz) of RC frames to the flight controller, 0 for every packet')
     # TX Params
     parser.add_argument('--tlm-report', type=int, const=320, nargs='?', action='store', help='The interval (in milliseconds) between telemetry packets')
     parser.add_argument('--fan-min-runtime', type=int, const=30, nargs='?', action='store', help='The minimum amount of time the fan should run for (in seconds) if it turns on')
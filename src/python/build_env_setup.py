@@ -81,6 +81,7 @@ elif platform in ['espressif8266']:
         env.Replace(UPLOADCMD=upload_via_esp8266_backpack.on_upload)
 
 elif platform in ['espressif32']:
+    env.AddPostAction("buildprog", esp_compress.compressFirmware)
     if "_WIFI" in target_name:
         env.Replace(UPLOAD_PROTOCOL="custom")
         env.Replace(UPLOADCMD=upload_via_esp8266_backpack.on_upload)
@@ -55,6 +55,9 @@ def process_json_flag(define):
         if parts.group(1) == "RCVR_UART_BAUD" and isRX:
             parts = re.search("-D(.*)\s*=\s*\"?([0-9]+).*\"?$", define)
             json_flags['rcvr-uart-baud'] = int(dequote(parts.group(2)))
+        if parts.group(1) == "RCVR_OUTPUT_RATE" and isRX:
+            parts = re.search("-D(.*)\s*=\s*\"?([0-9]+).*\"?$", define)
+            json_flags['rcvr-output-rate'] = int(dequote(parts.group(2)))
     if define == "-DUART_INVERTED" and not isRX:
         json_flags['uart-inverted'] = True
     if define == "-DUNLOCK_HIGHER_POWER"  and not isRX:
@@ -63,6 +66,8 @@ def process_json_flag(define):
         json_flags['rcvr-invert-tx'] = True
     if define == "-DLOCK_ON_FIRST_CONNECTION" and isRX:
         json_flags['lock-on-first-connection'] = True
+    if define == "-DRCVR_MAVLINK" and isRX:
+        json_flags['rcvr-mavlink'] = True
 
 def process_build_flag(define):
     if define.startswith("-D") or define.startswith("!-D"):
@@ -37,7 +37,8 @@ def build_html(mainfile, var, out, env, isTX=False):
             'VERSION': get_version(env),
             'PLATFORM': re.sub("_via_.*", "", env['PIOENV']),
             'isTX': isTX,
-            'sx127x': '-DRADIO_SX127X=1' in env['BUILD_FLAGS']
+            'sx127x': '-DRADIO_SX127X=1' in env['BUILD_FLAGS'],
+            'esp32': env.get('PIOPLATFORM', '') == 'espressif32'
         })
     if mainfile.endswith('.html'):
         data = html_minifier.html_minify(data)
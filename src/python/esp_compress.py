@@ -10,7 +10,7 @@ FIRMWARE_PACKING_ENABLED = True
 # https://gist.github.com/andrewwalters/d4e3539319e55fc980db1ba67254d7ed
 #
 def binary_compress(target_file, source_file):
-    """ Compress ESP8266 firmware using gzip for 'compressed OTA upload' """
+    """ Compress ESP8266/ESP32 firmware using gzip for 'compressed OTA upload' """
     do_compress = True
     source_file_bak = source_file
     if target_file == source_file:
@@ -44,7 +44,7 @@ def binary_compress(target_file, source_file):
 
 
 def compressFirmware(source, target, env):
-    """ Compress ESP8266 firmware using gzip for 'compressed OTA upload' """
+    """ Compress ESP8266/ESP32 firmware using gzip for 'compressed OTA upload' """
     if FIRMWARE_PACKING_ENABLED:
         build_dir = env.subst("$BUILD_DIR")
         image_name = env.subst("$PROGNAME")
@@ -0,0 +1,130 @@
+#!/usr/bin/python
+
+# Decode the link log downloaded from http://10.0.0.1/linklog.bin on a TX or RX
+# built with DEBUG_LINK_LOG into CSV, one row per packet slot, followed by a
+# summary per FHSS channel.
+
+import argparse
+import struct
+import sys
+import csv
+
+LINK_LOG_MAGIC = 0x474C4C45
+HEADER_FORMAT = '<IBBBBBBHI'
+RECORD_FORMAT = '<HBBbbbBhh'
+
+LINK_LOG_RECEIVED = 0x01
+LINK_LOG_CRC_ERROR = 0x02
+LINK_LOG_ANTENNA = 0x04
+LINK_LOG_TELEMETRY = 0x08
+LINK_LOG_FREQ_ERROR = 0x10
+LINK_LOG_CONNECTED = 0x20
+
+RATES = ['LORA_4HZ', 'LORA_25HZ', 'LORA_50HZ', 'LORA_100HZ', 'LORA_100HZ_8CH', 'LORA_150HZ',
+         'LORA_200HZ', 'LORA_250HZ', 'LORA_333HZ_8CH', 'LORA_500HZ', 'DVDA_250HZ', 'DVDA_500HZ',
+         'FLRC_500HZ', 'FLRC_1000HZ']
+
+class LinkLogError(Exception):
+    pass
+
+def decode(blob):
+    header_size = struct.calcsize(HEADER_FORMAT)
+    if len(blob) < header_size:
+        raise LinkLogError('file is too short')
+    (magic, version, record_size, role, snr_scale, rate, frozen, count, total) = \
+        struct.unpack_from(HEADER_FORMAT, blob, 0)
+    if magic != LINK_LOG_MAGIC:
+        raise LinkLogError('not a link log')
+    if version != 1 or record_size < struct.calcsize(RECORD_FORMAT):
+        raise LinkLogError(f'unsupported log version {version}')
+    count = min(count, (len(blob) - header_size) // record_size)
+
+    header = {
+        'role': 'RX' if role else 'TX',
+        'snr_scale': snr_scale,
+        'rate': RATES[rate] if rate < len(RATES) else str(rate),
+        'frozen': frozen != 0,
+        'count': count,
+        'total': total,
+    }
+    records = []
+    for i in range(count):
+        (time_ms, nonce, channel, rssi0, rssi1, snr, flags, freq_error, pfd) = \
+            struct.unpack_from(RECORD_FORMAT, blob, header_size + i * record_size)
+        antenna = 1 if flags & LINK_LOG_ANTENNA else 0
+        records.append({
+            'time_ms': time_ms,
+            'nonce': nonce,
+            'channel': channel,
+            'antenna': antenna,
+            'rssi': rssi1 if antenna else rssi0,
+            'rssi0': rssi0,
+            'rssi1': rssi1,
+            'snr': snr / snr_scale if snr_scale else snr,
+            'received': int(flags & LINK_LOG_RECEIVED != 0),
+            'crc_error': int(flags & LINK_LOG_CRC_ERROR != 0),
+            'telemetry': int(flags & LINK_LOG_TELEMETRY != 0),
+            'connected': int(flags & LINK_LOG_CONNECTED != 0),
+            'freq_error': freq_error if flags & LINK_LOG_FREQ_ERROR else '',
+            'pfd_offset': pfd,
+        })
+    return (header, records)
+
+def unwrap_time(records):
+    # Only the low 16 bits of millis() are stored, slots are never that far apart
+    base = 0
+    last = None
+    for r in records:
+        if last is not None and r['time_ms'] < last:
+            base += 0x10000
+        last = r['time_ms']
+        r['time_ms'] += base
+
+def channel_summary(header, records):
+    # Slots the RX transmits in aren't expected to receive anything on the RX,
+    # and the TX only logs those slots
+    expected = [r for r in records if r['connected'] and (header['role'] == 'TX' or not r['telemetry'])]
+    channels = {}
+    for r in expected:
+        c = channels.setdefault(r['channel'], {'slots': 0, 'received': 0, 'crc_error': 0, 'rssi': 0})
+        c['slots'] += 1
+        if r['received']:
+            c['received'] += 1
+            c['rssi'] += r['rssi']
+        c['crc_error'] += r['crc_error']
+    return channels
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode an ExpressLRS link log')
+    parser.add_argument('file', type=argparse.FileType('rb'), help='linklog.bin downloaded from the device')
+    parser.add_argument('--csv', type=argparse.FileType('w'), default=sys.stdout, help='Where to write the records (default stdout)')
+    parser.add_argument('--summary', action='store_true', help='Print only the summary')
+    args = parser.parse_args()
+
+    try:
+        (header, records) = decode(args.file.read())
+    except LinkLogError as e:
+        sys.exit(f'{args.file.name}: {e}')
+    unwrap_time(records)
+
+    if not args.summary and records:
+        writer = csv.DictWriter(args.csv, fieldnames=records[0].keys())
+        writer.writeheader()
+        writer.writerows(records)
+
+    out = sys.stderr if args.csv == sys.stdout and not args.summary else sys.stdout
+    print(f"{header['role']} log at {header['rate']}: {header['count']} of {header['total']} slots"
+          f"{', stopped after a connection loss' if header['frozen'] else ''}", file=out)
+    if records:
+        print(f"{(records[-1]['time_ms'] - records[0]['time_ms']) / 1000:.1f}s", file=out)
+    channels = channel_summary(header, records)
+    if channels:
+        print('channel  slots  lost%  crc_err  avg_rssi', file=out)
+        for ch in sorted(channels):
+            c = channels[ch]
+            lost = 100 * (c['slots'] - c['received']) / c['slots']
+            rssi = f"{c['rssi'] / c['received']:.0f}" if c['received'] else '-'
+            print(f"{ch:7}  {c['slots']:5}  {lost:5.1f}  {c['crc_error']:7}  {rssi:>8}", file=out)
+
+if __name__ == '__main__':
+    main()
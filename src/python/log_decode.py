@@ -0,0 +1,163 @@
+#!/usr/bin/python
+
+# Turn the binary frames written by a firmware built with DEBUG_LOG_TOKENIZED
+# back into log lines, using the format strings in the firmware's ELF file.
+#
+#   log_decode.py .pio/build/<target>/firmware.elf /dev/ttyUSB0
+#   log_decode.py .pio/build/<target>/firmware.elf capture.bin
+
+import argparse
+import re
+import struct
+import sys
+
+SYNC = 0xEC
+SYNC_NO_NEWLINE = 0xED
+FLAG_NEWLINE = 0x01
+FLAG_ERROR = 0x02
+TOKEN_DROPPED = 0
+
+SPECIFIER = re.compile(r'%[-+ 0#]*\d*(?:\.\d+)?(l|ll|h|hh|z)?([diuxXcsf%])')
+
+class ElfStrings:
+    '''Read format strings out of the allocated sections of an ELF file by address'''
+    def __init__(self, f):
+        self.data = f.read()
+        if self.data[:4] != b'\x7fELF':
+            raise ValueError('not an ELF file')
+        is64 = self.data[4] == 2
+        endian = '<' if self.data[5] == 1 else '>'
+        if is64:
+            (shoff,) = struct.unpack_from(endian + 'Q', self.data, 0x28)
+            (shentsize, shnum) = struct.unpack_from(endian + 'HH', self.data, 0x3A)
+            section = endian + 'IIQQQQ'
+        else:
+            (shoff,) = struct.unpack_from(endian + 'I', self.data, 0x20)
+            (shentsize, shnum) = struct.unpack_from(endian + 'HH', self.data, 0x2E)
+            section = endian + 'IIIIII'
+        self.sections = []
+        for i in range(shnum):
+            (_, sh_type, flags, addr, offset, size) = struct.unpack_from(section, self.data, shoff + i * shentsize)
+            # SHF_ALLOC and not SHT_NOBITS, the tokens are truncated to 32 bits
+            if flags & 2 and sh_type != 8 and addr:
+                self.sections.append((addr & 0xFFFFFFFF, offset, size))
+        self.cache = {}
+
+    def string(self, addr):
+        if addr in self.cache:
+            return self.cache[addr]
+        fmt = None
+        for (start, offset, size) in self.sections:
+            if start <= addr < start + size:
+                pos = offset + addr - start
+                end = self.data.find(b'\0', pos, offset + size)
+                if end >= 0:
+                    fmt = self.data[pos:end].decode('utf-8', 'replace')
+                break
+        self.cache[addr] = fmt
+        return fmt
+
+def format_args(fmt, args):
+    '''Substitute the packed arguments, the same specifiers debugPrintf() supports'''
+    out = []
+    pos = 0
+    last = 0
+    for m in SPECIFIER.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        conv = m.group(2)
+        if conv == '%':
+            out.append('%')
+            continue
+        if conv == 's':
+            if pos >= len(args):
+                out.append('?')
+                continue
+            n = args[pos]
+            out.append(args[pos + 1:pos + 1 + n].decode('utf-8', 'replace'))
+            pos += 1 + n
+            continue
+        if pos + 4 > len(args):
+            out.append('?')
+            continue
+        raw = args[pos:pos + 4]
+        pos += 4
+        if conv in 'di':
+            out.append(str(struct.unpack('<i', raw)[0]))
+        elif conv == 'u':
+            out.append(str(struct.unpack('<I', raw)[0]))
+        elif conv in 'xX':
+            out.append(format(struct.unpack('<I', raw)[0], conv))
+        elif conv == 'c':
+            out.append(chr(raw[0]))
+        elif conv == 'f':
+            out.append(f"{struct.unpack('<f', raw)[0]:.3f}")
+    out.append(fmt[last:])
+    return ''.join(out)
+
+def frames(stream):
+    '''Yield (token, flags, args) for each good frame, text between frames is passed through'''
+    buf = bytearray()
+    while True:
+        chunk = stream.read(1)
+        if not chunk:
+            return
+        buf += chunk
+        while buf:
+            if buf[0] not in (SYNC, SYNC_NO_NEWLINE):
+                # Plain text from before the logger started, or something else on the UART
+                yield (None, 0, bytes(buf[:1]))
+                del buf[0]
+                continue
+            if len(buf) < 2 or len(buf) < buf[1] + 3:
+                break
+            length = buf[1]
+            body = buf[2:2 + length]
+            if length < 5 or (length + sum(body)) & 0xFF != buf[2 + length]:
+                yield (None, 0, bytes(buf[:1]))
+                del buf[0]
+                continue
+            (token, flags) = struct.unpack_from('<IB', body, 0)
+            yield (token, flags, bytes(body[5:]))
+            del buf[:length + 3]
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode ExpressLRS tokenized debug logging')
+    parser.add_argument('elf', type=argparse.FileType('rb'), help='The firmware.elf the device is running')
+    parser.add_argument('input', help='A serial port or a file with the captured output')
+    parser.add_argument('-b', '--baud', type=int, default=420000, help='Baud rate of the serial port')
+    args = parser.parse_args()
+
+    strings = ElfStrings(args.elf)
+    try:
+        stream = open(args.input, 'rb')
+    except OSError:
+        import serial
+        stream = serial.Serial(args.input, args.baud)
+
+    line = ''
+    try:
+        for (token, flags, data) in frames(stream):
+            if token is None:
+                line += data.decode('latin-1')
+            elif token == TOKEN_DROPPED:
+                line += f'[{struct.unpack("<I", data[:4])[0]} log entries dropped]'
+                flags = FLAG_NEWLINE
+            else:
+                fmt = strings.string(token)
+                if fmt is None:
+                    line += f'[unknown token 0x{token:08x}, wrong ELF?]'
+                else:
+                    if not line and flags & FLAG_ERROR:
+                        line = 'ERROR: '
+                    line += format_args(fmt, data)
+            if flags & FLAG_NEWLINE or line.endswith('\n'):
+                print(line.rstrip('\r\n'), flush=True)
+                line = ''
+    except KeyboardInterrupt:
+        pass
+    if line:
+        print(line)
+
+if __name__ == '__main__':
+    main()
@@ -115,6 +115,9 @@ def on_upload(source, target, env):
     bin_path = os.path.dirname(firmware_path)
     upload_addr = ['elrs_tx', 'elrs_tx.local']
     elrs_bin_target = os.path.join(bin_path, 'firmware.elrs')
+    if not os.path.exists(elrs_bin_target) and env.get('PIOPLATFORM', '') in ['espressif32']:
+        # The ESP32 decompresses the image while flashing it and still checks the target
+        elrs_bin_target = os.path.join(bin_path, 'firmware.bin.gz')
     if not os.path.exists(elrs_bin_target):
         elrs_bin_target = os.path.join(bin_path, 'firmware.bin')
         if not os.path.exists(elrs_bin_target):
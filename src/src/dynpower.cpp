@@ -2,20 +2,15 @@
 
 #include <dynpower.h>
 #include <common.h>
+#include <DynPowerModel.h>
 
 // LQ-based boost defines
 #define DYNPOWER_LQ_BOOST_THRESH_DIFF 20  // If LQ is dropped suddenly for this amount (relative), immediately boost to the max power configured.
 #define DYNPOWER_LQ_BOOST_THRESH_MIN  50  // If LQ is below this value (absolute), immediately boost to the max power configured.
 #define DYNPOWER_LQ_MOVING_AVG_K      8   // Number of previous values for calculating moving average. Best with power of 2.
-#define DYNPOWER_LQ_THRESH_UP         85  // Below this LQ, the RSSI/SNR code will increase the power if RSSI/SNR did nothing
-
-// RSSI-based increment defines
-#define DYNPOWER_RSSI_CNT 5               // Number of RSSI readings to average (straight average) to make an RSSI-based adjustment
-#define DYNPOWER_RSSI_THRESH_UP 15        // RSSI < (Sensitivity+Up) -> raise power
-#define DYNPOWER_RSSI_THRESH_DN 21        // RSSI > (Sensitivity+Dn) >- lower power
-
-// SNR-based increment defines
-#define DYNPOWER_LQ_THRESH_DN 95          // Min LQ for lowering power using SNR-based power lowering
+#define DYNPOWER_LQ_THRESH_UP         85  // Below this LQ, increase the power if the model did nothing
+#define DYNPOWER_LQ_THRESH_DN         95  // Min LQ for lowering power
+#define DYNPOWER_LQ_SHORT_NONE        0xff // No 100ms LQ received since the last update
 
 template<uint8_t K, uint8_t SHIFT>
 class MovingAvg
@@ -32,9 +27,11 @@ private:
 };
 
 static MovingAvg<DYNPOWER_LQ_MOVING_AVG_K, 16> dynpower_mavg_lq;
-static MeanAccumulator<int32_t, int8_t, -128> dynpower_mean_rssi;
+static DynPowerModel dynpower_model;
+static expresslrs_rf_pref_params_s *dynpower_model_rfperf;
 static int8_t dynpower_updated;
 static uint32_t dynpower_last_linkstats_millis;
+static uint8_t dynpower_lq_short;
 
 static void DynamicPower_SetToConfigPower()
 {
@@ -44,7 +41,9 @@ static void DynamicPower_SetToConfigPower()
 void DynamicPower_Init()
 {
     dynpower_mavg_lq = 100;
+    dynpower_model_rfperf = nullptr;
     dynpower_updated = DYNPOWER_UPDATE_NOUPDATE;
+    dynpower_lq_short = DYNPOWER_LQ_SHORT_NONE;
 }
 
 void ICACHE_RAM_ATTR DynamicPower_TelemetryUpdate(int8_t snrScaled)
@@ -52,10 +51,17 @@ void ICACHE_RAM_ATTR DynamicPower_TelemetryUpdate(int8_t snrScaled)
     dynpower_updated = snrScaled;
 }
 
+void ICACHE_RAM_ATTR DynamicPower_UplinkLQShort(uint8_t lq)
+{
+    dynpower_lq_short = lq;
+}
+
 void DynamicPower_Update(uint32_t now)
 {
   int8_t snrScaled = dynpower_updated;
   dynpower_updated = DYNPOWER_UPDATE_NOUPDATE;
+  uint8_t lq_short = dynpower_lq_short;
+  dynpower_lq_short = DYNPOWER_LQ_SHORT_NONE;
 
   bool newTlmAvail = snrScaled > DYNPOWER_UPDATE_MISSED;
   bool lastTlmMissed = snrScaled == DYNPOWER_UPDATE_MISSED;
@@ -100,8 +106,8 @@ void DynamicPower_Update(uint32_t now)
 
   if (lastTlmMissed)
   {
-    // If armed and missing telemetry, raise the power, but only after the first LinkStats is missed (which come
-    // at most every 512ms). This delays the first increase, then will bump it once for each missed TLM after that
+    // If armed and missing telemetry, go to the configured power, but only after the first LinkStats is missed (which come
+    // at most every 512ms). With no reports there's nothing to model the link on, and they're missed because it's poor
     // state == connected is not used: unplugging an RX will be connected and will boost power to max before disconnect
     if (armed && (powerHeadroom > 0))
     {
@@ -110,7 +116,7 @@ void DynamicPower_Update(uint32_t now)
       if ((now - dynpower_last_linkstats_millis) > (linkstatsInterval + 2U))
       {
         DBGLN("+power (tlm)");
-        POWERMGNT::incPower();
+        DynamicPower_SetToConfigPower();
       }
     }
     return;
@@ -129,60 +135,43 @@ void DynamicPower_Update(uint32_t now)
   int32_t lq_diff = lq_avg - lq_current;
   dynpower_mavg_lq.add(lq_current);
   // if LQ drops quickly (DYNPOWER_LQ_BOOST_THRESH_DIFF) or critically low below DYNPOWER_LQ_BOOST_THRESH_MIN, immediately boost to the configured max power.
-  if (lq_diff >= DYNPOWER_LQ_BOOST_THRESH_DIFF || lq_current <= DYNPOWER_LQ_BOOST_THRESH_MIN)
+  // The RX's 100ms LQ sees a sudden drop well before the full window LQ does
+  if (lq_diff >= DYNPOWER_LQ_BOOST_THRESH_DIFF || lq_current <= DYNPOWER_LQ_BOOST_THRESH_MIN
+    || (lq_short != DYNPOWER_LQ_SHORT_NONE && lq_short <= DYNPOWER_LQ_BOOST_THRESH_MIN))
   {
       DynamicPower_SetToConfigPower();
       return;
   }
 
-  PowerLevels_e startPowerLevel = POWERMGNT::currPower();
-  if (ExpressLRS_currAirRate_RFperfParams->DynpowerSnrThreshUp == DYNPOWER_SNR_THRESH_NONE)
+  // =============  Path loss model ==============
+  // Estimate the path loss from the power sent at and the RSSI reported, and go straight
+  // to the level which keeps the margin over the rate's sensitivity
+  if (dynpower_model_rfperf != ExpressLRS_currAirRate_RFperfParams)
   {
-    // =============  RSSI-based power increment ==============
-    // a simple threshold compared against N sample average of
-    // rssi vs the sensitivity limit +/- some thresholds
-    dynpower_mean_rssi.add(rssi);
+    dynpower_model_rfperf = ExpressLRS_currAirRate_RFperfParams;
+    bool useSnr = dynpower_model_rfperf->DynpowerSnrThreshUp != DYNPOWER_SNR_THRESH_NONE;
+    dynpower_model.setRate(dynpower_model_rfperf->RXsensitivity,
+      useSnr ? SNR_DESCALE(dynpower_model_rfperf->DynpowerSnrThreshUp) : 0,
+      useSnr ? SNR_DESCALE(dynpower_model_rfperf->DynpowerSnrThreshDn) : 0, useSnr);
+    dynpower_model.reset(now);
+  }
 
-    if (dynpower_mean_rssi.getCount() >= DYNPOWER_RSSI_CNT)
-    {
-      int32_t expected_RXsensitivity = ExpressLRS_currAirRate_RFperfParams->RXsensitivity;
-      int8_t rssi_inc_threshold = expected_RXsensitivity + DYNPOWER_RSSI_THRESH_UP;
-      int8_t rssi_dec_threshold = expected_RXsensitivity + DYNPOWER_RSSI_THRESH_DN;
-      int8_t avg_rssi = dynpower_mean_rssi.mean(); // resets it too
-      if ((avg_rssi < rssi_inc_threshold) && (powerHeadroom > 0))
-      {
-        DBGLN("+power (rssi)");
-        POWERMGNT::incPower();
-      }
-      else if (avg_rssi > rssi_dec_threshold && lq_avg >= DYNPOWER_LQ_THRESH_DN)
-      {
-        DBGVLN("-power (rssi)"); // Verbose because this spams when idle
-        POWERMGNT::decPower();
-      }
-    }
-  } // ^^ if RSSI-based
-  else
+  PowerLevels_e startPowerLevel = POWERMGNT::currPower();
+  dynpower_model.update(startPowerLevel, rssi, SNR_DESCALE(snrScaled));
+  PowerLevels_e newPowerLevel = (PowerLevels_e)dynpower_model.selectLevel(now, startPowerLevel,
+    POWERMGNT::getMinPower(), config.GetPower(), armed, lq_avg >= DYNPOWER_LQ_THRESH_DN);
+  if (newPowerLevel > startPowerLevel)
   {
-    // =============  SNR-based power increment ==============
-    // Decrease the power if SNR above threshold and LQ is good
-    // Increase the power for each (X) SNR below the threshold
-    if (snrScaled >= ExpressLRS_currAirRate_RFperfParams->DynpowerSnrThreshDn && lq_avg >= DYNPOWER_LQ_THRESH_DN)
-    {
-      DBGVLN("-power (snr)"); // Verbose because this spams when idle
-      POWERMGNT::decPower();
-    }
-
-    while ((snrScaled <= ExpressLRS_currAirRate_RFperfParams->DynpowerSnrThreshUp) && (powerHeadroom > 0))
-    {
-      DBGLN("+power (snr)");
-      POWERMGNT::incPower();
-      // Every power doubling will theoretically increase the SNR by 3dB, but closer to 2dB in testing
-      snrScaled += SNR_SCALE(2);
-      --powerHeadroom;
-    }
-  } // ^^ if SNR-based
+    DBGLN("+power (model %ddB loss)", dynpower_model.getPathLoss());
+    POWERMGNT::setPower(newPowerLevel);
+  }
+  else if (newPowerLevel < startPowerLevel)
+  {
+    DBGVLN("-power (model %ddB loss)", dynpower_model.getPathLoss()); // Verbose because this spams when idle
+    POWERMGNT::setPower(newPowerLevel);
+  }
 
-  // If instant LQ is low, but the SNR/RSSI did nothing, inc power by one step
+  // If instant LQ is low, but the model did nothing, inc power by one step
   if ((powerHeadroom > 0) && (startPowerLevel == POWERMGNT::currPower()) && (lq_current <= DYNPOWER_LQ_THRESH_UP))
   {
     DBGLN("+power (lq)");
@@ -11,8 +11,14 @@
 #include "msp.h"
 #include "msptypes.h"
 #include "PFD.h"
+#include "FreqCorrector.h"
+#include "DvdaCombiner.h"
 #include "options.h"
 #include "MeanAccumulator.h"
+#include "mavlink_serial.h"
+#include "LinkLog.h"
+#include "LQWindows.h"
+#include "DiversityPredictor.h"
 
 #include "devCRSF.h"
 #include "devLED.h"
@@ -29,8 +35,6 @@
 
 //// CONSTANTS ////
 #define SEND_LINK_STATS_TO_FC_INTERVAL 100
-#define DIVERSITY_ANTENNA_INTERVAL 5
-#define DIVERSITY_ANTENNA_RSSI_TRIGGER 5
 #define PACKET_TO_TOCK_SLACK 200 // Desired buffer time between Packet ISR and Tock ISR
 ///////////////////
 
@@ -69,6 +73,11 @@ Crc2Byte ota_crc;
 ELRS_EEPROM eeprom;
 RxConfig config;
 Telemetry telemetry;
+MAVLinkSerial mavlink;
+#if defined(HAS_LINK_LOG)
+LinkLog linkLog(LINK_LOG_ROLE_RX);
+static int8_t linkLogRssi[2]; // latest reading from each antenna
+#endif
 Stream *SerialLogger;
 bool hardwareConfigured = true;
 
@@ -111,9 +120,20 @@ static bool telemBurstValid;
 LPF LPF_Offset(2);
 LPF LPF_OffsetDx(4);
 
+/// FEI Frequency Correction /////////
+#if defined(RADIO_SX127X)
+static const freqcorr_tuning_t FreqCorrTuning = FREQ_CORR_TUNING_900(FREQ_STEP);
+#elif defined(RADIO_SX128X)
+static const freqcorr_tuning_t FreqCorrTuning = FREQ_CORR_TUNING_2G4(FREQ_STEP);
+#endif
+FreqCorrector FreqCorrEstimator(FreqCorrTuning);
+
 /// LQ/RSSI/SNR Calculation //////////
 LQCALC<100> LQCalc;
 LQCALC<100> LQCalcDVDA;
+LQWindows uplinkLQWindows;
+DiversityPredictor diversity;
+DvdaCombiner DvdaPacketCombiner;
 uint8_t uplinkLQ;
 LPF LPF_UplinkRSSI0(5);  // track rssi per antenna
 LPF LPF_UplinkRSSI1(5);
@@ -143,9 +163,7 @@ static uint32_t SendLinkStatstoFCintervalLastSent;
 static uint8_t SendLinkStatstoFCForcedSends;
 
 int16_t RFnoiseFloor; //measurement of the current RF noise floor
-#if defined(DEBUG_RX_SCOREBOARD)
 static bool lastPacketCrcError;
-#endif
 ///////////////////////////////////////////////////////////////
 
 /// Variables for Sync Behaviour ////
@@ -205,6 +223,9 @@ static uint8_t minLqForChaos()
 void ICACHE_RAM_ATTR getRFlinkInfo()
 {
     int32_t rssiDBM = Radio.LastPacketRSSI;
+#if defined(HAS_LINK_LOG)
+    linkLogRssi[antenna] = rssiDBM;
+#endif
     if (antenna == 0)
     {
         #if !defined(DEBUG_RCVR_LINKSTATS)
@@ -264,6 +285,11 @@ void SetRFLinkRate(uint8_t index) // Set speed of RF link
     interval = interval * 12 / 10; // increase the packet interval by 20% to allow adding packet header
 #endif
     hwTimer.updateInterval(interval);
+    uplinkLQWindows.setInterval(interval);
+    const uint16_t outputRate = firmwareOptions.rcvr_output_rate;
+    crsfSetPacketInterval(interval * ModParams->numOfSends, outputRate ? 1000000U / outputRate : 0);
+    diversity.setSensitivity(RFperf->RXsensitivity);
+    diversity.reset();
     Radio.Config(ModParams->bw, ModParams->sf, ModParams->cr, GetInitialFreq(),
                  ModParams->PreambleLen, invertIQ, ModParams->PayloadLength, 0
 #if defined(RADIO_SX128X)
@@ -283,6 +309,22 @@ void SetRFLinkRate(uint8_t index) // Set speed of RF link
     telemBurstValid = false;
 }
 
+/**
+ * Apply the frequency error measured since the last hop to FreqCorrection
+ * Must be called before hopping so the new frequency includes the correction
+ **/
+static void ICACHE_RAM_ATTR HandleFreqCorr()
+{
+    if (!FreqCorrEstimator.apply(FreqCorrection))
+        return;
+
+    //DBGVLN(FreqCorrection);
+    #if defined(RADIO_SX127X)
+    // Teamp900 also needs to adjust its demood PPM
+    Radio.SetPPMoffsetReg(FreqCorrection);
+    #endif /* RADIO_SX127X */
+}
+
 bool ICACHE_RAM_ATTR HandleFHSS()
 {
     uint8_t modresultFHSS = (OtaNonce + 1) % ExpressLRS_currAirRate_Modparams->FHSShopInterval;
@@ -293,6 +335,7 @@ bool ICACHE_RAM_ATTR HandleFHSS()
     }
 
     alreadyFHSS = true;
+    HandleFreqCorr();
     Radio.SetFrequencyReg(FHSSgetNextFreq());
 
     uint8_t modresultTLM = (OtaNonce + 1) % ExpressLRS_currTlmDenom;
@@ -358,6 +401,9 @@ bool ICACHE_RAM_ATTR HandleSendTelemetryResponse()
         {
             otaPkt.std.tlm_dl.type = ELRS_TELEMETRY_TYPE_LINK;
             ls = &otaPkt.std.tlm_dl.ul_link_stats.stats;
+            otaPkt.std.tlm_dl.packageIndex = OTA4_LQ_SHORT_TO_INDEX(uplinkLQWindows.getLQ(LQ_WINDOW_SHORT));
+            // The packet which has just been received, if it was
+            otaPkt.std.tlm_dl.ul_link_stats.lastRSSI = LQCalc.currentIsSet() ? constrain(-Radio.LastPacketRSSI, 1, 127) : 0;
         }
         LinkStatsToOta(ls);
 
@@ -403,33 +449,6 @@ bool ICACHE_RAM_ATTR HandleSendTelemetryResponse()
     return true;
 }
 
-void ICACHE_RAM_ATTR HandleFreqCorr(bool value)
-{
-    //DBGVLN(FreqCorrection);
-    if (value)
-    {
-        if (FreqCorrection > FreqCorrectionMin)
-        {
-            FreqCorrection -= 1; // FREQ_STEP units
-        }
-        else
-        {
-            DBGLN("Max -FreqCorrection reached!");
-        }
-    }
-    else
-    {
-        if (FreqCorrection < FreqCorrectionMax)
-        {
-            FreqCorrection += 1; // FREQ_STEP units
-        }
-        else
-        {
-            DBGLN("Max +FreqCorrection reached!");
-        }
-    }
-}
-
 void ICACHE_RAM_ATTR updatePhaseLock()
 {
     if (connectionState != disconnected)
@@ -496,7 +515,11 @@ void ICACHE_RAM_ATTR HWtimerCallbackTick() // this is 180 out of phase with the
     crsf.LinkStatistics.uplink_Link_quality = uplinkLQ;
     // Only advance the LQI period counter if we didn't send Telemetry this period
     if (!alreadyTLMresp)
+    {
+        if (connectionState == connected)
+            uplinkLQWindows.add(LQCalc.currentIsSet());
         LQCalc.inc();
+    }
 
     alreadyTLMresp = false;
     alreadyFHSS = false;
@@ -517,61 +540,22 @@ static inline void switchAntenna()
     }
 }
 
-static void ICACHE_RAM_ATTR updateDiversity()
+/**
+ * Learn from the packet slot which has just ended on the channel it was on,
+ * unless it was this RX sending telemetry in it
+ **/
+static void ICACHE_RAM_ATTR updateDiversity(uint8_t channel, bool tlmSlot)
 {
-
     if (GPIO_PIN_ANTENNA_SELECT != UNDEF_PIN)
     {
         if(config.GetAntennaMode() == 2)
         {
             // 0 and 1 is use for gpio_antenna_select
             // 2 is diversity
-            static int32_t prevRSSI;        // saved rssi so that we can compare if switching made things better or worse
-            static int32_t antennaLQDropTrigger;
-            static int32_t antennaRSSIDropTrigger;
-            int32_t rssi = (antenna == 0) ? LPF_UplinkRSSI0.value() : LPF_UplinkRSSI1.value();
-            int32_t otherRSSI = (antenna == 0) ? LPF_UplinkRSSI1.value() : LPF_UplinkRSSI0.value();
-
-            //if rssi dropped by the amount of DIVERSITY_ANTENNA_RSSI_TRIGGER
-            if ((rssi < (prevRSSI - DIVERSITY_ANTENNA_RSSI_TRIGGER)) && antennaRSSIDropTrigger >= DIVERSITY_ANTENNA_INTERVAL)
-            {
-                switchAntenna();
-                antennaLQDropTrigger = 1;
-                antennaRSSIDropTrigger = 0;
-            }
-            else if (rssi > prevRSSI || antennaRSSIDropTrigger < DIVERSITY_ANTENNA_INTERVAL)
-            {
-                prevRSSI = rssi;
-                antennaRSSIDropTrigger++;
-            }
-
-            // if we didn't get a packet switch the antenna
-            if (!LQCalc.currentIsSet() && antennaLQDropTrigger == 0)
-            {
-                switchAntenna();
-                antennaLQDropTrigger = 1;
-                antennaRSSIDropTrigger = 0;
-            }
-            else if (antennaLQDropTrigger >= DIVERSITY_ANTENNA_INTERVAL)
-            {
-                // We switched antenna on the previous packet, so we now have relatively fresh rssi info for both antennas.
-                // We can compare the rssi values and see if we made things better or worse when we switched
-                if (rssi < otherRSSI)
-                {
-                    // things got worse when we switched, so change back.
-                    switchAntenna();
-                    antennaLQDropTrigger = 1;
-                    antennaRSSIDropTrigger = 0;
-                }
-                else
-                {
-                    // all good, we can stay on the current antenna. Clear the flag.
-                    antennaLQDropTrigger = 0;
-                }
-            }
-            else if (antennaLQDropTrigger > 0)
+            if (!tlmSlot)
             {
-                antennaLQDropTrigger ++;
+                diversity.update(antenna, channel, LQCalc.currentIsSet(),
+                    Radio.LastPacketRSSI, SNR_DESCALE(Radio.LastPacketSNRRaw));
             }
         }
         else
@@ -582,8 +566,49 @@ static void ICACHE_RAM_ATTR updateDiversity()
     }
 }
 
+/**
+ * Switch to the antenna predicted to be better for the next packet, once
+ * hopped to the channel it will be on
+ **/
+static void ICACHE_RAM_ATTR predictDiversity()
+{
+    if (GPIO_PIN_ANTENNA_SELECT != UNDEF_PIN && config.GetAntennaMode() == 2)
+    {
+        if (diversity.predict(antenna, FHSSsequence[FHSSgetCurrIndex()]) != antenna)
+            switchAntenna();
+    }
+}
+
+#if defined(HAS_LINK_LOG)
+/**
+ * Record the packet slot which has just ended
+ **/
+static void ICACHE_RAM_ATTR linkLogAdd(uint8_t channel, bool tlmSlot, bool haveFreqError, int32_t freqError)
+{
+    link_log_record_t rec;
+    rec.timeMs = millis();
+    rec.nonce = OtaNonce;
+    rec.fhssIndex = channel;
+    rec.rssi[0] = linkLogRssi[0];
+    rec.rssi[1] = linkLogRssi[1];
+    rec.snr = Radio.LastPacketSNRRaw;
+    rec.flags = (LQCalc.currentIsSet() ? LINK_LOG_RECEIVED : 0)
+        | (lastPacketCrcError ? LINK_LOG_CRC_ERROR : 0)
+        | (antenna ? LINK_LOG_ANTENNA : 0)
+        | (tlmSlot ? LINK_LOG_TELEMETRY : 0)
+        | (haveFreqError ? LINK_LOG_FREQ_ERROR : 0)
+        | (connectionState == connected ? LINK_LOG_CONNECTED : 0);
+    rec.freqError = constrain(freqError, INT16_MIN, INT16_MAX);
+    rec.pfdOffset = constrain(PfdPrevRawOffset, INT16_MIN, INT16_MAX);
+    linkLog.add(rec);
+}
+#endif
+
 void ICACHE_RAM_ATTR HWtimerCallbackTock()
 {
+    // Before the hop, the channel the packet was expected on
+    const uint8_t channel = FHSSsequence[FHSSgetCurrIndex()];
+    static bool lastTockSentTlm;
     if (ExpressLRS_currAirRate_Modparams->numOfSends > 1 && !(OtaNonce % ExpressLRS_currAirRate_Modparams->numOfSends) && LQCalcDVDA.currentIsSet())
     {
         crsfRCFrameAvailable();
@@ -600,26 +625,33 @@ void ICACHE_RAM_ATTR HWtimerCallbackTock()
 
     PFDloop.intEvent(micros()); // our internal osc just fired
 
-    updateDiversity();
+    // The telemetry from the last tock went out in the slot which has just ended
+    updateDiversity(channel, lastTockSentTlm);
     bool didFHSS = HandleFHSS();
+    predictDiversity();
     bool tlmSent = HandleSendTelemetryResponse();
 
-    if (!didFHSS && !tlmSent && LQCalc.currentIsSet() && Radio.FrequencyErrorAvailable())
+    int32_t freqError = 0;
+    const bool haveFreqError = !didFHSS && !tlmSent && LQCalc.currentIsSet() && Radio.FrequencyErrorAvailable();
+    if (haveFreqError)
     {
-        HandleFreqCorr(Radio.GetFrequencyErrorbool());      // Adjusts FreqCorrection for RX freq offset
-    #if defined(RADIO_SX127X)
-        // Teamp900 also needs to adjust its demood PPM
-        Radio.SetPPMoffsetReg(FreqCorrection);
-    #endif /* RADIO_SX127X */
+        // Measured error is applied to FreqCorrection on the next hop
+        freqError = Radio.GetFrequencyError();
+        FreqCorrEstimator.addSample(freqError);
     }
 
+    #if defined(HAS_LINK_LOG)
+    linkLogAdd(channel, lastTockSentTlm, haveFreqError, freqError);
+    #endif
+    lastTockSentTlm = tlmSent;
+
     #if defined(DEBUG_RX_SCOREBOARD)
     static bool lastPacketWasTelemetry = false;
     if (!LQCalc.currentIsSet() && !lastPacketWasTelemetry)
         DBGW(lastPacketCrcError ? '.' : '_');
-    lastPacketCrcError = false;
     lastPacketWasTelemetry = tlmSent;
     #endif
+    lastPacketCrcError = false;
 }
 
 void LostConnection()
@@ -629,7 +661,12 @@ void LostConnection()
     RFmodeCycleMultiplier = 1;
     connectionState = disconnected; //set lost connection
     RXtimerState = tim_disconnected;
+#if defined(HAS_LINK_LOG)
+    // Keep a little of what follows, then the log holds on to the lead up to this
+    linkLog.trigger(LINK_LOG_RECORDS / 4);
+#endif
     hwTimer.resetFreqOffset();
+    FreqCorrEstimator.reset();
     FreqCorrection = 0;
     #if defined(RADIO_SX127X)
     Radio.SetPPMoffsetReg(0);
@@ -639,6 +676,7 @@ void LostConnection()
     uplinkLQ = 0;
     LQCalc.reset();
     LQCalcDVDA.reset();
+    DvdaPacketCombiner.reset();
     LPF_Offset.init(0);
     LPF_OffsetDx.init(0);
     alreadyTLMresp = false;
@@ -663,6 +701,7 @@ void ICACHE_RAM_ATTR TentativeConnection(unsigned long now)
     connectionHasModelMatch = false;
     RXtimerState = tim_disconnected;
     DBGLN("tentative conn");
+    FreqCorrEstimator.reset();
     FreqCorrection = 0;
     PfdPrevRawOffset = 0;
     LPF_Offset.init(0);
@@ -725,7 +764,17 @@ static void ICACHE_RAM_ATTR ProcessRfPacket_RC(OTA_Packet_s const * const otaPkt
  **/
 void MspReceiveComplete()
 {
-    if (MspData[7] == MSP_SET_RX_CONFIG && MspData[8] == MSP_ELRS_MODEL_ID)
+    const uint8_t *mavData;
+    uint8_t mavLen;
+    if (firmwareOptions.rcvr_mavlink && (mavLen = MAVLinkSerial::UnwrapEnvelope(MspData, &mavData)))
+    {
+        // No MAVLink to the FC if no model match
+        if (connectionHasModelMatch)
+        {
+            crsf.sendRawToFC(mavData, mavLen);
+        }
+    }
+    else if (MspData[7] == MSP_SET_RX_CONFIG && MspData[8] == MSP_ELRS_MODEL_ID)
     {
         UpdateModelMatch(MspData[9]);
     }
@@ -752,14 +801,14 @@ void MspReceiveComplete()
             vtxSPIPowerIdx = MspData[10];
             vtxSPIPitmode = MspData[11];
         }
-        devicesTriggerEvent();
+        devicesTriggerEvent(EVENT_VTX_CHANGED);
     }
     else
     {
         crsf_ext_header_t *receivedHeader = (crsf_ext_header_t *) MspData;
 
-        // No MSP data to the FC if no model match
-        if (connectionHasModelMatch && (receivedHeader->dest_addr == CRSF_ADDRESS_BROADCAST || receivedHeader->dest_addr == CRSF_ADDRESS_FLIGHT_CONTROLLER))
+        // No MSP data to the FC if no model match, nor if it talks MAVLink
+        if (connectionHasModelMatch && !firmwareOptions.rcvr_mavlink && (receivedHeader->dest_addr == CRSF_ADDRESS_BROADCAST || receivedHeader->dest_addr == CRSF_ADDRESS_FLIGHT_CONTROLLER))
         {
             crsf.sendMSPFrameToFC(MspData);
         }
@@ -769,6 +818,7 @@ void MspReceiveComplete()
             crsf.ParameterUpdateData[0] = MspData[CRSF_TELEMETRY_TYPE_INDEX];
             crsf.ParameterUpdateData[1] = MspData[CRSF_TELEMETRY_FIELD_ID_INDEX];
             crsf.ParameterUpdateData[2] = MspData[CRSF_TELEMETRY_FIELD_CHUNK_INDEX];
+            crsf.ParameterUpdateData[3] = MspData[CRSF_TELEMETRY_FIELD_VERSION_INDEX];
             luaParamUpdateReq();
         }
     }
@@ -874,26 +924,45 @@ static bool ICACHE_RAM_ATTR ProcessRfPacket_SYNC(uint32_t const now, OTA_Sync_s
     return false;
 }
 
+/**
+ * Try to recover a DVDA RC packet which failed the CRC by combining it with
+ * the other failed copies in the same DVDA group
+ **/
+static bool ICACHE_RAM_ATTR RecoverDvdaPacket(SX12xxDriverCommon::rx_status const status, OTA_Packet_s * const otaPktPtr)
+{
+    // Only packets with just a CRC error are read from the radio, and there is
+    // nothing to recover if a good copy has already been received this group
+    if (ExpressLRS_currAirRate_Modparams->numOfSends == 1
+        || (status & ~SX12xxDriverCommon::SX12XX_RX_CRC_FAIL) != SX12xxDriverCommon::SX12XX_RX_OK
+        || connectionState != connected
+        || LQCalcDVDA.currentIsSet())
+        return false;
+
+    return DvdaPacketCombiner.add(otaPktPtr, OtaNonce / ExpressLRS_currAirRate_Modparams->numOfSends);
+}
+
 bool ICACHE_RAM_ATTR ProcessRFPacket(SX12xxDriverCommon::rx_status const status)
 {
+    uint32_t const beginProcessing = micros();
+
+    OTA_Packet_s * const otaPktPtr = (OTA_Packet_s * const)Radio.RXdataBuffer;
     if (status != SX12xxDriverCommon::SX12XX_RX_OK)
     {
         DBGVLN("HW CRC error");
-        #if defined(DEBUG_RX_SCOREBOARD)
+        if (!RecoverDvdaPacket(status, otaPktPtr))
+        {
             lastPacketCrcError = true;
-        #endif
-        return false;
+            return false;
+        }
     }
-    uint32_t const beginProcessing = micros();
-
-    OTA_Packet_s * const otaPktPtr = (OTA_Packet_s * const)Radio.RXdataBuffer;
-    if (!OtaValidatePacketCrc(otaPktPtr))
+    else if (!OtaValidatePacketCrc(otaPktPtr))
     {
         DBGVLN("CRC error");
-        #if defined(DEBUG_RX_SCOREBOARD)
+        if (!RecoverDvdaPacket(status, otaPktPtr))
+        {
             lastPacketCrcError = true;
-        #endif
-        return false;
+            return false;
+        }
     }
 
     PFDloop.extEvent(beginProcessing + PACKET_TO_TOCK_SLACK);
@@ -1099,6 +1168,14 @@ void HandleUARTin()
     {
         return;
     }
+    if (firmwareOptions.rcvr_mavlink)
+    {
+        while (CRSF_RX_SERIAL.available())
+        {
+            mavlink.RXhandleUARTin(CRSF_RX_SERIAL.read());
+        }
+        return;
+    }
     while (CRSF_RX_SERIAL.available())
     {
         telemetry.RXhandleUARTin(CRSF_RX_SERIAL.read());
@@ -1257,7 +1334,18 @@ static void checkSendLinkStatsToFc(uint32_t now)
         if ((connectionState != disconnected && connectionHasModelMatch) ||
             SendLinkStatstoFCForcedSends)
         {
-            crsf.sendLinkStatisticsToFC();
+            if (firmwareOptions.rcvr_mavlink)
+            {
+                // RADIO_STATUS also tells the FC how much room there is for its streams
+                uint8_t frame[MAVLINK_MAX_FRAME_LEN];
+                // rssi is the uplink LQ scaled to 0-254, the RX doesn't know how the TX hears it
+                const uint8_t rssi = crsf.LinkStatistics.uplink_Link_quality * 254 / 100;
+                crsf.sendRawToFC(frame, mavlink.BuildRadioStatus(frame, rssi, 0, mavlink.FramesDropped));
+            }
+            else
+            {
+                crsf.sendLinkStatisticsToFC();
+            }
             SendLinkStatstoFCintervalLastSent = now;
             if (SendLinkStatstoFCForcedSends)
                 --SendLinkStatstoFCForcedSends;
@@ -1389,6 +1477,10 @@ void loop()
 
     devicesUpdate(now);
 
+#if defined(DEBUG_LOG_TOKENIZED)
+    debugLogDrain(LOGGING_UART, 8);
+#endif
+
 #if defined(PLATFORM_ESP8266) || defined(PLATFORM_ESP32)
     // If the reboot time is set and the current time is past the reboot time then reboot.
     if (rebootTime != 0 && now > rebootTime) {
@@ -1402,7 +1494,7 @@ void loop()
         Radio.SetTxIdleMode();
         config.Commit();
         Radio.RXnb();
-        devicesTriggerEvent();
+        devicesTriggerEvent(EVENT_CONFIG_CHANGED);
     }
 
     executeDeferredFunction(now);
@@ -1453,7 +1545,9 @@ void loop()
 
     uint8_t *nextPayload = 0;
     uint8_t nextPlayloadSize = 0;
-    if (!TelemetrySender.IsActive() && telemetry.GetNextPayload(&nextPlayloadSize, &nextPayload))
+    if (!TelemetrySender.IsActive() &&
+        (firmwareOptions.rcvr_mavlink ? mavlink.GetNextPayload(&nextPlayloadSize, &nextPayload)
+                                      : telemetry.GetNextPayload(&nextPlayloadSize, &nextPayload)))
     {
         TelemetrySender.SetDataToTransmit(nextPayload, nextPlayloadSize);
     }
@@ -1528,7 +1622,7 @@ void EnterBindingMode()
     Radio.RXnb();
 
     DBGLN("Entered binding mode at freq = %d", Radio.currFreq);
-    devicesTriggerEvent();
+    devicesTriggerEvent(EVENT_BINDING);
 }
 
 void ExitBindingMode()
@@ -1567,7 +1661,7 @@ void ExitBindingMode()
     InLoanBindingMode = false;
     returnModelFromLoan = false;
     DBGLN("Exiting binding mode");
-    devicesTriggerEvent();
+    devicesTriggerEvent(EVENT_BINDING);
 }
 
 void ICACHE_RAM_ATTR OnELRSBindMSP(uint8_t* packet)
@@ -1,6 +1,8 @@
 #include "rxtx_common.h"
 
 #include "dynpower.h"
+#include "LinkLog.h"
+#include "DiversityPredictor.h"
 #include "lua.h"
 #include "msp.h"
 #include "telemetry_protocol.h"
@@ -106,8 +108,44 @@ device_affinity_t ui_devices[] = {
   {&VTX_device, 1}
 };
 
-#if defined(GPIO_PIN_ANT_CTRL_1)
-    static bool diversityAntennaState = LOW;
+static bool diversityAntennaState = LOW;
+// Learns which antenna the RX hears best from the RSSI it reports of single packets
+static TxDiversitySelector txDiversity;
+static uint8_t txDiversityAntenna;  // the antenna and channel of the last packet sent
+static uint8_t txDiversityChannel;
+
+#if defined(HAS_LINK_LOG)
+LinkLog linkLog(LINK_LOG_ROLE_TX);
+static int8_t linkLogRssi[2]; // latest reading from each antenna
+static bool linkLogCrcError;
+
+/**
+ * Record the telemetry slot which has just ended, before the antennas are switched
+ **/
+static void ICACHE_RAM_ATTR linkLogAddTelemetrySlot()
+{
+  const uint8_t ant = diversityAntennaState;
+  const bool received = LQCalc.currentIsSet();
+  if (received)
+    linkLogRssi[ant] = Radio.LastPacketRSSI;
+
+  link_log_record_t rec;
+  rec.timeMs = millis();
+  rec.nonce = OtaNonce;
+  rec.fhssIndex = FHSSsequence[FHSSgetCurrIndex()];
+  rec.rssi[0] = linkLogRssi[0];
+  rec.rssi[1] = linkLogRssi[1];
+  rec.snr = Radio.LastPacketSNRRaw;
+  rec.flags = LINK_LOG_TELEMETRY
+    | (received ? LINK_LOG_RECEIVED : 0)
+    | (linkLogCrcError ? LINK_LOG_CRC_ERROR : 0)
+    | (ant ? LINK_LOG_ANTENNA : 0)
+    | (connectionState == connected ? LINK_LOG_CONNECTED : 0);
+  rec.freqError = 0;
+  rec.pfdOffset = 0;
+  linkLog.add(rec);
+  linkLogCrcError = false;
+}
 #endif
 
 #ifdef TARGET_TX_GHOST
@@ -137,6 +175,31 @@ void switchDiversityAntennas()
   }
 }
 
+/**
+ * The RX reported the RSSI of the last packet sent (0 if it was missed), learn
+ * how well the antenna it was sent on did on that channel
+ **/
+static void ICACHE_RAM_ATTR TxDiversityFeedback(uint8_t lastRSSI)
+{
+  if (GPIO_PIN_ANT_CTRL_1 != UNDEF_PIN)
+  {
+    txDiversity.feedback(txDiversityAntenna, txDiversityChannel, lastRSSI);
+  }
+}
+
+/**
+ * Pick the antenna for a new packet. Alternate so the packets are spread over
+ * both antennas, unless recent feedback from the RX, which is only in the 4ch
+ * link stats, says one antenna is clearly better on this channel.
+ **/
+static void ICACHE_RAM_ATTR selectDiversityAntenna()
+{
+  if (txDiversity.select(diversityAntennaState, FHSSsequence[FHSSgetCurrIndex()]) != diversityAntennaState)
+  {
+    switchDiversityAntennas();
+  }
+}
+
 void ICACHE_RAM_ATTR LinkStatsFromOta(OTA_LinkStats_s * const ls)
 {
   int8_t snrScaled = ls->SNR;
@@ -163,6 +226,9 @@ bool ICACHE_RAM_ATTR ProcessTLMpacket(SX12xxDriverCommon::rx_status const status
   if (status != SX12xxDriverCommon::SX12XX_RX_OK)
   {
     DBGLN("TLM HW CRC error");
+#if defined(HAS_LINK_LOG)
+    linkLogCrcError = true;
+#endif
     return false;
   }
 
@@ -170,6 +236,9 @@ bool ICACHE_RAM_ATTR ProcessTLMpacket(SX12xxDriverCommon::rx_status const status
   if (!OtaValidatePacketCrc(otaPktPtr))
   {
     DBGLN("TLM crc error");
+#if defined(HAS_LINK_LOG)
+    linkLogCrcError = true;
+#endif
     return false;
   }
 
@@ -213,6 +282,12 @@ bool ICACHE_RAM_ATTR ProcessTLMpacket(SX12xxDriverCommon::rx_status const status
     {
       case ELRS_TELEMETRY_TYPE_LINK:
         LinkStatsFromOta(&otaPktPtr->std.tlm_dl.ul_link_stats.stats);
+        // An older RX sends neither
+        if (otaPktPtr->std.tlm_dl.packageIndex != 0)
+        {
+          DynamicPower_UplinkLQShort(OTA4_INDEX_TO_LQ_SHORT(otaPktPtr->std.tlm_dl.packageIndex));
+          TxDiversityFeedback(otaPktPtr->std.tlm_dl.ul_link_stats.lastRSSI);
+        }
         break;
 
       case ELRS_TELEMETRY_TYPE_DATA:
@@ -337,6 +412,7 @@ void ICACHE_RAM_ATTR SetRFLinkRate(uint8_t index) // Set speed of RF link (hz)
   ExpressLRS_currAirRate_Modparams = ModParams;
   ExpressLRS_currAirRate_RFperfParams = RFperf;
   crsf.LinkStatistics.rf_Mode = ModParams->enum_rate;
+  txDiversity.reset(RFperf->RXsensitivity);
 
   crsf.setSyncParams(interval * ExpressLRS_currAirRate_Modparams->numOfSends);
   connectionState = disconnected;
@@ -452,6 +528,13 @@ void ICACHE_RAM_ATTR timerCallbackNormal()
   }
 #endif
 
+#if defined(HAS_LINK_LOG)
+  if (TelemetryRcvPhase == ttrpExpectingTelem)
+  {
+    linkLogAddTelemetrySlot();
+  }
+#endif
+
   // Sync OpenTX to this point
   if (!(OtaNonce % ExpressLRS_currAirRate_Modparams->numOfSends))
   {
@@ -459,8 +542,11 @@ void ICACHE_RAM_ATTR timerCallbackNormal()
   }
 
   // Tx Antenna Diversity
-  if (OtaNonce % ExpressLRS_currAirRate_Modparams->numOfSends == 0 || // Swicth with new packet data
-      OtaNonce % ExpressLRS_currAirRate_Modparams->numOfSends == ExpressLRS_currAirRate_Modparams->numOfSends / 2) // Swicth in the middle of DVDA sends
+  if (OtaNonce % ExpressLRS_currAirRate_Modparams->numOfSends == 0) // Pick with new packet data
+  {
+    selectDiversityAntenna();
+  }
+  else if (OtaNonce % ExpressLRS_currAirRate_Modparams->numOfSends == ExpressLRS_currAirRate_Modparams->numOfSends / 2) // Switch in the middle of DVDA sends
   {
     switchDiversityAntennas();
   }
@@ -501,6 +587,8 @@ void ICACHE_RAM_ATTR timerCallbackNormal()
   if (!lastRcData || (micros() - lastRcData < 1000000))
   {
     busyTransmitting = true;
+    txDiversityAntenna = diversityAntennaState;
+    txDiversityChannel = FHSSsequence[FHSSgetCurrIndex()];
     SendRCdataToRF();
   }
 }
@@ -571,7 +659,7 @@ static void ConfigChangeCommit()
   hwTimer.callbackTock = &timerCallbackNormal;
   // UpdateFolderNames is expensive so it is called directly instead of in event() which gets called a lot
   luadevUpdateFolderNames();
-  devicesTriggerEvent();
+  devicesTriggerEvent(EVENT_CONFIG_CHANGED);
 }
 
 static void CheckConfigChangePending()
@@ -585,22 +673,30 @@ static void CheckConfigChangePending()
 #if !defined(PLATFORM_STM32) || defined(TARGET_USE_EEPROM)
     while (busyTransmitting); // wait until no longer transmitting
 #else
-    // The code expects to enter here shortly after the tock ISR has started sending the last
-    // sync packet, before the tick ISR. Because the EEPROM write takes so long and disables
-    // interrupts, FastForward the timer
-    const uint32_t EEPROM_WRITE_DURATION = 30000; // us, a page write on F103C8 takes ~29.3ms
-    const uint32_t cycleInterval = ExpressLRS_currAirRate_Modparams->interval;
-    // Total time needs to be at least DURATION, rounded up to next cycle
-    // adding one cycle that will be eaten by busywaiting for the transmit to end
-    uint32_t pauseCycles = ((EEPROM_WRITE_DURATION + cycleInterval - 1) / cycleInterval) + 1;
-    // Pause won't return until paused, and has just passed the tick ISR (but not fired)
-    hwTimer.pause(pauseCycles * cycleInterval);
-
-    while (busyTransmitting); // wait until no longer transmitting
-
-    --pauseCycles; // the last cycle will actually be a transmit
-    while (pauseCycles--)
-      timerCallbackIdle();
+    if (!config.IsCommitBlocking())
+    {
+      // Only appending to the config journal, which is quick
+      while (busyTransmitting); // wait until no longer transmitting
+    }
+    else
+    {
+      // The code expects to enter here shortly after the tock ISR has started sending the last
+      // sync packet, before the tick ISR. Because the EEPROM write takes so long and disables
+      // interrupts, FastForward the timer
+      const uint32_t EEPROM_WRITE_DURATION = 30000; // us, a page write on F103C8 takes ~29.3ms
+      const uint32_t cycleInterval = ExpressLRS_currAirRate_Modparams->interval;
+      // Total time needs to be at least DURATION, rounded up to next cycle
+      // adding one cycle that will be eaten by busywaiting for the transmit to end
+      uint32_t pauseCycles = ((EEPROM_WRITE_DURATION + cycleInterval - 1) / cycleInterval) + 1;
+      // Pause won't return until paused, and has just passed the tick ISR (but not fired)
+      hwTimer.pause(pauseCycles * cycleInterval);
+
+      while (busyTransmitting); // wait until no longer transmitting
+
+      --pauseCycles; // the last cycle will actually be a transmit
+      while (pauseCycles--)
+        timerCallbackIdle();
+    }
 #endif
     // Prevent any other RF SPI traffic during the commit from RX or scheduled TX
     hwTimer.callbackTock = &timerCallbackIdle;
@@ -661,6 +757,11 @@ static void UpdateConnectDisconnectStatus()
   }
   else
   {
+#if defined(HAS_LINK_LOG)
+    // Keep a little of what follows, then the log holds on to the lead up to this
+    if (connectionState == connected)
+      linkLog.trigger(LINK_LOG_RECORDS / 4);
+#endif
     connectionState = disconnected;
     connectionHasModelMatch = true;
     crsf.ForwardDevicePings = false;
@@ -1016,6 +1117,13 @@ void loop()
   // Update UI devices
   devicesUpdate(now);
 
+  #if defined(DEBUG_LOG_TOKENIZED)
+  if (TxBackpack)
+  {
+    debugLogDrain(*TxBackpack, 8);
+  }
+  #endif
+
   #if defined(PLATFORM_ESP8266) || defined(PLATFORM_ESP32)
     // If the reboot time is set and the current time is past the reboot time then reboot.
     if (rebootTime != 0 && now > rebootTime) {
@@ -0,0 +1,385 @@
+/**
+ * This file is part of ExpressLRS
+ * See https://github.com/AlessandroAU/ExpressLRS
+ *
+ * Unit tests for the config journal against a simulated flash which can lose
+ * power at any byte, and its write amplification compared to rewriting the
+ * whole config on every commit
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <unity.h>
+
+#include "ConfigJournal.h"
+
+#define SIM_MAX_SIZE    4096
+#define TEST_MAGIC      0x12345678
+#define TEST_KEYS       68 // 64 models + vtx, main, fan, motion like the TX
+#define TEST_RECORD_LEN 3
+
+/**
+ * Flash which can only clear bits and only be programmed once between erases.
+ * Each programmed byte and each erase uses one unit of the power budget, once
+ * it runs out the operation in progress is left half done and everything fails.
+ */
+class SimFlash : public JournalFlash
+{
+public:
+    SimFlash(uint32_t size, uint8_t count, uint8_t align) : size(size), count(count), align(align)
+    {
+        memset(mem, 0xFF, sizeof(mem));
+        budget = UINT32_MAX;
+        dead = false;
+        bytesProgrammed = 0;
+        erases = 0;
+    }
+
+    uint32_t bankSize() const { return size; }
+    uint8_t bankCount() const { return count; }
+    uint8_t writeAlign() const { return align; }
+
+    void read(uint32_t addr, void *dst, uint32_t len)
+    {
+        TEST_ASSERT_LESS_OR_EQUAL(size * count, addr + len);
+        memcpy(dst, &mem[addr], len);
+    }
+
+    bool program(uint32_t addr, const void *src, uint32_t len)
+    {
+        TEST_ASSERT_EQUAL(0, addr % align);
+        TEST_ASSERT_EQUAL(0, len % align);
+        TEST_ASSERT_LESS_OR_EQUAL(size * count, addr + len);
+        for (uint32_t i = 0; i < len; ++i)
+        {
+            if (!use())
+                return false;
+            // Never programmed twice without an erase
+            TEST_ASSERT_EQUAL_HEX8(0xFF, mem[addr + i]);
+            mem[addr + i] &= ((const uint8_t *)src)[i];
+            ++bytesProgrammed;
+        }
+        return true;
+    }
+
+    bool erase(uint8_t bank)
+    {
+        TEST_ASSERT_LESS_THAN(count, bank);
+        if (!use())
+        {
+            // Power lost half way through
+            memset(&mem[bank * size], 0xFF, size / 2);
+            return false;
+        }
+        memset(&mem[bank * size], 0xFF, size);
+        ++erases;
+        return true;
+    }
+
+    void powerOn() { budget = UINT32_MAX; dead = false; }
+
+    uint8_t mem[SIM_MAX_SIZE * 2];
+    uint32_t budget;
+    bool dead;
+    uint32_t bytesProgrammed;
+    uint32_t erases;
+
+private:
+    uint32_t size;
+    uint8_t count;
+    uint8_t align;
+
+    bool use()
+    {
+        if (dead || budget == 0)
+        {
+            dead = true;
+            return false;
+        }
+        --budget;
+        return true;
+    }
+};
+
+static uint8_t values[TEST_KEYS][TEST_RECORD_LEN];
+
+static uint8_t getRecord(void *ctx, uint8_t key, uint8_t *data)
+{
+    if (key >= TEST_KEYS)
+        return 0;
+    memcpy(data, values[key], TEST_RECORD_LEN);
+    return TEST_RECORD_LEN;
+}
+
+static uint32_t rngState;
+static uint32_t rng()
+{
+    rngState = rngState * 1103515245 + 12345;
+    return rngState >> 8;
+}
+
+static void resetValues()
+{
+    for (unsigned key = 0; key < TEST_KEYS; ++key)
+        for (unsigned i = 0; i < TEST_RECORD_LEN; ++i)
+            values[key][i] = key + i;
+}
+
+// Change a value and commit it the way the config does
+static bool commit(ConfigJournal &journal, uint8_t key)
+{
+    return (!journal.NeedsCompaction() && journal.Update(key, values[key], TEST_RECORD_LEN))
+        || journal.Compact(getRecord, nullptr);
+}
+
+static void checkValues(ConfigJournal &journal)
+{
+    for (unsigned key = 0; key < TEST_KEYS; ++key)
+    {
+        uint8_t data[TEST_RECORD_LEN];
+        TEST_ASSERT_TRUE(journal.Read(key, data, TEST_RECORD_LEN));
+        TEST_ASSERT_EQUAL_MEMORY(values[key], data, TEST_RECORD_LEN);
+    }
+}
+
+void test_journal_empty(void)
+{
+    SimFlash flash(1024, 2, 4);
+    ConfigJournal journal;
+    uint8_t data[TEST_RECORD_LEN];
+
+    TEST_ASSERT_FALSE(journal.Begin(&flash, TEST_MAGIC));
+    TEST_ASSERT_TRUE(journal.NeedsCompaction());
+    TEST_ASSERT_FALSE(journal.Read(0, data, TEST_RECORD_LEN));
+    TEST_ASSERT_FALSE(journal.Update(0, data, TEST_RECORD_LEN));
+}
+
+void test_journal_update_and_reload(void)
+{
+    SimFlash flash(1024, 2, 4);
+    ConfigJournal journal;
+    resetValues();
+
+    TEST_ASSERT_FALSE(journal.Begin(&flash, TEST_MAGIC));
+    TEST_ASSERT_TRUE(journal.Compact(getRecord, nullptr));
+    checkValues(journal);
+
+    values[5][1] = 0xAA;
+    TEST_ASSERT_TRUE(commit(journal, 5));
+    checkValues(journal);
+
+    // Unchanged values don't program anything
+    uint32_t programmed = flash.bytesProgrammed;
+    TEST_ASSERT_TRUE(commit(journal, 5));
+    TEST_ASSERT_TRUE(commit(journal, 6));
+    TEST_ASSERT_EQUAL(programmed, flash.bytesProgrammed);
+
+    // Found again after a reboot
+    ConfigJournal reloaded;
+    TEST_ASSERT_TRUE(reloaded.Begin(&flash, TEST_MAGIC));
+    checkValues(reloaded);
+
+    // A different config version doesn't match
+    TEST_ASSERT_FALSE(reloaded.Begin(&flash, TEST_MAGIC + 1));
+}
+
+void test_journal_compaction(void)
+{
+    SimFlash flash(1024, 2, 4);
+    ConfigJournal journal;
+    resetValues();
+    rngState = 1;
+
+    journal.Begin(&flash, TEST_MAGIC);
+    journal.Compact(getRecord, nullptr);
+    // Many times what fits in a bank, so it has to go round both banks a few times
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+        uint8_t key = rng() % TEST_KEYS;
+        values[key][rng() % TEST_RECORD_LEN] = rng();
+        // The TX only pauses the radio when NeedsCompaction() says the commit will erase
+        uint32_t erases = flash.erases;
+        bool blocking = journal.NeedsCompaction();
+        TEST_ASSERT_TRUE(commit(journal, key));
+        TEST_ASSERT_EQUAL(blocking ? erases + 1 : erases, flash.erases);
+    }
+    TEST_ASSERT_GREATER_THAN(4, flash.erases);
+    checkValues(journal);
+
+    ConfigJournal reloaded;
+    TEST_ASSERT_TRUE(reloaded.Begin(&flash, TEST_MAGIC));
+    checkValues(reloaded);
+}
+
+void test_journal_torn_record(void)
+{
+    SimFlash flash(1024, 1, 2);
+    ConfigJournal journal;
+    resetValues();
+
+    journal.Begin(&flash, TEST_MAGIC);
+    journal.Compact(getRecord, nullptr);
+    uint8_t old[TEST_RECORD_LEN];
+    memcpy(old, values[3], TEST_RECORD_LEN);
+
+    // Power lost after the key and length made it, but not the data or CRC
+    values[3][0] = 0x55;
+    values[3][2] = 0x66;
+    flash.budget = 3;
+    TEST_ASSERT_FALSE(journal.Update(3, values[3], TEST_RECORD_LEN));
+    flash.powerOn();
+
+    ConfigJournal reloaded;
+    TEST_ASSERT_TRUE(reloaded.Begin(&flash, TEST_MAGIC));
+    uint8_t data[TEST_RECORD_LEN];
+    TEST_ASSERT_TRUE(reloaded.Read(3, data, TEST_RECORD_LEN));
+    TEST_ASSERT_EQUAL_MEMORY(old, data, TEST_RECORD_LEN);
+    // Nothing can go after the torn record, the next commit compacts
+    TEST_ASSERT_TRUE(reloaded.NeedsCompaction());
+    TEST_ASSERT_TRUE(commit(reloaded, 3));
+    checkValues(reloaded);
+}
+
+/**
+ * Run a sequence of commits, cutting the power after every possible number of
+ * flash operations. After each cut the journal must hold every completed
+ * commit, and the interrupted one either completely or not at all. With a
+ * single bank a cut during a compaction can lose the journal, but it must then
+ * not be found at all rather than found with the wrong values.
+ **/
+#define POWER_LOSS_COMMITS  150
+
+static void checkPowerLoss(uint8_t bankCount)
+{
+    uint32_t cut = 0;
+    uint32_t lostJournals = 0;
+    for (;;)
+    {
+        SimFlash flash(1024, bankCount, 4);
+        ConfigJournal journal;
+        uint8_t committed[TEST_KEYS][TEST_RECORD_LEN];
+        bool anyCommitted = false;
+        bool inCompaction = false;
+        resetValues();
+        rngState = 42;
+        flash.budget = cut;
+
+        journal.Begin(&flash, TEST_MAGIC);
+        if (journal.Compact(getRecord, nullptr))
+        {
+            anyCommitted = true;
+            memcpy(committed, values, sizeof(values));
+            for (unsigned i = 0; i < POWER_LOSS_COMMITS; ++i)
+            {
+                uint8_t key = rng() % TEST_KEYS;
+                values[key][rng() % TEST_RECORD_LEN] = rng();
+                bool appended = !journal.NeedsCompaction()
+                    && journal.Update(key, values[key], TEST_RECORD_LEN);
+                if (flash.dead)
+                    break;
+                inCompaction = !appended;
+                if (inCompaction && !journal.Compact(getRecord, nullptr))
+                    break;
+                inCompaction = false;
+                memcpy(committed, values, sizeof(values));
+            }
+        }
+        // Ran to the end without losing power, every point has been tested
+        if (!flash.dead)
+            break;
+
+        flash.powerOn();
+        ConfigJournal reloaded;
+        if (!reloaded.Begin(&flash, TEST_MAGIC))
+        {
+            TEST_ASSERT_TRUE(!anyCommitted || (bankCount == 1 && inCompaction));
+            ++lostJournals;
+        }
+        else
+        {
+            for (unsigned key = 0; key < TEST_KEYS; ++key)
+            {
+                uint8_t data[TEST_RECORD_LEN];
+                TEST_ASSERT_TRUE(reloaded.Read(key, data, TEST_RECORD_LEN));
+                if (memcmp(data, committed[key], TEST_RECORD_LEN) != 0)
+                    TEST_ASSERT_EQUAL_MEMORY(values[key], data, TEST_RECORD_LEN);
+            }
+        }
+        ++cut;
+    }
+    printf("%u bank(s): %u power cuts checked, journal lost %u times\n", bankCount, cut, lostJournals);
+}
+
+void test_journal_power_loss_two_banks(void)
+{
+    checkPowerLoss(2);
+}
+
+void test_journal_power_loss_one_bank(void)
+{
+    checkPowerLoss(1);
+}
+
+/**
+ * Single model changes like the TX makes, compared to rewriting the whole
+ * EEPROM emulation buffer (erase and program) on every commit
+ **/
+static void checkWriteAmplification(const char *name, uint32_t bankSize, uint8_t align, uint32_t legacySize)
+{
+    const uint32_t commits = 1000;
+    SimFlash flash(bankSize, 1, align);
+    ConfigJournal journal;
+    resetValues();
+    rngState = 7;
+
+    journal.Begin(&flash, TEST_MAGIC);
+    journal.Compact(getRecord, nullptr);
+    uint32_t startBytes = flash.bytesProgrammed;
+    uint32_t startErases = flash.erases;
+    for (unsigned i = 0; i < commits; ++i)
+    {
+        uint8_t key = rng() % 64;
+        values[key][0] ^= 1 + rng() % 255;
+        TEST_ASSERT_TRUE(commit(journal, key));
+    }
+    uint32_t bytes = flash.bytesProgrammed - startBytes;
+    uint32_t erases = flash.erases - startErases;
+    printf("%s: %u commits, journal %u bytes %u erases, full rewrite %u bytes %u erases (%ux less programmed)\n",
+        name, commits, bytes, erases, commits * legacySize, commits, commits * legacySize / bytes);
+
+    TEST_ASSERT_LESS_THAN(commits * legacySize / 10, bytes);
+    TEST_ASSERT_LESS_THAN(commits / 10, erases);
+    checkValues(journal);
+}
+
+void test_journal_write_amplification_esp8266(void)
+{
+    // 4KB sector, the EEPROM library commits its 1KB buffer
+    checkWriteAmplification("ESP8266", 4096, 4, 1024);
+}
+
+void test_journal_write_amplification_stm32(void)
+{
+    // 1KB page on the F103, the EEPROM emulation flushes the whole page
+    checkWriteAmplification("STM32F1", 1024, 2, 1024);
+}
+
+// Unity setup/teardown
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_journal_empty);
+    RUN_TEST(test_journal_update_and_reload);
+    RUN_TEST(test_journal_compaction);
+    RUN_TEST(test_journal_torn_record);
+    RUN_TEST(test_journal_power_loss_two_banks);
+    RUN_TEST(test_journal_power_loss_one_bank);
+    RUN_TEST(test_journal_write_amplification_esp8266);
+    RUN_TEST(test_journal_write_amplification_stm32);
+    UNITY_END();
+
+    return 0;
+}
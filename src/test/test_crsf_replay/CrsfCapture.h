@@ -0,0 +1,136 @@
+#pragma once
+
+#include <stdio.h>
+#include "targets.h"
+
+#define CRSF_CAPTURE_MAX_BYTES 64 // in one record, longer reads are split
+
+// Where the bytes in a record came from
+#define CRSF_CAPTURE_HANDSET 'H' // from the handset to the TX module
+#define CRSF_CAPTURE_TX      'T' // from the TX module to the handset
+#define CRSF_CAPTURE_FC      'F' // from the flight controller to the RX
+#define CRSF_CAPTURE_RX      'R' // from the RX to the flight controller
+
+typedef struct {
+    uint32_t timeUs;
+    char source;
+    uint8_t len;
+    uint8_t data[CRSF_CAPTURE_MAX_BYTES];
+} crsfCaptureRecord_t;
+
+/**
+ * A capture of the raw bytes on the CRSF UARTs, the handset's and the FC's,
+ * as text so it can be read, diffed and edited by hand. Each line is a
+ * record of bytes read from one direction of a UART at one time:
+ *
+ *     <time us> <source> <hex bytes...>
+ *
+ *     # EdgeTX 2.8, 250Hz
+ *     1000 H C8 18 16 E0 03 1F ... 4C
+ *     1410 T EA 0D 3A EE EA 10 00 00 9C 40 FF FF F8 30 8E
+ *
+ * Records are in time order. Bytes are as they came off the UART, a record
+ * can hold part of a frame, several frames or line noise. Lines starting
+ * with # and blank lines are skipped. CrsfCaptureFormat() writes a record
+ * as a line.
+ */
+class CrsfCaptureReader
+{
+public:
+    explicit CrsfCaptureReader(const char *text) : pos(text), line(0), errors(0) {}
+
+    /* The next record, false at the end of the capture */
+    bool next(crsfCaptureRecord_t *rec)
+    {
+        while (*pos)
+        {
+            const char *end = pos;
+            while (*end && *end != '\n')
+                ++end;
+            ++line;
+            const bool parsed = parseLine(pos, end, rec);
+            pos = *end ? end + 1 : end;
+            if (parsed)
+                return true;
+        }
+        return false;
+    }
+
+    unsigned getLine() const { return line; }
+    // Lines which weren't a comment, blank, or a record
+    unsigned getErrors() const { return errors; }
+
+private:
+    static const char *skipSpace(const char *p, const char *end)
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+            ++p;
+        return p;
+    }
+
+    static int hexDigit(char c)
+    {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        return -1;
+    }
+
+    bool parseLine(const char *p, const char *end, crsfCaptureRecord_t *rec)
+    {
+        p = skipSpace(p, end);
+        if (p == end || *p == '#')
+            return false;
+
+        uint32_t timeUs = 0;
+        const char *start = p;
+        while (p < end && *p >= '0' && *p <= '9')
+            timeUs = timeUs * 10 + (*p++ - '0');
+        const char *source = skipSpace(p, end);
+        if (p == start || source == p || source == end ||
+            (*source != CRSF_CAPTURE_HANDSET && *source != CRSF_CAPTURE_TX &&
+             *source != CRSF_CAPTURE_FC && *source != CRSF_CAPTURE_RX))
+        {
+            ++errors;
+            return false;
+        }
+
+        rec->timeUs = timeUs;
+        rec->source = *source;
+        rec->len = 0;
+        p = skipSpace(source + 1, end);
+        while (p < end)
+        {
+            const int high = hexDigit(p[0]);
+            const int low = p + 1 < end ? hexDigit(p[1]) : -1;
+            if (high < 0 || low < 0 || rec->len == CRSF_CAPTURE_MAX_BYTES)
+            {
+                ++errors;
+                return false;
+            }
+            rec->data[rec->len++] = high << 4 | low;
+            p = skipSpace(p + 2, end);
+        }
+        return true;
+    }
+
+    const char *pos;
+    unsigned line;
+    unsigned errors;
+};
+
+/* The line for a record, with its newline, the length or 0 if it doesn't fit */
+inline size_t CrsfCaptureFormat(char *out, size_t size, const crsfCaptureRecord_t *rec)
+{
+    int len = snprintf(out, size, "%u %c", (unsigned)rec->timeUs, rec->source);
+    for (unsigned i = 0; i < rec->len && len > 0 && (size_t)len < size; ++i)
+        len += snprintf(out + len, size - len, " %02X", rec->data[i]);
+    if (len <= 0 || (size_t)len + 1 >= size)
+        return 0;
+    out[len++] = '\n';
+    out[len] = '\0';
+    return len;
+}
@@ -0,0 +1,537 @@
+#pragma once
+
+// Replayed by test_crsf_replay, in the format CrsfCaptureReader reads
+static const char captureEdgeTx250Hz[] = R"CAPTURE(
+# EdgeTX handset at 250Hz and 400000 baud on a TX module, with the
+# FC side of the link. Made up to cover the paths the replay checks:
+# split and bad RC frames, line noise, a device ping, a Lua parameter
+# read, a model select, an MSP request and battery and attitude
+# telemetry.
+1643 H C8 18 16 E0 E3 34 F8 48 C2 0A 56 60 87 60 30 E4 2A A2 99 82 27 D2 41 93 BF 20
+1793 T EA 0D 3A EA EE 10 00 00 9C 40 FF FF FB 50 69
+4243 R C8 18 16 E0 E3 34 F8 48 C2 0A 56 60 87 60 30 E4 2A A2 99 82 27 D2 41 93 BF 20
+5652 H C8 18 16 0B D4 34 ED 4A C2 8A 59 7C 67 61 37 1C EB A3 A7 F2 A7 D5 5D 73 C0 83
+5802 T EA 0C 14 3C 32 64 05 00 04 03 00 50 08 4E
+9655 H C8 18 16 37 B4 34 E2 52 C2 0A 5D 98 47 62 3E 54 AB A5 B5 62 28 D9 79 53 C1 95
+12255 R C8 18 16 37 B4 34 E2 52 C2 0A 5D 98 47 62 3E 54 AB A5 B5 62 28 D9 79 53 C1 95
+13397 H C8 18 16 63 7C 34 D7 60 C2 8A 60 B4 27 63 45 8C
+13647 H 6B A7 C3 D2 A8 DC 95 33 C2 1E
+17643 H C8 18 16 8E 34 74 CC 72 C2 0A 64 D0 07 64 4C C4 2B A9 D1 42 29 E0 B1 13 C3 36
+20243 R C8 18 16 8E 34 74 CC 72 C2 0A 64 D0 07 64 4C C4 2B A9 D1 42 29 E0 B1 13 C3 36
+21650 H C8 18 16 B8 CC F3 C1 8C C2 8A 67 EC E7 64 53 FC EB AA DF B2 A9 E3 CD F3 C3 08
+25652 H C8 18 16 E1 54 B3 B7 AA C2 0A 6B 08 C8 65 5A 34 AC AC ED 22 2A E7 E9 D3 C4 E2
+28252 R C8 18 16 E1 54 B3 B7 AA C2 0A 6B 08 C8 65 5A 34 AC AC ED 22 2A E7 E9 D3 C4 E2
+29656 H C8 18 16 0A CD 72 AD CC C2 8A 6E 24 A8 66 61 6C 6C AE FB 92 AA EA 05 B4 C5 55
+33643 H C8 18 16 31 2D B2 A3 F4 C2 0A 72 40 88 67 68 A4 2C B0 09 03 2B EE 21 94 C6 CD
+36243 R C8 18 16 31 2D B2 A3 F4 C2 0A 72 40 88 67 68 A4 2C B0 09 03 2B EE 21 94 C6 CD
+37643 H C8 18 16 57 7D 31 9A 20 C3 8A 75 5C 68 68 6F DC EC B1 17 73 AB F1 3D 74 C7 BC
+41404 H C8 18 16 7B B5 30 91 52 C3 0A 79 78 48 69 76 14
+41654 H AD B3 25 E3 2B F5 59 54 C8 12
+44254 R C8 18 16 7B B5 30 91 52 C3 0A 79 78 48 69 76 14 AD B3 25 E3 2B F5 59 54 C8 12
+45652 H C8 18 16 9E DD 6F 88 88 C3 8A 7C 94 28 6A 7D 4C 6D B5 33 53 AC F8 75 34 C9 9B
+49659 H C8 18 16 BF F5 2E 80 C2 C3 0A 80 B0 08 6B 84 84 2D B7 41 C3 2C FC 91 14 CA 3A
+51559 F C8 0A 08 00 A8 00 0C 00 00 00 32 E0
+52259 R C8 18 16 BF F5 2E 80 C2 C3 0A 80 B0 08 6B 84 84 2D B7 41 C3 2C FC 91 14 CA 3A
+53655 H C8 18 16 DE FD 6D 78 00 C4 8A 83 CC E8 6B 8B BC ED B8 4F 33 AD FF AD F4 CA A0
+57650 H C8 18 16 FB F5 2C 71 42 C4 0A 87 E8 C8 6C 92 F4 AD BA 5D A3 2D 03 CA D4 CB 92
+60250 R C8 18 16 FB F5 2C 71 42 C4 0A 87 E8 C8 6C 92 F4 AD BA 5D A3 2D 03 CA D4 CB 92
+61649 H C8 18 16 16 DE 6B 6A 88 C4 8A 8A 04 A9 6D 99 2C 6E BC 6B 13 AE 06 E6 B4 CC 67
+65665 H C8 18 16 2F BE 2A 64 D0 C4 0A 8E 20 89 6E A0 64 2E BE 79 83 2E 0A 02 95 CD 0A
+68265 R C8 18 16 2F BE 2A 64 D0 C4 0A 8E 20 89 6E A0 64 2E BE 79 83 2E 0A 02 95 CD 0A
+69399 H C8 18 16 45 8E A9 5E 1C C5 8A 91 3C 69 6F A7 9C
+69649 H EE BF 87 F3 AE 0D 1E 75 CE 8D
+73646 H C8 18 16 59 56 A8 59 6A C5 0A 95 58 49 70 AE D4 AE C1 95 63 2F 11 3A 55 CF 83
+76246 R C8 18 16 59 56 A8 59 6A C5 0A 95 58 49 70 AE D4 AE C1 95 63 2F 11 3A 55 CF 83
+77644 H C8 18 16 6A 0E 67 55 BC C5 8A 98 74 29 71 B5 0C 6F C3 A3 D3 AF 14 56 35 D0 0F
+81650 H C8 18 16 79 C6 A5 51 0E C6 0A 9C 90 09 72 BC 44 2F 2B B0 43 30 18 72 15 D1 F8
+84250 R C8 18 16 79 C6 A5 51 0E C6 0A 9C 90 09 72 BC 44 2F 2B B0 43 30 18 72 15 D1 F8
+85650 H C8 18 16 86 76 64 4E 62 C6 8A 9F AC E9 72 C3 7C EF 2C BE B3 B0 1B 8E F5 D1 8E
+89648 H C8 18 16 8F 1E 23 4C B8 C6 0A A3 C8 C9 73 CA B4 AF 2E CC 23 31 1F AA D5 D2 39
+92248 R C8 18 16 8F 1E 23 4C B8 C6 0A A3 C8 C9 73 CA B4 AF 2E CC 23 31 1F AA D5 D2 39
+93650 H C8 18 16 96 BE 61 4A 10 C7 8A A6 E4 A9 74 D1 EC 6F 30 DA 93 B1 22 C6 B5 D3 C9
+97401 H C8 18 16 9A 5E 60 49 68 C7 0A AA 00 8A 75 D8 24
+97651 H 30 32 E8 03 32 26 E2 95 D4 93
+100251 R C8 18 16 9A 5E 60 49 68 C7 0A AA 00 8A 75 D8 24 30 32 E8 03 32 26 E2 95 D4 93
+101654 H C8 18 16 9C 06 1F 49 BE C7 8A AD 1C 6A 76 DF 5C F0 33 F6 73 B2 29 FE 75 D5 A3
+105656 H C8 18 16 9A A6 5D 49 16 C8 0A B1 38 4A 77 E6 94 B0 35 04 E4 32 2D 1A 56 D6 96
+108256 R C8 18 16 9A A6 5D 49 16 C8 0A B1 38 4A 77 E6 94 B0 35 04 E4 32 2D 1A 56 D6 96
+109651 H C8 18 16 96 46 5C 4A 6E C8 8A B4 54 2A 78 ED CC 70 37 12 54 B3 30 36 36 D7 5F
+113640 H C8 18 16 8F E6 1A 4C C6 C8 0A B8 70 0A 79 F4 04 31 39 20 C4 33 34 52 16 D8 74
+116240 R C8 18 16 8F E6 1A 4C C6 C8 0A B8 70 0A 79 F4 04 31 39 20 C4 33 34 52 16 D8 74
+117654 H C8 18 16 86 8E 59 4E 1C C9 8A BB 8C EA 79 FB 3C F1 3A 2E 34 B4 37 6E F6 D8 24
+121642 H C8 18 16 79 3E 98 51 70 C9 0A BF A8 CA 7A 02 75 B1 3C 3C A4 34 3B 8A D6 D9 45
+124242 R C8 18 16 79 3E 98 51 70 C9 0A BF A8 CA 7A 02 75 B1 3C 3C A4 34 3B 8A D6 D9 45
+125399 H C8 18 16 6A F6 56 55 C2 C9 8A C2 C4 AA 7B 09 AD
+125649 H 71 3E 4A 14 B5 3E A6 B6 DA F3
+129642 H C8 18 16 59 AE 95 59 14 CA 0A C6 E0 8A 7C 10 E5 31 40 58 84 35 42 C2 96 DB 25
+132242 R C8 18 16 59 AE 95 59 14 CA 0A C6 E0 8A 7C 10 E5 31 40 58 84 35 42 C2 96 DB 25
+133650 H C8 18 16 45 76 94 5E 62 CA 8A C9 FC 6A 7D 17 1D F2 41 66 F4 B5 45 DE 76 DC 86
+137646 H C8 18 16 2F 46 13 64 AE CA 0A CD 18 4B 7E 1E 55 B2 43 74 64 36 49 FA 56 DD 53
+140246 R C8 18 16 2F 46 13 64 AE CA 0A CD 18 4B 7E 1E 55 B2 43 74 64 36 49 FA 56 DD 53
+141651 H C8 18 16 16 26 52 6A F6 CA 8A D0 34 2B 7F 25 8D 72 45 82 D4 B6 4C 16 37 DE 4B
+145669 H C8 18 16 FB 0D 11 71 3C CB 0A D4 50 0B 80 2C C5 32 47 90 44 37 50 32 17 DF CB
+148269 R C8 18 16 FB 0D 11 71 3C CB 0A D4 50 0B 80 2C C5 32 47 90 44 37 50 32 17 DF CB
+149650 H C8 18 16 DE 05 50 78 7E CB 8A D7 6C EB 80 33 FD F2 48 9E B4 B7 53 4E F7 DF 3D
+151550 F C8 0A 08 00 A7 00 0C 00 00 00 32 F8
+151750 F C8 08 1E 01 2C FF 10 00 40 E1
+153405 H C8 18 16 BF 0D 0F 80 BC CB 0A DB 88 CB 81 3A 35
+153655 H B3 4A AC 24 38 57 6A D7 E0 E2
+156255 R C8 18 16 BF 0D 0F 80 BC CB 0A DB 88 CB 81 3A 35 B3 4A AC 24 38 57 6A D7 E0 E2
+157643 H C8 18 16 9E 25 4E 88 F6 CB 8A DE A4 AB 82 41 6D 73 4C BA 94 B8 5A 86 B7 E1 F7
+161649 H C8 18 16 7B 4D 0D 91 2C CC 0A E2 C0 8B 83 48 A5 33 4E C8 04 39 5E A2 97 15 79
+164249 R C8 18 16 7B 4D 0D 91 2C CC 0A E2 C0 8B 83 48 A5 33 4E C8 04 39 5E A2 97 15 79
+165653 H C8 18 16 57 85 0C 9A 5E CC 8A E5 DC 6B 84 4F DD F3 4F D6 74 B9 61 BE 77 16 4B
+169650 H C8 18 16 31 D5 8B A3 8A CC 0A E9 F8 4B 85 56 15 B4 51 E4 E4 39 65 DA 57 17 A8
+172250 R C8 18 16 31 D5 8B A3 8A CC 0A E9 F8 4B 85 56 15 B4 51 E4 E4 39 65 DA 57 17 A8
+173652 H C8 18 16 0A 35 4B AD B2 CC 8A EC 14 2C 86 5D 4D 74 53 F2 54 BA 68 F6 37 18 C9
+177650 H C8 18 16 E1 AC 8A B7 D4 CC 0A F0 30 0C 87 64 85 34 55 00 C5 3A 6C 12 18 19 B4
+180250 R C8 18 16 E1 AC 8A B7 D4 CC 0A F0 30 0C 87 64 85 34 55 00 C5 3A 6C 12 18 19 B4
+181394 H C8 18 16 B8 34 CA C1 F2 CC 8A F3 4C EC 87 6B BD
+181644 H F4 56 0E 35 BB 6F 2E F8 19 2E
+185653 H C8 18 16 8E CC 49 CC 0C CD 0A F7 68 CC 88 72 F5 B4 58 1C A5 3B 73 4A D8 1A 7C
+188253 R C8 18 16 8E CC 49 CC 0C CD 0A F7 68 CC 88 72 F5 B4 58 1C A5 3B 73 4A D8 1A 7C
+189646 H C8 18 16 63 84 09 D7 1E CD 8A FA 84 AC 89 79 2D 75 5A 2A 15 BC 76 66 B8 1B E8
+193661 H C8 18 16 37 4C 09 E2 2C CD 0A FE A0 8C 8A 80 65 35 5C 38 85 3C 7A 82 98 1C 1D
+196261 R C8 18 16 37 4C 09 E2 2C CD 0A FE A0 8C 8A 80 65 35 5C 38 85 3C 7A 82 98 1C 1D
+197647 H C8 18 16 0B 2C 09 ED 34 CD 8A 01 BD 6C 8B 87 9D F5 5D 46 F5 BC 7D 9E 78 1D A5
+201654 H C8 18 16 E0 23 C9 F7 38 CD 0A 05 D9 4C 8C 8E D5 B5 5F 54 65 3D 81 BA 58 1E 64
+201804 T EA 0D 3A EA EE 10 00 00 9C 40 FF FF FB 50 69
+202854 H C8 04 28 00 EA 54
+204254 R C8 18 16 E0 23 C9 F7 38 CD 0A 05 D9 4C 8C 8E D5 B5 5F 54 65 3D 81 BA 58 1E 64
+205650 H C8 18 16 B4 2B C9 02 35 CD 8A 08 F5 2C 8D 95 0D 76 61 62 D5 BD 84 D6 38 1F 41
+209405 H C8 18 16 88 4B C9 0D 2D CD 0A 0C 11 0D 8E 9C 45
+209655 H 36 63 70 45 3E 88 F2 18 20 C5
+212255 R C8 18 16 88 4B C9 0D 2D CD 0A 0C 11 0D 8E 9C 45 36 63 70 45 3E 88 F2 18 20 C5
+213647 H C8 18 16 5C 83 C9 18 1F CD 8A 0F 2D ED 8E A3 7D F6 64 7E B5 BE 8B 0E F9 20 9E
+217655 H C8 18 16 31 CB 89 23 0D CD 0A 13 49 CD 8F AA B5 B6 66 8C 25 3F 8F 2A D9 21 84
+220255 R C8 18 16 31 CB 89 23 0D CD 0A 13 49 CD 8F AA B5 B6 66 8C 25 3F 8F 2A D9 21 84
+221650 H C8 18 16 07 33 0A 2E F3 CC 8A 16 65 AD 90 B1 ED 76 68 9A 95 BF 92 46 B9 22 9D
+225657 H C8 18 16 DE AA 4A 38 D5 CC 0A 1A 81 8D 91 B8 25 37 6A A8 05 40 96 62 99 23 4D
+228257 R C8 18 16 DE AA 4A 38 D5 CC 0A 1A 81 8D 91 B8 25 37 6A A8 05 40 96 62 99 23 4D
+229653 H C8 18 16 B5 32 8B 42 B3 CC 8A 1D 9D 6D 92 BF 5D F7 6B B6 75 C0 99 7E 79 24 DF
+233650 H C8 18 16 8E D2 4B 4C 8B CC 0A 21 B9 4D 93 C6 95 B7 6D C4 E5 40 9D 9A 59 25 A7
+236250 R C8 18 16 8E D2 4B 4C 8B CC 0A 21 B9 4D 93 C6 95 B7 6D C4 E5 40 9D 9A 59 25 A7
+237396 H C8 18 16 68 82 CC 55 5F CC 8A 24 D5 2D 94 CD CD
+237646 H 77 6F D2 55 C1 A0 B6 39 26 EE
+241654 H C8 18 16 44 4A CD 5E 2D CC 0A 28 F1 0D 95 D4 05 38 71 E0 C5 41 A4 D2 19 27 47
+244254 R C8 18 16 44 4A CD 5E 2D CC 0A 28 F1 0D 95 D4 05 38 71 E0 C5 41 A4 D2 19 27 47
+245652 H C8 18 16 21 22 8E 67 F7 CB 8A 2B 0D EE 95 DB 3D F8 72 EE 35 C2 A7 EE F9 27 63
+249659 H C8 18 16 00 0A CF 6F BD CB 0A 2F 29 CE 96 E2 75 B8 74 FC A5 42 AB 0A DA 28 0A
+251559 F C8 0A 08 00 A6 00 0C 00 00 00 32 6C
+252259 R C8 18 16 00 0A CF 6F BD CB 0A 2F 29 CE 96 E2 75 B8 74 FC A5 42 AB 0A DA 28 0A
+253648 H C8 18 16 E1 01 90 77 7F CB 8A 32 45 AE 97 E9 6D 45 76 0A 16 C3 AE 26 BA 29 21
+257653 H C8 18 16 C4 09 D1 7E 3D CB 0A 36 61 8E 98 F0 A5 05 78 18 86 43 B2 42 9A 2A CD
+257803 T EA 0C 14 3C 32 64 05 00 04 03 00 50 08 4E
+260253 R C8 18 16 C4 09 D1 7E 3D CB 0A 36 61 8E 98 F0 A5 05 78 18 86 43 B2 42 9A 2A CD
+261653 H C8 18 16 A9 21 92 85 F7 CA 8A 39 7D 6E 99 F7 DD C5 79 26 F6 C3 B5 5E 7A 2B A6
+265401 H C8 18 16 90 41 D3 8B AF CA 0A 3D 99 4E 9A FE 15
+265651 H 86 7B 34 66 44 B9 7A 5A 2C 4D
+268251 R C8 18 16 90 41 D3 8B AF CA 0A 3D 99 4E 9A FE 15 86 7B 34 66 44 B9 7A 5A 2C 4D
+269651 H C8 18 16 7A 71 54 91 63 CA 8A 40 B5 2E 9B 05 4E 46 7D 42 D6 C4 BC 96 3A 2D EB
+273651 H C8 18 16 66 A9 55 96 15 CA 0A 44 D1 0E 9C 0C 86 06 7F 50 46 45 C0 B2 1A 2E A5
+276251 R C8 18 16 66 A9 55 96 15 CA 0A 44 D1 0E 9C 0C 86 06 7F 50 46 45 C0 B2 1A 2E A5
+277647 H C8 18 16 55 F1 96 9A C3 C9 8A 47 ED EE 9C 13 BE C6 80 5E B6 C5 C3 CE FA 2E F3
+281644 H C8 18 16 46 39 58 9E 71 C9 0A 4B 09 CF 9D 1A F6 86 82 6C 26 46 C7 EA DA 2F 80
+284244 R C8 18 16 46 39 58 9E 71 C9 0A 4B 09 CF 9D 1A F6 86 82 6C 26 46 C7 EA DA 2F 80
+285648 H C8 18 16 39 89 99 A1 1D C9 8A 4E 25 AF 9E 21 2E 47 84 7A 96 C6 CA 06 BB 30 C1
+289653 H C8 18 16 30 E1 DA A3 C7 C8 0A 52 41 8F 9F 28 66 07 86 88 06 47 CE 22 9B 31 4F
+292253 R C8 18 16 30 E1 DA A3 C7 C8 0A 52 41 8F 9F 28 66 07 86 88 06 47 CE 22 9B 31 4F
+293409 H C8 18 16 29 41 9C A5 6F C8 8A 55 5D 6F A0 2F 9E
+293659 H C7 87 96 76 C7 D1 3E 7B 32 C0
+297655 H C8 18 16 25 A1 9D A6 17 C8 0A 59 79 4F A1 36 D6 87 89 A4 E6 47 D5 5A 5B 33 D7
+300255 R C8 18 16 25 A1 9D A6 17 C8 0A 59 79 4F A1 36 D6 87 89 A4 E6 47 D5 5A 5B 33 D7
+301656 H C8 18 16 24 F9 1E A7 C1 C7 8A 5C 95 2F A2 3D 0E 48 8B B2 56 C8 D8 76 3B 34 B0
+302856 H C8 06 2C EE EF 01 00 76
+305654 H C8 18 16 25 59 A0 A6 69 C7 0A 60 B1 0F A3 44 46 08 8D C0 C6 48 DC 92 1B 35 0E
+308254 R C8 18 16 25 59 A0 A6 69 C7 0A 60 B1 0F A3 44 46 08 8D C0 C6 48 DC 92 1B 35 0E
+309654 H C8 18 16 29 B9 A1 A5 11 C7 8A 63 CD EF A3 4B 7E C8 8E CE 36 C9 DF AE FB 35 73
+313651 H C8 18 16 30 19 E3 A3 B9 C6 0A 67 E9 CF A4 52 B6 88 90 DC A6 49 E3 CA DB 36 2D
+316251 R C8 18 16 30 19 E3 A3 B9 C6 0A 67 E9 CF A4 52 B6 88 90 DC A6 49 E3 CA DB 36 2D
+317654 H C8 18 16 39 71 A4 A1 63 C6 8A 6A 05 B0 A5 59 EE 48 92 EA 16 CA E6 E6 BB 37 51
+321410 H C8 18 16 46 C1 65 9E 0F C6 0A 6E 21 90 A6 60 26
+321660 H 09 94 F8 86 4A EA 02 9C 38 B3
+324260 R C8 18 16 46 C1 65 9E 0F C6 0A 6E 21 90 A6 60 26 09 94 F8 86 4A EA 02 9C 38 B3
+325649 H C8 18 16 55 09 A7 9A BD C5 8A 71 3D 70 A7 67 5E C9 95 06 F7 CA ED 1E 7C 39 90
+329646 H C8 18 16 66 51 68 96 6B C5 0A 75 59 50 A8 6E 96 89 97 14 67 4B F1 3A 5C 3A CE
+332246 R C8 18 16 66 51 68 96 6B C5 0A 75 59 50 A8 6E 96 89 97 14 67 4B F1 3A 5C 3A CE
+333661 H C8 18 16 7A 89 69 91 1D C5 8A 78 75 30 A9 75 CE 49 99 22 D7 CB F4 B6 22 3B 79
+337651 H C8 18 16 90 B9 EA 8B D1 C4 0A 7C 91 10 AA 7C 06 0A 9B 30 47 4C F8 D2 02 3C C5
+340251 R C8 18 16 90 B9 EA 8B D1 C4 0A 7C 91 10 AA 7C 06 0A 9B 30 47 4C F8 D2 02 3C C5
+341655 H C8 18 16 A9 D9 AB 85 89 C4 8A 7F AD F0 AA 83 3E CA 9C 3E B7 CC FB EE E2 3C 61
+345655 H C8 18 16 C4 F1 EC 7E 43 C4 0A 83 C9 D0 AB 8A 76 8A 9E 4C 27 4D FF 0A C3 3D 32
+348255 R C8 18 16 C4 F1 EC 7E 43 C4 0A 83 C9 D0 AB 8A 76 8A 9E 4C 27 4D FF 0A C3 3D 32
+349394 H C8 18 16 E1 F9 AD 77 01 C4 8A 86 E5 B0 AC 91 AE
+349644 H 4A A0 5A 97 CD 02 27 A3 3E 20
+351544 F C8 0A 08 00 A5 00 0C 00 00 00 32 05
+351744 F C8 08 1E 01 2C FF 10 00 40 E1
+353664 H C8 18 16 00 F2 EE 6F C3 C3 0A 8A 01 91 AD 98 E6 0A A2 68 07 4E 06 43 83 3F C7
+356264 R C8 18 16 00 F2 EE 6F C3 C3 0A 8A 01 91 AD 98 E6 0A A2 68 07 4E 06 43 83 3F C7
+357660 H C8 18 16 21 DA AF 67 89 C3 8A 8D 1D 71 AE 9F 1E CB A3 76 77 CE 09 5F 63 40 0A
+361651 H C8 18 16 44 B2 F0 5E 53 C3 0A 91 39 51 AF A6 56 8B A5 84 E7 4E 0D 7B 43 41 3A
+364251 R C8 18 16 44 B2 F0 5E 53 C3 0A 91 39 51 AF A6 56 8B A5 84 E7 4E 0D 7B 43 41 3A
+365654 H C8 18 16 68 7A F1 55 21 C3 8A 94 55 31 B0 AD 8E 4B A7 92 57 CF 10 97 23 42 38
+369650 H C8 18 16 8E 2A 72 4C F5 C2 0A 98 71 11 B1 B4 C6 0B A9 A0 C7 4F 14 B3 03 43 AF
+372250 R C8 18 16 8E 2A 72 4C F5 C2 0A 98 71 11 B1 B4 C6 0B A9 A0 C7 4F 14 B3 03 43 AF
+373645 H C8 18 16 B5 CA B2 42 CD C2 8A 9B 8D F1 B1 BB FE CB AA AE 37 D0 17 CF E3 43 78
+377400 H C8 18 16 DE 52 73 38 AB C2 0A 9F A9 D1 B2 C2 36
+377650 H 8C AC BC A7 50 1B EB C3 44 24
+380250 R C8 18 16 DE 52 73 38 AB C2 0A 9F A9 D1 B2 C2 36 8C AC BC A7 50 1B EB C3 44 24
+381652 H C8 18 16 07 CB 33 2E 8D C2 8A A2 C5 B1 B3 C9 6E 4C AE CA 17 D1 1E 07 A4 45 AD
+385656 H C8 18 16 31 33 B4 23 73 C2 0A A6 E1 91 B4 D0 A6 0C B0 D8 87 51 22 23 84 46 54
+388256 R C8 18 16 31 33 B4 23 73 C2 0A A6 E1 91 B4 D0 A6 0C B0 D8 87 51 22 23 84 46 54
+389654 H C8 18 16 5C 7B F4 18 61 C2 8A A9 FD 71 B5 D7 DE CC B1 E6 F7 D1 25 3F 64 47 DC
+393650 H C8 18 16 88 B3 F4 0D 53 C2 0A AD 19 52 B6 DE 16 8D B3 F4 67 52 29 5B 44 48 96
+396250 R C8 18 16 88 B3 F4 0D 53 C2 0A AD 19 52 B6 DE 16 8D B3 F4 67 52 29 5B 44 48 96
+397658 H C8 18 16 B4 D3 F4 02 4B C2 8A B0 35 32 B7 E5 4E 4D B5 02 D8 D2 2C 77 24 49 6D
+401646 H C8 18 16 DF E3 34 F8 48 C2 0A B4 51 12 B8 EC 86 0D B7 10 48 53 30 93 04 4A FB
+402846 H C8 08 32 EE EA 10 05 03 A8 C5
+404246 R C8 18 16 DF E3 34 F8 48 C2 0A B4 51 12 B8 EC 86 0D B7 10 48 53 30 93 04 4A FB
+405404 H C8 18 16 0B D4 34 ED 4A 32 F1 B7 6D F2 B8 F3 BE
+405654 H CD B8 1E B8 D3 33 AF E4 4A 7A
+405804 T EA 0D 3A EA EE 10 00 00 9C 40 FF FF FB 50 69
+409656 H C8 18 16 37 B4 34 E2 52 32 71 BB 89 D2 B9 FA F6 8D BA 2C 28 54 37 CB C4 4B C4
+412256 R C8 18 16 37 B4 34 E2 52 32 71 BB 89 D2 B9 FA F6 8D BA 2C 28 54 37 CB C4 4B C4
+413649 H C8 18 16 63 7C 34 D7 60 32 F1 BE A5 B2 BA 01 2F 4E BC 3A 98 D4 3A E7 A4 4C B7
+417640 H C8 18 16 8E 34 74 CC 72 32 71 C2 C1 92 BB 08 67 0E BE 48 08 55 3E 03 85 4D 87
+420240 R C8 18 16 8E 34 74 CC 72 32 71 C2 C1 92 BB 08 67 0E BE 48 08 55 3E 03 85 4D 87
+421645 H C8 18 16 B8 CC F3 C1 8C 32 F1 C5 DD 72 BC 0F 9F CE BF 56 78 D5 41 1F 65 4E 42
+425651 H C8 18 16 E1 54 B3 B7 AA 32 71 C9 F9 52 BD AE D0 8E C1 64 E8 55 45 3B 45 4F 9D
+428251 R C8 18 16 E1 54 B3 B7 AA 32 71 C9 F9 52 BD AE D0 8E C1 64 E8 55 45 3B 45 4F 9D
+429653 H C8 18 16 0A CD 72 AD CC 32 F1 CC 15 33 BE B5 08 4F C3 72 58 D6 48 57 25 50 83
+433409 H C8 18 16 31 2D B2 A3 F4 32 71 D0 31 13 BF BC 40
+433659 H 0F C5 80 C8 56 4C 73 05 51 2A
+436259 R C8 18 16 31 2D B2 A3 F4 32 71 D0 31 13 BF BC 40 0F C5 80 C8 56 4C 73 05 51 2A
+437644 H C8 18 16 57 7D 31 9A 20 33 F1 D3 4D F3 BF C3 78 CF C6 8E 38 D7 4F 8F E5 51 65
+441650 H C8 18 16 7B B5 30 91 52 33 71 D7 69 D3 C0 CA B0 8F C8 9C A8 57 53 AB C5 52 71
+444250 R C8 18 16 7B B5 30 91 52 33 71 D7 69 D3 C0 CA B0 8F C8 9C A8 57 53 AB C5 52 71
+445653 H C8 18 16 9E DD 6F 88 88 33 F1 DA 85 B3 C1 D1 E8 4F CA AA 18 D8 56 C7 A5 53 BA
+449650 H C8 18 16 BF F5 2E 80 C2 33 71 DE A1 93 C2 D8 20 10 CC B8 88 58 5A E3 85 54 88
+451550 F C8 0A 08 00 A4 00 0C 00 00 00 32 91
+452250 R C8 18 16 BF F5 2E 80 C2 33 71 DE A1 93 C2 D8 20 10 CC B8 88 58 5A E3 85 54 88
+453636 H C8 18 16 DE FD 6D 78 00 34 F1 E1 BD 73 C3 DF 58 D0 CD C6 F8 D8 5D FF 65 55 95
+457654 H C8 18 16 FB F5 2C 71 42 34 71 E5 D9 53 C4 E6 90 90 CF D4 68 59 61 1B 46 56 BF
+460254 R C8 18 16 FB F5 2C 71 42 34 71 E5 D9 53 C4 E6 90 90 CF D4 68 59 61 1B 46 56 BF
+461413 H C8 18 16 16 DE 6B 6A 88 34 F1 E8 F5 33 C5 ED C8
+461663 H 50 D1 E2 D8 D9 64 37 26 57 A7
+465656 H C8 18 16 2F BE 2A 64 D0 34 71 EC 11 14 C6 F4 00 11 D3 F0 48 5A 68 53 06 58 FD
+468256 R C8 18 16 2F BE 2A 64 D0 34 71 EC 11 14 C6 F4 00 11 D3 F0 48 5A 68 53 06 58 FD
+469645 H C8 18 16 45 8E A9 5E 1C 35 F1 EF 2D F4 C6 FB 38 D1 D4 FE B8 DA 6B 6F E6 58 14
+473648 H C8 18 16 59 56 A8 59 6A 35 71 F3 49 D4 C7 02 71 91 D6 0C 29 5B 6F 8B C6 59 86
+476248 R C8 18 16 59 56 A8 59 6A 35 71 F3 49 D4 C7 02 71 91 D6 0C 29 5B 6F 8B C6 59 86
+477651 H C8 18 16 6A 0E 67 55 BC 35 F1 F6 65 B4 C8 09 A9 51 D8 1A 99 DB 72 A7 A6 5A C8
+481664 H C8 18 16 79 C6 A5 51 0E 36 71 FA 81 94 C9 10 E1 11 DA 28 09 5C 76 C3 86 5B 18
+484264 R C8 18 16 79 C6 A5 51 0E 36 71 FA 81 94 C9 10 E1 11 DA 28 09 5C 76 C3 86 5B 18
+485653 H C8 18 16 86 76 64 4E 62 36 F1 FD 9D 74 CA 17 19 D2 DB 36 79 DC 79 DF 66 5C E0
+489400 H C8 18 16 8F 1E 23 4C B8 36 71 01 BA 54 CB 1E 51
+489650 H 92 DD 44 E9 5C 7D FB 46 5D 2D
+492250 R C8 18 16 8F 1E 23 4C B8 36 71 01 BA 54 CB 1E 51 92 DD 44 E9 5C 7D FB 46 5D 2D
+493659 H C8 18 16 96 BE 61 4A 10 37 F1 04 D6 34 CC 25 89 52 DF 52 59 DD 80 17 27 5E F3
+497650 H C8 18 16 9A 5E 60 49 68 37 71 08 F2 14 CD 2C C1 12 E1 60 C9 5D 84 33 07 5F ED
+500250 R C8 18 16 9A 5E 60 49 68 37 71 08 F2 14 CD 2C C1 12 E1 60 C9 5D 84 33 07 5F ED
+501661 H C8 18 16 9C 06 1F 49 BE 37 F1 0B 0E F5 CD 33 F9 D2 E2 6E 39 DE 87 4F E7 5F 05
+502861 H C8 07 7A C8 EA 30 00 65 7A
+505646 H C8 18 16 9A A6 5D 49 16 38 71 0F 2A D5 CE 3A 31 93 E4 7C A9 5E 57 68 C7 60 E8
+508246 R C8 18 16 9A A6 5D 49 16 38 71 0F 2A D5 CE 3A 31 93 E4 7C A9 5E 57 68 C7 60 E8
+509648 H C8 18 16 96 46 5C 4A 6E 38 F1 12 46 B5 CF 41 69 53 E6 8A 19 DF 5A 84 A7 61 FF
+509798 T EA 0C 14 3C 32 64 05 00 04 03 00 50 08 4E
+513654 H C8 18 16 8F E6 1A 4C C6 38 71 16 62 95 D0 48 A1 13 E8 98 89 5F 5E A0 87 62 83
+516254 R C8 18 16 8F E6 1A 4C C6 38 71 16 62 95 D0 48 A1 13 E8 98 89 5F 5E A0 87 62 83
+517408 H C8 18 16 86 8E 59 4E 1C 39 F1 19 7E 75 D1 4F D9
+517658 H D3 E9 A6 F9 DF 61 BC 67 63 F5
+521653 H C8 18 16 79 3E 98 51 70 39 71 1D 9A 55 D2 56 11 94 EB B4 69 60 65 D8 47 64 0A
+524253 R C8 18 16 79 3E 98 51 70 39 71 1D 9A 55 D2 56 11 94 EB B4 69 60 65 D8 47 64 0A
+525651 H C8 18 16 6A F6 56 55 C2 39 F1 20 B6 35 D3 5D 49 54 ED C2 D9 E0 68 F4 27 65 B8
+529640 H C8 18 16 59 AE 95 59 14 3A 71 24 D2 15 D4 64 81 14 EF D0 49 61 6C 10 08 66 D2
+532240 R C8 18 16 59 AE 95 59 14 3A 71 24 D2 15 D4 64 81 14 EF D0 49 61 6C 10 08 66 D2
+533646 H C8 18 16 45 76 94 5E 62 3A F1 27 EE F5 D4 6B B9 D4 F0 DE B9 E1 6F 2C E8 66 9D
+537647 H C8 18 16 2F 46 13 64 AE 3A 71 2B 0A D6 D5 72 F1 94 F2 EC 29 62 73 48 C8 67 E3
+540247 R C8 18 16 2F 46 13 64 AE 3A 71 2B 0A D6 D5 72 F1 94 F2 EC 29 62 73 48 C8 67 E3
+541647 H C8 18 16 16 26 52 6A F6 3A F1 2E 26 B6 D6 79 29 55 F4 FA 99 E2 76 64 A8 68 02
+545403 H C8 18 16 FB 0D 11 71 3C 3B 71 32 42 96 D7 80 61
+545653 H 15 F6 08 0A 63 7A 80 88 69 F1
+548253 R C8 18 16 FB 0D 11 71 3C 3B 71 32 42 96 D7 80 61 15 F6 08 0A 63 7A 80 88 69 F1
+549648 H C8 18 16 DE 05 50 78 7E 3B F1 35 5E 76 D8 87 99 D5 F7 16 7A E3 7D 9C 68 6A B5
+551548 F C8 0A 08 00 A3 00 0C 00 00 00 32 D7
+551748 F C8 08 1E 01 2C FF 10 00 40 E1
+553654 H C8 18 16 BF 0D 0F 80 BC 3B 71 39 7A 56 D9 8E D1 95 F9 24 EA 63 81 B8 48 6B D8
+556254 R C8 18 16 BF 0D 0F 80 BC 3B 71 39 7A 56 D9 8E D1 95 F9 24 EA 63 81 B8 48 6B D8
+557650 H C8 18 16 9E 25 4E 88 F6 3B F1 3C 96 36 DA 95 09 56 FB 32 5A E4 84 D4 28 6C 42
+561649 H C8 18 16 7B 4D 0D 91 2C 3C 71 40 B2 16 DB 9C 41 16 FD 40 CA 64 88 F0 08 6D 18
+564249 R C8 18 16 7B 4D 0D 91 2C 3C 71 40 B2 16 DB 9C 41 16 FD 40 CA 64 88 F0 08 6D 18
+565650 H C8 18 16 57 85 0C 9A 5E 3C F1 43 CE F6 DB A3 79 D6 FE 4E 3A E5 8B 0C E9 6D AB
+569652 H C8 18 16 31 D5 8B A3 8A 3C 71 47 EA D6 DC AA B1 96 00 5D AA 65 8F 28 C9 6E 7B
+572252 R C8 18 16 31 D5 8B A3 8A 3C 71 47 EA D6 DC AA B1 96 00 5D AA 65 8F 28 C9 6E 7B
+573405 H C8 18 16 0A 35 4B AD B2 3C F1 4A 06 B7 DD B1 E9
+573655 H 56 02 6B 1A E6 92 44 A9 6F BD
+577648 H C8 18 16 E1 AC 8A B7 D4 3C 71 4E 22 97 DE B8 21 17 04 79 8A 66 96 60 89 70 EE
+580248 R C8 18 16 E1 AC 8A B7 D4 3C 71 4E 22 97 DE B8 21 17 04 79 8A 66 96 60 89 70 EE
+581649 H C8 18 16 B8 34 CA C1 F2 3C F1 51 3E 77 DF BF 59 D7 05 87 FA E6 99 7C 69 71 94
+585642 H C8 18 16 8E CC 49 CC 0C 3D 71 55 5A 57 E0 C6 91 97 07 95 6A 67 9D 98 49 72 60
+588242 R C8 18 16 8E CC 49 CC 0C 3D 71 55 5A 57 E0 C6 91 97 07 95 6A 67 9D 98 49 72 60
+589659 H C8 18 16 63 84 09 D7 1E 3D F1 58 76 37 E1 CD C9 57 09 A3 DA E7 A0 B4 29 73 1F
+593658 H C8 18 16 37 4C 09 E2 2C 3D 71 5C 92 17 E2 D4 01 18 0B B1 4A 68 A4 D0 09 74 CA
+596258 R C8 18 16 37 4C 09 E2 2C 3D 71 5C 92 17 E2 D4 01 18 0B B1 4A 68 A4 D0 09 74 CA
+597649 H C8 18 16 0B 2C 09 ED 34 3D F1 5F AE F7 15 DB 39 D8 0C BF BA E8 A7 EC E9 74 12
+601398 H C8 18 16 E0 23 C9 F7 38 3D 71 63 CA D7 16 E2 71
+601648 H 98 0E CD 2A 69 AB 08 CA 75 A6
+602848 H 00 FF 13
+604248 R C8 18 16 E0 23 C9 F7 38 3D 71 63 CA D7 16 E2 71 98 0E CD 2A 69 AB 08 CA 75 A6
+605643 H C8 18 16 B4 2B C9 02 35 3D F1 66 E6 B7 17 E9 A9 58 10 DB 9A E9 AE 24 AA 76 AB
+609651 H C8 18 16 88 4B C9 0D 2D 3D 71 6A 02 98 18 F0 E1 18 12 E9 0A 6A B2 40 8A 77 93
+609801 T EA 0D 3A EA EE 10 00 00 9C 40 FF FF FB 50 69
+612251 R C8 18 16 88 4B C9 0D 2D 3D 71 6A 02 98 18 F0 E1 18 12 E9 0A 6A B2 40 8A 77 93
+613651 H C8 18 16 5C 83 C9 18 1F 3D F1 6D 1E 78 19 F7 19 D9 13 F7 7A EA B5 5C 6A 78 4F
+617663 H C8 18 16 31 CB 89 23 0D 3D 71 71 3A 58 1A FE 51 99 15 05 EB 6A B9 78 4A 79 2C
+620263 R C8 18 16 31 CB 89 23 0D 3D 71 71 3A 58 1A FE 51 99 15 05 EB 6A B9 78 4A 79 2C
+621651 H C8 18 16 07 33 0A 2E F3 3C F1 74 56 38 1B 05 8A 59 17 13 5B EB BC 94 2A 7A 01
+625646 H C8 18 16 DE AA 4A 38 D5 3C 71 78 72 18 1C 0C C2 19 19 21 CB 6B C0 B0 0A 7B 80
+628246 R C8 18 16 DE AA 4A 38 D5 3C 71 78 72 18 1C 0C C2 19 19 21 CB 6B C0 B0 0A 7B 80
+629386 H C8 18 16 B5 32 8B 42 B3 3C F1 7B 8E F8 1C 13 FA
+629636 H D9 1A 2F 3B EC C3 CC EA 7B C5
+633658 H C8 18 16 8E D2 4B 4C 8B 3C 71 7F AA D8 1D 1A 32 9A 1C 3D AB 6C C7 E8 CA 7C EB
+636258 R C8 18 16 8E D2 4B 4C 8B 3C 71 7F AA D8 1D 1A 32 9A 1C 3D AB 6C C7 E8 CA 7C EB
+637651 H C8 18 16 68 82 CC 55 5F 3C F1 82 C6 B8 1E 21 6A 5A 1E 4B 1B ED CA 04 AB 7D 16
+641641 H C8 18 16 44 4A CD 5E 2D 3C 71 86 E2 98 1F 28 A2 1A 20 59 8B 6D CE 20 8B 7E 26
+644241 R C8 18 16 44 4A CD 5E 2D 3C 71 86 E2 98 1F 28 A2 1A 20 59 8B 6D CE 20 8B 7E 26
+645651 H C8 18 16 21 22 8E 67 F7 3B F1 89 FE 78 20 2F DA DA 21 67 FB ED D1 3C 6B 7F 54
+649641 H C8 18 16 00 0A CF 6F BD 3B 71 8D 1A 59 21 36 12 9B 23 75 6B 6E D5 58 4B 80 58
+651541 F C8 0A 08 00 A2 00 0C 00 00 00 32 43
+652241 R C8 18 16 00 0A CF 6F BD 3B 71 8D 1A 59 21 36 12 9B 23 75 6B 6E D5 58 4B 80 58
+653670 H C8 18 16 E1 01 90 77 7F 3B F1 90 36 39 22 3D 4A 5B 25 83 DB EE D8 74 2B 81 C5
+657406 H C8 18 16 C4 09 D1 7E 3D 3B 71 94 52 19 23 44 82
+657656 H 1B 27 91 4B 6F DC 90 0B 82 B0
+660256 R C8 18 16 C4 09 D1 7E 3D 3B 71 94 52 19 23 44 82 1B 27 91 4B 6F DC 90 0B 82 B0
+661653 H C8 18 16 A9 21 92 85 F7 3A F1 97 6E F9 23 4B BA DB 28 9F BB EF DF AC EB 82 3B
+665649 H C8 18 16 90 41 D3 8B AF 3A 71 9B 8A D9 24 52 F2 9B 2A AD 2B 70 E3 C8 CB 83 2A
+668249 R C8 18 16 90 41 D3 8B AF 3A 71 9B 8A D9 24 52 F2 9B 2A AD 2B 70 E3 C8 CB 83 2A
+669638 H C8 18 16 7A 71 54 91 63 3A F1 9E A6 B9 25 59 2A 5C 2C BB 9B F0 E6 E4 AB 84 A1
+673650 H C8 18 16 66 A9 55 96 15 3A 71 A2 C2 99 26 60 62 1C 2E C9 0B 71 EA 00 8C 85 F7
+676250 R C8 18 16 66 A9 55 96 15 3A 71 A2 C2 99 26 60 62 1C 2E C9 0B 71 EA 00 8C 85 F7
+677641 H C8 18 16 55 F1 96 9A C3 39 F1 A5 DE 79 27 67 9A DC 2F D7 FB 8A ED 1C 6C 86 8F
+681653 H C8 18 16 46 39 58 9E 71 39 71 A9 FA 59 28 6E D2 9C 31 E5 6B 0B F1 38 4C 87 35
+684253 R C8 18 16 46 39 58 9E 71 39 71 A9 FA 59 28 6E D2 9C 31 E5 6B 0B F1 38 4C 87 35
+685388 H C8 18 16 39 89 99 A1 1D 39 F1 AC 16 3A 29 75 0A
+685638 H 5D 33 F3 DB 8B F4 54 2C 88 A1
+689645 H C8 18 16 30 E1 DA A3 C7 38 71 B0 32 1A 2A 7C 42 1D 35 01 4C 0C F8 70 0C 89 1E
+692245 R C8 18 16 30 E1 DA A3 C7 38 71 B0 32 1A 2A 7C 42 1D 35 01 4C 0C F8 70 0C 89 1E
+693657 H C8 18 16 29 41 9C A5 6F 38 F1 B3 4E FA 2A 83 7A DD 36 0F BC 8C FB 8C EC 89 2D
+697659 H C8 18 16 25 A1 9D A6 17 38 71 B7 6A DA 2B 8A B2 9D 38 1D 2C 0D FF A8 CC 8A AE
+700259 R C8 18 16 25 A1 9D A6 17 38 71 B7 6A DA 2B 8A B2 9D 38 1D 2C 0D FF A8 CC 8A AE
+701643 H C8 18 16 24 F9 1E A7 C1 37 F1 FA 86 BA 2C 91 EA 5D 3A 2B 9C 8D 02 C5 AC 8B D6
+705641 H C8 18 16 25 59 A0 A6 69 37 71 BE A2 9A 2D 98 22 1E 3C 39 0C 0E 06 E1 8C 8C 2B
+708241 R C8 18 16 25 59 A0 A6 69 37 71 BE A2 9A 2D 98 22 1E 3C 39 0C 0E 06 E1 8C 8C 2B
+709655 H C8 18 16 29 B9 A1 A5 11 37 F1 C1 BE 7A 2E 9F 5A DE 3D 47 7C 8E 09 FD 6C 8D A2
+713405 H C8 18 16 30 19 E3 A3 B9 36 71 C5 DA 5A 2F A6 92
+713655 H 9E 3F 55 EC 0E 0D 19 4D 8E DD
+716255 R C8 18 16 30 19 E3 A3 B9 36 71 C5 DA 5A 2F A6 92 9E 3F 55 EC 0E 0D 19 4D 8E DD
+717645 H C8 18 16 39 71 A4 A1 63 36 F1 C8 F6 3A 30 AD CA 5E 41 63 5C 8F 10 35 2D 8F B7
+721646 H C8 18 16 46 C1 65 9E 0F 36 71 CC 12 1B 31 B4 02 1F 43 71 CC 0F 14 51 0D 90 E8
+724246 R C8 18 16 46 C1 65 9E 0F 36 71 CC 12 1B 31 B4 02 1F 43 71 CC 0F 14 51 0D 90 E8
+725646 H C8 18 16 55 09 A7 9A BD 35 F1 CF 2E FB 31 BB 3A DF 44 7F 3C 90 17 6D ED 90 88
+729643 H C8 18 16 66 51 68 96 6B 35 71 D3 4A DB 32 C2 72 9F 46 8D AC 10 1B 89 CD 91 CB
+732243 R C8 18 16 66 51 68 96 6B 35 71 D3 4A DB 32 C2 72 9F 46 8D AC 10 1B 89 CD 91 CB
+733646 H C8 18 16 7A 89 69 91 1D 35 F1 D6 66 BB 33 C9 AA 5F 48 9B 1C 91 1E A5 AD 92 A4
+737657 H C8 18 16 90 B9 EA 8B D1 34 71 DA 82 9B 34 D0 E2 1F 4A A9 8C 11 22 C1 8D 93 56
+740257 R C8 18 16 90 B9 EA 8B D1 34 71 DA 82 9B 34 D0 E2 1F 4A A9 8C 11 22 C1 8D 93 56
+741404 H C8 18 16 A9 D9 AB 85 89 34 F1 DD 9E 7B 35 D7 1A
+741654 H E0 4B B7 FC 91 25 DD 6D 94 99
+745662 H C8 18 16 C4 F1 EC 7E 43 34 71 E1 BA 5B 36 DE 52 A0 4D C5 6C 12 29 F9 4D 95 D2
+748262 R C8 18 16 C4 F1 EC 7E 43 34 71 E1 BA 5B 36 DE 52 A0 4D C5 6C 12 29 F9 4D 95 D2
+749650 H C8 18 16 E1 F9 AD 77 01 34 F1 E4 D6 3B 37 E5 8A 60 4F D3 DC 92 2C 15 2E 96 C5
+751550 F C8 0A 08 00 A1 00 0C 00 00 00 32 2A
+751750 F C8 08 1E 01 2C FF 10 00 40 E1
+753650 H C8 18 16 00 F2 EE 6F C3 33 71 E8 F2 1B 38 EC C2 20 51 E1 4C 13 30 31 0E 97 8F
+756250 R C8 18 16 00 F2 EE 6F C3 33 71 E8 F2 1B 38 EC C2 20 51 E1 4C 13 30 31 0E 97 8F
+757645 H C8 18 16 21 DA AF 67 89 33 F1 EB 0E FC 38 F3 FA E0 52 EF BC 93 33 4D EE 97 8D
+761650 H C8 18 16 44 B2 F0 5E 53 33 71 EF 2A DC 39 FA 32 A1 54 FD 2C 14 37 69 CE 98 3E
+761800 T EA 0C 14 3C 32 64 05 00 04 03 00 50 08 4E
+764250 R C8 18 16 44 B2 F0 5E 53 33 71 EF 2A DC 39 FA 32 A1 54 FD 2C 14 37 69 CE 98 3E
+765643 H C8 18 16 68 7A F1 55 21 33 F1 F2 46 BC 3A 01 6B 61 56 0B 9D 94 3A 85 AE 99 33
+769390 H C8 18 16 8E 2A 72 4C F5 32 71 F6 C2 82 3B 08 A3
+769640 H 21 58 19 0D 15 3E A1 8E 9A 20
+772240 R C8 18 16 8E 2A 72 4C F5 32 71 F6 C2 82 3B 08 A3 21 58 19 0D 15 3E A1 8E 9A 20
+773654 H C8 18 16 B5 CA B2 42 CD 32 F1 F9 DE 62 3C 0F DB E1 59 27 7D 95 41 BD 6E 9B 3A
+777658 H C8 18 16 DE 52 73 38 AB 32 71 FD FA 42 3D 16 13 A2 5B 35 ED 15 45 D9 4E 9C 43
+780258 R C8 18 16 DE 52 73 38 AB 32 71 FD FA 42 3D 16 13 A2 5B 35 ED 15 45 D9 4E 9C 43
+781655 H C8 18 16 07 CB 33 2E 8D 32 F1 00 17 23 3E 1D 4B 62 5D 43 5D 96 48 F5 2E 9D 39
+785657 H C8 18 16 31 33 B4 23 73 32 71 04 33 03 3F 24 83 22 5F 51 CD 16 4C 11 0F 9E 56
+788257 R C8 18 16 31 33 B4 23 73 32 71 04 33 03 3F 24 83 22 5F 51 CD 16 4C 11 0F 9E 56
+789651 H C8 18 16 5C 7B F4 18 61 32 F1 07 4F E3 3F 2B BB E2 60 5F 3D 97 4F 2D EF 9E DC
+793646 H C8 18 16 88 B3 F4 0D 53 32 71 0B 6B C3 40 32 F3 A2 62 6D AD 17 53 49 CF 9F 00
+796246 R C8 18 16 88 B3 F4 0D 53 32 71 0B 6B C3 40 32 F3 A2 62 6D AD 17 53 49 CF 9F 00
+797400 H C8 18 16 B4 D3 F4 02 4B 32 F1 0E 87 A3 41 39 2B
+797650 H 63 64 7B 1D 98 56 65 AF A0 E9
+801648 H C8 18 16 DF E3 34 F8 48 32 71 12 A3 83 42 40 63 23 66 89 8D 18 5A 81 8F A1 1D
+804248 R C8 18 16 DF E3 34 F8 48 32 71 12 A3 83 42 40 63 23 66 89 8D 18 5A 81 8F A1 1D
+805644 H C8 18 16 0B D4 34 ED 4A 32 F1 15 BF 63 43 47 9B E3 67 97 FD 98 5D 9D 6F A2 7E
+809640 H C8 18 16 37 B4 34 E2 52 32 71 19 DB 43 44 4E D3 A3 69 A5 6D 19 61 B9 4F A3 37
+812240 R C8 18 16 37 B4 34 E2 52 32 71 19 DB 43 44 4E D3 A3 69 A5 6D 19 61 B9 4F A3 37
+813642 H C8 18 16 63 7C 34 D7 60 32 F1 1C F7 23 45 55 0B 64 6B B3 DD 99 64 D5 2F A4 C7
+813792 T EA 0D 3A EA EE 10 00 00 9C 40 FF FF FB 50 69
+817650 H C8 18 16 8E 34 74 CC 72 32 71 20 13 04 46 5C 43 24 6D C1 4D 1A 68 F1 0F A5 51
+820250 R C8 18 16 8E 34 74 CC 72 32 71 20 13 04 46 5C 43 24 6D C1 4D 1A 68 F1 0F A5 51
+821650 H C8 18 16 B8 CC F3 C1 8C 32 F1 23 2F E4 46 63 7B E4 6E CF BD 9A 6B 0D F0 A5 7F
+825398 H C8 18 16 E1 54 B3 B7 AA 32 71 27 4B C4 47 6A B3
+825648 H A4 70 DD 2D 1B 6F 29 D0 A6 06
+828248 R C8 18 16 E1 54 B3 B7 AA 32 71 27 4B C4 47 6A B3 A4 70 DD 2D 1B 6F 29 D0 A6 06
+829658 H C8 18 16 0A CD 72 AD CC 32 F1 2A 67 A4 48 71 EB 64 72 EB 9D 9B 72 45 B0 A7 4E
+833651 H C8 18 16 31 2D B2 A3 F4 32 71 2E 83 84 49 78 23 25 74 F9 0D 1C 76 61 90 A8 2F
+836251 R C8 18 16 31 2D B2 A3 F4 32 71 2E 83 84 49 78 23 25 74 F9 0D 1C 76 61 90 A8 2F
+837653 H C8 18 16 57 7D 31 9A 20 33 F1 31 9F 64 4A 7F 5B E5 75 07 7E 9C 79 7D 70 A9 A8
+841657 H C8 18 16 7B B5 30 91 52 33 71 35 BB 44 4B 86 93 A5 77 15 EE 1C 7D 99 50 AA E0
+844257 R C8 18 16 7B B5 30 91 52 33 71 35 BB 44 4B 86 93 A5 77 15 EE 1C 7D 99 50 AA E0
+845646 H C8 18 16 9E DD 6F 88 88 33 F1 38 D7 24 4C 8D CB 65 79 23 5E 9D 80 B5 30 AB 31
+849639 H C8 18 16 BF F5 2E 80 C2 33 71 3C F3 04 4D 94 03 26 7B 61 C1 1D 84 D1 10 AC 17
+851539 F C8 0A 08 00 A0 00 0C 00 00 00 32 BE
+852239 R C8 18 16 BF F5 2E 80 C2 33 71 3C F3 04 4D 94 03 26 7B 61 C1 1D 84 D1 10 AC 17
+853404 H C8 18 16 DE FD 6D 78 00 34 F1 3F 0F E5 4D 9B 3B
+853654 H E6 7C 6F 31 9E 87 ED F0 AC 09
+857646 H C8 18 16 FB F5 2C 71 42 34 71 43 2B C5 4E A2 73 A6 7E 7D A1 1E 8B 09 D1 AD 51
+860246 R C8 18 16 FB F5 2C 71 42 34 71 43 2B C5 4E A2 73 A6 7E 7D A1 1E 8B 09 D1 AD 51
+861657 H C8 18 16 16 DE 6B 6A 88 34 F1 46 47 A5 4F A9 AB 66 80 8B 11 9F 8E 25 B1 AE 43
+865652 H C8 18 16 2F BE 2A 64 D0 34 71 4A 63 85 50 B0 E3 26 82 99 81 1F 92 41 91 AF C6
+868252 R C8 18 16 2F BE 2A 64 D0 34 71 4A 63 85 50 B0 E3 26 82 99 81 1F 92 41 91 AF C6
+869656 H C8 18 16 45 8E A9 5E 1C 35 F1 4D 7F 65 51 B7 1B E7 83 A7 F1 9F 95 5D 71 B0 1B
+873654 H C8 18 16 59 56 A8 59 6A 35 71 51 9B 45 52 BE 53 A7 85 B5 61 20 99 79 51 B1 83
+876254 R C8 18 16 59 56 A8 59 6A 35 71 51 9B 45 52 BE 53 A7 85 B5 61 20 99 79 51 B1 83
+877638 H C8 18 16 6A 0E 67 55 BC 35 F1 54 B7 25 53 C5 8B 67 87 C3 D1 A0 9C 95 31 B2 9D
+881404 H C8 18 16 79 C6 A5 51 0E 36 71 58 D3 05 54 CC C3
+881654 H 27 89 D1 41 21 A0 B1 11 B3 FD
+884254 R C8 18 16 79 C6 A5 51 0E 36 71 58 D3 05 54 CC C3 27 89 D1 41 21 A0 B1 11 B3 FD
+885646 H C8 18 16 86 76 64 4E 62 36 F1 5B EF E5 54 D3 FB E7 8A DF B1 A1 A3 CD F1 B3 99
+889646 H C8 18 16 8F 1E 23 4C B8 36 71 5F 0B C6 55 DA 33 A8 8C ED 21 22 A7 E9 D1 B4 36
+892246 R C8 18 16 8F 1E 23 4C B8 36 71 5F 0B C6 55 DA 33 A8 8C ED 21 22 A7 E9 D1 B4 36
+893648 H C8 18 16 96 BE 61 4A 10 37 F1 62 27 A6 56 E1 6B 68 8E FB 91 A2 AA 05 B2 B5 8C
+897654 H C8 18 16 9A 5E 60 49 68 37 71 66 43 86 57 E8 A3 28 90 09 02 23 AE 21 92 B6 86
+900254 R C8 18 16 9A 5E 60 49 68 37 71 66 43 86 57 E8 A3 28 90 09 02 23 AE 21 92 B6 86
+901655 H C8 18 16 9C 06 1F 49 BE 37 F1 69 5F 66 58 EF DB E8 91 17 72 A3 B1 3D 72 B7 1C
+905656 H C8 18 16 9A A6 5D 49 16 38 71 6D 7B 46 59 F6 13 A9 93 25 E2 23 B5 59 52 B8 4E
+908256 R C8 18 16 9A A6 5D 49 16 38 71 6D 7B 46 59 F6 13 A9 93 25 E2 23 B5 59 52 B8 4E
+909391 H C8 18 16 96 46 5C 4A 6E 38 F1 70 97 26 5A FD 4B
+909641 H 69 95 33 52 A4 B8 75 32 B9 51
+913647 H C8 18 16 8F E6 1A 4C C6 38 71 74 B3 06 5B 04 84 29 97 41 C2 24 BC 91 12 BA C4
+916247 R C8 18 16 8F E6 1A 4C C6 38 71 74 B3 06 5B 04 84 29 97 41 C2 24 BC 91 12 BA C4
+917636 H C8 18 16 86 8E 59 4E 1C 39 F1 77 CF E6 5B 0B BC E9 98 4F 32 A5 BF AD F2 BA 47
+921650 H C8 18 16 79 3E 98 51 70 39 71 7B EB C6 5C 12 F4 A9 9A 5D A2 25 C3 C9 D2 BB 36
+924250 R C8 18 16 79 3E 98 51 70 39 71 7B EB C6 5C 12 F4 A9 9A 5D A2 25 C3 C9 D2 BB 36
+925653 H C8 18 16 6A F6 56 55 C2 39 F1 7E 07 A7 5D 19 2C 6A 9C 6B 12 A6 C6 E5 B2 BC F1
+929646 H C8 18 16 59 AE 95 59 14 3A 71 82 23 87 5E 20 64 2A 9E 79 82 26 CA 01 93 BD 2C
+932246 R C8 18 16 59 AE 95 59 14 3A 71 82 23 87 5E 20 64 2A 9E 79 82 26 CA 01 93 BD 2C
+933651 H C8 18 16 45 76 94 5E 62 3A F1 85 3F 67 5F 27 9C EA 9F 87 F2 A6 CD 1D 73 BE 08
+937401 H C8 18 16 2F 46 13 64 AE 3A 71 89 5B 47 60 2E D4
+937651 H AA A1 95 62 27 D1 39 53 BF F8
+940251 R C8 18 16 2F 46 13 64 AE 3A 71 89 5B 47 60 2E D4 AA A1 95 62 27 D1 39 53 BF F8
+941656 H C8 18 16 16 26 52 6A F6 3A F1 58 74 27 61 35 0C 6B A3 A3 D2 A7 D4 55 33 C0 C1
+945646 H C8 18 16 FB 0D 11 71 3C 3B 71 5C 90 07 62 3C 44 2B A5 B1 42 28 D8 71 13 C1 74
+948246 R C8 18 16 FB 0D 11 71 3C 3B 71 5C 90 07 62 3C 44 2B A5 B1 42 28 D8 71 13 C1 74
+949646 H C8 18 16 DE 05 50 78 7E 3B F1 5F AC E7 62 43 7C EB A6 BF B2 A8 DB 8D F3 C1 F7
+951546 F C8 0A 08 00 9F 00 0C 00 00 00 32 B7
+951746 F C8 08 1E 01 2C FF 10 00 40 E1
+953646 H C8 18 16 BF 0D 0F 80 BC 3B 71 63 C8 C7 63 4A B4 AB A8 CD 22 29 DF A9 D3 C2 74
+956246 R C8 18 16 BF 0D 0F 80 BC 3B 71 63 C8 C7 63 4A B4 AB A8 CD 22 29 DF A9 D3 C2 74
+957660 H C8 18 16 9E 25 4E 88 F6 3B F1 66 E4 A7 64 51 EC 6B AA DB 92 A9 E2 C5 B3 C3 74
+961656 H C8 18 16 7B 4D 0D 91 2C 3C 71 6A 00 88 65 58 24 2C AC E9 02 2A E6 E1 93 C4 02
+964256 R C8 18 16 7B 4D 0D 91 2C 3C 71 6A 00 88 65 58 24 2C AC E9 02 2A E6 E1 93 C4 02
+965400 H C8 18 16 57 85 0C 9A 5E 3C F1 6D 1C 68 66 5F 5C
+965650 H EC AD F7 72 AA E9 FD 73 C5 48
+969651 H C8 18 16 31 D5 8B A3 8A 3C 71 71 38 48 67 66 94 AC AF 05 E3 2A ED 19 54 C6 CD
+972251 R C8 18 16 31 D5 8B A3 8A 3C 71 71 38 48 67 66 94 AC AF 05 E3 2A ED 19 54 C6 CD
+973650 H C8 18 16 0A 35 4B AD B2 3C F1 74 54 28 68 6D CC 6C B1 13 53 AB F0 35 34 C7 AF
+977651 H C8 18 16 E1 AC 8A B7 D4 3C 71 78 70 08 69 74 04 2D B3 21 C3 2B F4 51 14 C8 20
+980251 R C8 18 16 E1 AC 8A B7 D4 3C 71 78 70 08 69 74 04 2D B3 21 C3 2B F4 51 14 C8 20
+981649 H C8 18 16 B8 34 CA C1 F2 3C F1 7B 8C E8 69 7B 3C ED B4 2F 33 AC F7 6D F4 C8 0E
+985648 H C8 18 16 8E CC 49 CC 0C 3D 71 7F A8 C8 6A 82 74 AD B6 3D A3 2C FB 89 D4 C9 9C
+988248 R C8 18 16 8E CC 49 CC 0C 3D 71 7F A8 C8 6A 82 74 AD B6 3D A3 2C FB 89 D4 C9 9C
+989643 H C8 18 16 63 84 09 D7 1E 3D F1 82 C4 A8 6B 89 AC 6D B8 4B 13 AD FE A5 B4 CA DA
+993397 H C8 18 16 37 4C 09 E2 2C 3D 71 86 E0 88 6C 90 E4
+993647 H 2D BA 59 83 2D 02 C2 94 CB 73
+996247 R C8 18 16 37 4C 09 E2 2C 3D 71 86 E0 88 6C 90 E4 2D BA 59 83 2D 02 C2 94 CB 73
+997659 H C8 18 16 0B 2C 09 ED 34 3D F1 89 FC 68 6D 97 1C EE BB 67 F3 AD 05 DE 74 CC 02
+1001653 H C8 18 16 E0 23 C9 F7 38 3D 71 8D 18 49 6E 9E 54 AE BD 75 63 2E 09 FA 54 CD 1D
+1004253 R C8 18 16 E0 23 C9 F7 38 3D 71 8D 18 49 6E 9E 54 AE BD 75 63 2E 09 FA 54 CD 1D
+1005650 H C8 18 16 B4 2B C9 02 35 3D F1 90 34 29 6F A5 8C 6E BF 83 D3 AE 0C 16 35 CE 69
+1009649 H C8 18 16 88 4B C9 0D 2D 3D 71 94 50 09 70 AC C4 2E C1 91 43 2F 10 32 15 CF B5
+1012249 R C8 18 16 88 4B C9 0D 2D 3D 71 94 50 09 70 AC C4 2E C1 91 43 2F 10 32 15 CF B5
+1013650 H C8 18 16 5C 83 C9 18 1F 3D F1 97 6C E9 70 B3 FC EE C2 9F B3 AF 13 4E F5 CF F5
+1013800 T EA 0D 3A EA EE 10 00 00 9C 40 FF FF FB 50 69
+1017652 H C8 18 16 31 CB 89 23 0D 3D 71 9B 88 C9 71 BA 34 AF C4 AD 23 30 17 6A D5 D0 62
+1017802 T EA 0C 14 3C 32 64 05 00 04 03 00 50 08 4E
+1020252 R C8 18 16 31 CB 89 23 0D 3D 71 9B 88 C9 71 BA 34 AF C4 AD 23 30 17 6A D5 D0 62
+1021397 H C8 18 16 07 33 0A 2E F3 3C F1 9E A4 A9 72 C1 6C
+1021647 H 6F 2C BA 93 B0 1A 86 B5 D1 60
+1025651 H C8 18 16 DE AA 4A 38 D5 3C 71 A2 C0 89 73 C8 A4 2F 2E C8 03 31 1E A2 95 D2 DA
+1028251 R C8 18 16 DE AA 4A 38 D5 3C 71 A2 C0 89 73 C8 A4 2F 2E C8 03 31 1E A2 95 D2 DA
+1029651 H C8 18 16 B5 32 8B 42 B3 3C F1 A5 DC 69 74 CF DC EF 2F D6 73 B1 21 BE 75 D3 CE
+1033646 H C8 18 16 8E D2 4B 4C 8B 3C 71 A9 F8 49 75 D6 14 B0 31 E4 E3 31 25 DA 55 D4 65
+1036246 R C8 18 16 8E D2 4B 4C 8B 3C 71 A9 F8 49 75 D6 14 B0 31 E4 E3 31 25 DA 55 D4 65
+1037646 H C8 18 16 68 82 CC 55 5F 3C F1 AC 14 2A 76 DD 4C 70 33 F2 53 B2 28 F6 35 D5 E5
+1041645 H C8 18 16 44 4A CD 5E 2D 3C 71 B0 30 0A 77 E4 84 30 35 00 C4 32 2C 12 16 D6 48
+1044245 R C8 18 16 44 4A CD 5E 2D 3C 71 B0 30 0A 77 E4 84 30 35 00 C4 32 2C 12 16 D6 48
+1045644 H C8 18 16 21 22 8E 67 F7 3B F1 B3 4C EA 77 EB BC F0 36 0E 34 B3 2F 2E F6 D6 DD
+1049405 H C8 18 16 00 0A CF 6F BD 3B 71 B7 68 CA 78 F2 F4
+1049655 H B0 38 1C A4 33 33 4A D6 D7 61
+1051555 F C8 0A 08 00 9E 00 0C 00 00 00 32 23
+1052255 R C8 18 16 00 0A CF 6F BD 3B 71 B7 68 CA 78 F2 F4 B0 38 1C A4 33 33 4A D6 D7 61
+1053636 H C8 18 16 E1 01 90 77 7F 3B F1 BA 84 AA 79 F9 2C 71 3A 2A 14 B4 36 66 B6 D8 63
+1057649 H C8 18 16 C4 09 D1 7E 3D 3B 71 BE A0 8A 7A 00 65 31 3C 38 84 34 3A 82 96 D9 2E
+1060249 R C8 18 16 C4 09 D1 7E 3D 3B 71 BE A0 8A 7A 00 65 31 3C 38 84 34 3A 82 96 D9 2E
+1061647 H C8 18 16 A9 21 92 85 F7 3A F1 C1 BC 6A 7B 07 9D F1 3D 46 F4 B4 3D 9E 76 DA A8
+1065647 H C8 18 16 90 41 D3 8B AF 3A 71 C5 D8 4A 7C 0E D5 B1 3F 54 64 35 41 BA 56 DB 2C
+1068247 R C8 18 16 90 41 D3 8B AF 3A 71 C5 D8 4A 7C 0E D5 B1 3F 54 64 35 41 BA 56 DB 2C
+1069650 H C8 18 16 7A 71 54 91 63 3A F1 C8 F4 2A 7D 15 0D 72 41 62 D4 B5 44 D6 36 DC 4E
+1073656 H C8 18 16 66 A9 55 96 15 3A 71 CC 10 0B 7E 1C 45 32 43 70 44 36 48 F2 16 DD 46
+1076256 R C8 18 16 66 A9 55 96 15 3A 71 CC 10 0B 7E 1C 45 32 43 70 44 36 48 F2 16 DD 46
+1077400 H C8 18 16 55 F1 96 9A C3 39 F1 CF 2C EB 7E 23 7D
+1077650 H F2 44 7E B4 B6 4B 0E F7 DD 51
+1081650 H C8 18 16 46 39 58 9E 71 39 71 D3 48 CB 7F 2A B5 B2 46 8C 24 37 4F 2A D7 DE 28
+1084250 R C8 18 16 46 39 58 9E 71 39 71 D3 48 CB 7F 2A B5 B2 46 8C 24 37 4F 2A D7 DE 28
+1085647 H C8 18 16 39 89 99 A1 1D 39 F1 D6 64 AB 80 31 ED 72 48 9A 94 B7 52 46 B7 DF 01
+1089650 H C8 18 16 30 E1 DA A3 C7 38 71 DA 80 8B 81 38 25 33 4A A8 04 38 56 62 97 E0 86
+1092250 R C8 18 16 30 E1 DA A3 C7 38 71 DA 80 8B 81 38 25 33 4A A8 04 38 56 62 97 E0 86
+1093655 H C8 18 16 29 41 9C A5 6F 38 F1 DD 9C 6B 82 3F 5D F3 4B B6 74 B8 59 7E 77 E1 F7
+1097648 H C8 18 16 25 A1 9D A6 17 38 71 E1 B8 4B 83 46 95 B3 4D C4 E4 38 5D 9A 57 E2 2B
+1100248 R C8 18 16 25 A1 9D A6 17 38 71 E1 B8 4B 83 46 95 B3 4D C4 E4 38 5D 9A 57 E2 2B
+1101644 H C8 18 16 24 F9 1E A7 C1 37 F1 E4 D4 2B 84 4D CD 73 4F D2 54 B9 60 B6 37 16 61
+1105393 H C8 18 16 25 59 A0 A6 69 37 71 E8 F0 0B 85 54 05
+1105643 H 34 51 E0 C4 39 64 D2 17 17 20
+1108243 R C8 18 16 25 59 A0 A6 69 37 71 E8 F0 0B 85 54 05 34 51 E0 C4 39 64 D2 17 17 20
+1109644 H C8 18 16 29 B9 A1 A5 11 37 F1 EB 0C EC 85 5B 3D F4 52 EE 34 BA 67 EE F7 17 48
+1113642 H C8 18 16 30 19 E3 A3 B9 36 71 EF 28 CC 86 62 75 B4 54 FC A4 3A 6B 0A D8 18 D5
+1116242 R C8 18 16 30 19 E3 A3 B9 36 71 EF 28 CC 86 62 75 B4 54 FC A4 3A 6B 0A D8 18 D5
+1117656 H C8 18 16 39 71 A4 A1 63 36 F1 F2 44 AC 87 69 AD 74 56 0A 15 BB 6E 26 B8 19 C0
+1121652 H C8 18 16 46 C1 65 9E 0F 36 71 F6 60 8C 88 70 E5 34 58 18 85 3B 72 42 98 1A 89
+1124252 R C8 18 16 46 C1 65 9E 0F 36 71 F6 60 8C 88 70 E5 34 58 18 85 3B 72 42 98 1A 89
+1125649 H C8 18 16 55 09 A7 9A BD 35 F1 F9 7C 6C 89 77 1D F5 59 26 F5 BB 75 5E 78 1B 93
+1129658 H C8 18 16 66 51 68 96 6B 35 71 FD 98 4C 8A 7E 55 B5 5B 34 65 3C 79 7A 58 1C 8A
+1132258 R C8 18 16 66 51 68 96 6B 35 71 FD 98 4C 8A 7E 55 B5 5B 34 65 3C 79 7A 58 1C 8A
+1133397 H C8 18 16 7A 89 69 91 1D 35 F1 00 B5 2C 8B 85 8D
+1133647 H 75 5D 42 D5 BC 7C 96 38 1D D2
+1137654 H C8 18 16 90 B9 EA 8B D1 34 71 04 D1 0C 8C 8C C5 35 5F 50 45 3D 80 B2 18 1E 41
+1140254 R C8 18 16 90 B9 EA 8B D1 34 71 04 D1 0C 8C 8C C5 35 5F 50 45 3D 80 B2 18 1E 41
+1141654 H C8 18 16 A9 D9 AB 85 89 34 F1 07 ED EC 8C 93 FD F5 60 5E B5 BD 83 CE F8 1E 66
+1145641 H C8 18 16 C4 F1 EC 7E 43 34 71 0B 09 CD 8D 9A 35 B6 62 6C 25 3E 87 EA D8 1F 7B
+1148241 R C8 18 16 C4 F1 EC 7E 43 34 71 0B 09 CD 8D 9A 35 B6 62 6C 25 3E 87 EA D8 1F 7B
+1149641 H C8 18 16 E1 F9 AD 77 01 34 F1 0E 25 AD 8E A1 6D 76 64 7A 95 BE 8A 06 B9 20 0C
+1151541 F C8 0A 08 00 9D 00 0C 00 00 00 32 4A
+1151741 F C8 08 1E 01 2C FF 10 00 40 E1
+1153645 H C8 18 16 00 F2 EE 6F C3 33 71 12 41 8D 8F A8 A5 36 66 88 05 3F 8E 22 99 21 FA
+1156245 R C8 18 16 00 F2 EE 6F C3 33 71 12 41 8D 8F A8 A5 36 66 88 05 3F 8E 22 99 21 FA
+1157655 H C8 18 16 21 DA AF 67 89 33 F1 15 5D 6D 90 AF DD F6 67 96 75 BF 91 3E 79 22 E8
+1161407 H C8 18 16 44 B2 F0 5E 53 33 71 19 79 4D 91 B6 15
+1161657 H B7 69 A4 E5 3F 95 5A 59 23 7B
+1164257 R C8 18 16 44 B2 F0 5E 53 33 71 19 79 4D 91 B6 15 B7 69 A4 E5 3F 95 5A 59 23 7B
+1165643 H C8 18 16 68 7A F1 55 21 33 F1 1C 95 2D 92 BD 4D 77 6B B2 55 C0 98 76 39 24 5F
+1169656 H C8 18 16 8E 2A 72 4C F5 32 71 20 B1 0D 93 C4 85 37 6D C0 C5 40 9C 92 19 25 18
+1172256 R C8 18 16 8E 2A 72 4C F5 32 71 20 B1 0D 93 C4 85 37 6D C0 C5 40 9C 92 19 25 18
+1173648 H C8 18 16 B5 CA B2 42 CD 32 F1 23 CD ED 93 CB BD F7 6E CE 35 C1 9F AE F9 25 BE
+1177648 H C8 18 16 DE 52 73 38 AB 32 71 27 E9 CD 94 D2 F5 B7 70 DC A5 41 A3 CA D9 26 4A
+1180248 R C8 18 16 DE 52 73 38 AB 32 71 27 E9 CD 94 D2 F5 B7 70 DC A5 41 A3 CA D9 26 4A
+1181647 H C8 18 16 07 CB 33 2E 8D 32 F1 2A 05 AE 95 D9 2D 78 72 EA 15 C2 A6 E6 B9 27 1F
+1185649 H C8 18 16 31 33 B4 23 73 32 71 2E 21 8E 96 E0 65 38 74 F8 85 42 AA 02 9A 28 35
+1188249 R C8 18 16 31 33 B4 23 73 32 71 2E 21 8E 96 E0 65 38 74 F8 85 42 AA 02 9A 28 35
+1189390 H C8 18 16 5C 7B F4 18 61 32 F1 31 3D 6E 97 E7 9D
+1189640 H F8 75 06 F6 C2 AD 1E 7A 29 56
+1193644 H C8 18 16 88 B3 F4 0D 53 32 71 35 59 4E 98 EE 95 85 77 14 66 43 B1 3A 5A 2A CD
+1196244 R C8 18 16 88 B3 F4 0D 53 32 71 35 59 4E 98 EE 95 85 77 14 66 43 B1 3A 5A 2A CD
+1197643 H C8 18 16 B4 D3 F4 02 4B 32 F1 38 75 2E 99 F5 CD 45 79 22 D6 C3 B4 56 3A 2B E4
+)CAPTURE";
@@ -0,0 +1,558 @@
+/**
+ * This file is part of ExpressLRS
+ * See https://github.com/AlessandroAU/ExpressLRS
+ *
+ * Replays a capture of the CRSF UARTs through the TX's handset parser, the
+ * MSP and telemetry paths over a lossless link and the OTA encoder, on the
+ * simulated clock, checking what comes out and when.
+ *
+ * The capture built in is replayed by default. To replay one of your own,
+ * in the format of CrsfCapture.h, set CRSF_REPLAY_CAPTURE to its path. Set
+ * CRSF_REPLAY_OUTPUT to a path to write the capture back out with what this
+ * firmware sent to the handset in place of the recorded T records.
+ *
+ * Only the TX side is replayed. F records are the RX's telemetry source,
+ * but what the RX sends the FC is not regenerated, R records are only
+ * checked for being good frames.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unity.h>
+
+#include "targets.h"
+#include "CRSF.h"
+#include "CrsfCapture.h"
+#include "OTA.h"
+#include "stubborn_receiver.h"
+#include "stubborn_sender.h"
+#include "telemetry.h"
+#include "capture_edgetx_250hz.h"
+
+CRSF crsf(NULL);  // need an instance to provide the fields used by the code under test
+Telemetry telemetry;
+uint8_t UID[6] = {1,2,3,4,5,6};
+
+#define REPLAY_PACKET_INTERVAL_US 4000 // the TX's RF packets, and what the handset is asked for
+#define REPLAY_FASTEST_BAUD       5250000
+
+/**
+ * The handset's side of the UART. Bytes from the capture are queued as their
+ * record comes up, what the firmware writes is kept as records at the time
+ * it was written.
+ */
+class ReplayPort : public Stream
+{
+public:
+    ReplayPort() : position(0) {}
+
+    void queue(const uint8_t *data, uint8_t len) { in.append((const char *)data, len); }
+
+    int available() { return in.length() - position; }
+    int read() { return position < in.length() ? (uint8_t)in[position++] : -1; }
+    int peek() { return position < in.length() ? (uint8_t)in[position] : -1; }
+    void flush() {}
+
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t write(uint8_t *data, int len)
+    {
+        for (int i = 0; i < len; ++i)
+        {
+            const uint32_t now = micros();
+            if (out.empty() || out.back().timeUs != now || out.back().len == CRSF_CAPTURE_MAX_BYTES)
+            {
+                crsfCaptureRecord_t rec = { now, CRSF_CAPTURE_TX, 0, {0} };
+                out.push_back(rec);
+            }
+            out.back().data[out.back().len++] = data[i];
+        }
+        return len;
+    }
+
+    std::vector<crsfCaptureRecord_t> out;
+
+private:
+    std::string in;
+    size_t position;
+};
+
+/**
+ * Frames from a byte stream, for checking against what the firmware makes
+ * of the same bytes
+ */
+class FrameSplitter
+{
+public:
+    FrameSplitter() : len(0), bad(0) {}
+
+    /* Add a byte, true if it completes a good frame */
+    bool add(uint8_t b)
+    {
+        if (len == 0 && b != CRSF_SYNC_BYTE && b != CRSF_ADDRESS_CRSF_TRANSMITTER &&
+            b != CRSF_ADDRESS_RADIO_TRANSMITTER && b != CRSF_ADDRESS_CRSF_RECEIVER)
+            return false;
+        if (len == 1 && (b < 2 || b > CRSF_MAX_PACKET_LEN - 2))
+        {
+            len = 0;
+            return add(b);
+        }
+        frame[len++] = b;
+        if (len < 2 || len < frame[1] + 2)
+            return false;
+        len = 0;
+        if (crsf_crc.calc(&frame[2], frame[1] - 1) == frame[frame[1] + 1])
+            return true;
+        ++bad;
+        return false;
+    }
+
+    uint8_t frame[CRSF_MAX_PACKET_LEN];
+    uint8_t len;
+    uint32_t bad;
+};
+
+typedef struct {
+    uint32_t handsetFrames;   // good frames in the capture from the handset
+    uint32_t handsetBad;
+    uint32_t processed;       // frames the parser passed on
+    uint32_t rcFrames;
+    uint32_t rcMismatched;    // channels which weren't those in the frame
+    uint32_t otaMismatched;   // channels which didn't come back out of the OTA packet
+    uint32_t paramUpdates;
+    uint32_t modelUpdates;
+    uint32_t mspExpected;     // MSP frames from the handset
+    uint32_t mspDelivered;    // arrived at the RX as sent
+    uint32_t fcTelemetry;     // frames from the FC
+    uint32_t tlmToHandset;    // which reached the handset as sent
+    uint32_t maxTlmLatencyUs; // from the FC to the handset
+    uint32_t syncFrames;
+    uint32_t outputFrames;
+    uint32_t outputBad;
+    uint32_t collisions;      // writes still going when the handset's next frame started
+    uint32_t recordedBad;     // T and R records which weren't good frames
+    uint32_t parseBytes;
+    double parseNs;
+    uint32_t durationUs;
+} replay_result_t;
+
+typedef struct {
+    uint32_t timeUs;
+    uint8_t frame[CRSF_MAX_PACKET_LEN];
+} pending_tlm_t;
+
+static uint32_t callbacks;
+static uint32_t paramUpdates;
+static uint32_t modelUpdates;
+static void onRCdata() { ++callbacks; }
+static void onParameterUpdate() { ++paramUpdates; }
+static void onModelUpdate() { ++modelUpdates; }
+
+static uint32_t replayBaseUs = 1000000; // each replay starts after the last, the clock never goes back
+
+/* The OTA link with nothing lost, one chunk a packet each way until the sender is done */
+static void linkTransfer(StubbornSender &sender, StubbornReceiver &receiver, uint8_t chunkLen)
+{
+    uint8_t chunk[ELRS8_TELEMETRY_BYTES_PER_CALL];
+    for (unsigned n = 0; sender.IsActive() && n < 1000; ++n)
+    {
+        const uint8_t packageIndex = sender.GetCurrentPayload(chunk, chunkLen);
+        receiver.ReceiveData(packageIndex, chunk, chunkLen);
+        sender.ConfirmCurrentPayload(receiver.GetCurrentConfirm());
+    }
+}
+
+/* The 11 bit channels of an RC frame, as the FC would read them */
+static void unpackRcFrame(const uint8_t *frame, uint32_t *channels)
+{
+    const uint8_t *payload = &frame[3];
+    uint32_t bits = 0;
+    unsigned bitCount = 0;
+    for (unsigned ch = 0; ch < CRSF_NUM_CHANNELS; ++ch)
+    {
+        while (bitCount < 11)
+        {
+            bits |= (uint32_t)*payload++ << bitCount;
+            bitCount += 8;
+        }
+        channels[ch] = bits & 0x7ff;
+        bits >>= 11;
+        bitCount -= 11;
+    }
+}
+
+/* Through the OTA encoder and back, as far as the encoding keeps them */
+static bool otaRoundTrip(uint8_t nonce)
+{
+    uint32_t sent[CRSF_NUM_CHANNELS];
+    memcpy(sent, CRSF::ChannelData, sizeof(sent));
+
+    OTA_Packet_s otaPkt;
+    memset(&otaPkt, 0, sizeof(otaPkt));
+    OtaNonce = nonce;
+    OtaPackChannelData(&otaPkt, &crsf, false, 8);
+    OtaGeneratePacketCrc(&otaPkt);
+    bool ok = OtaValidatePacketCrc(&otaPkt);
+    OtaUnpackChannelData(&otaPkt, &crsf, 8);
+    for (unsigned ch = 0; ch < 4; ++ch)
+        ok = ok && CRSF::ChannelData[ch] == UINT10_to_CRSF(CRSF_to_UINT10(sent[ch]));
+    ok = ok && CRSF::ChannelData[4] == BIT_to_CRSF(CRSF_to_BIT(sent[4]));
+
+    // Leave them as the parser had them
+    memcpy(CRSF::ChannelData, sent, sizeof(sent));
+    return ok;
+}
+
+static void writeRecord(FILE *output, const crsfCaptureRecord_t &rec)
+{
+    char line[16 + CRSF_CAPTURE_MAX_BYTES * 3];
+    if (CrsfCaptureFormat(line, sizeof(line), &rec))
+        fputs(line, output);
+}
+
+static void replay(const char *capture, replay_result_t *res, FILE *output)
+{
+    memset(res, 0, sizeof(*res));
+    callbacks = paramUpdates = modelUpdates = 0;
+
+    ReplayPort port;
+    CRSF::Port.connect(&port);
+    CRSF::RCdataCallback = &onRCdata;
+    CRSF::RecvParameterUpdate = &onParameterUpdate;
+    CRSF::RecvModelUpdate = &onModelUpdate;
+    OtaUpdateSerializers(smWideOr8ch, OTA4_PACKET_SIZE);
+
+    StubbornSender mspSender, tlmSender;
+    StubbornReceiver mspReceiver, tlmReceiver;
+    uint8_t mspBuffer[ELRS_MSP_BUFFER];
+    uint8_t tlmBuffer[CRSF_MAX_PACKET_LEN + 1];
+    mspSender.setMaxPackageIndex(ELRS_MSP_MAX_PACKAGES);
+    mspReceiver.setMaxPackageIndex(ELRS_MSP_MAX_PACKAGES);
+    mspReceiver.SetDataToReceive(mspBuffer, sizeof(mspBuffer));
+    tlmSender.setMaxPackageIndex(ELRS4_TELEMETRY_MAX_PACKAGES);
+    tlmReceiver.setMaxPackageIndex(ELRS4_TELEMETRY_MAX_PACKAGES);
+    tlmReceiver.SetDataToReceive(tlmBuffer, sizeof(tlmBuffer));
+    bool mspTransferActive = false;
+
+    FrameSplitter handset, fc, recorded, sentToHandset;
+    std::vector<std::vector<uint8_t> > mspFrames;
+    std::vector<pending_tlm_t> pendingTlm;
+    uint32_t lastCheckedOutput = 0;
+    uint32_t lastWrittenOutput = 0;
+
+    const uint32_t byteUs = 10000000 / CRSF::GetCurrentBaudRate();
+    CrsfCaptureReader reader(capture);
+    crsfCaptureRecord_t rec;
+    bool started = false;
+    uint32_t firstUs = 0, lastUs = 0, nextRfUs = 0;
+    while (reader.next(&rec))
+    {
+        if (!started)
+        {
+            started = true;
+            firstUs = rec.timeUs;
+            nativeSetMicros(replayBaseUs);
+            CRSF::Begin();
+            CRSF::setSyncParams(REPLAY_PACKET_INTERVAL_US);
+            nextRfUs = replayBaseUs;
+        }
+        const uint32_t now = replayBaseUs + rec.timeUs - firstUs;
+        lastUs = now;
+
+        // The TX's RF packets up to now
+        while ((int32_t)(now - nextRfUs) >= 0)
+        {
+            nativeSetMicros(nextRfUs);
+            CRSF::JustSentRFpacket();
+            nextRfUs += REPLAY_PACKET_INTERVAL_US;
+        }
+        nativeSetMicros(now);
+
+        if (rec.source == CRSF_CAPTURE_HANDSET)
+        {
+            // What the writes since the last handset record ran into
+            const uint32_t startUs = now - rec.len * byteUs;
+            for (; lastCheckedOutput < port.out.size(); ++lastCheckedOutput)
+            {
+                const crsfCaptureRecord_t &out = port.out[lastCheckedOutput];
+                if ((int32_t)(out.timeUs + out.len * byteUs - startUs) > 0)
+                    ++res->collisions;
+            }
+
+            // The reference, frame by frame
+            std::vector<std::vector<uint8_t> > frames;
+            for (unsigned i = 0; i < rec.len; ++i)
+                if (handset.add(rec.data[i]))
+                    frames.push_back(std::vector<uint8_t>(handset.frame, handset.frame + handset.frame[1] + 2));
+            res->handsetFrames += frames.size();
+
+            port.queue(rec.data, rec.len);
+            const auto parseStart = std::chrono::steady_clock::now();
+            CRSF::handleUARTin();
+            res->parseNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - parseStart).count();
+            res->parseBytes += rec.len;
+
+            for (unsigned f = 0; f < frames.size(); ++f)
+            {
+                const uint8_t type = frames[f][2];
+                if (type == CRSF_FRAMETYPE_RC_CHANNELS_PACKED)
+                {
+                    ++res->rcFrames;
+                    uint32_t channels[CRSF_NUM_CHANNELS];
+                    unpackRcFrame(frames[f].data(), channels);
+                    // Only the last of several in one read is left in ChannelData
+                    if (f == frames.size() - 1 || frames[f + 1][2] != CRSF_FRAMETYPE_RC_CHANNELS_PACKED)
+                    {
+                        if (memcmp(channels, CRSF::ChannelData, sizeof(channels)) != 0)
+                            ++res->rcMismatched;
+                        if (!otaRoundTrip(res->rcFrames))
+                            ++res->otaMismatched;
+                    }
+                }
+                else if (type >= CRSF_FRAMETYPE_MSP_REQ && type <= CRSF_FRAMETYPE_MSP_WRITE)
+                {
+                    mspFrames.push_back(frames[f]);
+                }
+            }
+
+            // tx_main's MSP handling, over to the RX
+            if (!mspSender.IsActive())
+            {
+                if (mspTransferActive)
+                {
+                    CRSF::UnlockMspMessage();
+                    mspTransferActive = false;
+                }
+                uint8_t *mspData;
+                uint8_t mspLen;
+                CRSF::GetMspMessage(&mspData, &mspLen);
+                if (mspData != nullptr)
+                {
+                    mspSender.SetDataToTransmit(mspData, mspLen);
+                    mspTransferActive = true;
+                    linkTransfer(mspSender, mspReceiver, ELRS_MSP_BYTES_PER_CALL);
+                    if (mspReceiver.HasFinishedData())
+                    {
+                        for (unsigned i = 0; i < mspFrames.size(); ++i)
+                        {
+                            if (mspFrames[i].size() <= mspLen && memcmp(mspFrames[i].data(), mspBuffer, mspFrames[i].size()) == 0)
+                            {
+                                ++res->mspDelivered;
+                                mspFrames.erase(mspFrames.begin() + i);
+                                break;
+                            }
+                        }
+                        mspReceiver.Unlock();
+                    }
+                }
+            }
+        }
+        else if (rec.source == CRSF_CAPTURE_FC)
+        {
+            // The RX's telemetry, over to the TX and on to the handset
+            for (unsigned i = 0; i < rec.len; ++i)
+            {
+                if (fc.add(rec.data[i]))
+                {
+                    ++res->fcTelemetry;
+                    pending_tlm_t tlm;
+                    tlm.timeUs = now;
+                    memcpy(tlm.frame, fc.frame, fc.frame[1] + 2);
+                    pendingTlm.push_back(tlm);
+                }
+                telemetry.RXhandleUARTin(rec.data[i]);
+            }
+            uint8_t *payload;
+            uint8_t payloadLen;
+            while (!tlmSender.IsActive() && telemetry.GetNextPayload(&payloadLen, &payload))
+            {
+                tlmSender.SetDataToTransmit(payload, payloadLen);
+                linkTransfer(tlmSender, tlmReceiver, ELRS4_TELEMETRY_BYTES_PER_CALL);
+                if (tlmReceiver.HasFinishedData())
+                {
+                    CRSF::sendTelemetryToTX(tlmBuffer);
+                    tlmReceiver.Unlock();
+                }
+            }
+        }
+        else
+        {
+            // What was recorded going out, checked and left for the firmware's own
+            for (unsigned i = 0; i < rec.len; ++i)
+                recorded.add(rec.data[i]);
+            if (rec.source == CRSF_CAPTURE_TX && output)
+                continue;
+        }
+
+        if (output)
+        {
+            // What the firmware sent in place of what was recorded, in time
+            // order, after the record it was sent in reply to
+            for (unsigned pass = 0; pass < 2; ++pass)
+            {
+                for (; lastWrittenOutput < port.out.size() && (int32_t)(port.out[lastWrittenOutput].timeUs - now) < (int32_t)pass; ++lastWrittenOutput)
+                {
+                    crsfCaptureRecord_t out = port.out[lastWrittenOutput];
+                    out.timeUs = out.timeUs - replayBaseUs + firstUs;
+                    writeRecord(output, out);
+                }
+                if (pass == 0)
+                    writeRecord(output, rec);
+            }
+        }
+    }
+
+    // What went to the handset
+    for (unsigned o = 0; o < port.out.size(); ++o)
+    {
+        const crsfCaptureRecord_t &out = port.out[o];
+        for (unsigned i = 0; i < out.len; ++i)
+        {
+            if (!sentToHandset.add(out.data[i]))
+                continue;
+            const uint8_t *frame = sentToHandset.frame;
+            ++res->outputFrames;
+            if (frame[2] == CRSF_FRAMETYPE_RADIO_ID && frame[5] == CRSF_FRAMETYPE_OPENTX_SYNC)
+            {
+                const uint32_t rate = (uint32_t)frame[6] << 24 | frame[7] << 16 | frame[8] << 8 | frame[9];
+                if (rate == REPLAY_PACKET_INTERVAL_US * 10)
+                    ++res->syncFrames;
+            }
+            for (unsigned p = 0; p < pendingTlm.size(); ++p)
+            {
+                // All but the sync byte, which is the handset's on the way out
+                if (memcmp(&pendingTlm[p].frame[1], &frame[1], frame[1] + 1) == 0)
+                {
+                    ++res->tlmToHandset;
+                    const uint32_t latency = out.timeUs - pendingTlm[p].timeUs;
+                    if (latency > res->maxTlmLatencyUs)
+                        res->maxTlmLatencyUs = latency;
+                    pendingTlm.erase(pendingTlm.begin() + p);
+                    break;
+                }
+            }
+        }
+        if (output && o >= lastWrittenOutput)
+        {
+            crsfCaptureRecord_t rec = out;
+            rec.timeUs = out.timeUs - replayBaseUs + firstUs;
+            writeRecord(output, rec);
+        }
+    }
+
+    res->handsetBad = handset.bad;
+    res->processed = callbacks;
+    res->paramUpdates = paramUpdates;
+    res->modelUpdates = modelUpdates;
+    res->mspExpected = res->mspDelivered + mspFrames.size();
+    res->outputBad = sentToHandset.bad;
+    res->recordedBad = recorded.bad;
+    res->durationUs = lastUs - replayBaseUs;
+    TEST_ASSERT_EQUAL_MESSAGE(0, reader.getErrors(), "Lines in the capture which couldn't be read");
+
+    replayBaseUs = lastUs + 1000000;
+    CRSF::Port.connect(nullptr);
+}
+
+static void printResult(const char *name, const replay_result_t &res)
+{
+    printf("%s: %u frames from the handset (%u bad) in %ums, %u RC\n"
+           "  parser %.1fns/byte, MSP %u/%u delivered, telemetry %u/%u to the handset (max %uus)\n"
+           "  %u frames to the handset (%u bad, %u sync), %u collisions\n",
+           name, res.handsetFrames, res.handsetBad, res.durationUs / 1000, res.rcFrames,
+           res.parseBytes ? res.parseNs / res.parseBytes : 0.0, res.mspDelivered, res.mspExpected,
+           res.tlmToHandset, res.fcTelemetry, res.maxTlmLatencyUs,
+           res.outputFrames, res.outputBad, res.syncFrames, res.collisions);
+}
+
+/* What holds for any capture */
+static void checkReplay(const replay_result_t &res)
+{
+    // Every good frame taken, as it was sent
+    TEST_ASSERT_EQUAL(res.handsetFrames, res.processed);
+    TEST_ASSERT_EQUAL(0, res.rcMismatched);
+    TEST_ASSERT_EQUAL(0, res.otaMismatched);
+    TEST_ASSERT_EQUAL(res.mspExpected, res.mspDelivered);
+    // Nothing broken going back, and only in the gaps between the handset's frames
+    TEST_ASSERT_EQUAL(0, res.outputBad);
+    TEST_ASSERT_EQUAL(0, res.collisions);
+    // The parser keeping up with the fastest UART
+    TEST_ASSERT_TRUE(res.parseNs / res.parseBytes < 10e9 / REPLAY_FASTEST_BAUD);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_replay_edgetx(void)
+{
+    replay_result_t res;
+    FILE *output = NULL;
+    const char *outputPath = getenv("CRSF_REPLAY_OUTPUT");
+    if (outputPath && !getenv("CRSF_REPLAY_CAPTURE"))
+        output = fopen(outputPath, "w");
+    replay(captureEdgeTx250Hz, &res, output);
+    if (output)
+        fclose(output);
+    printResult("EdgeTX 250Hz", res);
+    checkReplay(res);
+
+    // What is in the capture
+    TEST_ASSERT_EQUAL(300 - 1, res.rcFrames);
+    TEST_ASSERT_EQUAL(1, res.handsetBad);
+    TEST_ASSERT_EQUAL(0, res.recordedBad);
+    // The ping, which isn't forwarded, and the Lua read
+    TEST_ASSERT_EQUAL(2, res.paramUpdates);
+    TEST_ASSERT_EQUAL(CRSF_FRAMETYPE_PARAMETER_READ, CRSF::ParameterUpdateData[0]);
+    TEST_ASSERT_EQUAL(1, CRSF::ParameterUpdateData[1]);
+    TEST_ASSERT_EQUAL(1, res.modelUpdates);
+    TEST_ASSERT_EQUAL(3, CRSF::getModelID());
+    TEST_ASSERT_EQUAL(1, res.mspExpected);
+    // Armed partway through
+    TEST_ASSERT_TRUE(CRSF::IsArmed());
+    // Each battery and attitude frame, within a couple of RC frames
+    TEST_ASSERT_EQUAL(18, res.fcTelemetry);
+    TEST_ASSERT_EQUAL(res.fcTelemetry, res.tlmToHandset);
+    TEST_ASSERT_TRUE(res.maxTlmLatencyUs <= 2 * REPLAY_PACKET_INTERVAL_US);
+    // The handset synced at least as often as the longest sync interval
+    TEST_ASSERT_TRUE(res.syncFrames >= res.durationUs / 1000 / HANDSET_SYNC_INTERVAL_MAX_MS);
+}
+
+void test_replay_file(void)
+{
+    const char *path = getenv("CRSF_REPLAY_CAPTURE");
+    if (!path)
+        TEST_IGNORE_MESSAGE("Set CRSF_REPLAY_CAPTURE to replay a capture");
+
+    FILE *f = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL_MESSAGE(f, path);
+    std::string capture;
+    char buf[4096];
+    size_t len;
+    while ((len = fread(buf, 1, sizeof(buf), f)) > 0)
+        capture.append(buf, len);
+    fclose(f);
+
+    replay_result_t res;
+    FILE *output = NULL;
+    const char *outputPath = getenv("CRSF_REPLAY_OUTPUT");
+    if (outputPath)
+        output = fopen(outputPath, "w");
+    replay(capture.c_str(), &res, output);
+    if (output)
+        fclose(output);
+    printResult(path, res);
+    checkReplay(res);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_replay_edgetx);
+    RUN_TEST(test_replay_file);
+    UNITY_END();
+
+    return 0;
+}
@@ -0,0 +1,297 @@
+/**
+ * This file is part of ExpressLRS
+ * See https://github.com/AlessandroAU/ExpressLRS
+ *
+ * Unit tests for the device event queue and event delivery
+ */
+
+#include <thread>
+#include <vector>
+#include <unity.h>
+
+#include "targets.h"
+#include "common.h"
+#include "helpers.h"
+#include "device.h"
+#include "EventQueue.h"
+
+connectionState_e connectionState = disconnected;
+bool connectionHasModelMatch = false;
+
+void test_queue_order(void)
+{
+    EventQueue<uint32_t, 4> queue;
+    uint32_t val;
+
+    TEST_ASSERT_FALSE(queue.pop(val));
+    for (uint32_t i = 0; i < 4; ++i)
+        TEST_ASSERT_TRUE(queue.push(i));
+    // Full
+    TEST_ASSERT_FALSE(queue.push(99));
+
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        TEST_ASSERT_TRUE(queue.pop(val));
+        TEST_ASSERT_EQUAL(i, val);
+    }
+    TEST_ASSERT_FALSE(queue.pop(val));
+
+    // Wraps around
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        TEST_ASSERT_TRUE(queue.push(i));
+        TEST_ASSERT_TRUE(queue.pop(val));
+        TEST_ASSERT_EQUAL(i, val);
+    }
+}
+
+/**
+ * Several "ISR" threads push numbered items as fast as they can while the
+ * "loop" thread pops and also pushes its own items, as devicesUpdate() does for
+ * connection state changes. Every item must arrive exactly once, and the items
+ * from each producer must arrive in the order they were pushed.
+ **/
+#define STRESS_PRODUCERS 4
+#define STRESS_ITEMS 20000
+
+typedef struct {
+    uint32_t producer;
+    uint32_t seq;
+} stress_item_t;
+
+void test_queue_stress(void)
+{
+    static EventQueue<stress_item_t, 16> queue;
+    std::vector<std::thread> producers;
+    uint32_t dropped[STRESS_PRODUCERS + 1] = {0};
+
+    for (uint32_t p = 0; p < STRESS_PRODUCERS; ++p)
+    {
+        producers.push_back(std::thread([p, &dropped]() {
+            for (uint32_t seq = 0; seq < STRESS_ITEMS; ++seq)
+            {
+                // An ISR can't wait, but retry here so every item is checked
+                while (!queue.push({p, seq}))
+                {
+                    ++dropped[p];
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+
+    uint32_t nextSeq[STRESS_PRODUCERS + 1] = {0};
+    uint32_t received = 0;
+    uint32_t loopPushed = 0;
+    const uint32_t total = STRESS_PRODUCERS * STRESS_ITEMS;
+    while (received < total + loopPushed || loopPushed < STRESS_ITEMS / 100)
+    {
+        stress_item_t item;
+        if (queue.pop(item))
+        {
+            TEST_ASSERT_LESS_OR_EQUAL(STRESS_PRODUCERS, item.producer);
+            TEST_ASSERT_EQUAL(nextSeq[item.producer], item.seq);
+            ++nextSeq[item.producer];
+            ++received;
+        }
+        else
+            std::this_thread::yield();
+        if ((received % 100) == 0 && loopPushed < STRESS_ITEMS / 100)
+        {
+            if (queue.push({STRESS_PRODUCERS, loopPushed}))
+                ++loopPushed;
+            else
+                ++dropped[STRESS_PRODUCERS];
+        }
+    }
+
+    for (auto &t : producers)
+        t.join();
+
+    stress_item_t item;
+    TEST_ASSERT_FALSE(queue.pop(item));
+    for (uint32_t p = 0; p < STRESS_PRODUCERS; ++p)
+        TEST_ASSERT_EQUAL(STRESS_ITEMS, nextSeq[p]);
+    TEST_ASSERT_EQUAL(loopPushed, nextSeq[STRESS_PRODUCERS]);
+    printf("%u items through a 16 deep queue, %u pushes found it full\n", received,
+        dropped[0] + dropped[1] + dropped[2] + dropped[3] + dropped[4]);
+}
+
+/*** Event delivery to devices ***/
+static std::vector<deviceEvent_e> allEvents;
+static std::vector<deviceEvent_e> powerEvents;
+static uint32_t lastTimestamp;
+
+static int eventAll()
+{
+    const device_event_t *event = devicesCurrentEvent();
+    TEST_ASSERT_NOT_NULL(event);
+    // Delivered in order, so never earlier than the last
+    TEST_ASSERT_TRUE((int32_t)(event->timestamp - lastTimestamp) >= 0);
+    lastTimestamp = event->timestamp;
+    allEvents.push_back(event->type);
+    return DURATION_IGNORE;
+}
+
+static int eventPower()
+{
+    powerEvents.push_back(devicesCurrentEvent()->type);
+    return DURATION_IGNORE;
+}
+
+static device_t allDevice = {
+    .initialize = nullptr,
+    .start = nullptr,
+    .event = eventAll,
+    .timeout = nullptr
+};
+
+static device_t powerDevice = {
+    .initialize = nullptr,
+    .start = nullptr,
+    .event = eventPower,
+    .timeout = nullptr,
+    .subscriptions = EVENT_MASK(EVENT_POWER_CHANGED)
+};
+
+static device_affinity_t devices[] = {
+    {&allDevice, 0},
+    {&powerDevice, 0},
+};
+
+void test_device_event_delivery(void)
+{
+    devicesRegister(devices, ARRAY_SIZE(devices));
+    devicesInit();
+    devicesStart();
+    allEvents.clear();
+    powerEvents.clear();
+    lastTimestamp = micros();
+
+    devicesTriggerEvent(EVENT_VTX_CHANGED);
+    devicesTriggerEvent(EVENT_POWER_CHANGED);
+    devicesTriggerEvent(EVENT_VTX_CHANGED);
+    devicesTriggerEvent();
+    connectionState = connected;
+    devicesUpdate(millis());
+
+    // Every event in order for the unsubscribed device, the state change is found by devicesUpdate()
+    TEST_ASSERT_EQUAL(5, allEvents.size());
+    TEST_ASSERT_EQUAL(EVENT_VTX_CHANGED, allEvents[0]);
+    TEST_ASSERT_EQUAL(EVENT_POWER_CHANGED, allEvents[1]);
+    TEST_ASSERT_EQUAL(EVENT_VTX_CHANGED, allEvents[2]);
+    TEST_ASSERT_EQUAL(EVENT_GENERIC, allEvents[3]);
+    TEST_ASSERT_EQUAL(EVENT_CONNECTION_STATE, allEvents[4]);
+    // Only its subscription and the generic one for the other
+    TEST_ASSERT_EQUAL(2, powerEvents.size());
+    TEST_ASSERT_EQUAL(EVENT_POWER_CHANGED, powerEvents[0]);
+    TEST_ASSERT_EQUAL(EVENT_GENERIC, powerEvents[1]);
+    TEST_ASSERT_NULL(devicesCurrentEvent());
+
+    // Nothing new, nothing delivered
+    devicesUpdate(millis());
+    TEST_ASSERT_EQUAL(5, allEvents.size());
+}
+
+void test_device_event_overflow(void)
+{
+    devicesRegister(devices, ARRAY_SIZE(devices));
+    devicesStart();
+    allEvents.clear();
+    powerEvents.clear();
+    lastTimestamp = micros();
+
+    // More than the queue holds, the excess becomes one generic event at the end
+    for (unsigned i = 0; i < 20; ++i)
+        devicesTriggerEvent(EVENT_VTX_CHANGED);
+    devicesUpdate(millis());
+
+    TEST_ASSERT_EQUAL(17, allEvents.size());
+    TEST_ASSERT_EQUAL(EVENT_VTX_CHANGED, allEvents[15]);
+    TEST_ASSERT_EQUAL(EVENT_GENERIC, allEvents[16]);
+    TEST_ASSERT_EQUAL(1, powerEvents.size());
+}
+
+/*** Run time statistics ***/
+static uint32_t slowRunUs;
+
+static int startSlow()
+{
+    return 1;
+}
+
+static int timeoutSlow()
+{
+    // Simulated time passes while the device runs
+    nativeSetMicros(micros() + slowRunUs);
+    return 1;
+}
+
+static device_t slowDevice = {
+    .initialize = nullptr,
+    .start = startSlow,
+    .event = nullptr,
+    .timeout = timeoutSlow
+};
+
+static device_affinity_t slowDevices[] = {
+    {&slowDevice, 0},
+};
+
+void test_device_stats(void)
+{
+    nativeSetMicros(1000000);
+    devicesRegister(slowDevices, ARRAY_SIZE(slowDevices));
+    devicesStart();
+    const device_stats_t *stats = devicesGetStats(0);
+    TEST_ASSERT_NOT_NULL(stats);
+    TEST_ASSERT_NULL(devicesGetStats(1));
+    TEST_ASSERT_EQUAL(0, stats->runCount);
+
+    // On time and quick
+    slowRunUs = 100;
+    nativeSetMicros(micros() + 1000);
+    devicesUpdate(millis());
+    TEST_ASSERT_EQUAL(1, stats->runCount);
+    TEST_ASSERT_EQUAL(100, stats->runTimeUs);
+    TEST_ASSERT_EQUAL(100, stats->maxRunUs);
+    TEST_ASSERT_EQUAL(0, stats->overrunCount);
+    TEST_ASSERT_EQUAL(0, stats->lateCount);
+
+    // Not due yet
+    devicesUpdate(millis());
+    TEST_ASSERT_EQUAL(1, stats->runCount);
+
+    // Late and too long
+    slowRunUs = DEVICE_OVERRUN_US + 500;
+    nativeSetMicros(micros() + 1000 + DEVICE_LATE_US + 1);
+    devicesUpdate(millis());
+    TEST_ASSERT_EQUAL(2, stats->runCount);
+    TEST_ASSERT_EQUAL(100 + DEVICE_OVERRUN_US + 500, stats->runTimeUs);
+    TEST_ASSERT_EQUAL(DEVICE_OVERRUN_US + 500, stats->maxRunUs);
+    TEST_ASSERT_EQUAL(1, stats->overrunCount);
+    TEST_ASSERT_EQUAL(1, stats->lateCount);
+    devicesLogStats();
+
+    // Registering starts the counts again
+    devicesRegister(slowDevices, ARRAY_SIZE(slowDevices));
+    TEST_ASSERT_EQUAL(0, devicesGetStats(0)->runCount);
+    TEST_ASSERT_EQUAL(0, devicesGetStats(0)->maxRunUs);
+}
+
+// Unity setup/teardown
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_queue_order);
+    RUN_TEST(test_queue_stress);
+    RUN_TEST(test_device_event_delivery);
+    RUN_TEST(test_device_event_overflow);
+    RUN_TEST(test_device_stats);
+    UNITY_END();
+
+    return 0;
+}
@@ -0,0 +1,288 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <unity.h>
+#include "targets.h"
+#include "DiversityPredictor.h"
+
+void setUp() {}
+void tearDown() {}
+
+#define SENSITIVITY   -105
+#define NOISE_FLOOR   -95  // LoRa receives below the noise, SNR is -10 at sensitivity
+#define CHANNELS      40
+#define HOP_INTERVAL  4
+#define SLOTS         200000
+
+// Deterministic whatever the standard library
+class Rng
+{
+public:
+    explicit Rng(uint32_t seed) : state(seed) {}
+    double uniform()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return (state + 0.5) / 4294967296.0;
+    }
+    double gauss()
+    {
+        return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+    }
+private:
+    uint32_t state;
+};
+
+typedef struct {
+    const char *name;
+    double rho;         // correlation of the fading from one slot to the next, 1 for none
+    double freqSpread;  // how much each channel differs, 0 for flat, 1 for Rayleigh per channel
+    double marginDb;    // mean signal above sensitivity
+} fading_model_t;
+
+/**
+ * Two antennas, each with Rayleigh fading over time (Gauss-Markov) and a
+ * fixed Rayleigh gain per channel from multipath, independent between antennas
+ **/
+class Channel
+{
+public:
+    Channel(const fading_model_t &model, uint32_t seed) : model(model), rng(seed)
+    {
+        for (int a = 0; a < 2; ++a)
+        {
+            re[a] = rng.gauss() * M_SQRT1_2;
+            im[a] = rng.gauss() * M_SQRT1_2;
+            for (int c = 0; c < CHANNELS; ++c)
+            {
+                const double fr = rng.gauss() * M_SQRT1_2, fi = rng.gauss() * M_SQRT1_2;
+                const double rayleigh = 10 * log10(fr * fr + fi * fi);
+                chanDb[c][a] = model.freqSpread * rayleigh;
+            }
+        }
+    }
+
+    void step()
+    {
+        if (model.rho >= 1.0)
+            return;
+        const double k = sqrt(1 - model.rho * model.rho) * M_SQRT1_2;
+        for (int a = 0; a < 2; ++a)
+        {
+            re[a] = model.rho * re[a] + k * rng.gauss();
+            im[a] = model.rho * im[a] + k * rng.gauss();
+        }
+    }
+
+    // Signal strength (dBm) on antenna a, channel c right now
+    double strength(int a, int c) const
+    {
+        const double timeDb = model.rho >= 1.0 ? 0 : 10 * log10(re[a] * re[a] + im[a] * im[a]);
+        return SENSITIVITY + model.marginDb + timeDb + chanDb[c][a];
+    }
+
+private:
+    const fading_model_t &model;
+    Rng rng;
+    double re[2], im[2];
+    double chanDb[CHANNELS][2];
+};
+
+enum strategy_e { FIXED, REACTIVE, PREDICTIVE };
+
+// LQ in percent of the strategy over the model
+static double simulate(const fading_model_t &model, strategy_e strategy)
+{
+    Channel link(model, 1234);
+    Rng hopRng(99);
+    DiversityPredictor predictor;
+    predictor.setSensitivity(SENSITIVITY);
+
+    uint8_t antenna = 0;
+    uint8_t channel = 0;
+    uint32_t sinceSwitch = 0;
+    uint32_t received = 0;
+    for (uint32_t slot = 0; slot < SLOTS; ++slot)
+    {
+        const double s = link.strength(antenna, channel);
+        const bool ok = s >= SENSITIVITY;
+        received += ok;
+        const int8_t snr = lround(s - NOISE_FLOOR);
+        const int8_t rssi = lround(10 * log10(pow(10, s / 10) + pow(10, NOISE_FLOOR / 10.0)));
+
+        // Then the Tock: learn, hop, pick the antenna for the next packet
+        predictor.update(antenna, channel, ok, rssi, snr);
+        if (slot % HOP_INTERVAL == HOP_INTERVAL - 1)
+            channel = hopRng.uniform() * CHANNELS;
+        ++sinceSwitch;
+        if (strategy == REACTIVE)
+        {
+            // Switch after a missed packet, as the RX did
+            if (!ok && sinceSwitch > 1)
+            {
+                antenna = !antenna;
+                sinceSwitch = 0;
+            }
+        }
+        else if (strategy == PREDICTIVE)
+        {
+            antenna = predictor.predict(antenna, channel);
+        }
+        link.step();
+    }
+    return 100.0 * received / SLOTS;
+}
+
+static const fading_model_t models[] = {
+    // 500Hz, slow fading over ~100 slots, e.g. walking
+    { "slow fading",        0.995, 0.0, 10 },
+    // faster movement, coherent over ~10 slots
+    { "fast fading",        0.95,  0.0, 10 },
+    // nothing moving, multipath makes some channels poor on each antenna
+    { "frequency selective", 1.0,  1.0, 6 },
+    // all of it
+    { "mixed",              0.99,  0.5, 10 },
+};
+
+void test_diversity_lq_gain(void)
+{
+    const unsigned count = sizeof(models) / sizeof(models[0]);
+    double lq[count][3];
+    for (unsigned m = 0; m < count; ++m)
+    {
+        for (int strategy = FIXED; strategy <= PREDICTIVE; ++strategy)
+            lq[m][strategy] = simulate(models[m], (strategy_e)strategy);
+        printf("%-20s LQ fixed %5.1f%%  switch on miss %5.1f%%  predictive %5.1f%%\n",
+               models[m].name, lq[m][FIXED], lq[m][REACTIVE], lq[m][PREDICTIVE]);
+    }
+    for (unsigned m = 0; m < count; ++m)
+    {
+        TEST_ASSERT_TRUE(lq[m][PREDICTIVE] > lq[m][FIXED] + 5);
+        // Switching on a miss is about as good as it gets when all fading is in time
+        TEST_ASSERT_TRUE(lq[m][PREDICTIVE] > lq[m][REACTIVE] - 0.5);
+    }
+    // Channel history is where the prediction pays off
+    TEST_ASSERT_TRUE(lq[2][PREDICTIVE] > lq[2][REACTIVE] + 2);
+}
+
+// LQ in percent of the TX sending every packet on alternate antennas, or
+// choosing with TxDiversitySelector from a report every feedbackEvery packets
+static double simulateTx(const fading_model_t &model, bool predictive, uint32_t feedbackEvery)
+{
+    Channel link(model, 1234);
+    Rng hopRng(99);
+    TxDiversitySelector selector;
+    selector.reset(SENSITIVITY);
+
+    uint8_t antenna = 0;
+    uint8_t channel = 0;
+    uint32_t received = 0;
+    for (uint32_t slot = 0; slot < SLOTS; ++slot)
+    {
+        if (slot % HOP_INTERVAL == 0)
+            channel = hopRng.uniform() * CHANNELS;
+        if (predictive)
+            antenna = selector.select(antenna, channel);
+        else
+            antenna = !antenna;
+
+        const double s = link.strength(antenna, channel);
+        const bool ok = s >= SENSITIVITY;
+        received += ok;
+        if (slot % feedbackEvery == 0)
+        {
+            // The RX reports the RSSI, with the noise, positivized
+            const int8_t rssi = lround(10 * log10(pow(10, s / 10) + pow(10, NOISE_FLOOR / 10.0)));
+            selector.feedback(antenna, channel, ok ? -rssi : 0);
+        }
+        link.step();
+    }
+    return 100.0 * received / SLOTS;
+}
+
+// With reports from the RX as often as link stats come at a high telemetry
+// ratio, or hardly ever, the TX does better than alternating, never worse
+void test_tx_diversity_beats_alternating(void)
+{
+    const uint32_t feedbackEvery[] = { 4, 16, 64 };
+    const unsigned count = sizeof(models) / sizeof(models[0]);
+    for (unsigned f = 0; f < 3; ++f)
+    {
+        for (unsigned m = 0; m < count; ++m)
+        {
+            const double alternate = simulateTx(models[m], false, feedbackEvery[f]);
+            const double predictive = simulateTx(models[m], true, feedbackEvery[f]);
+            printf("report every %2u %-20s LQ alternating %5.1f%%  predictive %5.1f%%\n",
+                   feedbackEvery[f], models[m].name, alternate, predictive);
+            TEST_ASSERT_TRUE(predictive > alternate - 0.2);
+            if (f == 0)
+                TEST_ASSERT_TRUE(predictive > alternate + 1);
+        }
+    }
+}
+
+void test_tx_stale_feedback_alternates(void)
+{
+    TxDiversitySelector selector;
+    selector.reset(SENSITIVITY);
+    // Antenna 1 is far better on channel 3
+    for (int i = 0; i < 20; ++i)
+    {
+        selector.feedback(0, 3, 100);
+        selector.feedback(1, 3, 70);
+    }
+    TEST_ASSERT_EQUAL(1, selector.select(0, 3));
+    TEST_ASSERT_EQUAL(1, selector.select(1, 3));
+    // No reports for a while, back to alternating
+    uint8_t antenna = 1;
+    for (unsigned n = 0; n < DIVERSITY_TX_FRESH_SLOTS; ++n)
+        antenna = selector.select(antenna, 3);
+    TEST_ASSERT_EQUAL(0, selector.select(1, 3));
+    TEST_ASSERT_EQUAL(1, selector.select(0, 3));
+}
+
+void test_prefers_better_channel_history(void)
+{
+    DiversityPredictor p;
+    p.setSensitivity(SENSITIVITY);
+    // Channel 3 is weak on antenna 0, fine on antenna 1; channel 4 fine on both
+    for (int i = 0; i < 20; ++i)
+    {
+        p.update(0, 3, true, -98, 0);
+        p.update(0, 4, true, -80, 5);
+        p.update(1, 3, true, -82, 5);
+        p.update(1, 4, true, -81, 5);
+    }
+    TEST_ASSERT_EQUAL(1, p.predict(0, 3));
+    TEST_ASSERT_EQUAL(0, p.predict(0, 4));
+    // The hysteresis keeps the current antenna when they're close
+    TEST_ASSERT_EQUAL(1, p.predict(1, 4));
+}
+
+void test_switches_on_fade(void)
+{
+    DiversityPredictor p;
+    p.setSensitivity(SENSITIVITY);
+    p.update(1, 0, true, -85, 5);
+    for (int i = 0; i < 3; ++i)
+        p.update(0, 0, true, -85, 5);
+    TEST_ASSERT_EQUAL(0, p.predict(0, 0));
+    // Antenna 0 fades out
+    p.update(0, 0, false, 0, 0);
+    p.update(0, 0, false, 0, 0);
+    TEST_ASSERT_EQUAL(1, p.predict(0, 0));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_prefers_better_channel_history);
+    RUN_TEST(test_switches_on_fade);
+    RUN_TEST(test_diversity_lq_gain);
+    RUN_TEST(test_tx_stale_feedback_alternates);
+    RUN_TEST(test_tx_diversity_beats_alternating);
+    UNITY_END();
+
+    return 0;
+}
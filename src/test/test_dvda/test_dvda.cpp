@@ -0,0 +1,299 @@
+/**
+ * This file is part of ExpressLRS
+ * See https://github.com/AlessandroAU/ExpressLRS
+ *
+ * Unit tests and bit error simulation of the DVDA soft combining on the RX
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <unity.h>
+
+#include "targets.h"
+#include "CRSF.h"
+#include <OTA.h>
+#include <DvdaCombiner.h>
+
+CRSF crsf(NULL);  // need an instance to provide the fields used by the code under test
+uint8_t UID[6] = {1,2,3,4,5,6};
+
+static uint32_t rngState;
+static uint32_t rng()
+{
+    // Deterministic LCG so results are repeatable
+    rngState = rngState * 1103515245 + 12345;
+    return rngState >> 8;
+}
+
+static void randomizeChannels()
+{
+    for (unsigned ch = 0; ch < CRSF_NUM_CHANNELS; ++ch)
+        crsf.ChannelData[ch] = CRSF_CHANNEL_VALUE_MIN + rng() % (CRSF_CHANNEL_VALUE_MAX - CRSF_CHANNEL_VALUE_MIN);
+}
+
+static void generatePacket(OTA_Packet_s *otaPktPtr)
+{
+    memset(otaPktPtr, 0, sizeof(*otaPktPtr));
+    OtaPackChannelData(otaPktPtr, &crsf, false, 1);
+    OtaGeneratePacketCrc(otaPktPtr);
+}
+
+/* Flip each bit of the packet with probability ber (in parts per million) */
+static void corrupt(OTA_Packet_s *otaPktPtr, uint32_t berPpm)
+{
+    uint8_t *data = (uint8_t *)otaPktPtr;
+    for (unsigned i = 0; i < OTA4_PACKET_SIZE; ++i)
+        for (unsigned bit = 0; bit < 8; ++bit)
+            if (rng() % 1000000 < berPpm)
+                data[i] ^= 1 << bit;
+}
+
+/* True if the analog channels of two packets match */
+static bool sameChannels(OTA_Packet_s const *a, OTA_Packet_s const *b)
+{
+    return a->std.type == b->std.type
+        && memcmp(&a->std.rc.ch, &b->std.rc.ch, sizeof(a->std.rc.ch)) == 0
+        && a->std.rc.ch4 == b->std.rc.ch4;
+}
+
+typedef struct {
+    uint32_t plainGood;
+    uint32_t combinedGood;
+    uint32_t plainFalse;
+    uint32_t combinedFalse;
+} dvda_result_t;
+
+#define SIM_GROUPS 20000
+
+/**
+ * Send SIM_GROUPS DVDA groups of numOfSends copies through a channel with
+ * the given bit error rate and count how many groups deliver their channels
+ * with and without combining the failed copies
+ **/
+static dvda_result_t simulate(uint8_t numOfSends, uint32_t berPpm)
+{
+    dvda_result_t result = {0};
+    DvdaCombiner combiner;
+    rngState = 0x1234 + berPpm;
+
+    for (uint32_t group = 0; group < SIM_GROUPS; ++group)
+    {
+        randomizeChannels();
+        bool plainGood = false;
+        bool combinedGood = false;
+        for (uint8_t send = 0; send < numOfSends; ++send)
+        {
+            OtaNonce = group * numOfSends + send;
+            OTA_Packet_s sent;
+            generatePacket(&sent);
+            OTA_Packet_s received = sent;
+            corrupt(&received, berPpm);
+
+            if (OtaValidatePacketCrc(&received))
+            {
+                if (!sameChannels(&sent, &received))
+                    ++result.plainFalse;
+                plainGood = true;
+                combinedGood = true;
+            }
+            else if (!combinedGood && combiner.add(&received, OtaNonce / numOfSends))
+            {
+                if (!sameChannels(&sent, &received))
+                    ++result.combinedFalse;
+                combinedGood = true;
+            }
+        }
+        result.plainGood += plainGood;
+        result.combinedGood += combinedGood;
+    }
+
+    return result;
+}
+
+static void checkRate(const char *name, uint8_t numOfSends, uint32_t minGain)
+{
+    static const uint32_t berPpm[] = { 1000, 5000, 10000, 20000, 30000, 50000 };
+
+    OtaUpdateSerializers(smHybridOr16ch, OTA4_PACKET_SIZE);
+    uint32_t bestGain = 0;
+    for (unsigned i = 0; i < sizeof(berPpm) / sizeof(berPpm[0]); ++i)
+    {
+        dvda_result_t r = simulate(numOfSends, berPpm[i]);
+        uint32_t plainLq = r.plainGood * 100 / SIM_GROUPS;
+        uint32_t combinedLq = r.combinedGood * 100 / SIM_GROUPS;
+        printf("%s BER %5.3f: LQ %3u%% -> %3u%% combined (false frames %u -> %u)\n",
+            name, berPpm[i] / 1e6, plainLq, combinedLq,
+            r.plainFalse, r.plainFalse + r.combinedFalse);
+
+        TEST_ASSERT_GREATER_OR_EQUAL(r.plainGood, r.combinedGood);
+        // Combining can't let through more than a handful of bad frames
+        TEST_ASSERT_LESS_OR_EQUAL(SIM_GROUPS / 1000, r.combinedFalse);
+        if (combinedLq - plainLq > bestGain)
+            bestGain = combinedLq - plainLq;
+    }
+    // Somewhere in the marginal region there should be a real gain
+    TEST_ASSERT_GREATER_OR_EQUAL(minGain, bestGain);
+}
+
+void test_dvda_ber_d500(void)
+{
+    // Two copies only ever give one candidate, so the gain is small
+    checkRate("D500", 2, 3);
+}
+
+void test_dvda_ber_d250(void)
+{
+    checkRate("D250", 4, 5);
+}
+
+void test_dvda_false_accepts(void)
+{
+    // Copies of a random packet differing in a few bits, as noise decoded the
+    // same way each time would, with random CRCs. Anything accepted is a
+    // false frame, and the fewer bits differ the more candidates could be tried.
+    OtaUpdateSerializers(smHybridOr16ch, OTA4_PACKET_SIZE);
+    rngState = 0x5678;
+    DvdaCombiner combiner;
+    const uint32_t groups = 200000;
+    uint32_t accepts = 0;
+    uint32_t checks = 0;
+    for (uint32_t group = 0; group < groups; ++group)
+    {
+        // The top bits, the LCG's low ones repeat too soon
+        OTA_Packet_s base;
+        uint8_t *data = (uint8_t *)&base;
+        for (unsigned i = 0; i < OTA4_PACKET_SIZE; ++i)
+            data[i] = rng() >> 16;
+        base.std.type = PACKET_TYPE_RCDATA;
+
+        for (uint8_t send = 0; send < 4; ++send)
+        {
+            OtaNonce = group * 4 + send;
+            OTA_Packet_s copy = base;
+            // Up to 2 channel bits flipped
+            for (unsigned flips = rng() % 3; flips > 0; --flips)
+                copy.std.rc.ch.raw[(rng() >> 16) % sizeof(copy.std.rc.ch.raw)] ^= 1 << ((rng() >> 16) % 8);
+            copy.std.crcLow = rng() >> 16;
+            if (OtaValidatePacketCrc(&copy))
+                continue;
+            ++checks;
+            if (combiner.add(&copy, group))
+            {
+                ++accepts;
+                break;
+            }
+        }
+    }
+    // At most 2 candidates per copy each passing a 14-bit CRC by chance
+    const uint32_t limit = checks * 2 / 16384;
+    printf("False accepts %u in %u copies (limit %u, a plain CRC check %u)\n",
+        accepts, checks, limit, checks / 16384);
+    TEST_ASSERT_LESS_OR_EQUAL(limit, accepts);
+}
+
+void test_dvda_two_copies(void)
+{
+    OtaUpdateSerializers(smHybridOr16ch, OTA4_PACKET_SIZE);
+    OtaNonce = 0;
+    randomizeChannels();
+    DvdaCombiner combiner;
+
+    // First copy lost only its CRC, second a channel bit, flipping the one bit they disagree on recovers it
+    OTA_Packet_s sent, first, second;
+    generatePacket(&sent);
+    first = sent;
+    first.std.crcLow ^= 0x01;
+    TEST_ASSERT_FALSE(combiner.add(&first, 0));
+
+    OtaNonce = 1;
+    generatePacket(&sent);
+    second = sent;
+    second.std.rc.ch.raw[3] ^= 0x01;
+    TEST_ASSERT_TRUE(combiner.add(&second, 0));
+    TEST_ASSERT_EQUAL_MEMORY(&sent, &second, OTA4_PACKET_SIZE);
+
+    // A channel bit broken in each, too many combinations to risk trying
+    OtaNonce = 2;
+    generatePacket(&sent);
+    first = sent;
+    first.std.rc.ch.raw[0] ^= 0x10;
+    TEST_ASSERT_FALSE(combiner.add(&first, 1));
+
+    OtaNonce = 3;
+    generatePacket(&sent);
+    second = sent;
+    second.std.rc.ch.raw[3] ^= 0x01;
+    TEST_ASSERT_FALSE(combiner.add(&second, 1));
+}
+
+void test_dvda_majority(void)
+{
+    OtaUpdateSerializers(smHybridOr16ch, OTA4_PACKET_SIZE);
+    randomizeChannels();
+    DvdaCombiner combiner;
+    OTA_Packet_s sent, copy;
+
+    // Too many bits differ to try them all, but the vote of 3 copies is right
+    for (OtaNonce = 4; OtaNonce < 7; ++OtaNonce)
+    {
+        generatePacket(&sent);
+        copy = sent;
+        copy.std.rc.ch.raw[OtaNonce - 4] ^= 0x0f;
+        copy.std.rc.ch.raw[4] ^= 0x10 << (OtaNonce - 4);
+        bool recovered = combiner.add(&copy, 1);
+        TEST_ASSERT_EQUAL(OtaNonce == 6, recovered);
+    }
+    TEST_ASSERT_EQUAL_MEMORY(&sent, &copy, OTA4_PACKET_SIZE);
+}
+
+void test_dvda_new_group(void)
+{
+    OtaUpdateSerializers(smHybridOr16ch, OTA4_PACKET_SIZE);
+    OtaNonce = 0;
+    randomizeChannels();
+    DvdaCombiner combiner;
+
+    OTA_Packet_s sent, copy;
+    generatePacket(&sent);
+    copy = sent;
+    copy.std.rc.ch.raw[0] ^= 0x10;
+    TEST_ASSERT_FALSE(combiner.add(&copy, 0));
+
+    // The copy held from the previous group is not used
+    OtaNonce = 2;
+    generatePacket(&sent);
+    copy = sent;
+    copy.std.rc.ch.raw[3] ^= 0x01;
+    TEST_ASSERT_FALSE(combiner.add(&copy, 1));
+}
+
+void test_dvda_fullres_ignored(void)
+{
+    OtaUpdateSerializers(smHybridOr16ch, OTA8_PACKET_SIZE);
+    DvdaCombiner combiner;
+    OTA_Packet_s copy;
+    memset(&copy, 0, sizeof(copy));
+    TEST_ASSERT_FALSE(combiner.add(&copy, 0));
+    TEST_ASSERT_FALSE(combiner.add(&copy, 0));
+}
+
+// Unity setup/teardown
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    OtaUpdateCrcInitFromUid();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_dvda_ber_d500);
+    RUN_TEST(test_dvda_ber_d250);
+    RUN_TEST(test_dvda_false_accepts);
+    RUN_TEST(test_dvda_two_copies);
+    RUN_TEST(test_dvda_majority);
+    RUN_TEST(test_dvda_new_group);
+    RUN_TEST(test_dvda_fullres_ignored);
+    UNITY_END();
+
+    return 0;
+}
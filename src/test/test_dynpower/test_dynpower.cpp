@@ -0,0 +1,275 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <unity.h>
+#include "targets.h"
+#include "DynPowerModel.h"
+#include "LQCALC.h"
+
+void setUp() {}
+void tearDown() {}
+
+// A 250Hz rate with 1:64 telemetry, link stats every 256ms
+#define SENSITIVITY     -108
+#define NOISE_FLOOR     -112
+#define PACKET_MS       4
+#define TLM_EVERY       64
+#define RX_POWER_DBM    20
+#define MIN_LEVEL       0   // 10mW
+#define MAX_LEVEL       6   // 1000mW
+#define FADE_STDDEV     3.0 // dB, packet to packet
+#define DIP_LQ          70  // LQ below this counts as a dip
+
+// Deterministic whatever the standard library
+class Rng
+{
+public:
+    explicit Rng(uint32_t seed) : state(seed) {}
+    double uniform()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return (state + 0.5) / 4294967296.0;
+    }
+    double gauss()
+    {
+        return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+    }
+private:
+    uint32_t state;
+};
+
+typedef struct {
+    const char *name;
+    uint32_t durationMs;
+    double (*pathLoss)(uint32_t ms); // dB
+} trace_t;
+
+// Steady cruising at a distance
+static double traceCruise(uint32_t ms)
+{
+    return 112 + 3 * sin(ms / 5000.0);
+}
+
+// Cruising, then dives behind a structure which add 22dB over a second, for 5s
+static double traceDive(uint32_t ms)
+{
+    double loss = 105;
+    for (uint32_t start = 15000; start < 60000; start += 15000)
+    {
+        if (ms >= start && ms < start + 5000)
+        {
+            const double in = (ms - start) / 1000.0;
+            const double out = (start + 5000 - ms) / 1000.0;
+            loss += 22 * fmin(1, fmin(in, out));
+        }
+    }
+    return loss;
+}
+
+// Flying out to long range and back
+static double traceOutAndBack(uint32_t ms)
+{
+    const double t = ms / 60000.0;
+    return 85 + 40 * (t < 0.5 ? 2 * t : 2 * (1 - t));
+}
+
+static const trace_t traces[] = {
+    { "cruise",        60000,  traceCruise },
+    { "dive",          60000,  traceDive },
+    { "out and back",  120000, traceOutAndBack },
+};
+
+/**
+ * What DynamicPower_Update did before the model: the mean RSSI of 5 reports
+ * against sensitivity +15/+21dB steps one level up or down
+ **/
+class StepController
+{
+public:
+    StepController() : rssiSum(0), rssiCount(0) {}
+    uint8_t update(uint8_t level, int8_t rssi, double lqAvg)
+    {
+        rssiSum += rssi;
+        if (++rssiCount < 5)
+            return level;
+        const int32_t mean = rssiSum / rssiCount;
+        rssiSum = rssiCount = 0;
+        if (mean < SENSITIVITY + 15 && level < MAX_LEVEL)
+            return level + 1;
+        if (mean > SENSITIVITY + 21 && lqAvg >= 95 && level > MIN_LEVEL)
+            return level - 1;
+        return level;
+    }
+private:
+    int32_t rssiSum;
+    int32_t rssiCount;
+};
+
+typedef struct {
+    double avgMw;
+    uint32_t dips;      // reports with LQ below DIP_LQ
+    uint8_t minLq;
+} sim_result_t;
+
+static sim_result_t simulate(const trace_t &trace, bool useModel)
+{
+    Rng rng(4321);
+    LQCALC<100> lq;
+    DynPowerModel model;
+    model.setRate(SENSITIVITY, 0, 0, false);
+    StepController stepper;
+
+    uint8_t level = MIN_LEVEL;
+    double lqAvg = 100;
+    int32_t rssiSum = 0;
+    uint32_t rssiCount = 0;
+    double mwSum = 0;
+    sim_result_t res = { 0, 0, 100 };
+    const uint32_t packets = trace.durationMs / PACKET_MS;
+
+    for (uint32_t n = 0; n < packets; ++n)
+    {
+        const uint32_t now = n * PACKET_MS;
+        const double loss = trace.pathLoss(now);
+        mwSum += pow(10, DynPowerLevelDbm[level] / 10.0);
+
+        lq.inc();
+        if (n % TLM_EVERY != TLM_EVERY - 1)
+        {
+            const double signal = DynPowerLevelDbm[level] - loss + rng.gauss() * FADE_STDDEV;
+            if (signal >= SENSITIVITY)
+            {
+                lq.add();
+                rssiSum += lround(fmax(signal, NOISE_FLOOR));
+                ++rssiCount;
+            }
+            continue;
+        }
+
+        // Telemetry slot, the link stats only get back if the downlink makes it
+        const double downlink = RX_POWER_DBM - loss + rng.gauss() * FADE_STDDEV;
+        const uint8_t lqNow = lq.getLQ();
+        if (lqNow < res.minLq)
+            res.minLq = lqNow;
+        if (lqNow < DIP_LQ)
+            ++res.dips;
+        if (downlink < SENSITIVITY)
+        {
+            // Missed link stats while armed go to the max either way
+            level = MAX_LEVEL;
+            continue;
+        }
+        const int8_t rssi = rssiCount ? rssiSum / (int32_t)rssiCount : SENSITIVITY;
+        rssiSum = rssiCount = 0;
+
+        // The LQ boost both have
+        const double lqDiff = lqAvg - lqNow;
+        lqAvg = (7 * lqAvg + lqNow) / 8;
+        if (lqDiff >= 20 || lqNow <= 50)
+        {
+            level = MAX_LEVEL;
+            continue;
+        }
+
+        const uint8_t start = level;
+        if (useModel)
+        {
+            model.update(level, rssi, rssi - NOISE_FLOOR);
+            level = model.selectLevel(now, level, MIN_LEVEL, MAX_LEVEL, true, lqAvg >= 95);
+        }
+        else
+        {
+            level = stepper.update(level, rssi, lqAvg);
+        }
+        if (level == start && lqNow <= 85 && level < MAX_LEVEL)
+            ++level;
+    }
+    res.avgMw = mwSum / packets;
+    return res;
+}
+
+void test_model_against_steps(void)
+{
+    const unsigned count = sizeof(traces) / sizeof(traces[0]);
+    sim_result_t step[count], model[count];
+    for (unsigned t = 0; t < count; ++t)
+    {
+        step[t] = simulate(traces[t], false);
+        model[t] = simulate(traces[t], true);
+        printf("%-14s step: %6.1fmW avg, %3u LQ dips, min LQ %3u  model: %6.1fmW avg, %3u LQ dips, min LQ %3u\n",
+               traces[t].name, step[t].avgMw, step[t].dips, step[t].minLq,
+               model[t].avgMw, model[t].dips, model[t].minLq);
+    }
+    for (unsigned t = 0; t < count; ++t)
+        TEST_ASSERT_TRUE(model[t].dips <= step[t].dips);
+    // The dive is what stepping one level every 5 reports can't keep up with
+    TEST_ASSERT_TRUE(model[1].dips < step[1].dips);
+    TEST_ASSERT_TRUE(model[1].minLq > step[1].minLq);
+    // And cruising doesn't cost more power for it
+    TEST_ASSERT_TRUE(model[0].avgMw <= step[0].avgMw * 1.1);
+}
+
+void test_jumps_to_needed_level(void)
+{
+    DynPowerModel m;
+    m.setRate(SENSITIVITY, 0, 0, false);
+    // 10mW heard at -80dBm, 90dB of loss, the lowest level is plenty
+    m.update(0, -80, 10);
+    TEST_ASSERT_EQUAL(90, m.getPathLoss());
+    TEST_ASSERT_EQUAL(0, m.selectLevel(0, 0, 0, 6, true, true));
+    // 25dB more loss: -108 + 15 + 115 = 22dBm needed, straight to 250mW
+    m.update(0, -105, 10);
+    TEST_ASSERT_EQUAL(115, m.getPathLoss());
+    TEST_ASSERT_EQUAL(4, m.selectLevel(256, 0, 0, 6, true, true));
+    // Never above the configured max
+    m.update(4, -100, 10);
+    TEST_ASSERT_EQUAL(5, m.selectLevel(512, 4, 0, 5, true, true));
+}
+
+void test_steps_down_slowly(void)
+{
+    DynPowerModel m;
+    m.setRate(SENSITIVITY, 0, 0, false);
+    uint8_t level = 6;
+    uint32_t now = 0;
+    m.update(level, -70, 10);
+    level = m.selectLevel(now, level, 0, 6, true, true);
+    TEST_ASSERT_EQUAL(6, level);
+    // Armed, one level per hold period, none while LQ isn't good
+    now += DYNPOWER_HOLD_ARMED_MS;
+    TEST_ASSERT_EQUAL(6, m.selectLevel(now, level, 0, 6, true, false));
+    level = m.selectLevel(now, level, 0, 6, true, true);
+    TEST_ASSERT_EQUAL(5, level);
+    TEST_ASSERT_EQUAL(5, m.selectLevel(now + DYNPOWER_HOLD_ARMED_MS - 1, level, 0, 6, true, true));
+    // Disarmed steps down sooner
+    TEST_ASSERT_EQUAL(4, m.selectLevel(now + DYNPOWER_HOLD_DISARMED_MS, level, 0, 6, false, true));
+}
+
+void test_snr_threshold(void)
+{
+    DynPowerModel m;
+    // A LoRa rate which wants power up at 3dB SNR and allows it down from 9dB
+    m.setRate(SENSITIVITY, 3, 9, true);
+    // The RSSI says plenty of margin, but the SNR is 2dB short, 17dBm + 3
+    m.update(2, -80, 1);
+    TEST_ASSERT_EQUAL(3, m.selectLevel(0, 2, 0, 6, true, true));
+    // Margin for days but the SNR isn't high enough to come down
+    m.update(3, -60, 8);
+    TEST_ASSERT_EQUAL(3, m.selectLevel(100000, 3, 0, 6, true, true));
+    m.update(3, -60, 9);
+    TEST_ASSERT_EQUAL(2, m.selectLevel(200000, 3, 0, 6, true, true));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_jumps_to_needed_level);
+    RUN_TEST(test_steps_down_slowly);
+    RUN_TEST(test_snr_threshold);
+    RUN_TEST(test_model_against_steps);
+    UNITY_END();
+
+    return 0;
+}
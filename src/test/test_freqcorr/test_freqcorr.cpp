@@ -0,0 +1,178 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <FreqCorrector.h>
+#include <unity.h>
+
+// The FREQ_STEP of the SX127x and SX1280, only one radio's header can be included
+#define FREQ_STEP_900 61.03515625
+#define FREQ_STEP_2G4 (52000000.0 / 262144.0)
+
+static const freqcorr_tuning_t Tuning900 = FREQ_CORR_TUNING_900(FREQ_STEP_900);
+static const freqcorr_tuning_t Tuning2G4 = FREQ_CORR_TUNING_2G4(FREQ_STEP_2G4);
+
+// Simulated link
+#define HOP_INTERVAL 4
+#define MAX_PACKETS 20000
+#define PACKET_LOSS_PCT 10
+
+typedef struct {
+    const char *name;
+    double freqStep;
+    double carrierHz;
+    int32_t feiNoiseHz;
+    int32_t toleranceHz;
+} band_t;
+
+static const band_t Band900 = { "900", FREQ_STEP_900, 915e6, 400, 600 };
+static const band_t Band2G4 = { "2G4", FREQ_STEP_2G4, 2440e6, 1000, 2500 };
+
+static uint32_t rngState;
+static int32_t rngRange(int32_t range)
+{
+    // Deterministic LCG so results are repeatable
+    rngState = rngState * 1103515245 + 12345;
+    return (int32_t)((rngState >> 8) % (2 * range + 1)) - range;
+}
+
+/**
+ * Run a simulated connection with a crystal offset of `ppm` and return the
+ * number of packets before the residual error stays inside the tolerance,
+ * or MAX_PACKETS if it never converges.
+ * legacy = true uses the previous fixed +/-1 step per packet
+ **/
+static uint32_t simulate(const band_t &band, const freqcorr_tuning_t &tuning, double ppm, bool legacy, int32_t *finalCorrection = nullptr)
+{
+    const int32_t offsetHz = (int32_t)(band.carrierHz * ppm / 1e6);
+    FreqCorrector estimator(tuning);
+    int32_t correction = 0;      // value in use by the FHSS code
+    int32_t appliedCorrection = 0; // value the synthesizer was last tuned with
+    uint32_t convergedAt = MAX_PACKETS;
+    rngState = 0x1234 + (uint32_t)ppm;
+
+    for (uint32_t packet = 0; packet < MAX_PACKETS; ++packet)
+    {
+        int32_t residual = offsetHz - (int32_t)(appliedCorrection * band.freqStep);
+        if (abs(residual) <= band.toleranceHz)
+        {
+            if (convergedAt == MAX_PACKETS)
+                convergedAt = packet;
+        }
+        else
+            convergedAt = MAX_PACKETS;
+
+        bool hop = (packet + 1) % HOP_INTERVAL == 0;
+        if (hop)
+        {
+            if (!legacy)
+                estimator.apply(correction);
+            appliedCorrection = correction;
+            continue;
+        }
+
+        // Lost packets give no FEI
+        if ((uint32_t)(rngRange(50) + 50) < PACKET_LOSS_PCT)
+            continue;
+
+        int32_t feiHz = residual + rngRange(band.feiNoiseHz);
+        if (legacy)
+        {
+            if (feiHz < 0 && correction > -tuning.limit)
+                correction -= 1;
+            else if (feiHz >= 0 && correction < tuning.limit)
+                correction += 1;
+        }
+        else
+            estimator.addSample(feiHz);
+    }
+
+    if (finalCorrection)
+        *finalCorrection = appliedCorrection;
+    return convergedAt;
+}
+
+static void checkBand(const band_t &band, const freqcorr_tuning_t &tuning)
+{
+    static const double offsetsPpm[] = { 2.0, -5.0, 10.0, -20.0, 30.0 };
+    for (unsigned i = 0; i < sizeof(offsetsPpm) / sizeof(offsetsPpm[0]); ++i)
+    {
+        double ppm = offsetsPpm[i];
+        uint32_t pi = simulate(band, tuning, ppm, false);
+        uint32_t legacy = simulate(band, tuning, ppm, true);
+        printf("%s %+5.1fppm: converged in %5u packets (+/-1 stepping %5u)\n", band.name, ppm, pi, legacy);
+
+        // Should pull in within 10 hops no matter the offset
+        TEST_ASSERT_LESS_OR_EQUAL(10 * HOP_INTERVAL, pi);
+        TEST_ASSERT_LESS_OR_EQUAL(legacy, pi);
+    }
+}
+
+void test_freqcorr_converge_900(void)
+{
+    checkBand(Band900, Tuning900);
+}
+
+void test_freqcorr_converge_2g4(void)
+{
+    checkBand(Band2G4, Tuning2G4);
+}
+
+void test_freqcorr_clamped(void)
+{
+    // An offset larger than the correction range rails at the limit
+    int32_t correction;
+    simulate(Band900, Tuning900, 200.0, false, &correction);
+    TEST_ASSERT_EQUAL(Tuning900.limit, correction);
+    simulate(Band900, Tuning900, -200.0, false, &correction);
+    TEST_ASSERT_EQUAL(-Tuning900.limit, correction);
+}
+
+void test_freqcorr_step_limited(void)
+{
+    FreqCorrector estimator(Tuning900);
+    int32_t correction = 0;
+
+    // No samples, nothing to apply
+    TEST_ASSERT_EQUAL(false, estimator.apply(correction));
+    TEST_ASSERT_EQUAL(0, correction);
+
+    // Huge error only moves by maxStep in one hop
+    estimator.addSample(90000);
+    TEST_ASSERT_EQUAL(true, estimator.apply(correction));
+    TEST_ASSERT_EQUAL(Tuning900.maxStep, correction);
+
+    estimator.reset();
+    correction = 0;
+    estimator.addSample(-90000);
+    estimator.apply(correction);
+    TEST_ASSERT_EQUAL(-Tuning900.maxStep, correction);
+}
+
+void test_freqcorr_averages_samples(void)
+{
+    FreqCorrector estimator(Tuning900);
+    int32_t correction = 0;
+
+    // Opposing samples in the same hop cancel
+    estimator.addSample(3000);
+    estimator.addSample(-3000);
+    TEST_ASSERT_EQUAL(false, estimator.apply(correction));
+    TEST_ASSERT_EQUAL(0, correction);
+}
+
+// Unity setup/teardown
+void setUp() {}
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_freqcorr_converge_900);
+    RUN_TEST(test_freqcorr_converge_2g4);
+    RUN_TEST(test_freqcorr_clamped);
+    RUN_TEST(test_freqcorr_step_limited);
+    RUN_TEST(test_freqcorr_averages_samples);
+    UNITY_END();
+
+    return 0;
+}
@@ -0,0 +1,218 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <unity.h>
+#include "targets.h"
+#include "HandsetSync.h"
+
+#define HANDSET_DRIFT   30e-6 // its clock running faster than the TX's
+#define SIM_SECONDS     60
+#define OLD_INTERVAL_MS 200   // how often the sync used to go
+#define OLD_TARGET_US   100   // and the age it used to aim for
+
+// Deterministic whatever the standard library
+class Rng
+{
+public:
+    explicit Rng(uint32_t seed) : state(seed) {}
+    double uniform()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return (state + 0.5) / 4294967296.0;
+    }
+    double gauss()
+    {
+        return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+    }
+private:
+    uint32_t state;
+};
+
+typedef struct {
+    const char *name;
+    uint32_t periodUs;
+    double jitterUs;    // stddev of when the handset's frames go out
+    double spikeChance; // of a frame being held up
+    double spikeMaxUs;  // by up to this
+} handset_t;
+
+static const handset_t handsets[] = {
+    { "steady 250Hz",    4000, 8,  0.0,  0 },
+    { "steady 500Hz",    2000, 8,  0.0,  0 },
+    { "steady 1000Hz",   1000, 8,  0.0,  0 },
+    { "jittery 250Hz",   4000, 30, 0.02, 150 },
+    { "jittery 1000Hz",  1000, 30, 0.02, 150 },
+};
+
+typedef struct {
+    double meanAgeUs; // of the RC data in each RF packet
+    double stalePct;  // RF packets sending the same RC data as the one before
+    uint32_t syncs;
+    uint32_t target;
+} sync_result_t;
+
+/**
+ * The TX sending an RF packet each period and the handset sending RC frames
+ * on its own clock, moving them by each correction as it gets it.
+ * JustSentRFpacket()'s measurement of the age, and the sync either as it was,
+ * the last age against a fixed target every 200ms, or from HandsetSync.
+ **/
+static sync_result_t simulate(const handset_t &h, bool adaptive)
+{
+    Rng rng(7);
+    HandsetSync sync;
+    sync.setPeriod(h.periodUs);
+    const double handsetPeriod = h.periodUs * (1 - HANDSET_DRIFT);
+    const uint32_t slots = SIM_SECONDS * 1000000 / h.periodUs;
+
+    double phase = h.periodUs * 0.37; // where the handset starts, against the TX
+    uint32_t frame = 0;
+    double nextArrive = phase + h.periodUs;
+    double lastArrive = phase;
+    double lastSentArrive = -1;
+    uint32_t lastSyncMs = 0;
+    int32_t lastOffset = 0;
+    double sumAge = 0;
+    uint32_t stale = 0, measured = 0, syncs = 0;
+
+    for (uint32_t n = 1; n <= slots; ++n)
+    {
+        const double slot = (double)n * h.periodUs;
+        // Every frame that came in before the RF packet
+        while (nextArrive <= slot)
+        {
+            lastArrive = nextArrive;
+            ++frame;
+            double jitter = rng.gauss() * h.jitterUs;
+            if (rng.uniform() < h.spikeChance)
+                jitter += rng.uniform() * h.spikeMaxUs;
+            nextArrive = phase + (frame + 1) * handsetPeriod + jitter;
+        }
+
+        // JustSentRFpacket()
+        int32_t offset = slot - lastArrive;
+        if (offset > (int32_t)h.periodUs)
+            offset = -(offset % h.periodUs);
+        lastOffset = offset;
+        sync.rfPacketSent(offset);
+
+        if (n > slots / 4)
+        {
+            ++measured;
+            sumAge += slot - lastArrive;
+            if (lastArrive == lastSentArrive)
+                ++stale;
+        }
+        lastSentArrive = lastArrive;
+
+        // sendSyncPacketToTX(), the handset moving its frames by the correction
+        const uint32_t nowMs = slot / 1000;
+        int32_t correction;
+        if (adaptive)
+        {
+            if (nowMs - lastSyncMs < sync.getInterval() || !sync.nextCorrection(&correction))
+                continue;
+        }
+        else
+        {
+            if (nowMs - lastSyncMs < OLD_INTERVAL_MS)
+                continue;
+            correction = lastOffset - OLD_TARGET_US;
+        }
+        lastSyncMs = nowMs;
+        ++syncs;
+        phase += correction;
+        nextArrive += correction;
+    }
+
+    sync_result_t res;
+    res.meanAgeUs = sumAge / measured;
+    res.stalePct = 100.0 * stale / measured;
+    res.syncs = syncs;
+    res.target = adaptive ? sync.getTarget() : OLD_TARGET_US;
+    return res;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_data_age(void)
+{
+    uint32_t steadyTarget = 0, jitteryTarget = 0;
+    const unsigned count = sizeof(handsets) / sizeof(handsets[0]);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        const sync_result_t fixed = simulate(handsets[i], false);
+        const sync_result_t adaptive = simulate(handsets[i], true);
+        printf("%-15s fixed: %6.1fus %5.2f%% stale %4u syncs  adaptive: %6.1fus %5.2f%% stale %4u syncs target %uus\n",
+               handsets[i].name, fixed.meanAgeUs, fixed.stalePct, fixed.syncs,
+               adaptive.meanAgeUs, adaptive.stalePct, adaptive.syncs, adaptive.target);
+
+        // Fresher data without missing more frames
+        TEST_ASSERT_TRUE(adaptive.meanAgeUs < fixed.meanAgeUs);
+        TEST_ASSERT_TRUE(adaptive.stalePct <= fixed.stalePct + 0.1);
+        if (handsets[i].spikeChance == 0)
+            steadyTarget = adaptive.target;
+        else
+            jitteryTarget = adaptive.target;
+    }
+    TEST_ASSERT_TRUE(jitteryTarget > steadyTarget);
+}
+
+void test_correction_is_average(void)
+{
+    HandsetSync sync;
+    sync.setPeriod(4000);
+    int32_t correction;
+    TEST_ASSERT_FALSE(sync.nextCorrection(&correction));
+    sync.rfPacketSent(300);
+    sync.rfPacketSent(100);
+    sync.rfPacketSent(200);
+    TEST_ASSERT_TRUE(sync.nextCorrection(&correction));
+    TEST_ASSERT_EQUAL(200 - HANDSET_SYNC_TARGET_US, correction);
+    // Off target, so again soon
+    TEST_ASSERT_EQUAL(HANDSET_SYNC_INTERVAL_MIN_MS, sync.getInterval());
+    // Each sync on target waits longer, up to the most
+    for (unsigned i = 0; i < 5; ++i)
+    {
+        sync.rfPacketSent(HANDSET_SYNC_TARGET_US);
+        TEST_ASSERT_TRUE(sync.nextCorrection(&correction));
+        TEST_ASSERT_EQUAL(0, correction);
+    }
+    TEST_ASSERT_EQUAL(HANDSET_SYNC_INTERVAL_MAX_MS, sync.getInterval());
+}
+
+void test_histogram(void)
+{
+    HandsetSync sync;
+    sync.setPeriod(4000);
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+        // Now and then 60us late
+        sync.rfPacketSent(i % 10 == 0 ? 140 : 200);
+    }
+    TEST_ASSERT_TRUE(sync.getHistogramPercent(0) >= 85);
+    TEST_ASSERT_TRUE(sync.getHistogramPercent(2) >= 5);
+    TEST_ASSERT_EQUAL(0, sync.getHistogramPercent(HANDSET_SYNC_BINS - 1));
+    // Missing one now and then costs a period, more than waiting out 75us
+    int32_t correction;
+    sync.nextCorrection(&correction);
+    TEST_ASSERT_EQUAL(3 * HANDSET_SYNC_BIN_US, sync.getTarget());
+    // Changing rate starts over
+    sync.setPeriod(2000);
+    TEST_ASSERT_EQUAL(0, sync.getHistogramPercent(0));
+    TEST_ASSERT_EQUAL(HANDSET_SYNC_TARGET_US, sync.getTarget());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_correction_is_average);
+    RUN_TEST(test_histogram);
+    RUN_TEST(test_data_age);
+    UNITY_END();
+
+    return 0;
+}
@@ -0,0 +1,245 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <unity.h>
+#include "targets.h"
+#include "LBTAssessor.h"
+
+void setUp() {}
+void tearDown() {}
+
+// 500Hz LoRa: a packet every 2000us
+#define SLOT_US         2000
+#define CHANNELS        80
+#define GROUPS          4     // WiFi channels over the band, 20 FHSS channels each
+#define LIMIT_DBM       -71   // 100mW
+#define READING_NOISE   2.5   // dB, each RSSI reading
+#define READ_US         10    // one RSSI read over SPI
+#define SLOTS           50000
+
+// Deterministic whatever the standard library
+class Rng
+{
+public:
+    explicit Rng(uint32_t seed) : state(seed) {}
+    double uniform()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return (state + 0.5) / 4294967296.0;
+    }
+    double exponential(double mean)
+    {
+        return -mean * log(uniform());
+    }
+    double gauss()
+    {
+        return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+    }
+private:
+    uint32_t state;
+};
+
+typedef struct {
+    const char *name;
+    double duty;        // fraction of the time each WiFi channel is busy
+    double burstUs;     // mean length of a busy burst
+    double busyDbm;     // level of the bursts
+    double quietDbm;    // what the channel reads between them
+} occupancy_t;
+
+/**
+ * Bursts on each WiFi channel, exponentially distributed on and off times.
+ * Time only moves forward, so each channel's timeline is generated as needed.
+ **/
+class Occupancy
+{
+public:
+    Occupancy(const occupancy_t &model, uint32_t seed) : model(model), rng(seed)
+    {
+        for (int g = 0; g < GROUPS; ++g)
+        {
+            busy[g] = false;
+            next[g] = rng.exponential(offMean());
+        }
+    }
+
+    bool isBusy(uint8_t group, uint32_t t)
+    {
+        while (t >= next[group])
+        {
+            busy[group] = !busy[group];
+            next[group] += rng.exponential(busy[group] ? model.burstUs : offMean());
+        }
+        return busy[group];
+    }
+
+    double level(uint8_t group, uint32_t t)
+    {
+        return isBusy(group, t) ? model.busyDbm : model.quietDbm;
+    }
+
+private:
+    double offMean() const { return model.burstUs * (1 - model.duty) / model.duty; }
+
+    const occupancy_t &model;
+    Rng rng;
+    bool busy[GROUPS];
+    double next[GROUPS];
+};
+
+class SimRadio
+{
+public:
+    SimRadio(Occupancy &occ, Rng &rng) : t(0), group(0), occ(occ), rng(rng) {}
+    int8_t rssi()
+    {
+        const double l = occ.level(group, t) + rng.gauss() * READING_NOISE;
+        t += READ_US;
+        return lround(l);
+    }
+    uint32_t now() { return t; }
+    void waitUntil(uint32_t us)
+    {
+        if ((int32_t)(us - t) > 0)
+            t = us;
+    }
+
+    uint32_t t;
+    uint8_t group;
+private:
+    Occupancy &occ;
+    Rng &rng;
+};
+
+// 500Hz LoRa: the TOA and slack leave this long to reassess a busy channel
+#define RETRY_BUDGET_US 300
+
+typedef struct {
+    double sent;        // percent of slots a packet went out in
+    double collided;    // and went out on top of a burst
+} lbt_result_t;
+
+static lbt_result_t simulate(const occupancy_t &model, bool reassess)
+{
+    Occupancy occ(model, 777);
+    Rng noise(31);
+    Rng hop(5);
+    SimRadio radio(occ, noise);
+    uint32_t sent = 0, collided = 0;
+
+    for (uint32_t slot = 0; slot < SLOTS; ++slot)
+    {
+        const uint32_t start = slot * SLOT_US;
+        const uint8_t channel = hop.uniform() * CHANNELS;
+        const uint8_t ecca = 1 + hop.uniform() * LBT_ECCA_Q;
+        radio.t = start;
+        radio.group = channel * GROUPS / CHANNELS;
+
+        bool clear;
+        if (reassess)
+            clear = LBTAssessChannel(radio, LIMIT_DBM, start, start + RETRY_BUDGET_US, ecca);
+        else
+            clear = radio.rssi() < LIMIT_DBM; // one reading, skipped if busy
+        if (clear)
+        {
+            ++sent;
+            if (occ.isBusy(radio.group, radio.now()))
+                ++collided;
+        }
+    }
+    lbt_result_t res = { 100.0 * sent / SLOTS, 100.0 * collided / SLOTS };
+    return res;
+}
+
+static const occupancy_t models[] = {
+    { "light wifi",        0.10, 400, -55, -100 },
+    { "busy wifi",         0.30, 400, -55, -100 },
+    { "congested wifi",    0.50, 300, -55, -100 },
+    { "short bursts",      0.30, 100, -60, -100 },
+    { "near limit",        0.20, 400, -60, -75 },
+};
+
+// Reassessing a busy channel within the slot gets more packets out than
+// skipping them, without going out over many more bursts per packet sent
+void test_lbt_delivery(void)
+{
+    const unsigned count = sizeof(models) / sizeof(models[0]);
+    for (unsigned m = 0; m < count; ++m)
+    {
+        const lbt_result_t single = simulate(models[m], false);
+        const lbt_result_t reassess = simulate(models[m], true);
+        printf("%-16s skip if busy: sent %5.1f%% collided %5.2f%%  reassess: sent %5.1f%% collided %5.2f%%\n",
+               models[m].name, single.sent, single.collided, reassess.sent, reassess.collided);
+        TEST_ASSERT_TRUE(reassess.sent > single.sent);
+        // Each packet is about as likely to go out over a burst, there are just more of them
+        TEST_ASSERT_TRUE(reassess.collided / reassess.sent <= 1.1 * single.collided / single.sent);
+    }
+}
+
+// Replays fixed readings, one per observation slot
+class ScriptedRadio
+{
+public:
+    ScriptedRadio(const int8_t *readings) : t(0), readings(readings), reads(0) {}
+    int8_t rssi() { return readings[reads++]; }
+    uint32_t now() { return t; }
+    void waitUntil(uint32_t us)
+    {
+        if ((int32_t)(us - t) > 0)
+            t = us;
+    }
+
+    uint32_t t;
+    const int8_t *readings;
+    unsigned reads;
+};
+
+#define Q -100  // quiet
+#define B -60   // busy
+
+void test_lbt_reassess(void)
+{
+    // Clear at the first reading, nothing more is read
+    const int8_t quiet[] = { Q };
+    ScriptedRadio r1(quiet);
+    TEST_ASSERT_TRUE(LBTAssessChannel(r1, LIMIT_DBM, 150, 450, 3));
+    TEST_ASSERT_EQUAL(150, r1.t);
+    TEST_ASSERT_EQUAL(1, r1.reads);
+
+    // Busy, then clear for the extended CCA
+    const int8_t burst[] = { B, Q, Q, Q };
+    ScriptedRadio r2(burst);
+    TEST_ASSERT_TRUE(LBTAssessChannel(r2, LIMIT_DBM, 0, 300, 3));
+    TEST_ASSERT_EQUAL(4, r2.reads);
+    TEST_ASSERT_EQUAL(3 * LBT_OBSERVATION_US, r2.t);
+
+    // The count pauses while busy, and at the limit is busy
+    const int8_t gaps[] = { B, Q, B, LIMIT_DBM, Q, Q };
+    ScriptedRadio r3(gaps);
+    TEST_ASSERT_TRUE(LBTAssessChannel(r3, LIMIT_DBM, 0, 300, 3));
+    TEST_ASSERT_EQUAL(6, r3.reads);
+
+    // Gives up as soon as the extended CCA can't finish by the deadline
+    const int8_t late[] = { B, Q, B, B, B };
+    ScriptedRadio r4(late);
+    TEST_ASSERT_FALSE(LBTAssessChannel(r4, LIMIT_DBM, 0, 4 * LBT_OBSERVATION_US, 3));
+    TEST_ASSERT_EQUAL(4, r4.reads);
+    TEST_ASSERT_EQUAL(3 * LBT_OBSERVATION_US, r4.t);
+
+    // No time to reassess at all is the old skip if busy
+    ScriptedRadio r5(late);
+    TEST_ASSERT_FALSE(LBTAssessChannel(r5, LIMIT_DBM, 0, 0, 1));
+    TEST_ASSERT_EQUAL(1, r5.reads);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_lbt_reassess);
+    RUN_TEST(test_lbt_delivery);
+    UNITY_END();
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <cstdint>
+#include <cstring>
+#include <unity.h>
+#include <vector>
+#include "LinkLog.h"
+
+using namespace std;
+
+void setUp() {}
+void tearDown() {}
+
+static link_log_record_t makeRecord(uint32_t n)
+{
+    link_log_record_t rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.timeMs = n * 4;
+    rec.nonce = n;
+    rec.fhssIndex = n % 80;
+    rec.rssi[0] = -(int8_t)(n % 100);
+    rec.rssi[1] = -50;
+    rec.snr = n % 40;
+    rec.flags = LINK_LOG_RECEIVED;
+    rec.freqError = -(int16_t)n;
+    rec.pfdOffset = n;
+    return rec;
+}
+
+// Read the whole blob in pieces of `piece` bytes
+static vector<uint8_t> readAll(LinkLog &log, size_t piece)
+{
+    vector<uint8_t> blob;
+    vector<uint8_t> buf(piece);
+    size_t n;
+    while ((n = log.read(blob.size(), buf.data(), piece, 4, 7)) != 0)
+        blob.insert(blob.end(), buf.begin(), buf.begin() + n);
+    return blob;
+}
+
+static void checkRecords(const vector<uint8_t> &blob, uint32_t first, uint16_t count)
+{
+    const link_log_header_t *header = (const link_log_header_t *)blob.data();
+    TEST_ASSERT_EQUAL(count, header->count);
+    TEST_ASSERT_EQUAL(sizeof(link_log_header_t) + count * sizeof(link_log_record_t), blob.size());
+    for (uint16_t i = 0; i < count; ++i)
+    {
+        link_log_record_t expected = makeRecord(first + i);
+        TEST_ASSERT_EQUAL_MEMORY(&expected, &blob[sizeof(link_log_header_t) + i * sizeof(link_log_record_t)], sizeof(expected));
+    }
+}
+
+void test_record_size(void)
+{
+    TEST_ASSERT_EQUAL(12, sizeof(link_log_record_t));
+    TEST_ASSERT_EQUAL(16, sizeof(link_log_header_t));
+}
+
+void test_export_before_wrap(void)
+{
+    LinkLog log(LINK_LOG_ROLE_RX);
+    for (uint32_t n = 0; n < 10; ++n)
+        log.add(makeRecord(n));
+
+    vector<uint8_t> blob = readAll(log, 256);
+    const link_log_header_t *header = (const link_log_header_t *)blob.data();
+    TEST_ASSERT_EQUAL_HEX32(LINK_LOG_MAGIC, header->magic);
+    TEST_ASSERT_EQUAL(LINK_LOG_VERSION, header->version);
+    TEST_ASSERT_EQUAL(sizeof(link_log_record_t), header->recordSize);
+    TEST_ASSERT_EQUAL(LINK_LOG_ROLE_RX, header->role);
+    TEST_ASSERT_EQUAL(4, header->snrScale);
+    TEST_ASSERT_EQUAL(7, header->rate);
+    TEST_ASSERT_EQUAL(0, header->frozen);
+    TEST_ASSERT_EQUAL(10, header->total);
+    checkRecords(blob, 0, 10);
+}
+
+void test_export_after_wrap_odd_pieces(void)
+{
+    LinkLog log(LINK_LOG_ROLE_TX);
+    const uint32_t written = LINK_LOG_RECORDS * 2 + 5;
+    for (uint32_t n = 0; n < written; ++n)
+        log.add(makeRecord(n));
+
+    // Pieces which split the header and records at every possible place
+    for (size_t piece = 1; piece < 30; ++piece)
+    {
+        vector<uint8_t> blob = readAll(log, piece);
+        TEST_ASSERT_EQUAL(written, ((const link_log_header_t *)blob.data())->total);
+        checkRecords(blob, written - LINK_LOG_RECORDS, LINK_LOG_RECORDS);
+    }
+}
+
+void test_trigger_freezes_and_download_rearms(void)
+{
+    LinkLog log(LINK_LOG_ROLE_RX);
+    for (uint32_t n = 0; n < 20; ++n)
+        log.add(makeRecord(n));
+    log.trigger(5);
+    log.trigger(50); // already counting down, ignored
+    for (uint32_t n = 20; n < 200; ++n)
+        log.add(makeRecord(n));
+
+    TEST_ASSERT_TRUE(log.isFrozen());
+    TEST_ASSERT_EQUAL(25, log.getTotal());
+
+    vector<uint8_t> blob = readAll(log, 100);
+    TEST_ASSERT_EQUAL(1, ((const link_log_header_t *)blob.data())->frozen);
+    checkRecords(blob, 0, 25);
+
+    // Recording carries on once it has been read
+    TEST_ASSERT_FALSE(log.isFrozen());
+    log.add(makeRecord(25));
+    TEST_ASSERT_EQUAL(26, log.getCount());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_record_size);
+    RUN_TEST(test_export_before_wrap);
+    RUN_TEST(test_export_after_wrap_odd_pieces);
+    RUN_TEST(test_trigger_freezes_and_download_rearms);
+    UNITY_END();
+
+    return 0;
+}
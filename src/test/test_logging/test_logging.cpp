@@ -0,0 +1,133 @@
+#include <cstdint>
+#include <cstring>
+#include <unity.h>
+#include <vector>
+#include "targets.h"
+#include "logging.h"
+
+using namespace std;
+
+class VectorStream : public Stream
+{
+public:
+    int available() { return 0; }
+    int read() { return -1; }
+    int peek() { return -1; }
+    void flush() { }
+    size_t write(uint8_t c) { buf.push_back(c); return 1; }
+    size_t write(uint8_t *c, int l) { buf.insert(buf.end(), c, c + l); return l; }
+
+    vector<uint8_t> buf;
+};
+
+void setUp() {}
+void tearDown() {}
+
+static const char *fmtNumbers = "ints %d %u %x float %f";
+static const char *fmtString = "name %s";
+
+// Check the frame at buf[pos] and return where the next one starts
+static size_t checkFrame(const vector<uint8_t> &buf, size_t pos, const char *fmt, uint8_t flags, const vector<uint8_t> &args)
+{
+    TEST_ASSERT_TRUE(pos + 8 + args.size() <= buf.size());
+    TEST_ASSERT_EQUAL_HEX8((flags & LOG_FLAG_NEWLINE) ? LOG_TOKENIZED_SYNC : LOG_TOKENIZED_SYNC_NONL, buf[pos]);
+    TEST_ASSERT_EQUAL(5 + args.size(), buf[pos + 1]);
+    uint32_t token;
+    memcpy(&token, &buf[pos + 2], sizeof(token));
+    TEST_ASSERT_EQUAL_HEX32((uint32_t)(uintptr_t)fmt, token);
+    TEST_ASSERT_EQUAL_HEX8(flags, buf[pos + 6]);
+    if (!args.empty())
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(args.data(), &buf[pos + 7], args.size());
+    uint8_t sum = 0;
+    for (size_t i = pos + 1; i < pos + 7 + args.size(); ++i)
+        sum += buf[i];
+    TEST_ASSERT_EQUAL_HEX8(sum, buf[pos + 7 + args.size()]);
+    return pos + 8 + args.size();
+}
+
+static void put32(vector<uint8_t> &v, uint32_t val)
+{
+    uint8_t b[4];
+    memcpy(b, &val, sizeof(b));
+    v.insert(v.end(), b, b + 4);
+}
+
+void test_numbers(void)
+{
+    VectorStream out;
+    debugLogTokenized(LOG_FLAG_NEWLINE, fmtNumbers, -5, 7u, (uint8_t)0xAB, 1.5);
+    debugLogDrain(out, 8);
+
+    vector<uint8_t> args;
+    put32(args, (uint32_t)-5);
+    put32(args, 7);
+    put32(args, 0xAB);
+    float f = 1.5;
+    uint32_t fbits;
+    memcpy(&fbits, &f, sizeof(f));
+    put32(args, fbits);
+    TEST_ASSERT_EQUAL(out.buf.size(), checkFrame(out.buf, 0, fmtNumbers, LOG_FLAG_NEWLINE, args));
+}
+
+void test_string_copied_and_truncated(void)
+{
+    VectorStream out;
+    char name[40];
+    strcpy(name, "short");
+    debugLogTokenized(LOG_FLAG_NEWLINE | LOG_FLAG_ERROR, fmtString, name);
+    // Overwriting the caller's buffer doesn't change what was logged
+    strcpy(name, "a name much longer than the arguments");
+    debugLogTokenized(0, fmtString, name);
+    debugLogDrain(out, 8);
+
+    vector<uint8_t> args1 = {5, 's', 'h', 'o', 'r', 't'};
+    vector<uint8_t> args2 = {LOG_TOKENIZED_ARGS_LEN - 1};
+    args2.insert(args2.end(), name, name + LOG_TOKENIZED_ARGS_LEN - 1);
+    size_t pos = checkFrame(out.buf, 0, fmtString, LOG_FLAG_NEWLINE | LOG_FLAG_ERROR, args1);
+    TEST_ASSERT_EQUAL(out.buf.size(), checkFrame(out.buf, pos, fmtString, 0, args2));
+}
+
+void test_drain_limit(void)
+{
+    VectorStream out;
+    for (int i = 0; i < 3; ++i)
+        debugLogTokenized(LOG_FLAG_NEWLINE, "");
+    debugLogDrain(out, 2);
+    TEST_ASSERT_EQUAL(2 * 8, out.buf.size());
+    debugLogDrain(out, 2);
+    TEST_ASSERT_EQUAL(3 * 8, out.buf.size());
+    debugLogDrain(out, 2);
+    TEST_ASSERT_EQUAL(3 * 8, out.buf.size());
+}
+
+void test_overflow_reports_dropped(void)
+{
+    VectorStream out;
+    for (uint32_t i = 0; i < 64 + 10; ++i)
+        debugLogTokenized(LOG_FLAG_NEWLINE, fmtNumbers, i);
+    debugLogDrain(out, 255);
+
+    vector<uint8_t> dropped;
+    put32(dropped, 10);
+    size_t pos = checkFrame(out.buf, 0, nullptr, LOG_FLAG_NEWLINE, dropped);
+    // The oldest entries are the ones kept
+    for (uint32_t i = 0; i < 64; ++i)
+    {
+        vector<uint8_t> args;
+        put32(args, i);
+        pos = checkFrame(out.buf, pos, fmtNumbers, LOG_FLAG_NEWLINE, args);
+    }
+    TEST_ASSERT_EQUAL(out.buf.size(), pos);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_numbers);
+    RUN_TEST(test_string_copied_and_truncated);
+    RUN_TEST(test_drain_limit);
+    RUN_TEST(test_overflow_reports_dropped);
+    UNITY_END();
+
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include <cstdint>
+#include <unity.h>
+#include "targets.h"
+#include "LQCALC.h"
+#include "LQWindows.h"
+
+void setUp() {}
+void tearDown() {}
+
+void test_lqcalc_window(void)
+{
+    LQCALC<100> lq;
+    for (int i = 0; i < 100; ++i)
+    {
+        lq.inc();
+        if (i % 4)
+            lq.add();
+    }
+    TEST_ASSERT_EQUAL(75, lq.getLQ());
+}
+
+// At 1000Hz, 100ms is 100 slots
+void test_windows_short_is_exact(void)
+{
+    LQWindows lq;
+    lq.setInterval(1000);
+    for (int i = 0; i < 1000; ++i)
+        lq.add(true);
+    for (int i = 0; i < 30; ++i)
+        lq.add(false);
+    TEST_ASSERT_EQUAL(70, lq.getLQ(LQ_WINDOW_SHORT));
+    // The 30 losses are in the open bucket, not yet in the longer windows
+    TEST_ASSERT_EQUAL(100, lq.getLQ(LQ_WINDOW_MEDIUM));
+    for (int i = 0; i < 70; ++i)
+        lq.add(true);
+    TEST_ASSERT_EQUAL(70, lq.getLQ(LQ_WINDOW_SHORT));
+    TEST_ASSERT_EQUAL(97, lq.getLQ(LQ_WINDOW_MEDIUM));
+    TEST_ASSERT_EQUAL(97, lq.getLQ(LQ_WINDOW_LONG));
+}
+
+// The windows are the same length in time at any rate
+void test_windows_follow_time(void)
+{
+    const uint32_t intervals[] = { 1000, 2000, 4000, 6666, 20000, 40000, 250000 };
+    for (uint32_t interval : intervals)
+    {
+        LQWindows lq;
+        lq.setInterval(interval);
+        // 10s good then 1s with every other slot lost
+        const uint32_t good = 10000000 / interval;
+        const uint32_t bad = 1000000 / interval;
+        for (uint32_t i = 0; i < good; ++i)
+            lq.add(true);
+        for (uint32_t i = 0; i < bad; ++i)
+            lq.add(i % 2);
+        TEST_ASSERT_INT_WITHIN(5, 50, lq.getLQ(LQ_WINDOW_MEDIUM));
+        TEST_ASSERT_INT_WITHIN(3, 95, lq.getLQ(LQ_WINDOW_LONG));
+    }
+}
+
+void test_windows_partial(void)
+{
+    LQWindows lq;
+    lq.setInterval(4000);
+    TEST_ASSERT_EQUAL(0, lq.getLQ(LQ_WINDOW_SHORT));
+    TEST_ASSERT_EQUAL(0, lq.getLQ(LQ_WINDOW_LONG));
+    // Two 100ms buckets, the second with 12 of 25 lost
+    for (int i = 0; i < 50; ++i)
+        lq.add(i < 25 || i % 2);
+    TEST_ASSERT_EQUAL(52, lq.getLQ(LQ_WINDOW_SHORT));
+    TEST_ASSERT_EQUAL(76, lq.getLQ(LQ_WINDOW_LONG));
+}
+
+void test_burst_histogram(void)
+{
+    LQWindows lq;
+    lq.setInterval(2000);
+    const uint16_t runs[] = { 1, 1, 2, 3, 4, 5, 100, 7 };
+    for (uint16_t run : runs)
+    {
+        for (uint16_t i = 0; i < run; ++i)
+            lq.add(false);
+        lq.add(true);
+    }
+    // A run still going isn't counted until it ends
+    lq.add(false);
+
+    TEST_ASSERT_EQUAL(2, lq.getBurstCount(0)); // 1
+    TEST_ASSERT_EQUAL(1, lq.getBurstCount(1)); // 2
+    TEST_ASSERT_EQUAL(2, lq.getBurstCount(2)); // 3-4
+    TEST_ASSERT_EQUAL(2, lq.getBurstCount(3)); // 5-8
+    TEST_ASSERT_EQUAL(0, lq.getBurstCount(4));
+    TEST_ASSERT_EQUAL(1, lq.getBurstCount(7)); // 65+
+    TEST_ASSERT_EQUAL(100, lq.getLongestBurst());
+
+    lq.reset();
+    TEST_ASSERT_EQUAL(100, lq.getLongestBurst());
+    lq.resetBursts();
+    TEST_ASSERT_EQUAL(0, lq.getLongestBurst());
+    TEST_ASSERT_EQUAL(0, lq.getBurstCount(0));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_lqcalc_window);
+    RUN_TEST(test_windows_short_is_exact);
+    RUN_TEST(test_windows_follow_time);
+    RUN_TEST(test_windows_partial);
+    RUN_TEST(test_burst_histogram);
+    UNITY_END();
+
+    return 0;
+}
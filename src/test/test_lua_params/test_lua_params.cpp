@@ -0,0 +1,319 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <unity.h>
+#include "targets.h"
+#include "crsf_protocol.h"
+#include "luaParamCache.h"
+
+// A 64 byte CRSF frame: Sync, Len, Type, Dest, Origin, payload, CRC
+#define FRAME_OVERHEAD  6
+#define MAX_PAYLOAD     (CRSF_MAX_PACKET_LEN - FRAME_OVERHEAD)
+#define READ_FRAME      (FRAME_OVERHEAD + 2) // PARAMETER_READ FieldId + Chunk
+#define BATCH_READ      (FRAME_OVERHEAD + 3) // and the params version
+#define BATCH_FRAMES    3                    // sent for each request on the TX
+
+typedef struct {
+    uint8_t parent;
+    uint8_t type;
+    const char *name;
+    const char *options;  // selection options, or the value of info/folder
+    uint8_t value;
+    const char *units;
+} item_t;
+
+// The TX module's menu, as tx_devLUA registers it
+static item_t menu[] = {
+    { 0,  0,                   NULL,                   NULL, 0, NULL },
+    { 0,  CRSF_TEXT_SELECTION, "Packet Rate",          "25Hz;50Hz;100Hz;100Hz Full;200Hz", 4, "" },
+    { 0,  CRSF_TEXT_SELECTION, "Telem Ratio",          "Std;Off;1:128;1:64;1:32;1:16;1:8;1:4;1:2;Race", 0, " (1:128)" },
+    { 0,  CRSF_FOLDER,         "TX Power",             "TX Power (250mW)", 0, NULL },
+    { 3,  CRSF_TEXT_SELECTION, "Max Power",            "10;25;50;100;250;500", 4, "mW" },
+    { 3,  CRSF_TEXT_SELECTION, "Dynamic",              "Off;Dyn;AUX9;AUX10;AUX11;AUX12", 0, " " },
+    { 3,  CRSF_TEXT_SELECTION, "Fan Thresh",           "10mW;25mW;50mW;100mW;250mW;500mW;1000mW;2000mW;Never", 3, " " },
+    { 0,  CRSF_TEXT_SELECTION, "Switch Mode",          "Hybrid;Wide", 0, " " },
+    { 0,  CRSF_TEXT_SELECTION, "Model Match",          "Off;On", 0, " (ID: 3)" },
+    { 0,  CRSF_COMMAND,        "Bind",                 " ", 0, NULL },
+    { 0,  CRSF_INFO,           "Bad/Good",             " ", 0, NULL },
+    { 0,  CRSF_INFO,           "3.0.0 ISM2G4",         "a1b2c3", 0, NULL },
+    { 0,  CRSF_FOLDER,         "WiFi Connectivity",    "WiFi Connectivity", 0, NULL },
+    { 12, CRSF_COMMAND,        "Enable WiFi",          " ", 0, NULL },
+    { 12, CRSF_COMMAND,        "Enable Rx WiFi",       " ", 0, NULL },
+    { 12, CRSF_COMMAND,        "Enable Backpack WiFi", " ", 0, NULL },
+    { 12, CRSF_COMMAND,        "Enable VRx WiFi",      " ", 0, NULL },
+    { 0,  CRSF_COMMAND,        "BLE Joystick",         " ", 0, NULL },
+    { 0,  CRSF_FOLDER,         "VTX Administrator",    "VTX Administrator (A:1:1)", 0, NULL },
+    { 18, CRSF_TEXT_SELECTION, "Band",                 "Off;A;B;E;F;R;L", 1, " " },
+    { 18, CRSF_TEXT_SELECTION, "Channel",              "1;2;3;4;5;6;7;8", 0, " " },
+    { 18, CRSF_TEXT_SELECTION, "Pwr Lvl",              "-;1;2;3;4;5;6;7;8", 1, " " },
+    { 18, CRSF_TEXT_SELECTION, "Pitmode",              "Off;On;AUX1\xc0;AUX1\xc1;AUX2\xc0;AUX2\xc1;AUX3\xc0;AUX3\xc1;AUX4\xc0;AUX4\xc1;AUX5\xc0;AUX5\xc1;AUX6\xc0;AUX6\xc1;AUX7\xc0;AUX7\xc1;AUX8\xc0;AUX8\xc1;AUX9\xc0;AUX9\xc1;AUX10\xc0;AUX10\xc1", 0, " " },
+    { 18, CRSF_COMMAND,        "Send VTx",             " ", 0, NULL },
+    { 0,  CRSF_FOLDER,         "Backpack",             "Backpack", 0, NULL },
+    { 24, CRSF_TEXT_SELECTION, "DVR AUX",              "Off;AUX1;!AUX1;AUX2;!AUX2;AUX3;!AUX3;AUX4;!AUX4;AUX5;!AUX5;AUX6;!AUX6;AUX7;!AUX7;AUX8;!AUX8;AUX9;!AUX9;AUX10;!AUX10", 0, " " },
+    { 24, CRSF_TEXT_SELECTION, "DVR Srt Dly",          "0s;5s;15s;30s;45s;1min;2min", 0, " " },
+    { 24, CRSF_TEXT_SELECTION, "DVR Stp Dly",          "0s;5s;15s;30s;45s;1min;2min", 0, " " },
+};
+#define LAST_FIELD ((uint8_t)(sizeof(menu) / sizeof(menu[0]) - 1))
+
+// The entry the firmware serializes for a field: Parent + Type + Name + value
+static uint8_t serialize(uint8_t id, uint8_t *entry)
+{
+    if (id == 0 || id > LAST_FIELD)
+        return 0;
+    const item_t &it = menu[id];
+    uint8_t *p = entry;
+    *p++ = it.parent;
+    *p++ = it.type;
+    switch (it.type)
+    {
+    case CRSF_TEXT_SELECTION:
+        p = (uint8_t *)stpcpy((char *)p, it.name) + 1;
+        p = (uint8_t *)stpcpy((char *)p, it.options) + 1;
+        *p++ = it.value;
+        *p++ = 0;
+        *p++ = 0; // max, not needed here
+        *p++ = 0;
+        p = (uint8_t *)stpcpy((char *)p, it.units) + 1;
+        break;
+    case CRSF_COMMAND:
+        p = (uint8_t *)stpcpy((char *)p, it.name) + 1;
+        *p++ = 0;
+        *p++ = 200;
+        p = (uint8_t *)stpcpy((char *)p, it.options) + 1;
+        break;
+    case CRSF_INFO:
+        p = (uint8_t *)stpcpy((char *)p, it.name) + 1;
+        p = (uint8_t *)stpcpy((char *)p, it.options) + 1;
+        break;
+    case CRSF_FOLDER:
+        // Dynamic name in place of the name
+        p = (uint8_t *)stpcpy((char *)p, it.options) + 1;
+        break;
+    }
+    return p - entry;
+}
+
+typedef struct {
+    uint32_t requests; // each waits for the response to the last
+    uint32_t frames;   // both ways
+    uint32_t bytes;
+} traffic_t;
+
+// The handset reading each field in chunks, as the Lua script does without batches
+static void chunkedRead(uint8_t id, traffic_t &t)
+{
+    uint8_t entry[256];
+    const uint8_t len = serialize(id, entry);
+    const uint8_t chunkMax = MAX_PAYLOAD - 2;
+    const uint8_t chunks = (len + chunkMax - 1) / chunkMax;
+    for (uint8_t c = 0; c < chunks; ++c)
+    {
+        const uint8_t size = (c == chunks - 1) ? len - c * chunkMax : chunkMax;
+        ++t.requests;
+        t.frames += 2;
+        t.bytes += READ_FRAME + FRAME_OVERHEAD + 2 + size;
+    }
+}
+
+// What the handset gets back for one batch request
+static uint8_t responses[BATCH_FRAMES][MAX_PAYLOAD];
+static uint8_t responseLen[BATCH_FRAMES];
+static uint8_t responseCount;
+
+static void queueResponse(uint8_t *frame, uint8_t len)
+{
+    TEST_ASSERT_TRUE(responseCount < BATCH_FRAMES);
+    TEST_ASSERT_TRUE(len <= MAX_PAYLOAD);
+    memcpy(responses[responseCount], frame, len);
+    responseLen[responseCount++] = len;
+}
+
+/**
+ * The handset reading a batch pass since a version, checking every entry
+ * decodes to what the firmware serialized. Returns the version to keep.
+ **/
+static uint8_t batchRead(LuaParamCache &cache, uint8_t since, traffic_t &t, uint32_t *fieldsSeen = NULL)
+{
+    uint8_t from = 1;
+    uint8_t keep = 0;
+    do
+    {
+        responseCount = 0;
+        cache.buildBatches(from, LAST_FIELD, since, MAX_PAYLOAD, BATCH_FRAMES, serialize, queueResponse);
+        ++t.requests;
+        t.frames += 1 + responseCount;
+        t.bytes += BATCH_READ;
+        for (uint8_t r = 0; r < responseCount; ++r)
+        {
+            const uint8_t *frame = responses[r];
+            const uint8_t len = responseLen[r];
+            TEST_ASSERT_EQUAL_UINT8(LUA_FIELD_BATCH, frame[0]);
+            TEST_ASSERT_EQUAL(from, frame[1]);
+            t.bytes += FRAME_OVERHEAD + len;
+            if (from == 1)
+                keep = frame[3];
+            for (uint8_t pos = LUA_BATCH_HEADER; pos < len;)
+            {
+                const uint8_t id = frame[pos];
+                const uint8_t entryLen = frame[pos + 1];
+                uint8_t expected[256];
+                const uint8_t expectedLen = serialize(id, expected);
+                if (entryLen == 0)
+                {
+                    // Left to a chunked read
+                    TEST_ASSERT_TRUE(expectedLen + LUA_BATCH_HEADER + LUA_BATCH_ENTRY_HDR > MAX_PAYLOAD);
+                    chunkedRead(id, t);
+                }
+                else
+                {
+                    TEST_ASSERT_EQUAL(expectedLen, entryLen);
+                    TEST_ASSERT_EQUAL_MEMORY(expected, &frame[pos + 2], entryLen);
+                }
+                if (fieldsSeen)
+                    ++*fieldsSeen;
+                pos += LUA_BATCH_ENTRY_HDR + entryLen;
+            }
+            from = frame[2] & ~LUA_BATCH_MORE;
+            // Only the last frame of the response has the handset ask again
+            TEST_ASSERT_EQUAL(r < responseCount - 1, (frame[2] & LUA_BATCH_MORE) != 0);
+        }
+    } while (from != 0);
+    return keep;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_full_load(void)
+{
+    traffic_t chunked = {0, 0, 0}, batched = {0, 0, 0};
+    for (uint8_t id = 1; id <= LAST_FIELD; ++id)
+        chunkedRead(id, chunked);
+
+    LuaParamCache cache;
+    uint32_t fields = 0;
+    batchRead(cache, 0, batched, &fields);
+    TEST_ASSERT_EQUAL(LAST_FIELD, fields);
+
+    printf("full load: %u requests %u frames %u bytes chunked, %u requests %u frames %u bytes batched\n",
+           chunked.requests, chunked.frames, chunked.bytes, batched.requests, batched.frames, batched.bytes);
+    // Most entries are too big to share a 64 byte frame, and the long
+    // selections are still read in chunks, but the round trips halve
+    TEST_ASSERT_TRUE(batched.requests * 2 < chunked.requests);
+    TEST_ASSERT_TRUE(batched.frames < chunked.frames);
+    TEST_ASSERT_TRUE(batched.bytes < chunked.bytes);
+}
+
+void test_change_reload(void)
+{
+    LuaParamCache cache;
+    traffic_t t = {0, 0, 0};
+    const uint8_t loaded = batchRead(cache, 0, t);
+
+    // Nothing changed, one frame to find out
+    t.requests = t.frames = t.bytes = 0;
+    uint32_t fields = 0;
+    TEST_ASSERT_EQUAL(loaded, batchRead(cache, loaded, t, &fields));
+    TEST_ASSERT_EQUAL(0, fields);
+    TEST_ASSERT_EQUAL(1, t.requests);
+    TEST_ASSERT_EQUAL(2, t.frames);
+
+    // Max Power changes, and the folder name showing it
+    menu[4].value = 5;
+    menu[3].options = "TX Power (500mW)";
+    traffic_t batched = {0, 0, 0};
+    const uint8_t reloaded = batchRead(cache, loaded, batched, &fields);
+    TEST_ASSERT_EQUAL(2, fields);
+    TEST_ASSERT_TRUE(reloaded != loaded);
+    TEST_ASSERT_EQUAL(reloaded, cache.getVersion());
+
+    // What the script reloaded after a write: the folder, the field and the
+    // editable fields next to it
+    traffic_t chunked = {0, 0, 0};
+    for (uint8_t id = 3; id <= 6; ++id)
+        chunkedRead(id, chunked);
+    printf("change reload: %u requests %u frames %u bytes chunked, %u requests %u frames %u bytes batched\n",
+           chunked.requests, chunked.frames, chunked.bytes, batched.requests, batched.frames, batched.bytes);
+    TEST_ASSERT_EQUAL(1, batched.requests);
+    TEST_ASSERT_TRUE(batched.frames < chunked.frames);
+    TEST_ASSERT_TRUE(batched.bytes < chunked.bytes);
+
+    menu[4].value = 4;
+    menu[3].options = "TX Power (250mW)";
+}
+
+void test_versions(void)
+{
+    LuaParamCache cache;
+    uint8_t entry[4] = { 0, CRSF_INFO, 'a', 0 };
+    TEST_ASSERT_TRUE(cache.update(1, entry, sizeof(entry)));
+    TEST_ASSERT_TRUE(cache.update(2, entry, sizeof(entry)));
+    // First sight of a field isn't a change
+    TEST_ASSERT_EQUAL(1, cache.getVersion());
+    TEST_ASSERT_FALSE(cache.update(1, entry, sizeof(entry)));
+    TEST_ASSERT_TRUE(cache.changedSince(1, 0));
+    TEST_ASSERT_FALSE(cache.changedSince(1, 1));
+
+    // Goes round without a 0, and without losing what changed
+    for (unsigned i = 0; i < 600; ++i)
+    {
+        const uint8_t since = cache.getVersion();
+        entry[2] = 'a' + i % 2 + 1;
+        TEST_ASSERT_TRUE(cache.update(1, entry, sizeof(entry)));
+        TEST_ASSERT_TRUE(cache.getVersion() != 0);
+        TEST_ASSERT_TRUE(cache.changedSince(1, since));
+        TEST_ASSERT_FALSE(cache.changedSince(1, cache.getVersion()));
+    }
+    // Too far behind gets everything
+    TEST_ASSERT_TRUE(cache.changedSince(2, cache.getVersion() - LUA_VERSION_MAX_AGE - 1));
+    TEST_ASSERT_FALSE(cache.changedSince(2, cache.getVersion() - 1));
+}
+
+static uint8_t serializeBig(uint8_t id, uint8_t *entry)
+{
+    if (id < 1 || id > 3)
+        return 0;
+    const uint8_t len = id == 2 ? MAX_PAYLOAD : 10;
+    memset(entry, id, len);
+    return len;
+}
+
+void test_oversize_entry(void)
+{
+    LuaParamCache cache;
+    uint8_t frame[MAX_PAYLOAD];
+    const uint8_t len = cache.buildBatch(1, 3, 0, frame, MAX_PAYLOAD, serializeBig);
+    TEST_ASSERT_EQUAL(1, frame[1]);
+    TEST_ASSERT_EQUAL(0, frame[2]);
+    TEST_ASSERT_EQUAL(LUA_BATCH_HEADER + 3 * LUA_BATCH_ENTRY_HDR + 20, len);
+    TEST_ASSERT_EQUAL(1, frame[4]);
+    TEST_ASSERT_EQUAL(10, frame[5]);
+    TEST_ASSERT_EQUAL(2, frame[16]);
+    TEST_ASSERT_EQUAL(0, frame[17]);
+    TEST_ASSERT_EQUAL(3, frame[18]);
+}
+
+void test_frames_fitting(void)
+{
+    // Empty FIFO takes all of them
+    TEST_ASSERT_EQUAL(3, LuaParamCache::framesFitting(255, 58, 7, 3));
+    // Room for two full frames, not three
+    TEST_ASSERT_EQUAL(2, LuaParamCache::framesFitting(2 * 65 + 64, 58, 7, 3));
+    TEST_ASSERT_EQUAL(1, LuaParamCache::framesFitting(65, 58, 7, 3));
+    // Full, still answers the request with one
+    TEST_ASSERT_EQUAL(1, LuaParamCache::framesFitting(10, 58, 7, 3));
+    TEST_ASSERT_EQUAL(1, LuaParamCache::framesFitting(255, 58, 7, 1));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_versions);
+    RUN_TEST(test_oversize_entry);
+    RUN_TEST(test_full_load);
+    RUN_TEST(test_change_reload);
+    RUN_TEST(test_frames_fitting);
+    UNITY_END();
+
+    return 0;
+}
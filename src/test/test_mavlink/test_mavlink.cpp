@@ -0,0 +1,372 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <vector>
+#include <unity.h>
+#include "common.h"
+#include "crc.h"
+#include "mavlink_serial.h"
+
+using namespace std;
+
+GENERIC_CRC8 crsf_crc(CRSF_CRC_POLY);
+
+MAVLinkSerial mavlink;
+static uint8_t seqOut;
+
+// A MAVLink2 frame, the checksum uses a crc extra of 0 so only this test understands it
+static vector<uint8_t> mavFrame(uint32_t msgId, uint8_t len, uint8_t sysId = 1, uint8_t compId = 1, bool isSigned = false)
+{
+    vector<uint8_t> frame = {MAVLINK_V2_STX, len, (uint8_t)(isSigned ? MAVLINK_IFLAG_SIGNED : 0), 0, seqOut++, sysId, compId,
+                             (uint8_t)msgId, (uint8_t)(msgId >> 8), (uint8_t)(msgId >> 16)};
+    for (uint8_t i = 0; i < len; i++)
+        frame.push_back(rand());
+    const uint8_t extra = 0;
+    uint16_t crc = MAVLinkSerial::Checksum(&frame[1], frame.size() - 1);
+    crc = MAVLinkSerial::Checksum(&extra, 1, crc);
+    frame.push_back(crc);
+    frame.push_back(crc >> 8);
+    if (isSigned)
+        frame.insert(frame.end(), MAVLINK_SIGNATURE_LEN, 0x55);
+    return frame;
+}
+
+static void feed(const vector<uint8_t> &frame)
+{
+    for (uint8_t b : frame)
+        mavlink.RXhandleUARTin(b);
+}
+
+// Take the next envelope, checking it is a valid CRSF frame, and return its MAVLink data
+static bool nextEnvelope(vector<uint8_t> &data, uint8_t *chunks = nullptr)
+{
+    uint8_t size;
+    uint8_t *payload;
+    if (!mavlink.GetNextPayload(&size, &payload))
+        return false;
+
+    TEST_ASSERT_TRUE(size <= CRSF_MAX_PACKET_LEN);
+    TEST_ASSERT_EQUAL(size, CRSF_FRAME_SIZE(payload[1]));
+    TEST_ASSERT_EQUAL_HEX8(crsf_crc.calc(&payload[2], size - 3), payload[size - 1]);
+
+    const uint8_t *mav;
+    uint8_t len = MAVLinkSerial::UnwrapEnvelope(payload, &mav);
+    TEST_ASSERT_TRUE(len > 0);
+    data.insert(data.end(), mav, mav + len);
+    if (chunks)
+        *chunks = payload[3];
+    return true;
+}
+
+void setUp()
+{
+    mavlink.Reset();
+    mavlink.FramesIn = 0;
+    mavlink.FramesDropped = 0;
+}
+
+void tearDown() {}
+
+void test_checksum(void)
+{
+    // CRC-16/MCRF4XX check value
+    TEST_ASSERT_EQUAL_HEX16(0x6F91, MAVLinkSerial::Checksum((const uint8_t *)"123456789", 9));
+}
+
+void test_small_frames_packed_whole(void)
+{
+    vector<uint8_t> a = mavFrame(24, 10);
+    vector<uint8_t> b = mavFrame(74, 17);
+    vector<uint8_t> c = mavFrame(33, 20);
+    feed(a);
+    feed(b);
+    feed(c);
+    TEST_ASSERT_EQUAL(3, mavlink.FramesIn);
+
+    // a and b fit in one envelope, c doesn't fit after them and isn't split
+    vector<uint8_t> data;
+    uint8_t chunks;
+    TEST_ASSERT_TRUE(nextEnvelope(data, &chunks));
+    TEST_ASSERT_EQUAL_HEX8(0x10, chunks);
+    TEST_ASSERT_EQUAL(a.size() + b.size(), data.size());
+    TEST_ASSERT_TRUE(nextEnvelope(data));
+    TEST_ASSERT_FALSE(nextEnvelope(data));
+
+    vector<uint8_t> expected = a;
+    expected.insert(expected.end(), b.begin(), b.end());
+    expected.insert(expected.end(), c.begin(), c.end());
+    TEST_ASSERT_EQUAL(expected.size(), data.size());
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected.data(), data.data(), data.size());
+}
+
+void test_priority_first(void)
+{
+    vector<uint8_t> bulk = mavFrame(24, 30);
+    vector<uint8_t> heartbeat = mavFrame(MAVLINK_MSG_ID_HEARTBEAT, 9);
+    vector<uint8_t> attitude = mavFrame(MAVLINK_MSG_ID_ATTITUDE, 28);
+    feed(bulk);
+    feed(heartbeat);
+    feed(attitude);
+
+    // each goes in its own envelope as no two fit together, bulk goes last
+    vector<uint8_t> data;
+    TEST_ASSERT_TRUE(nextEnvelope(data));
+    TEST_ASSERT_EQUAL(heartbeat.size(), data.size());
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(heartbeat.data(), data.data(), heartbeat.size());
+    data.clear();
+    TEST_ASSERT_TRUE(nextEnvelope(data));
+    TEST_ASSERT_EQUAL(attitude.size(), data.size());
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(attitude.data(), data.data(), attitude.size());
+    data.clear();
+    TEST_ASSERT_TRUE(nextEnvelope(data));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(bulk.data(), data.data(), bulk.size());
+}
+
+void test_large_frame_split(void)
+{
+    vector<uint8_t> param = mavFrame(22, 200);
+    feed(param);
+    // arrives while the long frame is being sent, so must wait for it
+    vector<uint8_t> heartbeat = mavFrame(MAVLINK_MSG_ID_HEARTBEAT, 9);
+
+    vector<uint8_t> data;
+    uint8_t chunks;
+    const uint8_t total = (param.size() + MAVLINK_ENVELOPE_MAX_DATA - 1) / MAVLINK_ENVELOPE_MAX_DATA;
+    for (uint8_t i = 0; i < total; i++)
+    {
+        TEST_ASSERT_TRUE(nextEnvelope(data, &chunks));
+        TEST_ASSERT_EQUAL_HEX8((total << 4) | i, chunks);
+        if (i == 0)
+            feed(heartbeat);
+    }
+    TEST_ASSERT_EQUAL(param.size(), data.size());
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(param.data(), data.data(), data.size());
+
+    data.clear();
+    TEST_ASSERT_TRUE(nextEnvelope(data));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(heartbeat.data(), data.data(), heartbeat.size());
+}
+
+void test_garbage_and_signed_frames(void)
+{
+    vector<uint8_t> frame = mavFrame(33, 28, 1, 1, true);
+    const uint8_t junk[] = {0x00, 0x12, 0x34};
+    for (uint8_t b : junk)
+        mavlink.RXhandleUARTin(b);
+    feed(frame);
+
+    vector<uint8_t> data;
+    TEST_ASSERT_TRUE(nextEnvelope(data));
+    TEST_ASSERT_EQUAL(frame.size(), data.size());
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(frame.data(), data.data(), data.size());
+}
+
+void test_overflow_and_txbuf(void)
+{
+    TEST_ASSERT_EQUAL(100, mavlink.TxBufferFree());
+    vector<uint8_t> frame = mavFrame(24, 100);
+    for (int i = 0; i < 8; i++)
+        feed(frame);
+
+    TEST_ASSERT_TRUE(mavlink.TxBufferFree() < 20);
+    TEST_ASSERT_TRUE(mavlink.FramesDropped > 0);
+    TEST_ASSERT_EQUAL(8, mavlink.FramesIn + mavlink.FramesDropped);
+
+    // the frames which were kept come out whole
+    vector<uint8_t> data;
+    while (nextEnvelope(data))
+        ;
+    TEST_ASSERT_EQUAL(mavlink.FramesIn * frame.size(), data.size());
+    for (size_t pos = 0; pos < data.size(); pos += frame.size())
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(&frame[2], &data[pos + 2], frame.size() - 2);
+    TEST_ASSERT_EQUAL(100, mavlink.TxBufferFree());
+}
+
+void test_radio_status_and_rc_override(void)
+{
+    // the FC's heartbeat sets the target of the overrides
+    feed(mavFrame(MAVLINK_MSG_ID_HEARTBEAT, 9, 7, MAVLINK_COMP_ID_AUTOPILOT));
+    vector<uint8_t> data;
+    nextEnvelope(data);
+
+    uint8_t frame[MAVLINK_MAX_FRAME_LEN];
+    uint8_t len = mavlink.BuildRadioStatus(frame, 200, 150, 3);
+    TEST_ASSERT_EQUAL(MAVLINK_V2_HEADER_LEN + 7 + MAVLINK_CHECKSUM_LEN, len); // trailing zeros dropped
+    TEST_ASSERT_EQUAL(MAVLINK_MSG_ID_RADIO_STATUS, frame[7]);
+    TEST_ASSERT_EQUAL(200, frame[MAVLINK_V2_HEADER_LEN + 4]);
+    TEST_ASSERT_EQUAL(100, frame[MAVLINK_V2_HEADER_LEN + 6]); // txbuf
+    const uint8_t radioExtra = 185;
+    uint16_t crc = MAVLinkSerial::Checksum(&frame[1], len - 3);
+    crc = MAVLinkSerial::Checksum(&radioExtra, 1, crc);
+    TEST_ASSERT_EQUAL_HEX16(crc, frame[len - 2] | (frame[len - 1] << 8));
+
+    // and a copy goes to the GCS
+    data.clear();
+    TEST_ASSERT_TRUE(nextEnvelope(data));
+    TEST_ASSERT_EQUAL(len, data.size());
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(frame, data.data(), len);
+
+    uint32_t channels[CRSF_NUM_CHANNELS];
+    for (int ch = 0; ch < CRSF_NUM_CHANNELS; ch++)
+        channels[ch] = CRSF_CHANNEL_VALUE_MID;
+    channels[2] = CRSF_CHANNEL_VALUE_MIN;
+    channels[15] = CRSF_CHANNEL_VALUE_MAX;
+    len = mavlink.BuildRcOverride(frame, channels);
+    const uint8_t *payload = &frame[MAVLINK_V2_HEADER_LEN];
+    TEST_ASSERT_EQUAL(MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, frame[7]);
+    TEST_ASSERT_EQUAL(255, frame[5]);
+    TEST_ASSERT_EQUAL(988, payload[4] | (payload[5] << 8));
+    TEST_ASSERT_EQUAL(7, payload[16]);
+    TEST_ASSERT_EQUAL(MAVLINK_COMP_ID_AUTOPILOT, payload[17]);
+    TEST_ASSERT_EQUAL(2012, payload[32] | (payload[33] << 8)); // chan16
+    TEST_ASSERT_EQUAL(34, frame[1]);                           // chan17/18 dropped
+}
+
+/**
+ * The FC streams attitude at 20Hz, a heartbeat at 1Hz and bulk data at a rate
+ * backed off while RADIO_STATUS txbuf is low, like ArduPilot does, over a
+ * 115200 baud UART. The link moves 10 bytes every 4ms and an envelope can
+ * only start once the last one is fully sent.
+ */
+void test_loopback_throughput_latency(void)
+{
+    const uint32_t simUs = 60 * 1000000;
+    const uint32_t uartUsPerByte = 87;
+    const uint32_t slotUs = 4000;
+    const uint32_t slotBytes = 10;
+
+    struct sent_t {
+        vector<uint8_t> frame;
+        uint32_t queuedUs;
+    };
+    deque<sent_t> priority, bulk;
+    deque<uint8_t> uart;
+    vector<uint8_t> rxStream;
+    size_t rxParsed = 0;
+    uint64_t latency[2] = {0}, latencyMax[2] = {0}, delivered[2] = {0}, deliveredBytes = 0;
+
+    uint32_t nextAttitude = 0, nextHeartbeat = 0, nextBulk = 0, nextStatus = 0, nextUart = 0, nextSlot = 0;
+    uint32_t bulkIntervalUs = 20000;
+    uint32_t envelopeRemaining = 0;
+    vector<uint8_t> envelopeData;
+
+    for (uint32_t now = 0; now < simUs; now += 100)
+    {
+        // the FC
+        if (now >= nextAttitude)
+        {
+            vector<uint8_t> f = mavFrame(MAVLINK_MSG_ID_ATTITUDE, 28);
+            uart.insert(uart.end(), f.begin(), f.end());
+            priority.push_back({f, now});
+            nextAttitude += 50000;
+        }
+        if (now >= nextHeartbeat)
+        {
+            vector<uint8_t> f = mavFrame(MAVLINK_MSG_ID_HEARTBEAT, 9);
+            uart.insert(uart.end(), f.begin(), f.end());
+            priority.push_back({f, now});
+            nextHeartbeat += 1000000;
+        }
+        if (now >= nextBulk)
+        {
+            vector<uint8_t> f = mavFrame(rand() % 2 ? 24 : 22, 20 + rand() % 80);
+            uart.insert(uart.end(), f.begin(), f.end());
+            bulk.push_back({f, now});
+            nextBulk += bulkIntervalUs;
+        }
+        if (now >= nextStatus)
+        {
+            uint8_t frame[MAVLINK_MAX_FRAME_LEN];
+            mavlink.BuildRadioStatus(frame, 0, 0, 0);
+            uint8_t txbuf = mavlink.TxBufferFree();
+            if (txbuf < 50)
+                bulkIntervalUs += 5000;
+            else if (txbuf > 90 && bulkIntervalUs > 5000)
+                bulkIntervalUs -= 1000;
+            nextStatus += 100000;
+        }
+        while (!uart.empty() && now >= nextUart)
+        {
+            mavlink.RXhandleUARTin(uart.front());
+            uart.pop_front();
+            nextUart = (nextUart > now ? nextUart : now) + uartUsPerByte;
+        }
+
+        // the link
+        if (now >= nextSlot)
+        {
+            nextSlot += slotUs;
+            if (envelopeRemaining == 0)
+            {
+                uint8_t size;
+                uint8_t *payload;
+                if (mavlink.GetNextPayload(&size, &payload))
+                {
+                    const uint8_t *mav;
+                    uint8_t len = MAVLinkSerial::UnwrapEnvelope(payload, &mav);
+                    envelopeData.assign(mav, mav + len);
+                    envelopeRemaining = size;
+                }
+            }
+            if (envelopeRemaining)
+            {
+                envelopeRemaining = envelopeRemaining > slotBytes ? envelopeRemaining - slotBytes : 0;
+                if (envelopeRemaining == 0)
+                    rxStream.insert(rxStream.end(), envelopeData.begin(), envelopeData.end());
+            }
+        }
+
+        // the GCS
+        while (rxStream.size() - rxParsed >= MAVLINK_V2_HEADER_LEN)
+        {
+            const uint8_t *f = &rxStream[rxParsed];
+            TEST_ASSERT_EQUAL_HEX8(MAVLINK_V2_STX, f[0]);
+            size_t len = MAVLINK_V2_HEADER_LEN + f[1] + MAVLINK_CHECKSUM_LEN;
+            if (rxStream.size() - rxParsed < len)
+                break;
+            rxParsed += len;
+            if (f[7] == MAVLINK_MSG_ID_RADIO_STATUS)
+                continue;
+
+            // frames can be dropped but those delivered are whole and in order
+            const int cls = (f[7] == MAVLINK_MSG_ID_ATTITUDE || f[7] == MAVLINK_MSG_ID_HEARTBEAT) ? 0 : 1;
+            deque<sent_t> &q = cls == 0 ? priority : bulk;
+            while (!q.empty() && (q.front().frame.size() != len || memcmp(q.front().frame.data(), f, len) != 0))
+                q.pop_front();
+            TEST_ASSERT_FALSE(q.empty());
+            uint32_t lat = now - q.front().queuedUs;
+            latency[cls] += lat;
+            if (lat > latencyMax[cls])
+                latencyMax[cls] = lat;
+            delivered[cls]++;
+            deliveredBytes += len;
+            q.pop_front();
+        }
+    }
+
+    TEST_ASSERT_TRUE(delivered[0] > 0 && delivered[1] > 0);
+    TEST_ASSERT_TRUE(latency[0] / delivered[0] < latency[1] / delivered[1]);
+    cout << "MAVLink loopback: " << deliveredBytes * 1000000 / simUs << " bytes/s over a "
+         << slotBytes * 1000000 / slotUs << " bytes/s link, "
+         << mavlink.FramesIn << " frames in, " << mavlink.FramesDropped << " dropped" << endl;
+    cout << "  priority latency avg " << latency[0] / delivered[0] / 1000 << "ms max " << latencyMax[0] / 1000 << "ms" << endl;
+    cout << "  bulk latency avg " << latency[1] / delivered[1] / 1000 << "ms max " << latencyMax[1] / 1000 << "ms" << endl;
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_checksum);
+    RUN_TEST(test_small_frames_packed_whole);
+    RUN_TEST(test_priority_first);
+    RUN_TEST(test_large_frame_split);
+    RUN_TEST(test_garbage_and_signed_frames);
+    RUN_TEST(test_overflow_and_txbuf);
+    RUN_TEST(test_radio_status_and_rc_override);
+    RUN_TEST(test_loopback_throughput_latency);
+    UNITY_END();
+
+    return 0;
+}
@@ -1,5 +1,8 @@
 #include <cstdint>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <vector>
 #include <unity.h>
 #include "common.h"
 #include "msp2crsf.h"
@@ -56,18 +59,13 @@ void printFIFOhex()
     }
 }
 
-void runTest(const uint8_t *frame, int frameLen)
-{
-    cout << "MSP In Len: " << dec << (int)frameLen << endl;
-
-    // cout << "MSP()                ";
-    // printBufferhex(frame, frameLen);
-
-    // msp2crsf.parse(frame, frameLen);
-    // cout << "CRSF(MSP())          ";
-    // printFIFOhex();
+uint32_t peakFIFO;
 
-    msp2crsf.parse(frame, frameLen); // do again cause we pop'd the buffer
+// Move the CRSF frames from msp2crsf to crsf2msp, as the UART would
+void drainFIFO()
+{
+    if (msp2crsf.FIFOout.size() > peakFIFO)
+        peakFIFO = msp2crsf.FIFOout.size();
     while (msp2crsf.FIFOout.peek() > 0)
     {
         uint8_t sizeOut = msp2crsf.FIFOout.pop();
@@ -75,18 +73,53 @@ void runTest(const uint8_t *frame, int frameLen)
         msp2crsf.FIFOout.popBytes(crsfFrame, sizeOut);
         crsf2msp.parse(crsfFrame);
     }
+}
+
+// Write MSP bytes in pieces of at most chunk bytes, draining the FIFO whenever it fills
+void writeMSP(const uint8_t *data, uint32_t len, uint32_t chunk)
+{
+    while (len)
+    {
+        uint32_t count = chunk < len ? chunk : len;
+        uint32_t written = msp2crsf.write(data, count);
+        data += written;
+        len -= written;
+        drainFIFO();
+    }
+}
 
-    // if (crsf2msp.isFrameReady())
-    // {
-    //     cout << "CRSF^-1(CRSF(MSP())) ";
-    //     printBufferhex(crsf2msp.getFrame(), crsf2msp.getFrameLen());
-    // }
-    // else
-    // {
-    //     cout << "Frame not ready\n";
-    // }
-    cout << "MSP Out Len: " << dec << (int)crsf2msp.getFrameLen() << endl;
-    TEST_ASSERT_EQUAL_HEX8_ARRAY(frame, crsf2msp.getFrame(), frameLen);
+void checkFrame(const uint8_t *frame, int frameLen)
+{
+    TEST_ASSERT_EQUAL(frameLen, crsf2msp.peekFrameLen());
+    uint8_t out[MSP_FRAME_MAX_LEN];
+    crsf2msp.popFrame(out);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(frame, out, frameLen);
+    TEST_ASSERT_EQUAL(0, crsf2msp.peekFrameLen());
+}
+
+void runTest(const uint8_t *frame, int frameLen)
+{
+    cout << "MSP In Len: " << dec << (int)frameLen << endl;
+
+    // cout << "MSP()                ";
+    // printBufferhex(frame, frameLen);
+
+    writeMSP(frame, frameLen, frameLen);
+    cout << "MSP Out Len: " << dec << (int)crsf2msp.peekFrameLen() << endl;
+    checkFrame(frame, frameLen);
+
+    // The same again, a byte at a time
+    writeMSP(frame, frameLen, 1);
+    checkFrame(frame, frameLen);
+}
+
+// The frame is incomplete, so nothing comes out until the rest of it arrives
+void runTruncatedTest(const uint8_t *partial, int partialLen, const uint8_t *frame, int frameLen)
+{
+    writeMSP(partial, partialLen, partialLen);
+    TEST_ASSERT_EQUAL(0, crsf2msp.peekFrameLen());
+    writeMSP(&frame[partialLen], frameLen - partialLen, frameLen);
+    checkFrame(frame, frameLen);
 }
 
 void MSP_IDENT_TEST()
@@ -120,7 +153,7 @@ void MSPV2_2_CHUNK_MSG()
 void MSPV1_JUMBO_TEST()
 {
     // cout << "Testing MSPV2 within MSPV1 Hello World" << endl;
-    runTest(MSPV1_JUMBO, sizeof(MSPV1_JUMBO));
+    runTruncatedTest(MSPV1_JUMBO, sizeof(MSPV1_JUMBO), MSPV1_JUMBO_289, sizeof(MSPV1_JUMBO_289));
     // cout << endl;
 }
 
@@ -141,7 +174,7 @@ void MSPV1_JUMBO_289_TEST()
 void MSP_BOARD_INFO_81_TEST()
 {
     // cout << "Testing MSPV2 within MSPV1 Hello World" << endl;
-    runTest(MSP_BOARD_INFO_81, sizeof(MSP_BOARD_INFO_81));
+    runTruncatedTest(MSP_BOARD_INFO_81, sizeof(MSP_BOARD_INFO_81), MSPV1_81, sizeof(MSPV1_81));
     // cout << endl;
 }
 
@@ -152,8 +185,89 @@ void MSPV2_SERIAL_SETTINGS_TEST()
     // cout << endl;
 }
 
+void MSP_SEQ_GAP_TEST()
+{
+    // lose the second of the two chunks
+    msp2crsf.parse(MSP_2CHUNKS_LONG, sizeof(MSP_2CHUNKS_LONG));
+    uint8_t crsfFrame[64];
+    uint8_t sizeOut = msp2crsf.FIFOout.pop();
+    msp2crsf.FIFOout.popBytes(crsfFrame, sizeOut);
+    crsf2msp.parse(crsfFrame);
+    msp2crsf.FIFOout.flush();
+
+    // the partial frame is dropped and the next one comes through whole
+    const uint32_t dropped = crsf2msp.framesDropped;
+    runTest(MSPV2_HELLO_WORLD, sizeof(MSPV2_HELLO_WORLD));
+    TEST_ASSERT_EQUAL(dropped + 1, crsf2msp.framesDropped);
+}
+
+void MSP_LARGE_FRAME_TEST()
+{
+    // far bigger than any buffer in either converter, only msp2crsf can take it
+    const uint16_t payloadLen = 4000;
+    vector<uint8_t> frame = {'$', 'X', '>', 0, 0x34, 0x12, (uint8_t)payloadLen, (uint8_t)(payloadLen >> 8)};
+    for (int i = 0; i < payloadLen; i++)
+        frame.push_back(rand());
+    frame.push_back(0);
+
+    vector<uint8_t> body;
+    uint32_t len = frame.size();
+    const uint8_t *data = frame.data();
+    peakFIFO = 0;
+    while (len)
+    {
+        uint32_t count = 1 + rand() % 100;
+        uint32_t written = msp2crsf.write(data, count < len ? count : len);
+        data += written;
+        len -= written;
+        if (msp2crsf.FIFOout.size() > peakFIFO)
+            peakFIFO = msp2crsf.FIFOout.size();
+        while (msp2crsf.FIFOout.peek() > 0)
+        {
+            uint8_t crsfFrame[64];
+            uint8_t sizeOut = msp2crsf.FIFOout.pop();
+            msp2crsf.FIFOout.popBytes(crsfFrame, sizeOut);
+            body.insert(body.end(), &crsfFrame[CRSF_MSP_FRAME_OFFSET], &crsfFrame[sizeOut - 1]);
+        }
+    }
+
+    // the chunks carry everything after $X< apart from the checksum
+    TEST_ASSERT_EQUAL(frame.size() - 4, body.size());
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(&frame[3], body.data(), body.size());
+    TEST_ASSERT_TRUE(peakFIFO <= MSP2CRSF_FIFO_SIZE);
+}
+
+void MSP_THROUGHPUT_TEST()
+{
+    const uint8_t *frames[] = {MSP_IDENT, MSPV2_HELLO_WORLD, MSPV1_81, MSPV1_JUMBO_289, MSPV2_SERIAL_SETTINGS};
+    const int frameLens[] = {sizeof(MSP_IDENT), sizeof(MSPV2_HELLO_WORLD), sizeof(MSPV1_81), sizeof(MSPV1_JUMBO_289), sizeof(MSPV2_SERIAL_SETTINGS)};
+    const int rounds = 20000;
+    uint8_t out[MSP_FRAME_MAX_LEN];
+    uint64_t bytes = 0;
+
+    peakFIFO = 0;
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+    {
+        const int f = r % 5;
+        writeMSP(frames[f], frameLens[f], 64);
+        crsf2msp.popFrame(out);
+        bytes += frameLens[f];
+    }
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(MSPV2_SERIAL_SETTINGS, out, sizeof(MSPV2_SERIAL_SETTINGS));
+
+    cout << "MSP->CRSF->MSP: " << (uint64_t)(bytes / secs) << " bytes/s" << endl;
+    cout << "Converter memory: " << sizeof(MSP2CROSSFIRE) << " + " << sizeof(CROSSFIRE2MSP)
+         << " bytes, peak CRSF FIFO use " << peakFIFO << " bytes" << endl;
+}
+
 // Unity setup/teardown
-void setUp() {}
+void setUp()
+{
+    msp2crsf = MSP2CROSSFIRE();
+    crsf2msp.reset();
+}
 void tearDown() {}
 
 int main(int argc, char **argv)
@@ -169,6 +283,9 @@ int main(int argc, char **argv)
     RUN_TEST(MSPV1_JUMBO_289_TEST);
     RUN_TEST(MSP_BOARD_INFO_81_TEST);
     RUN_TEST(MSPV2_SERIAL_SETTINGS_TEST);
+    RUN_TEST(MSP_SEQ_GAP_TEST);
+    RUN_TEST(MSP_LARGE_FRAME_TEST);
+    RUN_TEST(MSP_THROUGHPUT_TEST);
 
     UNITY_END();
 
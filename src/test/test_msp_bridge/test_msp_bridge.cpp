@@ -0,0 +1,241 @@
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <iostream>
+#include <new>
+#include <vector>
+#include <unity.h>
+#include "MSPBridge.h"
+
+using namespace std;
+
+MSPBridge bridge;
+
+// Build an MSPv1 frame, direction is '<' for requests and '>' for responses
+static vector<uint8_t> mspV1(uint8_t dir, uint8_t function, uint8_t payloadLen, uint8_t fill)
+{
+    vector<uint8_t> frame = {'$', 'M', dir, payloadLen, function};
+    uint8_t crc = payloadLen ^ function;
+    for (uint8_t i = 0; i < payloadLen; ++i)
+    {
+        frame.push_back(fill + i);
+        crc ^= fill + i;
+    }
+    frame.push_back(crc);
+    return frame;
+}
+
+static vector<uint8_t> mspV2(uint8_t dir, uint16_t function, uint16_t payloadLen, uint8_t fill)
+{
+    vector<uint8_t> frame = {'$', 'X', dir, 0, (uint8_t)function, (uint8_t)(function >> 8), (uint8_t)payloadLen, (uint8_t)(payloadLen >> 8)};
+    for (uint16_t i = 0; i < payloadLen; ++i)
+        frame.push_back(fill + i);
+    frame.push_back(0); // the bridge doesn't check the crc
+    return frame;
+}
+
+// The FC answers every request with the same function
+static void fcEcho()
+{
+    const msp_bridge_buffer_t *req;
+    while ((req = bridge.peekRequest()) != nullptr)
+    {
+        vector<uint8_t> resp(req->data, req->data + req->len);
+        resp[2] = '>';
+        bridge.popRequest();
+        bridge.response(resp.data(), resp.size());
+    }
+}
+
+static vector<uint8_t> drainOutput(uint8_t client)
+{
+    vector<uint8_t> out;
+    const msp_bridge_buffer_t *frame;
+    while ((frame = bridge.peekOutput(client)) != nullptr)
+    {
+        out.insert(out.end(), frame->data, frame->data + frame->len);
+        bridge.popOutput(client);
+    }
+    return out;
+}
+
+void setUp()
+{
+    bridge.~MSPBridge();
+    new (&bridge) MSPBridge();
+}
+
+void tearDown() {}
+
+void test_frame_len(void)
+{
+    vector<uint8_t> v1 = mspV1('<', 100, 3, 0);
+    vector<uint8_t> v2 = mspV2('<', 0x1001, 37, 0);
+    const uint8_t jumbo[] = {'$', 'M', '>', 0xFF, 116, 25, 1};
+
+    TEST_ASSERT_EQUAL(0, MSPBridge::frameLen(v1.data(), 4));
+    TEST_ASSERT_EQUAL(v1.size(), MSPBridge::frameLen(v1.data(), 5));
+    TEST_ASSERT_EQUAL(0, MSPBridge::frameLen(v2.data(), 7));
+    TEST_ASSERT_EQUAL(v2.size(), MSPBridge::frameLen(v2.data(), 8));
+    TEST_ASSERT_EQUAL(289, MSPBridge::frameLen(jumbo, sizeof(jumbo)));
+    TEST_ASSERT_EQUAL(-1, MSPBridge::frameLen((const uint8_t *)"$Q<", 3));
+    TEST_ASSERT_EQUAL(100, MSPBridge::frameFunction(v1.data()));
+    TEST_ASSERT_EQUAL(0x1001, MSPBridge::frameFunction(v2.data()));
+}
+
+void test_split_frames_reassembled(void)
+{
+    vector<uint8_t> frame = mspV2('<', 0x100A, 200, 7);
+    bridge.connect(0);
+
+    // garbage before the frame, then the frame a byte at a time
+    bridge.receive(0, (const uint8_t *)"xyz", 3);
+    for (size_t i = 0; i < frame.size(); ++i)
+    {
+        TEST_ASSERT_NULL(bridge.peekRequest());
+        bridge.receive(0, &frame[i], 1);
+    }
+
+    const msp_bridge_buffer_t *req = bridge.peekRequest();
+    TEST_ASSERT_NOT_NULL(req);
+    TEST_ASSERT_EQUAL(frame.size(), req->len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(frame.data(), req->data, frame.size());
+    bridge.popRequest();
+    TEST_ASSERT_NULL(bridge.peekRequest());
+}
+
+void test_interleaved_clients_routed(void)
+{
+    vector<uint8_t> a = mspV1('<', 1, 10, 0x10);
+    vector<uint8_t> b = mspV1('<', 2, 20, 0x20);
+    bridge.connect(0);
+    bridge.connect(1);
+
+    // halves of each client's frame arrive interleaved
+    bridge.receive(0, a.data(), 5);
+    bridge.receive(1, b.data(), 7);
+    bridge.receive(0, a.data() + 5, a.size() - 5);
+    bridge.receive(1, b.data() + 7, b.size() - 7);
+    fcEcho();
+
+    vector<uint8_t> outA = drainOutput(0);
+    vector<uint8_t> outB = drainOutput(1);
+    a[2] = '>';
+    b[2] = '>';
+    TEST_ASSERT_EQUAL(a.size(), outA.size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(a.data(), outA.data(), a.size());
+    TEST_ASSERT_EQUAL(b.size(), outB.size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(b.data(), outB.data(), b.size());
+}
+
+void test_same_function_in_order(void)
+{
+    vector<uint8_t> a = mspV1('<', 5, 1, 0xA0);
+    vector<uint8_t> b = mspV1('<', 5, 1, 0xB0);
+    bridge.connect(0);
+    bridge.connect(1);
+
+    bridge.receive(1, b.data(), b.size());
+    bridge.receive(0, a.data(), a.size());
+    fcEcho();
+
+    // client 1 asked first so gets the first answer
+    TEST_ASSERT_EQUAL_UINT8(0xB0, drainOutput(1)[5]);
+    TEST_ASSERT_EQUAL_UINT8(0xA0, drainOutput(0)[5]);
+}
+
+void test_unrequested_broadcast(void)
+{
+    vector<uint8_t> frame = mspV2('>', 0x2000, 4, 1);
+    bridge.connect(0);
+    bridge.connect(2);
+
+    bridge.response(frame.data(), frame.size());
+    TEST_ASSERT_EQUAL(frame.size(), drainOutput(0).size());
+    TEST_ASSERT_EQUAL(0, drainOutput(1).size());
+    TEST_ASSERT_EQUAL(frame.size(), drainOutput(2).size());
+
+    // the shared buffer is back in the pool
+    for (int i = 0; i < MSP_BRIDGE_POOL_SIZE; ++i)
+        bridge.response(frame.data(), frame.size());
+    TEST_ASSERT_EQUAL(0, bridge.framesDropped);
+}
+
+void test_disconnect_releases_buffers(void)
+{
+    vector<uint8_t> frame = mspV1('<', 9, 30, 0);
+    bridge.connect(0);
+
+    // leave a partial frame and queued output behind
+    bridge.receive(0, frame.data(), frame.size() / 2);
+    frame[2] = '>';
+    for (int i = 0; i < 4; ++i)
+        bridge.response(frame.data(), frame.size());
+    bridge.disconnect(0);
+
+    bridge.connect(0);
+    frame[2] = '<';
+    for (int i = 0; i < MSP_BRIDGE_POOL_SIZE; ++i)
+    {
+        bridge.receive(0, frame.data(), frame.size());
+        TEST_ASSERT_NOT_NULL(bridge.peekRequest());
+        bridge.popRequest();
+    }
+    TEST_ASSERT_EQUAL(0, bridge.framesDropped);
+}
+
+void test_throughput(void)
+{
+    const int clients = MSP_BRIDGE_MAX_CLIENTS;
+    const int rounds = 20000;
+    vector<uint8_t> frames[clients];
+    for (int c = 0; c < clients; ++c)
+        frames[c] = (c & 1) ? mspV2('<', 0x1000 + c, 64, c) : mspV1('<', 100 + c, 32, c);
+    for (int c = 0; c < clients; ++c)
+        bridge.connect(c);
+
+    srand(1);
+    size_t bytes = 0;
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r)
+    {
+        // every client sends a frame split at a random point
+        for (int c = 0; c < clients; ++c)
+        {
+            size_t split = rand() % frames[c].size();
+            bridge.receive(c, frames[c].data(), split);
+            bridge.receive(c, frames[c].data() + split, frames[c].size() - split);
+            bytes += frames[c].size();
+        }
+        fcEcho();
+        for (int c = 0; c < clients; ++c)
+        {
+            vector<uint8_t> out = drainOutput(c);
+            TEST_ASSERT_EQUAL(frames[c].size(), out.size());
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(frames[c].data() + 3, out.data() + 3, out.size() - 3);
+        }
+    }
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    TEST_ASSERT_EQUAL(rounds * clients, bridge.framesIn);
+    TEST_ASSERT_EQUAL(rounds * clients, bridge.framesOut);
+    TEST_ASSERT_EQUAL(0, bridge.framesDropped);
+    cout << "MSP bridge: " << (uint32_t)(rounds * clients / secs) << " frames/s, "
+         << (uint32_t)(bytes * 2 / secs) << " bytes/s" << endl;
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_frame_len);
+    RUN_TEST(test_split_frames_reassembled);
+    RUN_TEST(test_interleaved_clients_routed);
+    RUN_TEST(test_same_function_in_order);
+    RUN_TEST(test_unrequested_broadcast);
+    RUN_TEST(test_disconnect_releases_buffers);
+    RUN_TEST(test_throughput);
+    UNITY_END();
+
+    return 0;
+}
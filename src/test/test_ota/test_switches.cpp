@@ -8,6 +8,7 @@
  */
 
 
+#include <algorithm>
 #include <unity.h>
 
 #include "targets.h"
@@ -620,6 +621,184 @@ void test_decodingHybridWide_AUXX_low()
         test_decodingHybridWide(false, i, 0, CRSF_CHANNEL_VALUE_1000);
 }
 
+/* Switch latency over a lossy link, in packets from a switch moving on the
+ * TX to the RX having its new position
+ */
+#define LATENCY_SWITCHES 7 // AUX2-AUX8
+#define LATENCY_PACKETS  50000
+
+typedef struct {
+    uint32_t changes;
+    uint32_t total;
+    uint32_t max;
+} switch_latency_t;
+
+// Deterministic whatever the standard library
+static uint32_t latencyRng;
+static uint32_t latencyRand()
+{
+    latencyRng ^= latencyRng << 13;
+    latencyRng ^= latencyRng >> 17;
+    latencyRng ^= latencyRng << 5;
+    return latencyRng;
+}
+
+static void runSwitchLatency(OtaSwitchMode_e switchMode, unsigned lossPercent, uint8_t tlmDenom, switch_latency_t *stats)
+{
+    constexpr uint32_t POSITIONS[] =
+        { CRSF_CHANNEL_VALUE_1000, CRSF_CHANNEL_VALUE_MID, CRSF_CHANNEL_VALUE_2000 };
+    // Everything decodes to within this of what was sent
+    constexpr uint32_t TOLERANCE = 100;
+    uint32_t txChannels[CRSF_NUM_CHANNELS];
+    uint32_t rxChannels[CRSF_NUM_CHANNELS];
+    uint32_t changedAt[LATENCY_SWITCHES];
+    bool pending[LATENCY_SWITCHES] = {0};
+
+    for (unsigned ch = 0; ch < CRSF_NUM_CHANNELS; ++ch)
+        txChannels[ch] = rxChannels[ch] = CRSF_CHANNEL_VALUE_1000;
+    memset(stats, 0, sizeof(switch_latency_t) * LATENCY_SWITCHES);
+    latencyRng = 1;
+    OtaUpdateSerializers(switchMode, OTA4_PACKET_SIZE);
+    OtaSetHybrid8NextSwitchIndex(0);
+
+    uint32_t nextChange = 100;
+    for (uint32_t n = 0; n < LATENCY_PACKETS; ++n)
+    {
+        // A switch or two moved now and then, arm and mode together
+        if (n == nextChange)
+        {
+            const unsigned moved = 1 + latencyRand() % 2;
+            for (unsigned m = 0; m < moved; ++m)
+            {
+                const unsigned sw = latencyRand() % LATENCY_SWITCHES;
+                txChannels[5 + sw] = POSITIONS[(latencyRand() % 2 + 1 + txChannels[5 + sw] / 800) % 3];
+                if (!pending[sw])
+                    changedAt[sw] = n;
+                pending[sw] = true;
+            }
+            nextChange = n + 20 + latencyRand() % 40;
+        }
+
+        uint8_t TXdataBuffer[OTA4_PACKET_SIZE] = {0};
+        OTA_Packet_s * const otaPktPtr = (OTA_Packet_s *)TXdataBuffer;
+        OtaNonce = n;
+        memcpy(crsf.ChannelData, txChannels, sizeof(txChannels));
+        OtaPackChannelData(otaPktPtr, &crsf, false, tlmDenom);
+        if (latencyRand() % 100 >= lossPercent)
+        {
+            memcpy(crsf.ChannelData, rxChannels, sizeof(rxChannels));
+            OtaUnpackChannelData(otaPktPtr, &crsf, tlmDenom);
+            memcpy(rxChannels, crsf.ChannelData, sizeof(rxChannels));
+        }
+
+        for (unsigned sw = 0; sw < LATENCY_SWITCHES; ++sw)
+        {
+            const uint32_t tx = txChannels[5 + sw];
+            const uint32_t rx = rxChannels[5 + sw];
+            if (pending[sw] && (rx > tx ? rx - tx : tx - rx) <= TOLERANCE)
+            {
+                const uint32_t latency = n - changedAt[sw] + 1;
+                ++stats[sw].changes;
+                stats[sw].total += latency;
+                if (latency > stats[sw].max)
+                    stats[sw].max = latency;
+                pending[sw] = false;
+            }
+        }
+    }
+}
+
+static void printSwitchLatency(const char *name, unsigned lossPercent, const switch_latency_t *stats)
+{
+    printf("%-7s %2u%% loss", name, lossPercent);
+    for (unsigned sw = 0; sw < LATENCY_SWITCHES; ++sw)
+        printf("  AUX%u %4.2f/%-2u", sw + 2, (double)stats[sw].total / stats[sw].changes, stats[sw].max);
+    printf("  (avg/max packets)\n");
+}
+
+void test_switchLatency()
+{
+    switch_latency_t hybrid[LATENCY_SWITCHES];
+    switch_latency_t wide[LATENCY_SWITCHES];
+
+    // Lossless, a switch is in the next packet, or the one after when two moved together
+    runSwitchLatency(smHybridOr16ch, 0, 0, hybrid);
+    runSwitchLatency(smWideOr8ch, 0, 64, wide);
+    printSwitchLatency("Hybrid", 0, hybrid);
+    printSwitchLatency("Wide", 0, wide);
+    for (unsigned sw = 0; sw < LATENCY_SWITCHES; ++sw)
+    {
+        TEST_ASSERT_TRUE(hybrid[sw].changes > 50);
+        TEST_ASSERT_LESS_OR_EQUAL(2, hybrid[sw].max);
+        // Wide has no room for the index so is still round-robin by the nonce
+        TEST_ASSERT_LESS_OR_EQUAL(16, wide[sw].max);
+    }
+
+    // Lossy, repeats keep the changed switches well ahead of the round-robin
+    runSwitchLatency(smHybridOr16ch, 10, 0, hybrid);
+    runSwitchLatency(smWideOr8ch, 10, 64, wide);
+    printSwitchLatency("Hybrid", 10, hybrid);
+    printSwitchLatency("Wide", 10, wide);
+    uint32_t hybridMax = 0, wideMax = 0;
+    for (unsigned sw = 0; sw < LATENCY_SWITCHES; ++sw)
+    {
+        TEST_ASSERT_TRUE((double)hybrid[sw].total / hybrid[sw].changes < 2.0);
+        TEST_ASSERT_TRUE(hybrid[sw].total * 2 < wide[sw].total);
+        hybridMax = std::max(hybridMax, hybrid[sw].max);
+        wideMax = std::max(wideMax, wide[sw].max);
+    }
+    TEST_ASSERT_TRUE(hybridMax < wideMax);
+}
+
+/* A switch moving every packet doesn't stop the others being sent
+ */
+void test_switchLatencyRefresh()
+{
+    // Round-robin gets at least one packet in 4 (HYBRID8_MAX_CHANGED_RUN + 1)
+    constexpr uint32_t MAX_INTERVAL = 4 * LATENCY_SWITCHES;
+    uint32_t lastSent[LATENCY_SWITCHES] = {0};
+
+    for (unsigned ch = 0; ch < CRSF_NUM_CHANNELS; ++ch)
+        crsf.ChannelData[ch] = CRSF_CHANNEL_VALUE_MID;
+    OtaUpdateSerializers(smHybridOr16ch, OTA4_PACKET_SIZE);
+    OtaSetHybrid8NextSwitchIndex(0);
+    for (uint32_t n = 1; n < 1000; ++n)
+    {
+        crsf.ChannelData[6] = (n & 1) ? CRSF_CHANNEL_VALUE_1000 : CRSF_CHANNEL_VALUE_2000;
+        uint8_t TXdataBuffer[OTA4_PACKET_SIZE] = {0};
+        OTA_Packet_s * const otaPktPtr = (OTA_Packet_s *)TXdataBuffer;
+        OtaPackChannelData(otaPktPtr, &crsf, false, 0);
+
+        // Index 6 is sent as 0b11x
+        const uint8_t sw = (otaPktPtr->std.rc.switches >> 3) & 0b111;
+        lastSent[sw > 6 ? 6 : sw] = n;
+        for (unsigned i = 0; i < LATENCY_SWITCHES; ++i)
+            TEST_ASSERT_LESS_OR_EQUAL(MAX_INTERVAL, n - lastSent[i]);
+    }
+}
+
+void test_linkStatsLqShort()
+{
+    OTA_Packet_s otaPkt = {0};
+    for (uint8_t lq = 0; lq <= 100; ++lq)
+    {
+        otaPkt.std.tlm_dl.packageIndex = OTA4_LQ_SHORT_TO_INDEX(lq);
+        // Never 0, which is what an older RX sends
+        TEST_ASSERT_NOT_EQUAL(0, otaPkt.std.tlm_dl.packageIndex);
+        const uint8_t decoded = OTA4_INDEX_TO_LQ_SHORT(otaPkt.std.tlm_dl.packageIndex);
+        TEST_ASSERT_TRUE(decoded <= lq && decoded + 1 >= lq);
+    }
+}
+
+void test_switchModeOutOfRange()
+{
+    OtaUpdateSerializers(smHybridOr16ch, OTA4_PACKET_SIZE);
+    OtaUpdateSerializers((OtaSwitchMode_e)3, OTA4_PACKET_SIZE);
+    TEST_ASSERT_EQUAL(smWideOr8ch, OtaSwitchModeCurrent);
+    OtaUpdateSerializers((OtaSwitchMode_e)0xff, OTA8_PACKET_SIZE);
+    TEST_ASSERT_EQUAL(smWideOr8ch, OtaSwitchModeCurrent);
+}
+
 // Unity setup/teardown
 void setUp() {}
 void tearDown() {}
@@ -628,6 +807,7 @@ int main(int argc, char **argv)
 {
     UNITY_BEGIN();
     RUN_TEST(test_crsf_endpoints);
+    RUN_TEST(test_linkStatsLqShort);
     RUN_TEST(test_crsfToBit);
     RUN_TEST(test_bitToCrsf);
     RUN_TEST(test_crsfToN);
@@ -636,6 +816,8 @@ int main(int argc, char **argv)
     RUN_TEST(test_encodingHybrid8_3);
     RUN_TEST(test_encodingHybrid8_7);
     RUN_TEST(test_decodingHybrid8_all);
+    RUN_TEST(test_switchLatency);
+    RUN_TEST(test_switchLatencyRefresh);
 
     RUN_TEST(test_encodingHybridWide_high);
     RUN_TEST(test_encodingHybridWide_low);
@@ -647,6 +829,7 @@ int main(int argc, char **argv)
     RUN_TEST(test_encodingFullres16ch);
     RUN_TEST(test_encodingFullres12ch);
     RUN_TEST(test_decodingFullres16chLow);
+    RUN_TEST(test_switchModeOutOfRange);
 
     UNITY_END();
 
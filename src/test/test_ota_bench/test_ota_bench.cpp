@@ -0,0 +1,151 @@
+/**
+ * This file is part of ExpressLRS
+ * See https://github.com/AlessandroAU/ExpressLRS
+ *
+ * Benchmark of the OTA packet path for each packet size and switch mode,
+ * packing and CRC on the TX and CRC check and unpacking on the RX, called
+ * through the serializers OtaUpdateSerializers() selects and through
+ * std::function wrappers of them as they used to be called.
+ * Times are of the native build, for comparing modes and the dispatch, not
+ * a measure of any target.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <unity.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "targets.h"
+#include "CRSF.h"
+#include <OTA.h>
+
+CRSF crsf(NULL);  // need an instance to provide the fields used by the code under test
+uint8_t UID[6] = {1,2,3,4,5,6};
+
+#define BENCH_PACKETS 200000
+#define BENCH_RUNS    5      // the fastest is kept, the others had something else going on
+
+typedef struct {
+    const char *name;
+    OtaSwitchMode_e switchMode;
+    uint8_t packetSize;
+} bench_mode_t;
+
+static const bench_mode_t modes[] = {
+    { "Wide",      smWideOr8ch,    OTA4_PACKET_SIZE },
+    { "Hybrid",    smHybridOr16ch, OTA4_PACKET_SIZE },
+    { "Full 8ch",  smWideOr8ch,    OTA8_PACKET_SIZE },
+    { "Full 16ch", smHybridOr16ch, OTA8_PACKET_SIZE },
+    { "Full 12ch", sm12ch,         OTA8_PACKET_SIZE },
+};
+
+typedef struct {
+    double ns;
+    double cycles;
+} bench_time_t;
+
+static uint64_t cycleCount()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Where the results go, so the work can't be optimized out
+static volatile uint32_t benchSink;
+
+/**
+ * A packet each iteration, TX packing and CRC then the RX checking the CRC
+ * and unpacking, with the fastest of the runs kept per packet
+ **/
+template <typename Pack, typename Generate, typename Validate, typename Unpack>
+static bench_time_t runBench(Pack pack, Generate generate, Validate validate, Unpack unpack)
+{
+    bench_time_t best = { 1e9, 1e9 };
+    for (unsigned run = 0; run < BENCH_RUNS; ++run)
+    {
+        uint32_t good = 0;
+        const uint64_t startCycles = cycleCount();
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t n = 0; n < BENCH_PACKETS; ++n)
+        {
+            OtaNonce = n;
+            crsf.ChannelData[n % 16] = CRSF_CHANNEL_VALUE_MIN + n % (CRSF_CHANNEL_VALUE_MAX - CRSF_CHANNEL_VALUE_MIN);
+            OTA_Packet_s otaPkt;
+            memset(&otaPkt, 0, sizeof(otaPkt));
+            pack(&otaPkt, &crsf, n & 1, 8);
+            generate(&otaPkt);
+            if (validate(&otaPkt))
+                good += unpack(&otaPkt, &crsf, 8);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        const uint64_t endCycles = cycleCount();
+        benchSink = good;
+
+        const double ns = std::chrono::duration<double, std::nano>(end - start).count() / BENCH_PACKETS;
+        const double cycles = (double)(endCycles - startCycles) / BENCH_PACKETS;
+        if (ns < best.ns)
+        {
+            best.ns = ns;
+            best.cycles = cycles;
+        }
+    }
+    return best;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_ota_bench(void)
+{
+    for (unsigned i = 0; i < sizeof(modes) / sizeof(modes[0]); ++i)
+    {
+        OtaUpdateSerializers(modes[i].switchMode, modes[i].packetSize);
+
+        const bench_time_t direct = runBench(OtaPackChannelData, OtaGeneratePacketCrc,
+            OtaValidatePacketCrc, OtaUnpackChannelData);
+
+        const std::function<void (OTA_Packet_s * const, CRSF const * const, bool, uint8_t)> packFn = OtaPackChannelData;
+        const std::function<void (OTA_Packet_s * const)> generateFn = OtaGeneratePacketCrc;
+        const std::function<bool (OTA_Packet_s * const)> validateFn = OtaValidatePacketCrc;
+        const std::function<bool (OTA_Packet_s const * const, CRSF * const, uint8_t)> unpackFn = OtaUnpackChannelData;
+        const bench_time_t wrapped = runBench(packFn, generateFn, validateFn, unpackFn);
+
+        printf("%-9s %5.1fns %6.1f cycles/packet  std::function %5.1fns %6.1f cycles/packet\n",
+               modes[i].name, direct.ns, direct.cycles, wrapped.ns, wrapped.cycles);
+        TEST_ASSERT_TRUE(direct.ns > 0);
+    }
+}
+
+/* Every mode's packets pass their own CRC check, and fail it with a bit flipped */
+void test_ota_bench_crc(void)
+{
+    for (unsigned i = 0; i < sizeof(modes) / sizeof(modes[0]); ++i)
+    {
+        OtaUpdateSerializers(modes[i].switchMode, modes[i].packetSize);
+        OTA_Packet_s otaPkt;
+        memset(&otaPkt, 0, sizeof(otaPkt));
+        OtaNonce = 3;
+        OtaPackChannelData(&otaPkt, &crsf, true, 8);
+        OtaGeneratePacketCrc(&otaPkt);
+        TEST_ASSERT_TRUE(OtaValidatePacketCrc(&otaPkt));
+        ((uint8_t *)&otaPkt)[1] ^= 0x10;
+        TEST_ASSERT_FALSE(OtaValidatePacketCrc(&otaPkt));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ota_bench_crc);
+    RUN_TEST(test_ota_bench);
+    UNITY_END();
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <unity.h>
+#include "targets.h"
+#include "RCOutputScheduler.h"
+
+// Deterministic whatever the standard library
+class Rng
+{
+public:
+    explicit Rng(uint32_t seed) : state(seed) {}
+    double uniform()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return (state + 0.5) / 4294967296.0;
+    }
+    double gauss()
+    {
+        return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+    }
+private:
+    uint32_t state;
+};
+
+void setUp() {}
+void tearDown() {}
+
+void test_every_packet(void)
+{
+    RCOutputScheduler out;
+    out.setIntervals(2000, 0);
+    TEST_ASSERT_EQUAL(2000, out.getInterval());
+    for (uint32_t n = 0; n < 10; ++n)
+        TEST_ASSERT_TRUE(out.due(n * 2000));
+    // Faster than the packets is as fast as the packets
+    out.setIntervals(2000, 1000);
+    TEST_ASSERT_EQUAL(2000, out.getInterval());
+    TEST_ASSERT_TRUE(out.due(0));
+    TEST_ASSERT_TRUE(out.due(2000));
+}
+
+void test_divided(void)
+{
+    // 500Hz air rate to the FC at 250Hz
+    RCOutputScheduler out;
+    out.setIntervals(2000, 4000);
+    TEST_ASSERT_TRUE(out.due(10000));
+    TEST_ASSERT_FALSE(out.due(12000));
+    TEST_ASSERT_TRUE(out.due(14000 + 5));
+    TEST_ASSERT_FALSE(out.due(16000));
+    // The packet at 18000 is lost, the one after isn't sent in its place
+    TEST_ASSERT_FALSE(out.due(20000));
+    TEST_ASSERT_TRUE(out.due(22000 - 5));
+    TEST_ASSERT_FALSE(out.due(24000));
+    TEST_ASSERT_TRUE(out.due(26000));
+    // Back after a long loss, starting again from the first packet
+    TEST_ASSERT_TRUE(out.due(26000 + 4000 * RC_OUTPUT_RESTART_INTERVALS + 2000 * 5));
+}
+
+void test_not_a_multiple(void)
+{
+    // 1000Hz air rate to the FC at 333Hz, every third packet and now and then
+    // every fourth to keep to the rate
+    RCOutputScheduler out;
+    out.setIntervals(1000, 3003);
+    unsigned sent = 0;
+    uint32_t last = 0;
+    for (uint32_t n = 0; n < 3000; ++n)
+    {
+        if (out.due(n * 1000))
+        {
+            if (sent)
+                TEST_ASSERT_TRUE(n * 1000 - last == 3000 || n * 1000 - last == 4000);
+            last = n * 1000;
+            ++sent;
+        }
+    }
+    TEST_ASSERT_EQUAL(3000000 / 3003, sent);
+}
+
+void test_stats(void)
+{
+    RCOutputScheduler out;
+    out.setIntervals(4000, 0);
+    out.sent(0);
+    out.sent(4010);
+    out.sent(7990);
+    out.sent(12000);
+    // One lost
+    out.sent(20030);
+    out.latch();
+    TEST_ASSERT_EQUAL((10 + 20 + 10 + 30) / 4, out.getAvgJitter());
+    TEST_ASSERT_EQUAL(30, out.getMaxJitter());
+    TEST_ASSERT_EQUAL(1, out.getMissed());
+    // Latching starts over
+    out.latch();
+    TEST_ASSERT_EQUAL(0, out.getMaxJitter());
+    TEST_ASSERT_EQUAL(0, out.getMissed());
+}
+
+/**
+ * RC frames to the FC at 500Hz with 2% of packets lost, sent right away from
+ * the packet path with a few us of interrupt latency, or flagged for the main
+ * loop which gets to it anything up to a loop later and now and then after a
+ * WiFi or telemetry hold up.
+ **/
+void test_jitter(void)
+{
+    Rng rng(3);
+    RCOutputScheduler immediate, loop;
+    immediate.setIntervals(2000, 0);
+    loop.setIntervals(2000, 0);
+    for (uint32_t n = 0; n < 50000; ++n)
+    {
+        if (rng.uniform() < 0.02)
+            continue;
+        const double ready = 1000000 + n * 2000.0 + fabs(rng.gauss() * 3);
+        double loopDelay = rng.uniform() * 250;
+        if (rng.uniform() < 0.03)
+            loopDelay += rng.uniform() * 1500;
+        immediate.sent(ready + 2);
+        loop.sent(ready + loopDelay);
+    }
+    immediate.latch();
+    loop.latch();
+    printf("immediate: avg %uus max %uus missed %u  main loop: avg %uus max %uus missed %u\n",
+           immediate.getAvgJitter(), immediate.getMaxJitter(), immediate.getMissed(),
+           loop.getAvgJitter(), loop.getMaxJitter(), loop.getMissed());
+    TEST_ASSERT_TRUE(immediate.getMaxJitter() < 20);
+    TEST_ASSERT_TRUE(loop.getAvgJitter() > 10 * immediate.getAvgJitter());
+    // Frames held up most of a period look like one missed and one on time
+    TEST_ASSERT_TRUE(loop.getMissed() >= immediate.getMissed());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_every_packet);
+    RUN_TEST(test_divided);
+    RUN_TEST(test_not_a_multiple);
+    RUN_TEST(test_stats);
+    RUN_TEST(test_jitter);
+    UNITY_END();
+
+    return 0;
+}
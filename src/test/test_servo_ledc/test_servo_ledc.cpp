@@ -0,0 +1,99 @@
+#include <cstdint>
+#include <unity.h>
+#include "LedcTimerAlloc.h"
+
+#define HZ50  20000U
+#define HZ100 10000U
+#define HZ400 2500U
+
+void setUp() {}
+void tearDown() {}
+
+static bool sameTimer(uint8_t a, uint8_t b)
+{
+    return LedcTimerAlloc::speedMode(a) == LedcTimerAlloc::speedMode(b)
+        && LedcTimerAlloc::timer(a) == LedcTimerAlloc::timer(b);
+}
+
+void test_own_timer_each_rate(void)
+{
+    LedcTimerAlloc alloc;
+    uint8_t chan[8];
+    for (uint8_t ch = 0; ch < 8; ++ch)
+        chan[ch] = alloc.assign(ch, HZ50 + ch);
+    for (uint8_t a = 0; a < 8; ++a)
+    {
+        TEST_ASSERT_NOT_EQUAL(LedcTimerAlloc::NONE, chan[a]);
+        for (uint8_t b = a + 1; b < 8; ++b)
+            TEST_ASSERT_FALSE(sameTimer(chan[a], chan[b]));
+    }
+    // Every timer is at another rate
+    TEST_ASSERT_EQUAL(LedcTimerAlloc::NONE, alloc.assign(8, HZ400));
+}
+
+void test_same_rate_shares(void)
+{
+    LedcTimerAlloc alloc;
+    // 16 outputs at 2 rates fit, only ever sharing with their own rate
+    uint8_t chan[16];
+    for (uint8_t ch = 0; ch < 16; ++ch)
+        chan[ch] = alloc.assign(ch, (ch & 1) ? HZ400 : HZ50);
+    for (uint8_t a = 0; a < 16; ++a)
+    {
+        TEST_ASSERT_NOT_EQUAL(LedcTimerAlloc::NONE, chan[a]);
+        for (uint8_t b = a + 1; b < 16; ++b)
+        {
+            TEST_ASSERT_NOT_EQUAL(chan[a], chan[b]);
+            if (sameTimer(chan[a], chan[b]))
+                TEST_ASSERT_EQUAL(a & 1, b & 1);
+        }
+    }
+}
+
+void test_rate_change_moves_timer(void)
+{
+    // Output 0 and 8 are on the same timer with the old fixed mapping,
+    // changing 8's rate must not change 0's
+    LedcTimerAlloc alloc;
+    uint8_t chan[12];
+    for (uint8_t ch = 0; ch < 12; ++ch)
+        chan[ch] = alloc.assign(ch, HZ50);
+    const uint8_t moved = alloc.assign(8, HZ100);
+    TEST_ASSERT_NOT_EQUAL(LedcTimerAlloc::NONE, moved);
+    for (uint8_t ch = 0; ch < 12; ++ch)
+    {
+        if (ch != 8)
+            TEST_ASSERT_FALSE(sameTimer(moved, chan[ch]));
+    }
+}
+
+void test_sync_kept_apart(void)
+{
+    // Synced outputs restart their timer, so don't pair them with a free running one
+    LedcTimerAlloc alloc;
+    const uint8_t fixed = alloc.assign(0, HZ50);
+    const uint8_t synced = alloc.assign(1, (1U << 16) | HZ50);
+    TEST_ASSERT_FALSE(sameTimer(fixed, synced));
+}
+
+void test_release(void)
+{
+    LedcTimerAlloc alloc;
+    for (uint8_t ch = 0; ch < 8; ++ch)
+        alloc.assign(ch, HZ50 + ch);
+    alloc.release(3);
+    TEST_ASSERT_NOT_EQUAL(LedcTimerAlloc::NONE, alloc.assign(8, HZ400));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_own_timer_each_rate);
+    RUN_TEST(test_same_rate_shares);
+    RUN_TEST(test_rate_change_moves_timer);
+    RUN_TEST(test_sync_kept_apart);
+    RUN_TEST(test_release);
+    UNITY_END();
+
+    return 0;
+}
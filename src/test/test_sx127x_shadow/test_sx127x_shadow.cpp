@@ -0,0 +1,220 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <unity.h>
+#include "targets.h"
+#include "SX127x.h"
+
+extern SX127xHal hal;
+SX127xDriver Radio;
+
+/**
+ * The radio on the other end of a mocked SPI, a register file which counts
+ * every byte clocked over the bus. The HAL's register shadow is real, only
+ * the SPI transfers underneath it are replaced.
+ **/
+static uint8_t regs[256];
+static uint32_t spiBytes;
+static uint32_t spiReads;
+static uint32_t tunedTo; // the frequency the radio is on, taken when FRF_LSB is written
+
+SX127xHal *SX127xHal::instance = NULL;
+
+SX127xHal::SX127xHal()
+{
+    instance = this;
+}
+
+void SX127xHal::init()
+{
+    invalidateShadow();
+    memset(regs, 0, sizeof(regs));
+    regs[SX127X_REG_VERSION] = 0x12;
+    tunedTo = 0;
+}
+
+void SX127xHal::end() {}
+void ICACHE_RAM_ATTR SX127xHal::dioISR() {}
+void ICACHE_RAM_ATTR SX127xHal::TXenable() {}
+void ICACHE_RAM_ATTR SX127xHal::RXenable() {}
+void ICACHE_RAM_ATTR SX127xHal::TXRXdisable() {}
+
+uint8_t ICACHE_RAM_ATTR SX127xHal::readRegister(uint8_t reg)
+{
+    spiBytes += 2;
+    ++spiReads;
+    return regs[reg];
+}
+
+void ICACHE_RAM_ATTR SX127xHal::readRegisterBurst(uint8_t reg, uint8_t numBytes, uint8_t *inBytes)
+{
+    spiBytes += numBytes + 1;
+    ++spiReads;
+    memcpy(inBytes, regs + reg, numBytes);
+}
+
+void ICACHE_RAM_ATTR SX127xHal::writeRegisterFIFO(volatile uint8_t *data, uint8_t numBytes)
+{
+    spiBytes += numBytes + 1;
+}
+
+void ICACHE_RAM_ATTR SX127xHal::readRegisterFIFO(volatile uint8_t *data, uint8_t numBytes)
+{
+    spiBytes += numBytes + 1;
+}
+
+void ICACHE_RAM_ATTR SX127xHal::writeRegisterRaw(uint8_t reg, uint8_t *data, uint8_t numBytes)
+{
+    spiBytes += numBytes + 1;
+    memcpy(regs + reg, data, numBytes);
+    if (reg <= SX127X_REG_FRF_LSB && reg + numBytes > SX127X_REG_FRF_LSB)
+        tunedTo = (regs[SX127X_REG_FRF_MSB] << 16) | (regs[SX127X_REG_FRF_MID] << 8) | regs[SX127X_REG_FRF_LSB];
+}
+
+void setUp()
+{
+    Radio.Begin();
+    spiBytes = 0;
+    spiReads = 0;
+}
+
+void tearDown() {}
+
+typedef struct {
+    uint8_t bw;
+    uint8_t sf;
+    uint8_t cr;
+    uint8_t preambleLen;
+    uint8_t payloadLength;
+    uint32_t interval;
+} rate_t;
+
+// The 900MHz LoRa rates, 200Hz down to 25Hz
+static const rate_t rates[] = {
+    { SX127x_BW_500_00_KHZ, SX127x_SF_6, SX127x_CR_4_7, 8,  8,  5000 },
+    { SX127x_BW_500_00_KHZ, SX127x_SF_6, SX127x_CR_4_8, 8,  13, 10000 },
+    { SX127x_BW_500_00_KHZ, SX127x_SF_7, SX127x_CR_4_7, 8,  8,  10000 },
+    { SX127x_BW_500_00_KHZ, SX127x_SF_8, SX127x_CR_4_7, 10, 8,  20000 },
+    { SX127x_BW_500_00_KHZ, SX127x_SF_9, SX127x_CR_4_7, 10, 8,  40000 },
+};
+#define RATE_COUNT (sizeof(rates) / sizeof(rates[0]))
+
+static uint32_t freqReg(uint32_t hz)
+{
+    return (uint32_t)((double)hz / FREQ_STEP);
+}
+
+static void config(const rate_t &rate, bool shadowed)
+{
+    // Without the shadow every register is written and every bitfield read
+    // first, as each call forgets what was written before it
+    if (!shadowed)
+        hal.invalidateShadow();
+    Radio.Config(rate.bw, rate.sf, rate.cr, freqReg(915000000), rate.preambleLen, false, rate.payloadLength, rate.interval);
+}
+
+// The RX cycling through the rates looking for a TX
+static uint32_t rateCycleBytes(bool shadowed, uint8_t *image)
+{
+    Radio.Begin();
+    config(rates[0], shadowed);
+    spiBytes = 0;
+    for (unsigned cycle = 0; cycle < 4; ++cycle)
+        for (unsigned r = 0; r < RATE_COUNT; ++r)
+            config(rates[(r + 1) % RATE_COUNT], shadowed);
+    memcpy(image, regs, sizeof(regs));
+    return spiBytes / (4 * RATE_COUNT);
+}
+
+void test_rate_change(void)
+{
+    uint8_t before[sizeof(regs)], after[sizeof(regs)];
+    const uint32_t bytesBefore = rateCycleBytes(false, before);
+    const uint32_t bytesAfter = rateCycleBytes(true, after);
+    printf("rate change: %u SPI bytes without the shadow, %u with\n", bytesBefore, bytesAfter);
+    // The radio ends up configured the same
+    TEST_ASSERT_EQUAL_MEMORY(before, after, sizeof(regs));
+    TEST_ASSERT_TRUE(bytesAfter < bytesBefore / 2);
+
+    // Configuring the rate already in use touches nothing but the mode
+    config(rates[2], true);
+    spiBytes = 0;
+    config(rates[2], true);
+    TEST_ASSERT_TRUE(spiBytes <= 4);
+}
+
+void test_bitfields_are_pure_writes(void)
+{
+    config(rates[0], true);
+    spiReads = 0;
+    for (unsigned r = 1; r < RATE_COUNT; ++r)
+        config(rates[r], true);
+    TEST_ASSERT_EQUAL(0, spiReads);
+    // The registers not written since the reset are read once
+    hal.invalidateShadow();
+    config(rates[0], true);
+    TEST_ASSERT_TRUE(spiReads > 0);
+}
+
+void test_hop(void)
+{
+    // 40 channels 600kHz apart, hopped in a scrambled order
+    const unsigned channels = 40;
+    const unsigned hops = 1000;
+    uint32_t bytes[2];
+    for (unsigned shadowed = 0; shadowed < 2; ++shadowed)
+    {
+        Radio.Begin();
+        config(rates[0], true);
+        spiBytes = 0;
+        uint32_t ch = 0;
+        for (unsigned h = 0; h < hops; ++h)
+        {
+            ch = (ch + 17) % channels;
+            const uint32_t freq = freqReg(903500000 + ch * 600000);
+            if (!shadowed)
+                hal.invalidateShadow();
+            Radio.SetFrequencyReg(freq);
+            // Every hop lands, whichever bytes were written
+            TEST_ASSERT_EQUAL(freq, tunedTo);
+        }
+        bytes[shadowed] = spiBytes;
+    }
+    printf("hop: %.2f SPI bytes without the shadow, %.2f with\n", (double)bytes[0] / hops, (double)bytes[1] / hops);
+    TEST_ASSERT_EQUAL(4 * hops, bytes[0]);
+    // FRF_MSB steps every 4MHz so hops across the band still write it
+    TEST_ASSERT_TRUE(bytes[1] <= bytes[0]);
+
+    // Frequency correction moves the LSB only, and staying put costs nothing
+    const uint32_t freq = freqReg(915000000);
+    Radio.SetFrequencyReg(freq);
+    spiBytes = 0;
+    Radio.SetFrequencyReg(freq + 1);
+    TEST_ASSERT_EQUAL(2, spiBytes);
+    TEST_ASSERT_EQUAL(freq + 1, tunedTo);
+    spiBytes = 0;
+    Radio.SetFrequencyReg(freq + 1);
+    TEST_ASSERT_EQUAL(0, spiBytes);
+}
+
+// Registers the radio changes itself always go out
+void test_volatile_registers_not_shadowed(void)
+{
+    hal.writeRegister(SX127X_REG_IRQ_FLAGS, 0xFF);
+    hal.writeRegister(SX127X_REG_IRQ_FLAGS, 0xFF);
+    hal.writeRegister(SX127X_REG_FIFO_ADDR_PTR, 0);
+    hal.writeRegister(SX127X_REG_FIFO_ADDR_PTR, 0);
+    TEST_ASSERT_EQUAL(8, spiBytes);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_rate_change);
+    RUN_TEST(test_bitfields_are_pure_writes);
+    RUN_TEST(test_hop);
+    RUN_TEST(test_volatile_registers_not_shadowed);
+    UNITY_END();
+
+    return 0;
+}
@@ -0,0 +1,272 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <unity.h>
+#include "targets.h"
+#include "SX1280.h"
+
+extern SX1280Hal hal;
+SX1280Driver Radio;
+
+/**
+ * The radios on the other end of a mocked SPI, which keep the parameters of
+ * each command and the registers they were sent, and count every byte
+ * clocked over the bus. The HAL's parameter shadow is real, only the SPI
+ * transfers underneath it are replaced.
+ **/
+typedef struct {
+    uint8_t size;
+    uint8_t data[16];
+} params_t;
+
+typedef struct {
+    params_t commands[256];
+    uint8_t regs[0x100]; // 0x900 to 0x9FF, where the configuration registers are
+} chip_t;
+
+static chip_t chips[2];
+static uint32_t spiBytes;
+static uint32_t commandsSent[256];
+static uint32_t regsWritten[0x100];
+
+SX1280Hal *SX1280Hal::instance = NULL;
+
+SX1280Hal::SX1280Hal()
+{
+    instance = this;
+}
+
+void SX1280Hal::init() {}
+void SX1280Hal::end() {}
+
+void SX1280Hal::reset()
+{
+    InvalidateShadow(SX1280_Radio_All);
+    memset(chips, 0, sizeof(chips));
+}
+
+void ICACHE_RAM_ATTR SX1280Hal::setNss(uint8_t radioNumber, bool state) {}
+bool ICACHE_RAM_ATTR SX1280Hal::WaitOnBusy(SX1280_Radio_Number_t radioNumber) { return true; }
+void ICACHE_RAM_ATTR SX1280Hal::TXenable(SX1280_Radio_Number_t radioNumber) {}
+void ICACHE_RAM_ATTR SX1280Hal::RXenable() {}
+void ICACHE_RAM_ATTR SX1280Hal::TXRXdisable() {}
+void ICACHE_RAM_ATTR SX1280Hal::dioISR_1() {}
+void ICACHE_RAM_ATTR SX1280Hal::dioISR_2() {}
+
+void ICACHE_RAM_ATTR SX1280Hal::ReadCommand(SX1280_RadioCommands_t command, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber)
+{
+    spiBytes += size + 2;
+    memset(buffer, 0, size);
+}
+
+void ICACHE_RAM_ATTR SX1280Hal::ReadRegister(uint16_t address, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber)
+{
+    spiBytes += size + 4;
+    // Anything but 0 or 0xFFFF for the firmware version
+    memset(buffer, 0xA5, size);
+}
+
+uint8_t ICACHE_RAM_ATTR SX1280Hal::ReadRegister(uint16_t address, SX1280_Radio_Number_t radioNumber)
+{
+    uint8_t data;
+    ReadRegister(address, &data, 1, radioNumber);
+    return data;
+}
+
+void ICACHE_RAM_ATTR SX1280Hal::WriteBuffer(uint8_t offset, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber)
+{
+    spiBytes += size + 2;
+}
+
+void ICACHE_RAM_ATTR SX1280Hal::ReadBuffer(uint8_t offset, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber)
+{
+    spiBytes += size + 3;
+}
+
+void ICACHE_RAM_ATTR SX1280Hal::WriteCommandRaw(SX1280_RadioCommands_t command, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber, uint32_t busyDelay)
+{
+    spiBytes += size + 1;
+    ++commandsSent[command];
+    for (uint8_t radio = 0; radio < 2; ++radio)
+    {
+        if (radioNumber & (1 << radio))
+        {
+            chips[radio].commands[command].size = size;
+            memcpy(chips[radio].commands[command].data, buffer, size);
+        }
+    }
+}
+
+void ICACHE_RAM_ATTR SX1280Hal::WriteRegisterRaw(uint16_t address, uint8_t *buffer, uint8_t size, SX1280_Radio_Number_t radioNumber)
+{
+    spiBytes += size + 3;
+    for (uint8_t radio = 0; radio < 2; ++radio)
+    {
+        if ((radioNumber & (1 << radio)) && address >= 0x900 && address + size <= 0xA00)
+            memcpy(chips[radio].regs + address - 0x900, buffer, size);
+    }
+    if (address >= 0x900 && address < 0xA00)
+        ++regsWritten[address - 0x900];
+}
+
+typedef struct {
+    uint8_t bw;
+    uint8_t sf;
+    uint8_t cr;
+    uint8_t preambleLen;
+    uint32_t interval;
+    uint8_t flrc;
+} rate_t;
+
+// The 2.4GHz rates, FLRC 1000Hz and LoRa 500Hz down to 50Hz
+static const rate_t rates[] = {
+    { SX1280_FLRC_BR_0_650_BW_0_6, SX1280_FLRC_BT_1, SX1280_FLRC_CR_1_2,    32, 1000,  1 },
+    { SX1280_LORA_BW_0800,         SX1280_LORA_SF5,  SX1280_LORA_CR_LI_4_6, 12, 2000,  0 },
+    { SX1280_LORA_BW_0800,         SX1280_LORA_SF6,  SX1280_LORA_CR_LI_4_7, 14, 4000,  0 },
+    { SX1280_LORA_BW_0800,         SX1280_LORA_SF7,  SX1280_LORA_CR_LI_4_7, 12, 6666,  0 },
+    { SX1280_LORA_BW_0800,         SX1280_LORA_SF9,  SX1280_LORA_CR_LI_4_6, 12, 20000, 0 },
+};
+#define RATE_COUNT (sizeof(rates) / sizeof(rates[0]))
+
+static uint32_t freqReg(uint32_t hz)
+{
+    return (uint32_t)((double)hz / FREQ_STEP);
+}
+
+static void config(const rate_t &rate, bool shadowed)
+{
+    // Without the shadow everything is sent, as each call forgets what was
+    // sent before it
+    if (!shadowed)
+        hal.InvalidateShadow(SX1280_Radio_All);
+    Radio.Config(rate.bw, rate.sf, rate.cr, freqReg(2440000000), rate.preambleLen, false, 8, rate.interval,
+                 0x12345678, 0xABCD, rate.flrc);
+}
+
+void setUp()
+{
+    Radio.Begin();
+    spiBytes = 0;
+    memset(commandsSent, 0, sizeof(commandsSent));
+    memset(regsWritten, 0, sizeof(regsWritten));
+}
+
+void tearDown() {}
+
+// The RX cycling through the rates looking for a TX, which goes between the
+// LoRa rates each time and between LoRa and FLRC once per cycle
+static uint32_t rateCycleBytes(bool shadowed, chip_t *image)
+{
+    Radio.Begin();
+    config(rates[0], shadowed);
+    spiBytes = 0;
+    for (unsigned cycle = 0; cycle < 4; ++cycle)
+        for (unsigned r = 0; r < RATE_COUNT; ++r)
+            config(rates[(r + 1) % RATE_COUNT], shadowed);
+    memcpy(image, &chips[0], sizeof(chip_t));
+    return spiBytes / (4 * RATE_COUNT);
+}
+
+void test_rate_change(void)
+{
+    static chip_t before, after;
+    const uint32_t bytesBefore = rateCycleBytes(false, &before);
+    const uint32_t bytesAfter = rateCycleBytes(true, &after);
+    printf("rate change: %u SPI bytes without the shadow, %u with\n", bytesBefore, bytesAfter);
+    // The radio ends up configured the same
+    TEST_ASSERT_EQUAL_MEMORY(&before, &after, sizeof(chip_t));
+    TEST_ASSERT_TRUE(bytesAfter < bytesBefore);
+
+    // Configuring the rate already in use only sets the mode
+    config(rates[2], true);
+    spiBytes = 0;
+    config(rates[2], true);
+    TEST_ASSERT_EQUAL(2, spiBytes); // SET_STANDBY
+}
+
+void test_packet_type_change_resends_everything(void)
+{
+    config(rates[1], true);
+    memset(commandsSent, 0, sizeof(commandsSent));
+    config(rates[0], true);
+    TEST_ASSERT_EQUAL(1, commandsSent[SX1280_RADIO_SET_PACKETTYPE]);
+    TEST_ASSERT_EQUAL(1, commandsSent[SX1280_RADIO_SET_MODULATIONPARAMS]);
+    TEST_ASSERT_EQUAL(1, commandsSent[SX1280_RADIO_SET_PACKETPARAMS]);
+    TEST_ASSERT_EQUAL(1, commandsSent[SX1280_RADIO_SET_RFFREQUENCY]);
+    TEST_ASSERT_EQUAL(1, commandsSent[SX1280_RADIO_SET_DIOIRQPARAMS]);
+}
+
+void test_sleep_forgets(void)
+{
+    config(rates[1], true);
+    Radio.End();
+    Radio.Begin();
+    memset(commandsSent, 0, sizeof(commandsSent));
+    config(rates[1], true);
+    TEST_ASSERT_EQUAL(1, commandsSent[SX1280_RADIO_SET_MODULATIONPARAMS]);
+}
+
+// SF5 and SF6 share the SF additional config value, it is written again anyway
+void test_modulation_change_rewrites_registers(void)
+{
+    config(rates[1], true);
+    memset(commandsSent, 0, sizeof(commandsSent));
+    memset(regsWritten, 0, sizeof(regsWritten));
+    config(rates[2], true);
+    TEST_ASSERT_EQUAL(1, commandsSent[SX1280_RADIO_SET_MODULATIONPARAMS]);
+    TEST_ASSERT_EQUAL(1, regsWritten[SX1280_REG_SF_ADDITIONAL_CONFIG - 0x900]);
+    TEST_ASSERT_EQUAL(1, regsWritten[SX1280_REG_FREQ_ERR_CORRECTION - 0x900]);
+    // Without a modulation change they are still skipped
+    memset(regsWritten, 0, sizeof(regsWritten));
+    config(rates[2], true);
+    TEST_ASSERT_EQUAL(0, regsWritten[SX1280_REG_SF_ADDITIONAL_CONFIG - 0x900]);
+    TEST_ASSERT_EQUAL(0, regsWritten[SX1280_REG_FREQ_ERR_CORRECTION - 0x900]);
+}
+
+void test_hop(void)
+{
+    config(rates[1], true);
+    const uint32_t freq = freqReg(2440000000);
+    spiBytes = 0;
+    // Each command is the minimum already, a hop is sent whole
+    Radio.SetFrequencyReg(freq + 1000);
+    TEST_ASSERT_EQUAL(4, spiBytes);
+    TEST_ASSERT_EQUAL_UINT8(((freq + 1000) >> 8) & 0xFF, chips[0].commands[SX1280_RADIO_SET_RFFREQUENCY].data[1]);
+    // Staying on the channel isn't
+    spiBytes = 0;
+    Radio.SetFrequencyReg(freq + 1000);
+    TEST_ASSERT_EQUAL(0, spiBytes);
+}
+
+void test_per_radio(void)
+{
+    uint8_t buf[2] = { 31, SX1280_RADIO_RAMP_04_US };
+    hal.WriteCommand(SX1280_RADIO_SET_TXPARAMS, buf, sizeof(buf), SX1280_Radio_1);
+    hal.WriteCommand(SX1280_RADIO_SET_TXPARAMS, buf, sizeof(buf), SX1280_Radio_1);
+    TEST_ASSERT_EQUAL(1, commandsSent[SX1280_RADIO_SET_TXPARAMS]);
+    // Radio 2 doesn't have it yet
+    hal.WriteCommand(SX1280_RADIO_SET_TXPARAMS, buf, sizeof(buf), SX1280_Radio_All);
+    TEST_ASSERT_EQUAL(2, commandsSent[SX1280_RADIO_SET_TXPARAMS]);
+    hal.WriteCommand(SX1280_RADIO_SET_TXPARAMS, buf, sizeof(buf), SX1280_Radio_2);
+    TEST_ASSERT_EQUAL(2, commandsSent[SX1280_RADIO_SET_TXPARAMS]);
+    // Sleeping one radio only forgets that one
+    hal.WriteCommand(SX1280_RADIO_SET_SLEEP, 0x01, SX1280_Radio_2);
+    hal.WriteCommand(SX1280_RADIO_SET_TXPARAMS, buf, sizeof(buf), SX1280_Radio_1);
+    TEST_ASSERT_EQUAL(2, commandsSent[SX1280_RADIO_SET_TXPARAMS]);
+    hal.WriteCommand(SX1280_RADIO_SET_TXPARAMS, buf, sizeof(buf), SX1280_Radio_2);
+    TEST_ASSERT_EQUAL(3, commandsSent[SX1280_RADIO_SET_TXPARAMS]);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_rate_change);
+    RUN_TEST(test_packet_type_change_resends_everything);
+    RUN_TEST(test_sleep_forgets);
+    RUN_TEST(test_modulation_change_rewrites_registers);
+    RUN_TEST(test_hop);
+    RUN_TEST(test_per_radio);
+    UNITY_END();
+
+    return 0;
+}
@@ -0,0 +1,259 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <unity.h>
+#include "targets.h"
+#include "UARTSlotScheduler.h"
+
+#define RC_FRAME_BYTES   26
+#define HANDSET_FIFO     128  // HANDSET_TELEMETRY_FIFO_SIZE
+#define HANDSET_JITTER   20.0 // us, stddev of when the handset's frames go out
+#define HANDSET_DRIFT    50e-6 // its clock running slower than the TX's
+#define FRAMES           20000
+
+// Deterministic whatever the standard library
+class Rng
+{
+public:
+    explicit Rng(uint32_t seed) : state(seed) {}
+    double uniform()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return (state + 0.5) / 4294967296.0;
+    }
+    double exponential(double mean)
+    {
+        return -mean * log(uniform());
+    }
+    double gauss()
+    {
+        return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+    }
+private:
+    uint32_t state;
+};
+
+typedef struct {
+    const char *name;
+    uint32_t baud;
+    uint32_t periodUs;
+    double busyChance;  // of the main loop being held up before it sees the RC frame
+    double busyMaxFrac; // for up to this much of the period
+} link_t;
+
+static const link_t links[] = {
+    { "400k 250Hz",   400000,  4000, 0.05, 0.6 },
+    { "400k 500Hz",   400000,  2000, 0.05, 0.6 },
+    { "115k2 150Hz",  115200,  6666, 0.05, 0.6 },
+    { "1.87M 1000Hz", 1870000, 1000, 0.10, 0.7 },
+    { "400k 250Hz quiet", 400000, 4000, 0.0, 0.0 },
+};
+
+// What adjustMaxPacketSize() allows in a period, 40% of it
+static uint8_t maxPeriodBytes(const link_t &link)
+{
+    uint32_t bytes = link.baud / 10 / 2 / (1000000 / link.periodUs) * 80 / 100;
+    bytes = bytes > HANDSET_FIFO ? HANDSET_FIFO : bytes;
+    return bytes < 10 ? 10 : bytes;
+}
+
+typedef struct {
+    double collisionPct; // of the periods the TX sent in
+    double bytesPerSec;
+    uint32_t reported;   // collisions the scheduler counted
+} uart_result_t;
+
+/**
+ * The handset's RC frames with a little jitter, the TX processing each after
+ * a short delay or, now and then, a long one while the main loop is busy,
+ * with a backlog of telemetry, MSP and Lua frames to send back.
+ * handleUARTout()'s sending, with the period's bytes as a fixed budget from
+ * whenever the RC frame got processed, or the scheduler's window.
+ **/
+static uart_result_t simulate(const link_t &link, bool scheduled)
+{
+    Rng rng(99);
+    UARTSlotScheduler slots;
+    slots.setTiming(link.periodUs, link.baud);
+    const uint8_t periodMax = maxPeriodBytes(link);
+    static const uint8_t backlog[] = { 14, 64, 22, 64, 64, 12 };
+    unsigned nextPkt = 0;
+    uint8_t remaining = 0;
+    uint32_t sentPeriods = 0, collided = 0, bytes = 0;
+    const uint32_t frameUs = slots.bytesToUs(RC_FRAME_BYTES);
+
+    double arrive = 1000000;
+    for (uint32_t n = 0; n < FRAMES; ++n)
+    {
+        const double nextArrive = 1000000 + (n + 1) * link.periodUs * (1 + HANDSET_DRIFT) + rng.gauss() * HANDSET_JITTER;
+        double latency = 30 + rng.exponential(40);
+        if (rng.uniform() < link.busyChance)
+            latency += rng.uniform() * link.busyMaxFrac * link.periodUs;
+        const uint32_t now = arrive + latency;
+
+        slots.rcFrameReceived(now, RC_FRAME_BYTES);
+        uint8_t budget = periodMax;
+        if (scheduled)
+        {
+            const uint8_t window = slots.windowBytes(now);
+            budget = window < budget ? window : budget;
+        }
+
+        uint8_t periodBytes = 0;
+        while (budget > periodBytes)
+        {
+            if (remaining == 0)
+            {
+                remaining = backlog[nextPkt++ % sizeof(backlog)];
+            }
+            const uint8_t left = budget - periodBytes;
+            uint8_t writeLength = remaining;
+            if (remaining > left)
+            {
+                // Only start to send a split packet as the first packet
+                if (periodBytes > 0)
+                    break;
+                writeLength = left;
+            }
+            remaining -= writeLength;
+            periodBytes += writeLength;
+        }
+
+        if (periodBytes)
+        {
+            slots.sent(now, periodBytes);
+            ++sentPeriods;
+            bytes += periodBytes;
+            const double txEnd = now + UART_SLOT_TURNAROUND_US + slots.bytesToUs(periodBytes);
+            if (txEnd > nextArrive - frameUs)
+                ++collided;
+        }
+        arrive = nextArrive;
+    }
+    uart_result_t res;
+    res.collisionPct = sentPeriods ? 100.0 * collided / sentPeriods : 0;
+    res.bytesPerSec = bytes * 1000000.0 / ((double)FRAMES * link.periodUs);
+    res.reported = slots.getCollisions();
+    return res;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_collisions(void)
+{
+    const unsigned count = sizeof(links) / sizeof(links[0]);
+    for (unsigned l = 0; l < count; ++l)
+    {
+        const uart_result_t fixed = simulate(links[l], false);
+        const uart_result_t slots = simulate(links[l], true);
+        printf("%-17s fixed: %5.2f%% collide %6.0fB/s  slots: %5.2f%% collide %6.0fB/s (counted %u/%u)\n",
+               links[l].name, fixed.collisionPct, fixed.bytesPerSec,
+               slots.collisionPct, slots.bytesPerSec, fixed.reported, slots.reported);
+
+        TEST_ASSERT_TRUE(slots.collisionPct < 0.05);
+        TEST_ASSERT_TRUE(slots.collisionPct <= fixed.collisionPct);
+        // Collisions seen are counted, not missed or made up
+        TEST_ASSERT_TRUE(fixed.reported > 0 || fixed.collisionPct == 0);
+        TEST_ASSERT_TRUE(slots.reported <= fixed.reported);
+        // What isn't sent into the next frame goes in the one after, very
+        // little is lost to waiting
+        TEST_ASSERT_TRUE(slots.bytesPerSec > fixed.bytesPerSec * 0.95);
+        if (links[l].busyChance > 0)
+            TEST_ASSERT_TRUE(fixed.collisionPct > 0.5);
+    }
+}
+
+void test_window(void)
+{
+    UARTSlotScheduler slots;
+    // 250Hz at 400k baud: 25us a byte, the RC frame is 650us
+    slots.setTiming(4000, 400000);
+    TEST_ASSERT_EQUAL(0, slots.windowBytes(0));
+    slots.rcFrameReceived(10000, RC_FRAME_BYTES);
+    // Next frame starts at 13350, less the guard and turnaround
+    TEST_ASSERT_EQUAL((13350 - UART_SLOT_GUARD_US - UART_SLOT_TURNAROUND_US - 10000) / 25, slots.windowBytes(10000));
+    // Later in the period there is less room
+    TEST_ASSERT_EQUAL((13350 - UART_SLOT_GUARD_US - UART_SLOT_TURNAROUND_US - 12000) / 25, slots.windowBytes(12000));
+    TEST_ASSERT_EQUAL(0, slots.windowBytes(13300));
+}
+
+void test_late_processing_not_taken_as_arrival(void)
+{
+    UARTSlotScheduler slots;
+    slots.setTiming(4000, 400000);
+    slots.rcFrameReceived(10000, RC_FRAME_BYTES);
+    // Processed 2ms late, the frame still arrived at 14000
+    slots.rcFrameReceived(16000, RC_FRAME_BYTES);
+    const uint8_t window = slots.windowBytes(16000);
+    TEST_ASSERT_TRUE(window < (17350 - 16000) / 25);
+    TEST_ASSERT_TRUE(window > (17350 - 16000) / 25 - 20);
+    // A frame missed altogether keeps the phase
+    slots.rcFrameReceived(22000 + 50, RC_FRAME_BYTES);
+    TEST_ASSERT_TRUE(slots.windowBytes(22050) > (25350 - 22050) / 25 - 20);
+}
+
+void test_relock(void)
+{
+    UARTSlotScheduler slots;
+    slots.setTiming(4000, 400000);
+    slots.rcFrameReceived(10000, RC_FRAME_BYTES);
+    // The handset's frames move 1ms later, which looks like each is processed late
+    uint32_t arrive = 10000 + 1000;
+    for (unsigned n = 0; n < UART_SLOT_RELOCK_FRAMES - 1; ++n)
+    {
+        arrive += 4000;
+        slots.rcFrameReceived(arrive, RC_FRAME_BYTES);
+        // Sending less than there is room for, never more
+        TEST_ASSERT_TRUE(slots.windowBytes(arrive) < (4000 - 650 - 1000) / 25);
+    }
+    arrive += 4000;
+    slots.rcFrameReceived(arrive, RC_FRAME_BYTES);
+    TEST_ASSERT_EQUAL((4000 - 650 - UART_SLOT_GUARD_US - UART_SLOT_TURNAROUND_US) / 25, slots.windowBytes(arrive));
+}
+
+void test_collision_counted(void)
+{
+    UARTSlotScheduler slots;
+    slots.setTiming(4000, 400000);
+    slots.rcFrameReceived(10000, RC_FRAME_BYTES);
+    slots.sent(10000, 100); // 2.5ms
+    slots.rcFrameReceived(14000, RC_FRAME_BYTES);
+    TEST_ASSERT_EQUAL(0, slots.getCollisions());
+    slots.sent(14000, 140); // 3.5ms, into the next frame
+    slots.rcFrameReceived(18000, RC_FRAME_BYTES);
+    TEST_ASSERT_EQUAL(1, slots.getCollisions());
+    slots.resetCollisions();
+    TEST_ASSERT_EQUAL(0, slots.getCollisions());
+}
+
+void test_full_duplex_not_limited(void)
+{
+    UARTSlotScheduler slots;
+    slots.setTiming(4000, 400000);
+    slots.setHalfDuplex(false);
+    // No handset traffic at all
+    TEST_ASSERT_EQUAL(255, slots.windowBytes(0));
+    slots.rcFrameReceived(10000, RC_FRAME_BYTES);
+    // Right up to and over the next RC frame
+    TEST_ASSERT_EQUAL(255, slots.windowBytes(13300));
+    slots.sent(13300, 255);
+    slots.rcFrameReceived(14000, RC_FRAME_BYTES);
+    TEST_ASSERT_EQUAL(0, slots.getCollisions());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_window);
+    RUN_TEST(test_late_processing_not_taken_as_arrival);
+    RUN_TEST(test_relock);
+    RUN_TEST(test_collision_counted);
+    RUN_TEST(test_full_duplex_not_limited);
+    RUN_TEST(test_collisions);
+    UNITY_END();
+
+    return 0;
+}